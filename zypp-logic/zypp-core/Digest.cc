@@ -27,18 +27,74 @@
 #include <string.h>
 
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include <zypp-core/AutoDispose.h>
 #include <zypp-core/Digest.h>
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/PtrTypes.h>
+#include <zypp-core/fs/BulkIO.h>
 
 using std::endl;
 
 namespace zypp {
 
+    namespace {
+      /** One time OpenSSL setup, Digests may be created concurrently (\ref Digest::digestFiles). */
+      void initOpenSSL()
+      {
+        static std::once_flag once;
+        std::call_once( once, [](){
+#if OPENSSL_API_LEVEL >= 30000
+          // openssl 3.0 does not use engines anymore, instead we fetch algorithms via a new API
+          // also it seems initialization is implicit, i'm not sure if that call here is even required.
+          OPENSSL_init_crypto( OPENSSL_INIT_LOAD_CONFIG, nullptr );
+
+          // md4 was moved to legacy, we need this for zsync
+          if ( !OSSL_PROVIDER_load( nullptr, "legacy" ) ) {
+            ERR << "Failed to load legacy openssl provider" << std::endl;
+          }
+          if ( !OSSL_PROVIDER_load( nullptr, "default") ) {
+            ERR << "Failed to load default openssl provider" << std::endl;
+          }
+
+          OPENSSL_init_crypto( OPENSSL_INIT_ADD_ALL_DIGESTS, nullptr );
+#else
+# if OPENSSL_VERSION_NUMBER >= 0x10100000L
+          OPENSSL_init_crypto( OPENSSL_INIT_LOAD_CONFIG, nullptr );
+# else
+          OPENSSL_config(NULL);
+# endif
+          ENGINE_load_builtin_engines();
+          ENGINE_register_all_complete();
+          OpenSSL_add_all_digests();
+#endif
+        });
+      }
+
+      /** The algorithm for \a name_r, fetched ones are reused for all Digest instances. */
+      const EVP_MD * fetchDigest( const std::string & name_r )
+      {
+#if OPENSSL_API_LEVEL >= 30000
+        // fetching the provider based algorithms is expensive, the returned objects are
+        // reference counted and can be shared between threads
+        static std::mutex lock;
+        static std::unordered_map<std::string, AutoDispose<EVP_MD *>> fetched;
+
+        std::lock_guard lk( lock );
+        auto it = fetched.find( name_r );
+        if ( it == fetched.end() )
+          it = fetched.emplace( name_r, AutoDispose<EVP_MD *>( EVP_MD_fetch( nullptr, name_r.c_str(), nullptr ), EVP_MD_free ) ).first;
+        return it->second;
+#else
+        return EVP_get_digestbyname( name_r.c_str() );
+#endif
+      }
+    } // namespace
+
     const std::string & Digest::md5()
     { static std::string _type( "md5" ); return _type; }
 
@@ -71,17 +127,12 @@ namespace zypp {
         ~P();
 
         EvpDataPtr mdctx;
-#if OPENSSL_API_LEVEL >= 30000
-        AutoDispose<EVP_MD *> md;
-#else
         const EVP_MD *md;
-#endif
         unsigned char md_value[EVP_MAX_MD_SIZE];
         unsigned md_len;
         zypp::ByteCount bytesHashed;
 
         bool finalized : 1;
-        static bool openssl_digests_added;
 
         std::string name;
 
@@ -91,8 +142,6 @@ namespace zypp {
 
 
 
-    bool Digest::P::openssl_digests_added = false;
-
     Digest::P::P() :
       md(nullptr),
       finalized(false)
@@ -106,44 +155,11 @@ namespace zypp {
 
     bool Digest::P::maybeInit()
     {
-      if(!openssl_digests_added)
-      {
-#if OPENSSL_API_LEVEL >= 30000
-        // openssl 3.0 does not use engines anymore, instead we fetch algorithms via a new API
-        // also it seems initialization is implicit, i'm not sure if that call here is even required.
-        OPENSSL_init_crypto( OPENSSL_INIT_LOAD_CONFIG, nullptr );
-
-        // md4 was moved to legacy, we need this for zsync
-        if ( !OSSL_PROVIDER_load( nullptr, "legacy" ) ) {
-          ERR << "Failed to load legacy openssl provider" << std::endl;
-        }
-        if ( !OSSL_PROVIDER_load( nullptr, "default") ) {
-          ERR << "Failed to load default openssl provider" << std::endl;
-        }
-
-        OPENSSL_init_crypto( OPENSSL_INIT_ADD_ALL_DIGESTS, nullptr );
-#else
-# if OPENSSL_VERSION_NUMBER >= 0x10100000L
-        OPENSSL_init_crypto( OPENSSL_INIT_LOAD_CONFIG, nullptr );
-# else
-        OPENSSL_config(NULL);
-# endif
-        ENGINE_load_builtin_engines();
-        ENGINE_register_all_complete();
-        OpenSSL_add_all_digests();
-#endif
-        openssl_digests_added = true;
-      }
+      initOpenSSL();
 
       if(!mdctx)
       {
-#if OPENSSL_API_LEVEL >= 30000
-        // this fetches the new provider based algorithms, returned objects have to be free'd
-        // i wonder if we could cache the providers instead of querying them for every Digest instance....
-        md = AutoDispose<EVP_MD *>( EVP_MD_fetch (nullptr, name.c_str(), nullptr), EVP_MD_free );
-#else
-        md = EVP_get_digestbyname(name.c_str());
-#endif
+        md = fetchDigest( name );
         if(!md)
           return false;
 
@@ -171,9 +187,7 @@ namespace zypp {
 
     void Digest::P::cleanup()
     {
-#if OPENSSL_API_LEVEL >= 30000
-      md.reset();
-#endif
+      md = nullptr;
       mdctx.reset();
       finalized = false;
     }
@@ -354,4 +368,9 @@ namespace zypp {
       return digest( name, is, bufsize );
     }
 
+    std::vector<std::string> Digest::digestFiles( const std::string & name, const std::vector<Pathname> & files, unsigned parallelism )
+    {
+      return filesystem::checksums( files, name, parallelism );
+    }
+
 } // namespace zypp
@@ -19,6 +19,7 @@
 #include <iosfwd>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include <zypp-core/Pathname.h>
 #include <zypp-core/ByteArray.h>
@@ -169,6 +170,18 @@ namespace zypp {
 
         /** \overload Reading input data from \c string. */
         static std::string digest( const std::string & name, const std::string & input, size_t bufsize = 4096 );
+
+        /** \brief compute the digests of many files
+         *
+         * The files are read in large blocks and up to \a parallelism of them are
+         * hashed concurrently ( \c 0 uses one thread per CPU, at most 16 ).
+         *
+         * @param name name of the digest algorithm, \see create
+         * @param files the files to hash
+         * @param parallelism maximum number of files hashed at the same time
+         * @return the digests in the order of \a files, empty for files that could not be read
+         * */
+        static std::vector<std::string> digestFiles( const std::string & name, const std::vector<Pathname> & files, unsigned parallelism = 0 );
     };
 
 } // namespace zypp
@@ -28,6 +28,7 @@
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/Gettext.h>
+#include <zypp-core/base/Metrics.h>
 #include <zypp-core/ExternalProgram.h>
 #include <zypp-core/base/CleanerThread_p.h>
 
@@ -317,7 +318,16 @@ namespace zypp {
       _backend->setEnvironment( environment );
       _backend->setUseDefaultLocale( default_locale );
 
-      if ( _backend->start( argv, stdinFd, stdoutFd, stderrFd ) ) {
+      static metrics::Counter & spawns      { metrics::counter( "ExternalProgram.spawns" ) };
+      static metrics::Histogram & spawnTime { metrics::histogram( "ExternalProgram.spawn" ) };
+      spawns.inc();
+      bool started = false;
+      {
+        metrics::ScopedTimer timer { spawnTime };
+        started = _backend->start( argv, stdinFd, stdoutFd, stderrFd );
+      }
+
+      if ( started ) {
         bool connected = true;
         if ( childStdoutParentFd != -1 ) {
           inputfile = fdopen( childStdoutParentFd, "r" );
@@ -13,20 +13,23 @@
 #include <fstream>
 #include <string>
 #include <mutex>
+#include <condition_variable>
 #include <map>
+#include <array>
+#include <algorithm>
+#include <typeinfo>
 
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/LogControl.h>
 #include <zypp-core/base/ProfilingFormater.h>
 #include <zypp-core/base/PtrTypes.h>
 #include <zypp-core/base/String.h>
+#include <zypp-core/base/Trace.h>
 #include <zypp-core/Date.h>
 #include <zypp-core/TriBool.h>
 #include <zypp-core/AutoDispose.h>
 
 #include <utility>
-#include <zypp-core/ng/io/Socket>
-#include <zypp-core/ng/io/SockAddr>
 #include <zypp-core/ng/base/EventLoop>
 #include <zypp-core/ng/base/EventDispatcher>
 #include <zypp-core/ng/base/Timer>
@@ -44,9 +47,11 @@ extern "C"
 {
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <limits.h>
 }
 
 using std::endl;
@@ -81,6 +86,96 @@ namespace zypp
     std::atomic_flag _atomicLock = ATOMIC_FLAG_INIT;
   };
 
+  ///////////////////////////////////////////////////////////////////
+  namespace log
+  {
+    namespace
+    {
+      /** What \ref FileLineWriter keeps in \c _outs when writing to a file. */
+      struct FileSink
+      {
+        AutoFD fd;
+      };
+
+      /** Writes all \a cnt_r buffers in \a iov_r, retrying partial writes. */
+      void writeAllv( int fd_r, struct iovec * iov_r, int cnt_r )
+      {
+        while ( cnt_r ) {
+          ssize_t res = zyppng::eintrSafeCall( ::writev, fd_r, iov_r, cnt_r );
+          if ( res < 0 )
+            break;	// nowhere to report
+          // skip what was written
+          while ( cnt_r && std::size_t(res) >= iov_r->iov_len ) {
+            res -= iov_r->iov_len;
+            ++iov_r;
+            --cnt_r;
+          }
+          if ( cnt_r ) {
+            iov_r->iov_base = static_cast<char *>(iov_r->iov_base) + res;
+            iov_r->iov_len -= res;
+          }
+        }
+      }
+    } // namespace
+  } // namespace log
+  ///////////////////////////////////////////////////////////////////
+
+  /*!
+   * \internal Lock-free single producer, single consumer queue of formatted
+   * log lines (without trailing NL). Each thread logs into its own LogRing,
+   * the \ref LogThread drains them.
+   */
+  class LogRing
+  {
+  public:
+    static constexpr std::size_t capacity = 1024;	// must be a power of 2
+
+    /** Producer: Append \a line_r unless the ring is full. */
+    bool push( std::string && line_r )
+    {
+      const std::size_t head = _head.load( std::memory_order_relaxed );
+      if ( head - _tail.load( std::memory_order_acquire ) == capacity )
+        return false;
+      _slots[head & (capacity-1)] = std::move(line_r);
+      _head.store( head + 1, std::memory_order_release );
+      return true;
+    }
+
+    /** Producer: A line was dropped due to overflow. */
+    void dropped()
+    { _dropped.fetch_add( 1, std::memory_order_relaxed ); }
+
+    /** Producer: The thread is gone, the ring can be released once it is drained. */
+    void close()
+    { _closed.store( true, std::memory_order_release ); }
+
+    /** Consumer: Pass all available lines to \a fnc_r. */
+    template <class TFnc>
+    void drain( TFnc && fnc_r )
+    {
+      std::size_t tail = _tail.load( std::memory_order_relaxed );
+      const std::size_t head = _head.load( std::memory_order_acquire );
+      for ( ; tail != head; ++tail )
+        fnc_r( std::move(_slots[tail & (capacity-1)]) );
+      _tail.store( tail, std::memory_order_release );
+    }
+
+    /** Consumer: Number of lines dropped since the last call. */
+    unsigned takeDropped()
+    { return _dropped.exchange( 0, std::memory_order_relaxed ); }
+
+    /** Consumer: Whether the ring can be released. */
+    bool done() const
+    { return _closed.load( std::memory_order_acquire ) && _tail.load( std::memory_order_relaxed ) == _head.load( std::memory_order_acquire ); }
+
+  private:
+    alignas(64) std::atomic<std::size_t> _head { 0 };
+    alignas(64) std::atomic<std::size_t> _tail { 0 };
+    std::atomic<unsigned> _dropped { 0 };
+    std::atomic<bool> _closed { false };
+    std::array<std::string,capacity> _slots;
+  };
+
   class LogThread
   {
 
@@ -99,6 +194,7 @@ namespace zypp
 
     void setLineWriter ( zypp::shared_ptr<log::LineWriter> writer ) {
       std::lock_guard lk( _lineWriterLock );
+      base::logger::lineWriterInstalled.store( bool(writer), std::memory_order_relaxed );
       _lineWriter = std::move(writer);
     }
 
@@ -109,18 +205,67 @@ namespace zypp
     }
 
     void stop () {
+      _stopped.store( true );
       _stopSignal.notify();
-      if ( _thread.get_id() != std::this_thread::get_id() )
+      if ( _thread.joinable() && _thread.get_id() != std::this_thread::get_id() )
         _thread.join();
+      // release producers waiting for room
+      {
+        std::lock_guard lk( _drainedLock );
+      }
+      _drained.notify_all();
+    }
+
+    bool stopped () const {
+      return _stopped.load( std::memory_order_relaxed );
     }
 
     std::thread::id threadId () {
       return _thread.get_id();
     }
 
-    static std::string sockPath () {
-      static std::string path = zypp::str::Format("zypp-logsocket-%1%") % getpid();
-      return path;
+    void setOverflowPolicy ( base::LogControl::OverflowPolicy policy ) {
+      _overflowPolicy.store( policy, std::memory_order_relaxed );
+    }
+
+    base::LogControl::OverflowPolicy overflowPolicy () const {
+      return _overflowPolicy.load( std::memory_order_relaxed );
+    }
+
+    /*!
+     * Creates the ring buffer a thread logs into.
+     */
+    std::shared_ptr<LogRing> registerRing () {
+      auto ring = std::make_shared<LogRing>();
+      std::lock_guard lk( _ringsLock );
+      _rings.push_back( ring );
+      return ring;
+    }
+
+    /*!
+     * Tells the log thread that new lines are available. Only the first
+     * notification until the next drain costs a syscall.
+     */
+    void notifyData () {
+      if ( !_dataPending.exchange( true, std::memory_order_acq_rel ) )
+        _dataSignal.notify();
+    }
+
+    /*!
+     * Number of drains done so far, pass it to \ref waitForDrain.
+     */
+    std::uint64_t drainCount () {
+      std::lock_guard lk( _drainedLock );
+      return _drainCount;
+    }
+
+    /*!
+     * Blocks until the log thread drained the rings after \a seen_r was
+     * returned by \ref drainCount, or the log thread stopped.
+     */
+    void waitForDrain ( std::uint64_t seen_r ) {
+      std::unique_lock lk( _drainedLock );
+      _drained.wait( lk, [&](){ return _drainCount != seen_r || stopped(); } );
     }
 
   private:
@@ -142,43 +287,11 @@ namespace zypp
       zyppng::ThreadData::current().setName("Zypp-Log");
 
       auto ev = zyppng::EventLoop::create();
-      auto server = zyppng::Socket::create( AF_UNIX, SOCK_STREAM, 0 );
       auto stopNotifyWatch = _stopSignal.makeNotifier( );
+      auto dataNotifyWatch = _dataSignal.makeNotifier( );
 
-      std::vector<zyppng::Socket::Ptr> clients;
-
-      // bind to a abstract unix domain socket address, which means we do not need to care about cleaning it up
-      server->bind( std::make_shared<zyppng::UnixSockAddr>( sockPath(), true ) );
-      server->listen();
-
-      // wait for incoming connections from other threads
-      server->connectFunc( &zyppng::Socket::sigIncomingConnection, [&](){
-
-        auto cl = server->accept();
-        if ( !cl ) return;
-        clients.push_back( cl );
-
-        // wait until data is available, we operate line by line so we only
-        // log a string once we encounter \n
-        cl->connectFunc( &zyppng::Socket::sigReadyRead, [ this, sock = cl.get() ](){
-          auto writer = getLineWriter();
-          if ( !writer ) return;
-          while ( sock->canReadLine() ) {
-            auto br = sock->readLine();
-            writer->writeOut( std::string( br.data(), br.size() - 1 ) );
-          }
-        }, *cl);
-
-        // once a client disconnects we remove it from the std::vector so that the socket is not leaked
-        cl->connectFunc( &zyppng::Socket::sigDisconnected, [&clients, sock = std::weak_ptr(cl)](){
-          auto lock = sock.lock();
-          if ( !lock  )
-            return;
-
-          auto idx = std::find_if( clients.begin(), clients.end(), [lock]( const auto &s ){ return lock.get() == s.get(); } );
-          clients.erase( idx );
-        });
-
+      dataNotifyWatch->connectFunc( &zyppng::SocketNotifier::sigActivated, [this]( const auto &, auto ) {
+        drainRings();
       });
 
       stopNotifyWatch->connectFunc( &zyppng::SocketNotifier::sigActivated, [&ev]( const auto &, auto ) {
@@ -188,25 +301,109 @@ namespace zypp
       ev->run();
 
       // make sure we have written everything
+      drainRings();
+    }
+
+    /*!
+     * Collects the lines of all threads and writes them out in one batch.
+     */
+    void drainRings () {
+      // Ack first, then clear the flag: a notifyData() in between must not have
+      // its wakeup discarded while the flag stays set. Everything pushed before
+      // the flag was cleared is picked up by the drain below, everything pushed
+      // afterwards notifies us again.
+      _dataSignal.ack();
+      _dataPending.store( false, std::memory_order_release );
+
+      std::vector<std::shared_ptr<LogRing>> rings;
+      {
+        std::lock_guard lk( _ringsLock );
+        rings = _rings;
+      }
+
+      _batch.clear();
+      bool released = false;
+      for ( const auto & ring : rings ) {
+        if ( unsigned dropped = ring->takeDropped() )
+          _batch.push_back( str::Str() << "---[" << dropped << " LOG LINES DROPPED ON OVERFLOW]---" );
+        ring->drain( [this]( std::string && line ) {
+          _batch.push_back( std::move(line) );
+        });
+        if ( ring->done() )
+          released = true;
+      }
+
+      if ( released ) {
+        std::lock_guard lk( _ringsLock );
+        _rings.erase( std::remove_if( _rings.begin(), _rings.end(), []( const auto & ring ) { return ring->done(); } ), _rings.end() );
+      }
+
       auto writer = getLineWriter();
-      if ( writer ) {
-        for ( auto &sock : clients ){
-          auto br = sock->readLine();
-          while ( !br.empty() ) {
-            if ( br.back () == '\n' )
-              writer->writeOut( std::string( br.data(), br.size() - 1 ) );
-            else
-              writer->writeOut( std::string( br.data(), br.size() ) );
-
-            br = sock->readLine();
+      if ( writer && !_batch.empty() )
+        writeBatch( *writer, _batch );
+
+      // wake up producers blocked on a full ring
+      {
+        std::lock_guard lk( _drainedLock );
+        ++_drainCount;
+      }
+      _drained.notify_all();
+    }
+
+    /*!
+     * A plain \ref log::FileLineWriter gets the whole batch in a single writev,
+     * any other LineWriter is fed line by line.
+     */
+    static void writeBatch ( log::LineWriter & writer, const std::vector<std::string> & batch ) {
+      // derived writers may override writeOut
+      int fd = ( typeid(writer) == typeid(log::FileLineWriter) ? static_cast<log::FileLineWriter &>(writer).fd() : -1 );
+      if ( fd == -1 ) {
+        for ( const std::string & line : batch ) {
+          if ( line.find( '\n' ) == std::string::npos ) {
+            writer.writeOut( line );
+            continue;
           }
+          // LineWriter expects single lines (e.g. raw lines)
+          std::vector<std::string> lines;
+          str::split( line, std::back_inserter(lines), "\n" );
+          for ( const std::string & l : lines )
+            writer.writeOut( l );
         }
+        return;
       }
+
+      static char nl = '\n';
+      std::vector<struct iovec> iov;
+      iov.reserve( std::min<std::size_t>( batch.size() * 2, IOV_MAX ) );
+      auto flush = [&]() {
+        log::writeAllv( fd, iov.data(), iov.size() );
+        iov.clear();
+      };
+
+      for ( const std::string & line : batch ) {
+        if ( iov.size() + 2 > IOV_MAX )
+          flush();
+        iov.push_back( { const_cast<char *>(line.data()), line.size() } );
+        if ( line.empty() || line.back() != '\n' )
+          iov.push_back( { &nl, 1 } );
+      }
+      flush();
     }
 
   private:
     std::thread _thread;
     zyppng::Wakeup _stopSignal;
+    zyppng::Wakeup _dataSignal;
+    std::atomic<bool> _dataPending { false };
+    std::mutex _drainedLock;
+    std::condition_variable _drained;	// signaled after each drain
+    std::uint64_t _drainCount = 0;
+    std::atomic<bool> _stopped { false };
+    std::atomic<base::LogControl::OverflowPolicy> _overflowPolicy { base::LogControl::OverflowPolicy::Block };
+
+    std::mutex _ringsLock;
+    std::vector<std::shared_ptr<LogRing>> _rings;
+    std::vector<std::string> _batch;	// only used by the log thread
 
     // since the public API uses boost::shared_ptr (via the alias zypp::shared_ptr) we can not use the atomic
     // functionalities provided in std.
@@ -219,32 +416,18 @@ namespace zypp
   class LogClient
   {
    public:
-    LogClient(){
-      // make sure the thread is running
-      LogThread::instance();
-    }
+    LogClient()
+    : _ring( LogThread::instance().registerRing() )
+    {}
 
     LogClient(const LogClient &) = delete;
     LogClient(LogClient &&) = delete;
     LogClient &operator=(const LogClient &) = delete;
     LogClient &operator=(LogClient &&) = delete;
 
-    ~LogClient() { if (_sockFD >= 0) ::close(_sockFD); }
-
-    /*!
-     * Tries to connect to the log threads socket, returns true on success or
-     * if the socket is already connected
-     */
-    bool ensureConnection () {
-      if ( _sockFD >= 0 )
-        return true;
-
-      _sockFD = ::socket( AF_UNIX, SOCK_STREAM, 0 );
-      if ( _sockFD == -1 )
-        return false;
-
-      zyppng::UnixSockAddr addr( LogThread::sockPath(), true );
-      return zyppng::trySocketConnection( _sockFD, addr, 100 );
+    ~LogClient() {
+      _ring->close();
+      LogThread::instance().notifyData();
     }
 
     /*!
@@ -261,35 +444,34 @@ namespace zypp
       });
       inPushMessage = true;
 
-      // if we are in the same thread as the Log worker we can directly push our messages out, no need to use the socket
-      if ( std::this_thread::get_id() == LogThread::instance().threadId() ) {
-        auto writer = LogThread::instance().getLineWriter();
+      auto &logThread = LogThread::instance();
+
+      // if we are in the same thread as the Log worker we can directly push our messages out, no need to use the ring
+      if ( std::this_thread::get_id() == logThread.threadId() ) {
+        auto writer = logThread.getLineWriter();
         if ( writer )
           writer->writeOut( msg );
         return;
       }
 
-      if(!ensureConnection())
-        return;
-
-      if ( msg.back() != '\n' )
-        msg.push_back('\n');
+      if ( !msg.empty() && msg.back() == '\n' )
+        msg.pop_back();
 
-      size_t written = 0;
-      while ( written < msg.size() ) {
-        const auto res = zyppng::eintrSafeCall( ::send, _sockFD, msg.data() + written, msg.size() - written, MSG_NOSIGNAL );
-        if ( res == -1 ) {
-          //assume broken socket
-          ::close( _sockFD );
-          _sockFD = -1;
+      while ( !_ring->push( std::move(msg) ) ) {
+        if ( logThread.stopped() || logThread.overflowPolicy() == base::LogControl::OverflowPolicy::Drop ) {
+          _ring->dropped();
           return;
         }
-        written += res;
+        // Block: wait for the log thread to make room
+        const std::uint64_t seen = logThread.drainCount();
+        logThread.notifyData();
+        logThread.waitForDrain( seen );
       }
+      logThread.notifyData();
     }
 
     private:
-      int _sockFD = -1;
+      std::shared_ptr<LogRing> _ring;
       bool inPushMessage = false;
   };
 
@@ -297,17 +479,27 @@ namespace zypp
   {
     unsigned BlockTrace::_depth = 0;
 
+    /** Begin timestamps of the threads open BLOCKTRACE spans. */
+    static thread_local std::vector<std::int64_t> blockTraceBegin;
+
     BlockTrace::BlockTrace( const char * file_r, const char * fnc_r, int line_r, std::string msg_r )
     : BlockTraceBase( file_r, fnc_r, line_r, std::move(msg_r) )
     {
       unsigned depth = _depth++;
       zypp::base::logger::getStream( "BLOCK", zypp::base::logger::E_MIL, _file, _fnc, _line ) << "+++ (" << depth << ") " << _msg << endl;
+      if ( traceEnabled() )
+        blockTraceBegin.push_back( traceNow() );
     }
 
     BlockTrace::~BlockTrace()
     {
       unsigned depth = --_depth;
       zypp::base::logger::getStream( "BLOCK", zypp::base::logger::E_MIL, _file, _fnc, _line ) << "--- (" << depth << ") " << _msg << endl;
+      if ( traceEnabled() && ! blockTraceBegin.empty() )
+      {
+        traceComplete( _fnc, "block", blockTraceBegin.back(), _msg );
+        blockTraceBegin.pop_back();
+      }
     }
 
 #ifndef ZYPP_NDEBUG
@@ -343,6 +535,8 @@ namespace zypp
       unsigned depth = _depth++;
       const std::string & m { tracestr( '>',depth, _msg, _file,_fnc,_line ) };
       Osd(L_USR("TRACE"),depth) << m << endl;
+      if ( traceEnabled() )
+        blockTraceBegin.push_back( traceNow() );
     }
 
     TraceLeave::~TraceLeave()
@@ -350,6 +544,11 @@ namespace zypp
       unsigned depth = --_depth;
       const std::string & m { tracestr( '<',depth, _msg, _file,_fnc,_line ) };
       Osd(L_USR("TRACE"),depth) << m << endl;
+      if ( traceEnabled() && ! blockTraceBegin.empty() )
+      {
+        traceComplete( _fnc, "trace", blockTraceBegin.back(), _msg );
+        blockTraceBegin.pop_back();
+      }
     }
 
     Osd::Osd( std::ostream & str, int i )
@@ -403,14 +602,30 @@ namespace zypp
           if ( fd != -1 )
             ::close( fd );
         }
-        // set unbuffered write
-        std::ofstream * fstr = 0;
-        _outs.reset( (fstr = new std::ofstream( file_r.asString().c_str(), std::ios_base::app )) );
-        fstr->rdbuf()->pubsetbuf(0,0);
-        _str = &(*fstr);
+        // unbuffered write, the LogThread writes batches to the same fd
+        FileSink * sink = 0;
+        _outs.reset( (sink = new FileSink) );
+        sink->fd = AutoFD( ::open( file_r.c_str(), O_WRONLY|O_APPEND|O_CREAT|O_CLOEXEC, 0666 ) );
       }
     }
 
+    void FileLineWriter::writeOut( const std::string & formated_r )
+    {
+      int outfd = fd();
+      if ( outfd == -1 )
+      {
+        if ( _str )
+          StreamLineWriter::writeOut( formated_r );
+        return;
+      }
+      static char nl = '\n';
+      struct iovec iov[2] = { { const_cast<char *>(formated_r.data()), formated_r.size() }, { &nl, 1 } };
+      writeAllv( outfd, iov, 2 );
+    }
+
+    int FileLineWriter::fd() const
+    { return _outs ? static_cast<FileSink *>(_outs.get())->fd.value() : -1; }
+
     /////////////////////////////////////////////////////////////////
   } // namespace log
   ///////////////////////////////////////////////////////////////////
@@ -710,7 +925,6 @@ namespace zypp
         using StreamTable = std::map<std::string, StreamSet>;
         /** one streambuffer per group and level */
         StreamTable _streamtable;
-        zyppng::Socket::Ptr _sock;
 
       private:
 
@@ -723,6 +937,14 @@ namespace zypp
             shared_ptr<LogControl::LineFormater> formater(new ProfilingFormater);
             setLineFormater(formater);
           }
+
+          if ( const char * env = getenv("ZYPP_LOG_OVERFLOW") )
+          {
+            if ( env == std::string_view("drop") )
+              LogThread::instance().setOverflowPolicy( LogControl::OverflowPolicy::Drop );
+            else if ( env == std::string_view("block") )
+              LogThread::instance().setOverflowPolicy( LogControl::OverflowPolicy::Block );
+          }
         }
         /** Singleton ctor.
          * No logging per default, unless enabled via $ZYPP_LOGFILE.
@@ -819,6 +1041,8 @@ namespace zypp
                             buffer_r );
       }
 
+      std::atomic<bool> lineWriterInstalled { false };
+
       bool isExcessive()
       {
         auto impl = LogControlImpl::instance();
@@ -967,9 +1191,15 @@ namespace zypp
       LogThread::instance().stop();
     }
 
+    void LogControl::setOverflowPolicy( OverflowPolicy policy_r )
+    {
+      LogThread::instance().setOverflowPolicy( policy_r );
+    }
+
     void LogControl::notifyFork()
     {
       logger::logControlValidFlag () = 0;
+      logger::lineWriterInstalled.store( false, std::memory_order_relaxed );
     }
 
     void LogControl::logRawLine ( std::string &&line )
@@ -72,6 +72,12 @@ namespace zypp
     struct ZYPP_API FileLineWriter : public StreamLineWriter
     {
       FileLineWriter( const Pathname & file_r, mode_t mode_r = 0 );
+
+      void writeOut( const std::string & formated_r ) override;
+
+      /** The fd of the log file, \c -1 if logging to \c cerr or the file could not be opened. */
+      int fd() const;
+
       protected:
         shared_ptr<void> _outs;
     };
@@ -165,9 +171,17 @@ namespace zypp
       /** Log to std::err. */
       void logToStdErr();
 
-      /** will cause the log thread to exit and flush all sockets */
+      /** will cause the log thread to exit and flush all pending lines */
       void emergencyShutdown();
 
+      /** What a thread does if its log buffer is full because the log thread
+       * can't keep up. \c Block waits for the log thread (default), \c Drop
+       * discards the line; the number of dropped lines is reported in the log.
+       * Also settable via \c $ZYPP_LOG_OVERFLOW=(block|drop).
+       */
+      enum class OverflowPolicy { Block, Drop };
+      void setOverflowPolicy( OverflowPolicy policy_r );
+
       /**
        *  This will completely disable logging.
        *  It is supposed to be called in the child process after fork()
@@ -14,6 +14,7 @@
 #include <cstring>
 #include <iosfwd>
 #include <string>
+#include <atomic>
 
 #include <zypp-core/Globals.h>
 
@@ -117,6 +118,16 @@ namespace zypp::debug {
  * @endcode
  * Defines group @a "foo" as default for log messages and logs a
  * debug message.
+ *
+ * The \c l prefixed variants (\c lDBG, \c lMIL, ...) are lazy: The
+ * streamed arguments are not evaluated at all, unless the line is
+ * actually written (see \ref zypp::base::logger::isEnabled). They can
+ * be used in hot code paths, but only as a statement, not as an
+ * \c std::ostream expression:
+ * @code
+ * lDBG << expensive() << endl;
+ * @endcode
+ * Defining \c ZYPP_BASE_LOGGER_NO_DEBUG compiles out \c lXXX and \c lDBG.
  */
 /*@{*/
 
@@ -143,6 +154,30 @@ namespace zypp::debug {
 #define L_INT(GROUP) ZYPP_BASE_LOGGER_LOG( GROUP, zypp::base::logger::E_INT )
 #define L_USR(GROUP) ZYPP_BASE_LOGGER_LOG( GROUP, zypp::base::logger::E_USR )
 
+#define lXXX lL_XXX( ZYPP_BASE_LOGGER_LOGGROUP )
+#define lDBG lL_DBG( ZYPP_BASE_LOGGER_LOGGROUP )
+#define lMIL lL_MIL( ZYPP_BASE_LOGGER_LOGGROUP )
+#define lWAR lL_WAR( ZYPP_BASE_LOGGER_LOGGROUP )
+#define lERR lL_ERR( ZYPP_BASE_LOGGER_LOGGROUP )
+#define lSEC lL_SEC( ZYPP_BASE_LOGGER_LOGGROUP )
+#define lINT lL_INT( ZYPP_BASE_LOGGER_LOGGROUP )
+#define lUSR lL_USR( ZYPP_BASE_LOGGER_LOGGROUP )
+
+#ifdef ZYPP_BASE_LOGGER_NO_DEBUG
+#define ZYPP_BASE_LOGGER_DEBUG_ENABLED false
+#else
+#define ZYPP_BASE_LOGGER_DEBUG_ENABLED true
+#endif
+
+#define lL_XXX(GROUP) ZYPP_BASE_LOGGER_LOG_IF( ZYPP_BASE_LOGGER_DEBUG_ENABLED, GROUP, zypp::base::logger::E_XXX )
+#define lL_DBG(GROUP) ZYPP_BASE_LOGGER_LOG_IF( ZYPP_BASE_LOGGER_DEBUG_ENABLED, GROUP"++", zypp::base::logger::E_MIL )
+#define lL_MIL(GROUP) ZYPP_BASE_LOGGER_LOG_IF( true, GROUP, zypp::base::logger::E_MIL )
+#define lL_WAR(GROUP) ZYPP_BASE_LOGGER_LOG_IF( true, GROUP, zypp::base::logger::E_WAR )
+#define lL_ERR(GROUP) ZYPP_BASE_LOGGER_LOG_IF( true, GROUP, zypp::base::logger::E_ERR )
+#define lL_SEC(GROUP) ZYPP_BASE_LOGGER_LOG_IF( true, GROUP, zypp::base::logger::E_SEC )
+#define lL_INT(GROUP) ZYPP_BASE_LOGGER_LOG_IF( true, GROUP, zypp::base::logger::E_INT )
+#define lL_USR(GROUP) ZYPP_BASE_LOGGER_LOG_IF( true, GROUP, zypp::base::logger::E_USR )
+
 
 #define L_ENV_CONSTR_DEFINE_FUNC(ENV) \
     namespace zypp::log { \
@@ -158,7 +193,8 @@ namespace zypp::debug {
     }
 
 #define L_ENV_CONSTR_FWD_DECLARE_FUNC(ENV) namespace zypp::log { bool has_env_constr_##ENV (); const char *empty_or_group_if_##ENV ( const char *group ); }
-#define L_ENV_CONSTR(ENV,GROUP,LEVEL) ZYPP_BASE_LOGGER_LOG( zypp::log::empty_or_group_if_##ENV( GROUP ), LEVEL )
+/** Lazy (statement only) log if \c $ENV is set. */
+#define L_ENV_CONSTR(ENV,GROUP,LEVEL) ZYPP_BASE_LOGGER_LOG_IF( zypp::log::has_env_constr_##ENV(), GROUP, LEVEL )
 
 #define L_BASEFILE ( *__FILE__ == '/' ? strrchr( __FILE__, '/' ) + 1 : __FILE__ )
 
@@ -166,6 +202,10 @@ namespace zypp::debug {
 #define ZYPP_BASE_LOGGER_LOG(GROUP,LEVEL) \
         zypp::base::logger::getStream( GROUP, LEVEL, L_BASEFILE, __FUNCTION__, __LINE__ )
 
+/** Lazy call to @ref getStream if \a COND and the \a LEVEL is enabled (statement only). */
+#define ZYPP_BASE_LOGGER_LOG_IF(COND,GROUP,LEVEL) \
+        !( (COND) && zypp::base::logger::isEnabled( LEVEL ) ) ? (void)0 : zypp::base::logger::Voidify() & ZYPP_BASE_LOGGER_LOG( GROUP, LEVEL )
+
 /*@}*/
 
 ///////////////////////////////////////////////////////////////////
@@ -211,6 +251,23 @@ namespace zypp
                                        const int    line_r ) ZYPP_API;
       extern bool isExcessive() ZYPP_API;
 
+      /** \internal Whether a LineWriter is installed (maintained by LogControl). */
+      extern std::atomic<bool> lineWriterInstalled ZYPP_API;
+
+      /** Whether a line logged at \a level_r would be written at all.
+       * Cheap enough to guard the formatting of log lines in hot code
+       * paths, which is what the lazy \ref ZYPP_BASE_LOGGER_MACROS do.
+       */
+      inline bool isEnabled( LogLevel level_r )
+      { return lineWriterInstalled.load( std::memory_order_relaxed ) && ( level_r != E_XXX || isExcessive() ); }
+
+      /** \internal Turns the log stream expression of a lazy log macro into \c void. */
+      struct Voidify
+      {
+        template <class Tp>
+        void operator&( Tp && ) const {}
+      };
+
       /////////////////////////////////////////////////////////////////
     } // namespace logger
     ///////////////////////////////////////////////////////////////////
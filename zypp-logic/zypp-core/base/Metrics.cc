@@ -0,0 +1,144 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp-core/base/Metrics.cc
+ *
+*/
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <unistd.h>
+
+#include <zypp-core/base/Metrics.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/String.h>
+#include <zypp-core/parser/json.h>
+
+#undef ZYPP_BASE_LOGGER_LOGGROUP
+#define ZYPP_BASE_LOGGER_LOGGROUP "zypp::metrics"
+
+///////////////////////////////////////////////////////////////////
+namespace zypp::metrics
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    template <class Tp>
+    using MetricMap = std::map<std::string, std::unique_ptr<Tp>, std::less<>>;
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class Registry
+    /// \brief All metrics by name.
+    /// Never destructed, so metric references cached in static
+    /// variables remain valid during static destruction.
+    ///////////////////////////////////////////////////////////////////
+    struct Registry
+    {
+      static Registry & instance()
+      {
+        static Registry & _instance { *new Registry };
+        return _instance;
+      }
+
+      template <class Tp>
+      Tp & lookup( MetricMap<Tp> & map_r, std::string_view name_r )
+      {
+        std::lock_guard lk( _lock );
+        auto it = map_r.find( name_r );
+        if ( it == map_r.end() )
+          it = map_r.emplace( std::string(name_r), std::make_unique<Tp>() ).first;
+        return *it->second;
+      }
+
+      std::mutex             _lock;
+      MetricMap<Counter>     _counters;
+      MetricMap<Gauge>       _gauges;
+      MetricMap<Histogram>   _histograms;
+
+    private:
+      Registry()
+      {
+        if ( const char * env = ::getenv( "ZYPP_METRICSFILE" ); env && *env )
+        {
+          _dumpfile = env;
+          std::atexit( []() { Registry::instance().dumpAtExit(); } );
+        }
+      }
+
+      void dumpAtExit()
+      {
+        // Workers inherit the environment, each process writes its own file.
+        // The pid is taken now, a forked child must not overwrite its parents file.
+        const std::string file { str::form( "%s.%d", _dumpfile.c_str(), int(::getpid()) ) };
+        std::ofstream out( file.c_str(), std::ios_base::out|std::ios_base::trunc );
+        if ( ! ( dumpOn( out ) << std::endl ) )
+          WAR << "Unable to write metrics to " << file << std::endl;
+      }
+
+      std::string _dumpfile;
+    };
+
+    json::Object histogramAsJSON( const Histogram & hist_r )
+    {
+      json::Object buckets;
+      for ( unsigned i = 0; i < Histogram::bucketCount; ++i )
+      {
+        if ( std::uint64_t cnt = hist_r.bucket( i ); cnt )
+        {
+          std::uint64_t limit = Histogram::bucketLimit( i );
+          buckets.add( limit ? str::numstring( limit ) : std::string("inf"), cnt );
+        }
+      }
+      return json::Object {
+        { "count",   hist_r.count() },
+        { "sum",     hist_r.sum() },
+        { "buckets", std::move(buckets) },	// bucket limit (exclusive) : count
+      };
+    }
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  Counter & counter( std::string_view name_r )
+  { Registry & r { Registry::instance() }; return r.lookup( r._counters, name_r ); }
+
+  Gauge & gauge( std::string_view name_r )
+  { Registry & r { Registry::instance() }; return r.lookup( r._gauges, name_r ); }
+
+  Histogram & histogram( std::string_view name_r )
+  { Registry & r { Registry::instance() }; return r.lookup( r._histograms, name_r ); }
+
+  json::Object asJSON()
+  {
+    json::Object counters;
+    json::Object gauges;
+    json::Object histograms;
+    {
+      Registry & r { Registry::instance() };
+      std::lock_guard lk( r._lock );
+      for ( const auto & [name,metric] : r._counters )
+        counters.add( name, metric->value() );
+      for ( const auto & [name,metric] : r._gauges )
+        gauges.add( name, metric->value() );
+      for ( const auto & [name,metric] : r._histograms )
+        histograms.add( name, histogramAsJSON( *metric ) );
+    }
+    return json::Object {
+      { "counters",   std::move(counters) },
+      { "gauges",     std::move(gauges) },
+      { "histograms", std::move(histograms) },
+    };
+  }
+
+  std::ostream & dumpOn( std::ostream & str )
+  { return str << asJSON(); }
+
+} // namespace zypp::metrics
+///////////////////////////////////////////////////////////////////
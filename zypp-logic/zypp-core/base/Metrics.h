@@ -0,0 +1,180 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp-core/base/Metrics.h
+ *
+*/
+#ifndef ZYPP_BASE_METRICS_H
+#define ZYPP_BASE_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+#include <zypp-core/Globals.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp::json
+{
+  class Object;
+}
+
+///////////////////////////////////////////////////////////////////
+/// \brief Process wide metrics registry.
+///
+/// Counters, gauges and latency histograms are registered by name
+/// on first use and live until the process ends. Updating a metric
+/// is a relaxed atomic operation, so instrumenting hot code is cheap
+/// as long as the metric reference is looked up once:
+///
+/// \code
+///   static metrics::Counter & spawns { metrics::counter( "ExternalProgram.spawns" ) };
+///   spawns.inc();
+///
+///   static metrics::Histogram & prepare { metrics::histogram( "PoolImpl.prepare" ) };
+///   metrics::ScopedTimer timer { prepare };
+/// \endcode
+///
+/// Metrics are dumped as JSON via \ref metrics::asJSON or \ref metrics::dumpOn.
+/// If \c $ZYPP_METRICSFILE is set, the JSON dump is written to
+/// \c $ZYPP_METRICSFILE.<pid> when the process exits. Each process, e.g.
+/// the media workers inheriting the variable, writes its own file.
+///////////////////////////////////////////////////////////////////
+namespace zypp::metrics
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class Counter
+  /// \brief A monotonically increasing value.
+  ///////////////////////////////////////////////////////////////////
+  class ZYPP_API Counter
+  {
+  public:
+    void inc( std::uint64_t n_r = 1 )
+    { _value.fetch_add( n_r, std::memory_order_relaxed ); }
+
+    std::uint64_t value() const
+    { return _value.load( std::memory_order_relaxed ); }
+
+  private:
+    std::atomic<std::uint64_t> _value { 0 };
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class Gauge
+  /// \brief A value that can go up and down.
+  ///////////////////////////////////////////////////////////////////
+  class ZYPP_API Gauge
+  {
+  public:
+    void set( std::int64_t val_r )
+    { _value.store( val_r, std::memory_order_relaxed ); }
+
+    void add( std::int64_t n_r = 1 )
+    { _value.fetch_add( n_r, std::memory_order_relaxed ); }
+
+    void sub( std::int64_t n_r = 1 )
+    { _value.fetch_sub( n_r, std::memory_order_relaxed ); }
+
+    std::int64_t value() const
+    { return _value.load( std::memory_order_relaxed ); }
+
+  private:
+    std::atomic<std::int64_t> _value { 0 };
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class Histogram
+  /// \brief Distribution of observed values in power of 2 buckets.
+  ///
+  /// Bucket \c 0 counts the value \c 0, bucket \c i>0 counts values in
+  /// <tt>[2^(i-1),2^i)</tt>. Latencies are observed in microseconds.
+  ///////////////////////////////////////////////////////////////////
+  class ZYPP_API Histogram
+  {
+  public:
+    static constexpr unsigned bucketCount = 65;
+
+    void observe( std::uint64_t val_r )
+    {
+      _buckets[bucketFor( val_r )].fetch_add( 1, std::memory_order_relaxed );
+      _count.fetch_add( 1, std::memory_order_relaxed );
+      _sum.fetch_add( val_r, std::memory_order_relaxed );
+    }
+
+    template <class Rep, class Period>
+    void observe( std::chrono::duration<Rep,Period> dur_r )
+    { observe( std::chrono::duration_cast<std::chrono::microseconds>( dur_r ).count() ); }
+
+    std::uint64_t count() const
+    { return _count.load( std::memory_order_relaxed ); }
+
+    std::uint64_t sum() const
+    { return _sum.load( std::memory_order_relaxed ); }
+
+    std::uint64_t bucket( unsigned idx_r ) const
+    { return idx_r < bucketCount ? _buckets[idx_r].load( std::memory_order_relaxed ) : 0; }
+
+    /** The bucket counting \a val_r. */
+    static unsigned bucketFor( std::uint64_t val_r )
+    { return val_r ? 64 - __builtin_clzll( val_r ) : 0; }
+
+    /** Exclusive upper bound of values counted in bucket \a idx_r (\c 0 if unbounded). */
+    static std::uint64_t bucketLimit( unsigned idx_r )
+    { return idx_r < 64 ? std::uint64_t(1) << idx_r : 0; }
+
+  private:
+    std::array<std::atomic<std::uint64_t>,bucketCount> _buckets {};
+    std::atomic<std::uint64_t> _count { 0 };
+    std::atomic<std::uint64_t> _sum { 0 };
+  };
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class ScopedTimer
+  /// \brief Observe the lifetime of this object in a \ref Histogram.
+  ///////////////////////////////////////////////////////////////////
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer( Histogram & hist_r )
+    : _hist { hist_r }
+    , _start { std::chrono::steady_clock::now() }
+    {}
+
+    ScopedTimer( const ScopedTimer & ) = delete;
+    ScopedTimer & operator=( const ScopedTimer & ) = delete;
+
+    ~ScopedTimer()
+    { _hist.observe( std::chrono::steady_clock::now() - _start ); }
+
+  private:
+    Histogram & _hist;
+    std::chrono::steady_clock::time_point _start;
+  };
+
+  /** The \ref Counter named \a name_r (created on first use). */
+  Counter & counter( std::string_view name_r ) ZYPP_API;
+
+  /** The \ref Gauge named \a name_r (created on first use). */
+  Gauge & gauge( std::string_view name_r ) ZYPP_API;
+
+  /** The \ref Histogram named \a name_r (created on first use). */
+  Histogram & histogram( std::string_view name_r ) ZYPP_API;
+
+  /** All metrics as JSON object <tt>{ "counters":{..}, "gauges":{..}, "histograms":{..} }</tt>. */
+  json::Object asJSON() ZYPP_API;
+
+  /** Write \ref asJSON to \a str. */
+  std::ostream & dumpOn( std::ostream & str ) ZYPP_API;
+
+} // namespace zypp::metrics
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_BASE_METRICS_H
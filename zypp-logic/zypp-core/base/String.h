@@ -665,12 +665,15 @@ namespace zypp
     template<class TOutputIterator>
       unsigned splitEscaped( const C_Str & line_r, TOutputIterator result_r, const C_Str & sepchars_r = " \t", bool withEmpty = false)
       {
+        // the size bounds the line, so views that are not NUL terminated work as well
         const char * beg = line_r;
         const char * cur = beg;
+        const char * end = beg + line_r.size();
+        const auto isSep = [&sepchars_r]( char ch ) { return ch && ::strchr( sepchars_r, ch ); };
         unsigned ret = 0;
 
         // skip leading sepchars
-        while ( *cur && ::strchr( sepchars_r, *cur ) )
+        while ( cur != end && isSep( *cur ) )
         {
           ++cur;
           if (withEmpty)
@@ -681,7 +684,7 @@ namespace zypp
         }
 
         // there were only sepchars in the string
-        if (!*cur && withEmpty)
+        if ( cur == end && withEmpty )
         {
           *result_r = "";
           return ++ret;
@@ -691,7 +694,7 @@ namespace zypp
         enum class Quote { None, Slash, Single, Double, DoubleSlash };
         std::vector<char> buf;
         Quote quoting = Quote::None;
-        for ( beg = cur; *beg; beg = cur, ++result_r, ++ret )
+        for ( beg = cur; beg != end; beg = cur, ++result_r, ++ret )
         {
           // read next value until unquoted sepchar
           buf.clear();
@@ -745,14 +748,14 @@ namespace zypp
                 break;
             }
             ++cur;
-          } while ( *cur && ( quoting != Quote::None || !::strchr( sepchars_r, *cur ) ) );
+          } while ( cur != end && ( quoting != Quote::None || !isSep( *cur ) ) );
           *result_r = std::string( buf.begin(), buf.end() );
 
 
           // skip sepchars
-          if ( *cur && ::strchr( sepchars_r, *cur ) )
+          if ( cur != end && isSep( *cur ) )
             ++cur;
-          while ( *cur && ::strchr( sepchars_r, *cur ) )
+          while ( cur != end && isSep( *cur ) )
           {
             ++cur;
             if (withEmpty)
@@ -762,7 +765,7 @@ namespace zypp
             }
           }
           // the last was a separator => one more field
-          if ( !*cur && withEmpty && ::strchr( sepchars_r, *(cur-1) ) )
+          if ( cur == end && withEmpty && isSep( *(cur-1) ) )
           {
             *result_r = "";
             ++ret;
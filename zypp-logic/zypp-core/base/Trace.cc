@@ -0,0 +1,289 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp-core/base/Trace.cc
+ *
+*/
+extern "C"
+{
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+}
+#include <algorithm>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <zypp-core/base/Trace.h>
+#include <zypp-core/base/String.h>
+#include <zypp-core/AutoDispose.h>
+#include <zypp-core/ng/base/private/threaddata_p.h>
+#include <zypp-core/ng/base/private/linuxhelpers_p.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp::debug
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace
+  {
+    /** Append \a val_r as JSON string. */
+    void appendJsonString( std::string & out_r, std::string_view val_r )
+    {
+      out_r += '"';
+      for ( char ch : val_r )
+      {
+        switch ( ch )
+        {
+          case '"':  out_r += "\\\""; break;
+          case '\\': out_r += "\\\\"; break;
+          case '\n': out_r += "\\n"; break;
+          case '\t': out_r += "\\t"; break;
+          default:
+            if ( (unsigned char)ch < 0x20 )
+              out_r += str::form( "\\u%04x", (unsigned)ch );
+            else
+              out_r += ch;
+            break;
+        }
+      }
+      out_r += '"';
+    }
+
+    struct TraceEvent
+    {
+      char         ph;	///< 'X' complete, 'i' instant
+      std::string  name;
+      const char * cat;
+      std::int64_t ts;
+      std::int64_t dur;
+      std::string  detail;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class TraceBuffer
+    /// \brief The events recorded by one thread.
+    /// Only the owning thread appends, the lock is uncontended unless
+    /// the \ref TraceFile flushes all buffers.
+    ///////////////////////////////////////////////////////////////////
+    struct TraceBuffer
+    {
+      static constexpr std::size_t flushSize = 4096;
+
+      std::mutex             lock;
+      std::vector<TraceEvent> events;
+      pid_t                  tid = 0;
+      std::string            threadName;
+      bool                   announced = false;	///< thread_name metadata written
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class TraceFile
+    /// \brief The trace file and all threads buffers.
+    ///////////////////////////////////////////////////////////////////
+    class TraceFile
+    {
+    public:
+      static TraceFile & instance()
+      {
+        static TraceFile _instance;
+        return _instance;
+      }
+
+      bool enabled() const
+      { return _fd != -1; }
+
+      std::shared_ptr<TraceBuffer> registerBuffer()
+      {
+        auto buf = std::make_shared<TraceBuffer>();
+        buf->tid = ::syscall( SYS_gettid );
+        buf->threadName = zyppng::ThreadData::current().name();
+        std::lock_guard lk( _lock );
+        _buffers.push_back( buf );
+        return buf;
+      }
+
+      void releaseBuffer( const std::shared_ptr<TraceBuffer> & buf_r )
+      {
+        flush( *buf_r );
+        std::lock_guard lk( _lock );
+        _buffers.erase( std::remove( _buffers.begin(), _buffers.end(), buf_r ), _buffers.end() );
+      }
+
+      /** Write out and clear the events in \a buf_r. */
+      void flush( TraceBuffer & buf_r )
+      {
+        std::string out;
+        {
+          std::lock_guard lk( buf_r.lock );
+          if ( buf_r.events.empty() )
+            return;
+
+          const pid_t pid = ::getpid();
+          out.reserve( buf_r.events.size() * 128 );
+          if ( ! buf_r.announced && ! buf_r.threadName.empty() )
+          {
+            out += str::form( "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", pid, buf_r.tid );
+            appendJsonString( out, buf_r.threadName );
+            out += "}},\n";
+            buf_r.announced = true;
+          }
+          for ( const TraceEvent & ev : buf_r.events )
+          {
+            out += "{\"name\":";
+            appendJsonString( out, ev.name );
+            out += ",\"cat\":";
+            appendJsonString( out, ev.cat ? ev.cat : "zypp" );
+            if ( ev.ph == 'X' )
+              out += str::form( ",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld", (long long)ev.ts, (long long)ev.dur );
+            else
+              out += str::form( ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld", (long long)ev.ts );
+            out += str::form( ",\"pid\":%d,\"tid\":%d", pid, buf_r.tid );
+            if ( ! ev.detail.empty() )
+            {
+              out += ",\"args\":{\"detail\":";
+              appendJsonString( out, ev.detail );
+              out += "}";
+            }
+            out += "},\n";
+          }
+          buf_r.events.clear();
+        }
+        write( out );
+      }
+
+      /** Forget everything recorded by the parent process. */
+      void atForkChild()
+      {
+        for ( const auto & buf : _buffers )
+          buf->events.clear();
+      }
+
+    private:
+      TraceFile()
+      {
+        const char * env = ::getenv( "ZYPP_TRACEFILE" );
+        if ( ! env || ! *env )
+          return;
+
+        // The first process creates the file and starts the JSON array.
+        _fd = ::open( env, O_WRONLY|O_APPEND|O_CREAT|O_EXCL|O_CLOEXEC, 0640 );
+        if ( _fd != -1 )
+          write( "[\n" );
+        else
+          _fd = ::open( env, O_WRONLY|O_APPEND|O_CLOEXEC );
+        if ( _fd == -1 )
+          return;
+
+        std::string comm;
+        {
+          char buf[64];
+          AutoFD fd { ::open( "/proc/self/comm", O_RDONLY|O_CLOEXEC ) };
+          ssize_t res = fd == -1 ? -1 : ::read( fd, buf, sizeof(buf)-1 );
+          if ( res > 0 )
+            comm = str::rtrim( std::string( buf, res ) );
+        }
+        std::string out { str::form( "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":", ::getpid() ) };
+        appendJsonString( out, std::string( str::Str() << comm << "(" << ::getpid() << ")" ) );
+        out += "}},\n";
+        write( out );
+
+        pthread_atfork( nullptr, nullptr, []() { TraceFile::instance().atForkChild(); } );
+      }
+
+      ~TraceFile()
+      {
+        std::vector<std::shared_ptr<TraceBuffer>> buffers;
+        {
+          std::lock_guard lk( _lock );
+          buffers = _buffers;
+        }
+        for ( const auto & buf : buffers )
+          flush( *buf );
+        if ( _fd != -1 )
+          ::close( _fd );
+      }
+
+      void write( const std::string & out_r )
+      {
+        // one write per chunk keeps the lines of concurrent writers apart
+        std::size_t written = 0;
+        while ( written < out_r.size() )
+        {
+          ssize_t res = zyppng::eintrSafeCall( ::write, _fd, out_r.data() + written, out_r.size() - written );
+          if ( res <= 0 )
+            break;
+          written += res;
+        }
+      }
+
+    private:
+      int _fd = -1;
+      std::mutex _lock;
+      std::vector<std::shared_ptr<TraceBuffer>> _buffers;
+    };
+
+    /** The calling threads buffer, flushed when the thread ends. */
+    TraceBuffer & threadBuffer()
+    {
+      struct Holder
+      {
+        Holder() : buf { TraceFile::instance().registerBuffer() } {}
+        ~Holder() { TraceFile::instance().releaseBuffer( buf ); }
+        std::shared_ptr<TraceBuffer> buf;
+      };
+      thread_local Holder _holder;
+      return *_holder.buf;
+    }
+
+    void record( TraceEvent && ev_r )
+    {
+      TraceBuffer & buf { threadBuffer() };
+      bool full = false;
+      {
+        std::lock_guard lk( buf.lock );
+        buf.events.push_back( std::move(ev_r) );
+        full = buf.events.size() >= TraceBuffer::flushSize;
+      }
+      if ( full )
+        TraceFile::instance().flush( buf );
+    }
+  } // namespace
+  ///////////////////////////////////////////////////////////////////
+
+  bool traceEnabled()
+  {
+    static bool _enabled = TraceFile::instance().enabled();
+    return _enabled;
+  }
+
+  std::int64_t traceNow()
+  {
+    struct timespec ts;
+    ::clock_gettime( CLOCK_MONOTONIC, &ts );
+    return std::int64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+  }
+
+  void traceComplete( std::string name_r, const char * cat_r, std::int64_t begin_r, std::string detail_r )
+  {
+    if ( ! traceEnabled() )
+      return;
+    record( TraceEvent{ 'X', std::move(name_r), cat_r, begin_r, traceNow() - begin_r, std::move(detail_r) } );
+  }
+
+  void traceInstant( std::string name_r, const char * cat_r, std::string detail_r )
+  {
+    if ( ! traceEnabled() )
+      return;
+    record( TraceEvent{ 'i', std::move(name_r), cat_r, traceNow(), 0, std::move(detail_r) } );
+  }
+
+} // namespace zypp::debug
+///////////////////////////////////////////////////////////////////
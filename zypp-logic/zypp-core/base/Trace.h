@@ -0,0 +1,101 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp-core/base/Trace.h
+ *
+*/
+#ifndef ZYPP_BASE_TRACE_H
+#define ZYPP_BASE_TRACE_H
+
+#include <cstdint>
+#include <string>
+
+#include <zypp-core/Globals.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp::debug
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \brief Span tracing in Chrome trace event format.
+  ///
+  /// If \c $ZYPP_TRACEFILE is set, begin/end spans are recorded per
+  /// thread and written to that file as Chrome trace events, which can
+  /// be loaded into e.g. \c chrome://tracing or the Perfetto UI.
+  ///
+  /// The file uses the JSON array format without closing bracket, so
+  /// worker processes inheriting the environment append their events to
+  /// the same file. Timestamps are taken from \c CLOCK_MONOTONIC, so
+  /// spans of different processes line up.
+  ///
+  /// \code
+  ///   void RepoManager::refreshMetadata(...)
+  ///   {
+  ///     ZYPP_TRACE_SPAN_DETAIL( "RepoManager::refreshMetadata", info.alias(), "zypp" );
+  ///     ...
+  ///   }
+  /// \endcode
+  ///
+  /// \ref Measure and \ref BLOCKTRACE record their spans as well.
+  ///////////////////////////////////////////////////////////////////
+
+  /** Whether tracing is enabled (\c $ZYPP_TRACEFILE). */
+  bool traceEnabled() ZYPP_API;
+
+  /** Timestamp to pass as \a begin_r to \ref traceComplete (microseconds, \c CLOCK_MONOTONIC). */
+  std::int64_t traceNow() ZYPP_API;
+
+  /** Record a span \a name_r in category \a cat_r which started at \a begin_r and ends now.
+   * \a detail_r is shown as argument of the span.
+   */
+  void traceComplete( std::string name_r, const char * cat_r, std::int64_t begin_r, std::string detail_r = std::string() ) ZYPP_API;
+
+  /** Record a point in time event. */
+  void traceInstant( std::string name_r, const char * cat_r, std::string detail_r = std::string() ) ZYPP_API;
+
+  ///////////////////////////////////////////////////////////////////
+  /// \class TraceSpan
+  /// \brief Record a span for the lifetime of this object.
+  /// Costs only a flag test if tracing is disabled.
+  ///////////////////////////////////////////////////////////////////
+  class TraceSpan
+  {
+  public:
+    TraceSpan( const char * name_r, const char * cat_r = "zypp" )
+    : _name { traceEnabled() ? name_r : nullptr }
+    , _cat { cat_r }
+    , _begin { _name ? traceNow() : 0 }
+    {}
+
+    /** A detail always needs an explicit category, a string literal would be taken as category otherwise. */
+    TraceSpan( const char * name_r, const char * cat_r, std::string detail_r )
+    : TraceSpan( name_r, cat_r )
+    { if ( _name ) _detail = std::move(detail_r); }
+
+    TraceSpan( const TraceSpan & ) = delete;
+    TraceSpan & operator=( const TraceSpan & ) = delete;
+
+    ~TraceSpan()
+    { if ( _name ) traceComplete( _name, _cat, _begin, std::move(_detail) ); }
+
+  private:
+    const char * _name;
+    const char * _cat;
+    std::int64_t _begin;
+    std::string  _detail;
+  };
+
+#define ZYPP_TRACE_CONCAT2(A,B) A##B
+#define ZYPP_TRACE_CONCAT(A,B) ZYPP_TRACE_CONCAT2(A,B)
+  /** Trace the enclosing scope as span \a NAME (a string literal), optionally in category \a CAT (default \c "zypp"). */
+#define ZYPP_TRACE_SPAN(...) ::zypp::debug::TraceSpan ZYPP_TRACE_CONCAT(_zyppTraceSpan,__LINE__)( __VA_ARGS__ )
+  /** Trace the enclosing scope as span \a NAME in category \a CAT, showing \a DETAIL as argument. */
+#define ZYPP_TRACE_SPAN_DETAIL(NAME,DETAIL,CAT) ::zypp::debug::TraceSpan ZYPP_TRACE_CONCAT(_zyppTraceSpan,__LINE__)( NAME, CAT, DETAIL )
+
+} // namespace zypp::debug
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_BASE_TRACE_H
@@ -0,0 +1,516 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file zypp-core/fs/BulkIO.cc
+ *
+*/
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <linux/fs.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <zypp-core/fs/BulkIO.h>
+#include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/Errno.h>
+#include <zypp-core/AutoDispose.h>
+#include <zypp-core/Digest.h>
+#include <zypp-core/ng/thread/threadpool.h>
+
+namespace zypp {
+  namespace filesystem {
+
+    namespace
+    {
+      /** Page aligned buffer, allows the kernel to fill it without bouncing. */
+      using AlignedBuffer = std::unique_ptr<char, decltype(&::free)>;
+
+      AlignedBuffer alignedBuffer( std::size_t size_r )
+      {
+        void * mem = nullptr;
+        if ( ::posix_memalign( &mem, ::sysconf( _SC_PAGESIZE ), size_r ) != 0 )
+          throw std::bad_alloc();
+        return AlignedBuffer( static_cast<char *>( mem ), &::free );
+      }
+
+      /** Writes all of \a len_r bytes, returns 0 or the errno. */
+      int writeAll( int fd_r, const char * data_r, std::size_t len_r )
+      {
+        while ( len_r ) {
+          ssize_t res = ::write( fd_r, data_r, len_r );
+          if ( res == -1 ) {
+            if ( errno == EINTR )
+              continue;
+            return errno;
+          }
+          data_r += res;
+          len_r  -= res;
+        }
+        return 0;
+      }
+
+      /**
+       * Calls \a fnc_r for each index in [0, count_r) using up to \a depth_r threads,
+       * the calling thread and helpers posted to the \ref zyppng::ThreadPool::global.
+       * The first exception is rethrown after all threads finished.
+       *
+       * The caller only waits for helpers which already started, so it does not
+       * block on queued jobs if it runs inside the pool itself.
+       */
+      template <class TFnc>
+      void forEachBounded( std::size_t count_r, unsigned depth_r, TFnc && fnc_r )
+      {
+        if ( ! count_r )
+          return;
+
+        // shared with helpers which start after the caller returned
+        struct State
+        {
+          std::atomic<std::size_t> _next { 0 };
+          std::size_t _count = 0;
+          std::function<void( std::size_t )> _fnc;
+          std::exception_ptr _error;
+          std::mutex _lock;
+          std::condition_variable _done;
+          unsigned _running = 0;
+          bool _closed = false;
+
+          void work()
+          {
+            for ( std::size_t i = _next++; i < _count; i = _next++ ) {
+              try {
+                _fnc( i );
+              }
+              catch ( ... ) {
+                std::lock_guard lk( _lock );
+                if ( ! _error )
+                  _error = std::current_exception();
+                _next = _count;
+              }
+            }
+          }
+        };
+        auto state = std::make_shared<State>();
+        state->_count = count_r;
+        state->_fnc = std::ref( fnc_r );
+
+        const std::size_t threads = std::min<std::size_t>( depth_r ? depth_r : bulkIODefaultQueueDepth(), count_r );
+        for ( std::size_t i = 1; i < threads; ++i ) {
+          zyppng::ThreadPool::global().post( [state]() {
+            {
+              std::lock_guard lk( state->_lock );
+              if ( state->_closed )
+                return;
+              ++state->_running;
+            }
+            state->work();
+            std::lock_guard lk( state->_lock );
+            --state->_running;
+            state->_done.notify_all();
+          });
+        }
+        state->work();
+
+        std::unique_lock lk( state->_lock );
+        state->_closed = true;
+        state->_done.wait( lk, [&](){ return state->_running == 0; } );
+        if ( state->_error )
+          std::rethrow_exception( state->_error );
+      }
+
+      /** Reads \a fd_r from the start in blocks of \a blockSize_r bytes, see \ref readFileBlocks. */
+      int readBlocks( int fd_r, off_t size_r, const std::function<void( const char *, std::size_t )> & consumer_r, std::size_t blockSize_r )
+      {
+        if ( ! blockSize_r )
+          blockSize_r = bulkIOBlockSize;
+        ::posix_fadvise( fd_r, 0, 0, POSIX_FADV_SEQUENTIAL );
+
+        AlignedBuffer buf { alignedBuffer( blockSize_r ) };
+        off_t offset = 0;
+        while ( true ) {
+          ssize_t res = ::pread( fd_r, buf.get(), blockSize_r, offset );
+          if ( res == -1 ) {
+            if ( errno == EINTR )
+              continue;
+            return errno;
+          }
+          if ( res == 0 )
+            break;
+
+          offset += res;
+          // let the kernel fetch the next block while the consumer works on this one
+          if ( offset < size_r )
+            ::posix_fadvise( fd_r, offset, blockSize_r, POSIX_FADV_WILLNEED );
+          consumer_r( buf.get(), res );
+        }
+        return 0;
+      }
+
+      /** Whether a failed copy_file_range/sendfile just means the kernel can't do it for these files. */
+      inline bool unsupportedCopy( int errno_r )
+      { return errno_r == EXDEV || errno_r == EINVAL || errno_r == ENOSYS || errno_r == EOPNOTSUPP || errno_r == EBADF; }
+
+      /** Largest chunk passed to copy_file_range and sendfile (the kernel limit). */
+      constexpr std::size_t maxCopyChunk = 0x7ffff000;
+
+      /**
+       * Copies the content of \a srcFd_r to the empty \a destFd_r. The cheapest way
+       * available wins: a reflink sharing the extents, a copy_file_range(2) done by the
+       * filesystem, a sendfile(2) inside the kernel, a read/write loop as last resort.
+       * \return \c 0 or the errno.
+       */
+      int copyData( int srcFd_r, int destFd_r, off_t size_r )
+      {
+#ifdef FICLONE
+        if ( ::ioctl( destFd_r, FICLONE, srcFd_r ) == 0 )
+          return 0;
+#endif
+        // The fallbacks are only possible as long as nothing was copied. Pseudo
+        // filesystems may report 0 bytes copied at once, so try the next one.
+        off_t copied = 0;
+        while ( true ) {
+          ssize_t res = ::copy_file_range( srcFd_r, nullptr, destFd_r, nullptr, maxCopyChunk, 0 );
+          if ( res == -1 ) {
+            if ( errno == EINTR )
+              continue;
+            if ( copied || ! unsupportedCopy( errno ) )
+              return errno;
+            break;
+          }
+          if ( res == 0 ) {
+            if ( copied )
+              return 0;
+            break;
+          }
+          copied += res;
+        }
+
+        while ( true ) {
+          ssize_t res = ::sendfile( destFd_r, srcFd_r, nullptr, maxCopyChunk );
+          if ( res == -1 ) {
+            if ( errno == EINTR )
+              continue;
+            if ( copied || ! unsupportedCopy( errno ) )
+              return errno;
+            break;
+          }
+          if ( res == 0 ) {
+            if ( copied )
+              return 0;
+            break;
+          }
+          copied += res;
+        }
+
+        int writeErr = 0;
+        int ret = readBlocks( srcFd_r, size_r, [&]( const char * data_r, std::size_t len_r ) {
+          if ( ! writeErr )
+            writeErr = writeAll( destFd_r, data_r, len_r );
+        }, bulkIOBlockSize );
+        return ret ? ret : writeErr;
+      }
+
+      /** Owner, mode and timestamps of \a st_r for \a path_r, like 'cp -p'. Lacking the permission to chown is not an error. */
+      int preserveAttributes( const Pathname & path_r, const struct stat & st_r, bool isLink_r = false )
+      {
+        const int flags = isLink_r ? AT_SYMLINK_NOFOLLOW : 0;
+        if ( ::fchownat( AT_FDCWD, path_r.c_str(), st_r.st_uid, st_r.st_gid, flags ) == -1 && errno != EPERM )
+          return errno;
+        if ( ! isLink_r && ::chmod( path_r.c_str(), st_r.st_mode & 07777 ) == -1 )
+          return errno;
+        const struct timespec times[2] = { st_r.st_atim, st_r.st_mtim };
+        if ( ::utimensat( AT_FDCWD, path_r.c_str(), times, flags ) == -1 )
+          return errno;
+        return 0;
+      }
+
+      /** Removes an existing non directory \a path_r, like 'cp --remove-destination'. */
+      inline int removeDestination( const Pathname & path_r )
+      { return ( ::unlink( path_r.c_str() ) == -1 && errno != ENOENT ) ? errno : 0; }
+
+      int copySymlink( const Pathname & link_r, const Pathname & dest_r, const struct stat & st_r, bool preserve_r )
+      {
+        std::string target( st_r.st_size > 0 ? st_r.st_size : PATH_MAX, '\0' );
+        ssize_t len = ::readlink( link_r.c_str(), target.data(), target.size() );
+        if ( len == -1 )
+          return errno;
+        target.resize( len );
+
+        if ( int res = removeDestination( dest_r ) )
+          return res;
+        if ( ::symlink( target.c_str(), dest_r.c_str() ) == -1 )
+          return errno;
+        return preserve_r ? preserveAttributes( dest_r, st_r, /*isLink*/true ) : 0;
+      }
+
+      int copyNode( const Pathname & dest_r, const struct stat & st_r, bool preserve_r )
+      {
+        if ( int res = removeDestination( dest_r ) )
+          return res;
+        if ( ::mknod( dest_r.c_str(), st_r.st_mode, st_r.st_rdev ) == -1 )
+          return errno;
+        return preserve_r ? preserveAttributes( dest_r, st_r ) : 0;
+      }
+    } // namespace
+
+    unsigned bulkIODefaultQueueDepth()
+    {
+      return std::clamp( std::thread::hardware_concurrency(), 2U, 16U );
+    }
+
+    int readFileBlocks( const Pathname & file_r, const std::function<void( const char *, std::size_t )> & consumer_r, std::size_t blockSize_r )
+    {
+      AutoFD fd( ::open( file_r.c_str(), O_RDONLY | O_CLOEXEC ) );
+      if ( fd == -1 )
+        return errno;
+
+      struct stat st;
+      if ( ::fstat( fd, &st ) == -1 )
+        return errno;
+      if ( ! S_ISREG( st.st_mode ) )
+        return EINVAL;
+
+      return readBlocks( fd, st.st_size, consumer_r, blockSize_r );
+    }
+
+    int copyFile( const Pathname & file_r, const Pathname & dest_r, bool preserve_r )
+    {
+      if ( ! PathInfo( file_r ).isFile() )
+        return EINVAL;
+      AutoFD src( ::open( file_r.c_str(), O_RDONLY | O_CLOEXEC ) );
+      if ( src == -1 )
+        return errno;
+
+      struct stat st;
+      if ( ::fstat( src, &st ) == -1 )
+        return errno;
+      if ( ! S_ISREG( st.st_mode ) )
+        return EINVAL;
+      if ( PathInfo( dest_r ).isDir() )
+        return EISDIR;
+
+      if ( int res = removeDestination( dest_r ) )
+        return res;
+
+      // without preserve the umask applies, like for 'cp'
+      AutoFD dest( ::open( dest_r.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, preserve_r ? 0600 : ( st.st_mode & 0777 ) ) );
+      if ( dest == -1 )
+        return errno;
+
+      int ret = copyData( src, dest, st.st_size );
+      if ( ! ret ) {
+        // close explicitly, it may report delayed write errors
+        int destFd = dest;
+        dest.resetDispose();
+        if ( ::close( destFd ) == -1 )
+          ret = errno;
+      }
+      if ( ! ret && preserve_r )
+        ret = preserveAttributes( dest_r, st );
+
+      if ( ret )
+        ::unlink( dest_r.c_str() );
+      return ret;
+    }
+
+    int copyTree( const Pathname & src_r, const Pathname & dest_r, bool preserve_r, unsigned queueDepth_r )
+    {
+      const auto start = std::chrono::steady_clock::now();
+
+      struct Dir
+      {
+        Pathname _src;
+        Pathname _dest;
+        struct stat _st;
+        bool _created;
+      };
+      std::vector<Dir> dirs;					// parents before their children
+      std::vector<std::pair<Pathname, Pathname>> files;
+      std::vector<std::pair<Pathname, Pathname>> hardlinks;	// (first copy, link to create)
+      std::map<std::pair<dev_t, ino_t>, Pathname> inodes;
+
+      // directories are created writable for us and get their final mode when the content is complete
+      const auto makeDir = [&]( const Pathname & src, const Pathname & dest, const struct stat & st ) {
+        bool created = true;
+        if ( ::mkdir( dest.c_str(), ( st.st_mode & 0777 ) | S_IRWXU ) == -1 ) {
+          if ( errno != EEXIST )
+            return errno;
+          if ( ! PathInfo( dest, PathInfo::LSTAT ).isDir() )
+            return ENOTDIR;
+          created = false;	// merge into the existing one
+        }
+        dirs.push_back( Dir{ src, dest, st, created } );
+        return 0;
+      };
+
+      struct stat st;
+      if ( ::lstat( src_r.c_str(), &st ) == -1 )
+        return errno;
+      if ( ! S_ISDIR( st.st_mode ) )
+        return ENOTDIR;
+      if ( int res = makeDir( src_r, dest_r, st ) )
+        return res;
+
+      // don't descend into the copy if it's inside src_r
+      struct stat destSt;
+      if ( ::stat( dest_r.c_str(), &destSt ) == -1 )
+        return errno;
+
+      int ret = 0;
+      for ( std::size_t idx = 0; idx < dirs.size() && ! ret; ++idx ) {
+        // dirs grows while walking it, so don't keep references
+        const Pathname srcDir { dirs[idx]._src };
+        const Pathname destDir { dirs[idx]._dest };
+
+        int res = dirForEach( srcDir, [&]( const Pathname &, const char *const name_r ) {
+          const Pathname src { srcDir / name_r };
+          const Pathname dest { destDir / name_r };
+          struct stat est;
+          if ( ::lstat( src.c_str(), &est ) == -1 ) {
+            ret = errno;
+            return false;
+          }
+
+          switch ( est.st_mode & S_IFMT ) {
+            case S_IFDIR:
+              if ( est.st_dev == destSt.st_dev && est.st_ino == destSt.st_ino ) {
+                ret = EINVAL;	// can't copy a directory into itself
+                break;
+              }
+              ret = makeDir( src, dest, est );
+              break;
+            case S_IFREG:
+              // hardlinks within the tree stay hardlinks, like 'cp -d'
+              if ( est.st_nlink > 1 ) {
+                auto [ it, isNew ] = inodes.try_emplace( std::make_pair( est.st_dev, est.st_ino ), dest );
+                if ( ! isNew ) {
+                  hardlinks.push_back( { it->second, dest } );
+                  break;
+                }
+              }
+              files.push_back( { src, dest } );
+              break;
+            case S_IFLNK:
+              ret = copySymlink( src, dest, est, preserve_r );
+              break;
+            default:
+              ret = copyNode( dest, est, preserve_r );
+              break;
+          }
+          if ( ret )
+            WAR << "copyTree " << src << " -> " << dest << ": " << Errno( ret ) << std::endl;
+          return ret == 0;
+        } );
+        if ( res > 0 )
+          ret = res;
+      }
+
+      if ( ! ret ) {
+        std::vector<int> results( files.size(), 0 );
+        forEachBounded( files.size(), queueDepth_r, [&]( std::size_t idx ) {
+          results[idx] = copyFile( files[idx].first, files[idx].second, preserve_r );
+          if ( results[idx] )
+            WAR << "copyTree " << files[idx].first << " -> " << files[idx].second << ": " << Errno( results[idx] ) << std::endl;
+        } );
+        auto failed = std::find_if( results.begin(), results.end(), []( int res_r ) { return res_r != 0; } );
+        if ( failed != results.end() )
+          ret = *failed;
+      }
+
+      for ( auto it = hardlinks.begin(); it != hardlinks.end() && ! ret; ++it ) {
+        ret = removeDestination( it->second );
+        if ( ! ret && ::link( it->first.c_str(), it->second.c_str() ) == -1 )
+          ret = ( errno == EXDEV || errno == EPERM ) ? copyFile( it->first, it->second, preserve_r ) : errno;
+      }
+
+      // children first, creating their content changed the parents mtime
+      for ( auto it = dirs.rbegin(); it != dirs.rend(); ++it ) {
+        int res = 0;
+        if ( preserve_r )
+          res = preserveAttributes( it->_dest, it->_st );
+        else if ( it->_created && ( it->_st.st_mode & S_IRWXU ) != S_IRWXU && ::chmod( it->_dest.c_str(), it->_st.st_mode & 0777 ) == -1 )
+          res = errno;
+        if ( res && ! ret )
+          ret = res;
+      }
+
+      MIL << "copyTree " << src_r << " -> " << dest_r << ": " << files.size() << " files in "
+          << std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count() << "ms"
+          << ( ret ? " failed " + Errno( ret ).asString() : std::string() ) << std::endl;
+      return ret;
+    }
+
+    std::vector<std::string> checksums( const std::vector<Pathname> & files_r, const std::string & algorithm_r, unsigned queueDepth_r )
+    {
+      std::vector<std::pair<Pathname, std::string>> files;
+      files.reserve( files_r.size() );
+      for ( const auto & file : files_r )
+        files.push_back( { file, algorithm_r } );
+      return checksums( files, queueDepth_r );
+    }
+
+    std::vector<std::string> checksums( const std::vector<std::pair<Pathname, std::string>> & files_r, unsigned queueDepth_r )
+    {
+      std::vector<std::string> ret( files_r.size() );
+      const auto start = std::chrono::steady_clock::now();
+
+      forEachBounded( files_r.size(), queueDepth_r, [&]( std::size_t idx ) {
+        const auto & [ file, algorithm ] = files_r[idx];
+        Digest digest;
+        if ( ! digest.create( algorithm ) )
+          return;
+
+        bool ok = true;
+        int res = readFileBlocks( file, [&]( const char * data_r, std::size_t len_r ) {
+          ok = ok && digest.update( data_r, len_r );
+        } );
+        if ( res || ! ok ) {
+          DBG << "checksum " << file << ": " << Errno( res ) << std::endl;
+          return;
+        }
+        ret[idx] = digest.digest();
+      } );
+
+      MIL << "checksums of " << files_r.size() << " files in "
+          << std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count() << "ms" << std::endl;
+      return ret;
+    }
+
+    std::vector<int> copyFiles( const std::vector<std::pair<Pathname, Pathname>> & jobs_r, unsigned queueDepth_r )
+    {
+      std::vector<int> ret( jobs_r.size(), 0 );
+      const auto start = std::chrono::steady_clock::now();
+
+      forEachBounded( jobs_r.size(), queueDepth_r, [&]( std::size_t idx ) {
+        ret[idx] = copyFile( jobs_r[idx].first, jobs_r[idx].second );
+        if ( ret[idx] )
+          WAR << "copy " << jobs_r[idx].first << " -> " << jobs_r[idx].second << ": " << Errno( ret[idx] ) << std::endl;
+      } );
+
+      MIL << "copyFiles of " << jobs_r.size() << " files in "
+          << std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count() << "ms" << std::endl;
+      return ret;
+    }
+
+  } // namespace filesystem
+} // namespace zypp
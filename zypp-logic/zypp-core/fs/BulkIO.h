@@ -0,0 +1,96 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file zypp-core/fs/BulkIO.h
+ *
+*/
+#ifndef ZYPP_CORE_FS_BULKIO_H
+#define ZYPP_CORE_FS_BULKIO_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zypp-core/Globals.h>
+#include <zypp-core/Pathname.h>
+
+namespace zypp {
+  namespace filesystem {
+
+    /** Size of the blocks \ref readFileBlocks passes to the consumer (1MiB). */
+    constexpr std::size_t bulkIOBlockSize = 1024 * 1024;
+
+    /**
+     * Number of files the bulk operations process concurrently if no
+     * queue depth is passed: one per CPU, but at least 2 and at most 16.
+     */
+    unsigned bulkIODefaultQueueDepth() ZYPP_API;
+
+    /**
+     * Reads the regular file \a file_r sequentially in page aligned blocks of
+     * \a blockSize_r bytes and passes each block to \a consumer_r.
+     *
+     * The kernel is asked to read ahead the next block while the consumer is
+     * still busy with the current one, so hashing and reading overlap.
+     *
+     * \return \c 0 on success, otherwise the \c errno of the failed operation
+     * (\c EINVAL if \a file_r is not a regular file).
+     */
+    int readFileBlocks( const Pathname & file_r, const std::function<void( const char *, std::size_t )> & consumer_r, std::size_t blockSize_r = bulkIOBlockSize ) ZYPP_API;
+
+    /**
+     * Computes the \a algorithm_r checksum of all \a files_r, processing up to
+     * \a queueDepth_r files concurrently (\c 0 means \ref bulkIODefaultQueueDepth).
+     *
+     * \return The checksums in the order of \a files_r. Like \ref checksum an empty
+     * string is returned for files that could not be read.
+     */
+    std::vector<std::string> checksums( const std::vector<Pathname> & files_r, const std::string & algorithm_r, unsigned queueDepth_r = 0 ) ZYPP_API;
+
+    /** \overload Each file is hashed with its own algorithm, given as the \c second element of \a files_r. */
+    std::vector<std::string> checksums( const std::vector<std::pair<Pathname, std::string>> & files_r, unsigned queueDepth_r = 0 ) ZYPP_API;
+
+    /**
+     * Copies the regular file \a file_r to \a dest_r in process, like
+     * 'cp --remove-destination' (or 'cp -p' if \a preserve_r is set).
+     *
+     * The cheapest available way is used: a reflink (\c FICLONE) sharing the
+     * extents, \c copy_file_range(2), \c sendfile(2) and finally a read/write loop.
+     * A partially written \a dest_r is removed on error.
+     *
+     * \return \c 0 on success, otherwise the \c errno of the failed operation
+     * (\c EINVAL if \a file_r is not a regular file, \c EISDIR if \a dest_r is a directory).
+     */
+    int copyFile( const Pathname & file_r, const Pathname & dest_r, bool preserve_r = false ) ZYPP_API;
+
+    /**
+     * Recursively copies the directory \a src_r to \a dest_r, like 'cp -dR' (or
+     * 'cp -a' if \a preserve_r is set). Symlinks are copied as symlinks and
+     * hardlinks inside the tree are kept. An existing \a dest_r directory is merged.
+     *
+     * The regular files are copied via \ref copyFile, up to \a queueDepth_r of them
+     * concurrently (\c 0 means \ref bulkIODefaultQueueDepth).
+     *
+     * \return \c 0 on success, otherwise the first \c errno encountered
+     * (\c ENOTDIR if \a src_r is not a directory).
+     */
+    int copyTree( const Pathname & src_r, const Pathname & dest_r, bool preserve_r = false, unsigned queueDepth_r = 0 ) ZYPP_API;
+
+    /**
+     * Copies each \c first file of \a jobs_r to its \c second path via \ref copyFile,
+     * processing up to \a queueDepth_r files concurrently (\c 0 means \ref bulkIODefaultQueueDepth).
+     *
+     * \return The \c errno of each job in the order of \a jobs_r, \c 0 on success.
+     */
+    std::vector<int> copyFiles( const std::vector<std::pair<Pathname, Pathname>> & jobs_r, unsigned queueDepth_r = 0 ) ZYPP_API;
+
+  } // namespace filesystem
+} // namespace zypp
+
+#endif // ZYPP_CORE_FS_BULKIO_H
@@ -20,13 +20,13 @@
 #include <utility>
 
 #include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/fs/BulkIO.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/IOStream.h>
 #include <zypp-core/base/Errno.h>
 
 #include <zypp-core/AutoDispose.h>
-#include <zypp-core/ExternalProgram.h>
 #include <zypp-core/Digest.h>
 #include <zypp-core/fs/TmpPath.h>
 
@@ -498,21 +498,7 @@ namespace zypp
         return logResult( EEXIST );
       }
 
-
-      const char *const argv[] = {
-        "/bin/cp",
-        "-dR",
-        "--",
-        srcpath.asString().c_str(),
-        destpath.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( copyTree( srcpath, tp.path() ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -538,22 +524,7 @@ namespace zypp
         return logResult( EEXIST );
       }
 
-      std::string src( srcpath.asString());
-      src += "/.";
-      const char *const argv[] = {
-        "/bin/cp",
-        "-dR",
-        "--",
-        src.c_str(),
-        destpath.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( copyTree( srcpath, destpath ) );
     }
 
     ///////////////////////////////////////////////////////////////////////
@@ -728,24 +699,50 @@ namespace zypp
     ///////////////////////////////////////////////////////////////////
     namespace
     {
+      /** Move \a oldpath by copying it including its attributes and removing it afterwards, like mv(1) does. */
+      int move_by_copy( const Pathname & oldpath, const Pathname & newpath )
+      {
+        PathInfo pi( oldpath, PathInfo::LSTAT );
+        int ret = 0;
+        if ( pi.isDir() ) {
+          ret = copyTree( oldpath, newpath, /*preserve*/true );
+          if ( ret == 0 )
+            ret = recursive_rmdir( oldpath );
+        }
+        else if ( pi.isLink() ) {
+          Pathname target;
+          ret = readlink( oldpath, target );
+          if ( ret == 0 && ::unlink( newpath.c_str() ) == -1 && errno != ENOENT )
+            ret = errno;
+          if ( ret == 0 && ::symlink( target.c_str(), newpath.c_str() ) == -1 )
+            ret = errno;
+          if ( ret == 0 && ::unlink( oldpath.c_str() ) == -1 )
+            ret = errno;
+        }
+        else if ( pi.isFile() ) {
+          ret = copyFile( oldpath, newpath, /*preserve*/true );
+          if ( ret == 0 && ::unlink( oldpath.c_str() ) == -1 )
+            ret = errno;
+        }
+        else {
+          ret = pi.isExist() ? EXDEV : ENOENT;
+        }
+        return ret;
+      }
+
       int safe_rename( const Pathname & oldpath, const Pathname & newpath )
       {
         int ret = ::rename( oldpath.asString().c_str(), newpath.asString().c_str() );
 
-        // rename(2) can fail on OverlayFS. Fallback to using mv(1), which is
-        // explicitly mentioned in the kernel docs to deal correctly with OverlayFS.
+        // rename(2) can fail on OverlayFS. Fallback to copy and remove like mv(1),
+        // which is explicitly mentioned in the kernel docs to deal correctly with OverlayFS.
         if ( ret == -1 && errno == EXDEV ) {
-          const char *const argv[] = {
-            "/usr/bin/mv",
-            oldpath.asString().c_str(),
-            newpath.asString().c_str(),
-            NULL
-          };
-          ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-          for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-            MIL << "  " << output;
+          MIL << " (EXDEV, move by copy)";
+          ret = move_by_copy( oldpath, newpath );
+          if ( ret != 0 ) {
+            errno = ret;
+            ret = -1;
           }
-          ret = prog.close();
         }
 
         return ret;
@@ -850,20 +847,7 @@ namespace zypp
         return logResult( EISDIR );
       }
 
-      const char *const argv[] = {
-        "/bin/cp",
-        "--remove-destination",
-        "--",
-        file.asString().c_str(),
-        dest.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( copyFile( file, dest ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -1020,19 +1004,7 @@ namespace zypp
         return logResult( ENOTDIR );
       }
 
-      const char *const argv[] = {
-        "/bin/cp",
-        "--",
-        file.asString().c_str(),
-        dest.asString().c_str(),
-        NULL
-      };
-      ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout );
-      for ( string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-        MIL << "  " << output;
-      }
-      int ret = prog.close();
-      return logResult( ret, "returned" );
+      return logResult( copyFile( file, dest / file.basename() ) );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -1042,14 +1014,7 @@ namespace zypp
     //
     std::string md5sum( const Pathname & file )
     {
-      if ( ! PathInfo( file ).isFile() ) {
-        return string();
-      }
-      std::ifstream istr( file.asString().c_str() );
-      if ( ! istr ) {
-        return string();
-      }
-      return Digest::digest( "MD5", istr );
+      return checksum( file, "MD5" );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -1069,14 +1034,15 @@ namespace zypp
     //
     std::string checksum( const Pathname & file, const std::string &algorithm )
     {
-      if ( ! PathInfo( file ).isFile() ) {
+      Digest digest;
+      if ( ! digest.create( algorithm ) ) {
         return string();
       }
-      std::ifstream istr( file.asString().c_str() );
-      if ( ! istr ) {
+      bool ok = true;
+      if ( readFileBlocks( file, [&]( const char * data, std::size_t len ) { ok = ok && digest.update( data, len ); } ) != 0 || ! ok ) {
         return string();
       }
-      return Digest::digest( algorithm, istr );
+      return digest.digest();
     }
 
     bool is_checksum( const Pathname & file, const CheckSum &checksum )
@@ -451,21 +451,24 @@ namespace zypp
     int clean_dir( const Pathname & path ) ZYPP_API;
 
     /**
-     * Like 'cp -a srcpath destpath'. Copy directory tree. srcpath/destpath must be
+     * Like 'cp -dR srcpath destpath'. Copy directory tree. srcpath/destpath must be
      * directories. 'basename srcpath' must not exist in destpath.
      *
+     * The tree is copied in process, see \ref copyTree.
+     *
      * @return 0 on success, ENOTDIR if srcpath/destpath is not a directory, EEXIST if
-     * 'basename srcpath' exists in destpath, otherwise the commands return value.
+     * 'basename srcpath' exists in destpath, otherwise errno.
      **/
     int copy_dir( const Pathname & srcpath, const Pathname & destpath ) ZYPP_API;
 
     /**
-     * Like 'cp -a srcpath/. destpath'. Copy the content of srcpath recursively
+     * Like 'cp -dR srcpath/. destpath'. Copy the content of srcpath recursively
      * into destpath. Both \p srcpath and \p destpath has to exists.
      *
+     * The tree is copied in process, see \ref copyTree.
+     *
      * @return 0 on success, ENOTDIR if srcpath/destpath is not a directory,
-     * EEXIST if srcpath and destpath are equal, otherwise the commands
-     * return value.
+     * EEXIST if srcpath and destpath are equal, otherwise errno.
      */
     int copy_dir_content( const Pathname & srcpath, const Pathname & destpath) ZYPP_API;
 
@@ -596,9 +599,10 @@ namespace zypp
 
     /**
      * Like '::rename'. Renames a file, moving it between directories if
-     * required. It falls back to using mv(1) in case errno is set to
-     * EXDEV, indicating a cross-device rename, which is likely to happen when
-     * oldpath and newpath are not on the same OverlayFS layer.
+     * required. Like mv(1) it falls back to copying (preserving the attributes)
+     * and removing oldpath in case errno is set to EXDEV, indicating a
+     * cross-device rename, which is likely to happen when oldpath and newpath
+     * are not on the same OverlayFS layer.
      *
      * @return 0 on success, errno on failure
      **/
@@ -633,10 +637,12 @@ namespace zypp
     int exchange( const Pathname & lpath, const Pathname & rpath );
 
     /**
-     * Like 'cp file dest'. Copy file to destination file.
+     * Like 'cp --remove-destination file dest'. Copy file to destination file.
+     *
+     * The data are copied in process, preferably as reflink, see \ref copyFile.
      *
      * @return 0 on success, EINVAL if file is not a file, EISDIR if
-     * destiantion is a directory, otherwise the commands return value.
+     * destiantion is a directory, otherwise errno.
      **/
     int copy( const Pathname & file, const Pathname & dest ) ZYPP_API;
 
@@ -695,8 +701,10 @@ namespace zypp
     /**
      * Like 'cp file dest'. Copy file to dest dir.
      *
+     * The data are copied in process, see \ref copyFile.
+     *
      * @return 0 on success, EINVAL if file is not a file, ENOTDIR if dest
-     * is no directory, otherwise the commands return value.
+     * is no directory, otherwise errno.
      **/
     int copy_file2dir( const Pathname & file, const Pathname & dest );
     //@}
@@ -0,0 +1,43 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------*/
+#ifndef ZYPP_NG_BASE_CANCELLATIONTOKEN_H_INCLUDED
+#define ZYPP_NG_BASE_CANCELLATIONTOKEN_H_INCLUDED
+
+#include <atomic>
+#include <memory>
+
+namespace zyppng {
+
+  /*!
+   * Cooperative cancellation flag shared between the code starting a job
+   * and the job itself. Copies share the same flag.
+   *
+   * Long running jobs should check \ref cancelled in regular intervals and
+   * return early if it is set.
+   */
+  class CancellationToken
+  {
+  public:
+    CancellationToken() : _flag( std::make_shared<std::atomic<bool>>( false ) ) {}
+
+    void cancel() {
+      _flag->store( true, std::memory_order_relaxed );
+    }
+
+    bool cancelled() const {
+      return _flag->load( std::memory_order_relaxed );
+    }
+
+  private:
+    std::shared_ptr<std::atomic<bool>> _flag;
+  };
+
+}
+
+#endif // ZYPP_NG_BASE_CANCELLATIONTOKEN_H_INCLUDED
@@ -38,15 +38,27 @@ class EventDispatcherPrivate;
  * we need to work together with an already exisiting event loop, for example in a Qt application. The default implementation however
  * uses the glib eventloop, just like Qt and GTK, so integrating libzypp here is just a matter of passing the default main context
  * to the constructor of \ref EventDispatcher.
+ *
+ * Dispatchers that do not need to integrate with a existing glib context can use a native epoll
+ * backend instead, see \ref setPreferredBackend.
  */
 class  EventDispatcher : public Base
 {
   ZYPP_DECLARE_PRIVATE(EventDispatcher)
   friend class AbstractEventSource;
   friend class Timer;
+  friend class EventLoop;
 
 public:
 
+  /*!
+   * The implementations available to drive a EventDispatcher.
+   */
+  enum class Backend {
+    Glib,   //< The glib main context, the default
+    Epoll   //< Native epoll(7) backend with a timer wheel, no glib main context is available
+  };
+
   using Ptr = EventDispatcherRef;
   using WeakPtr = EventDispatcherWeakRef;
   using IdleFunction = std::function<bool ()>;
@@ -169,6 +181,20 @@ public:
 
   GMainContext * glibContext();
 
+  /*!
+   * Selects the backend used for EventDispatchers created after this call. Dispatchers
+   * that are created for a existing glib context always use the glib backend.
+   * The initial value is taken from \c $ZYPP_EVENTDISPATCHER ( \c glib or \c epoll ),
+   * it defaults to \ref Backend::Glib.
+   */
+  static void setPreferredBackend ( Backend backend );
+
+  /*!
+   * Returns the backend this dispatcher is using.
+   * \note \ref nativeDispatcherHandle and \ref glibContext return a nullptr for the epoll backend.
+   */
+  Backend backend () const;
+
 protected:
 
   /*!
@@ -0,0 +1,481 @@
+#include "timer.h"
+#include "private/eventdispatcher_epoll_p.h"
+#include "private/eventdispatcher_glib_p.h"
+#include <zypp-core/ng/base/private/linuxhelpers_p.h>
+
+#include <zypp-core/base/Exception.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/Errno.h>
+
+#include <algorithm>
+#include <climits>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace zyppng {
+
+  namespace {
+
+    int zypp_pidfd_open( int pid )
+    {
+#ifdef SYS_pidfd_open
+      return ::syscall( SYS_pidfd_open, pid, 0 );
+#else
+      errno = ENOSYS;
+      return -1;
+#endif
+    }
+
+    uint32_t evModeToEpoll( int mode )
+    {
+      uint32_t ev = 0;
+      if ( mode & AbstractEventSource::Read )
+        ev |= EPOLLIN;
+      if ( mode & AbstractEventSource::Write )
+        ev |= EPOLLOUT;
+      if ( mode & AbstractEventSource::Exception )
+        ev |= EPOLLPRI;
+      return ev;
+    }
+
+    /// Same mapping as the glib backend: HUP is reported as Read, if no Read was requested as Error
+    int epollToEventTypes( uint32_t events, int mode )
+    {
+      int ev = 0;
+      if ( ( events & ( EPOLLIN | EPOLLHUP ) ) && ( mode & AbstractEventSource::Read ) )
+        ev |= AbstractEventSource::Read;
+      if ( ( events & EPOLLOUT ) && ( mode & AbstractEventSource::Write ) )
+        ev |= AbstractEventSource::Write;
+      if ( ( events & EPOLLPRI ) && ( mode & AbstractEventSource::Exception ) )
+        ev |= AbstractEventSource::Exception;
+      if ( ( events & EPOLLERR ) || ( ( events & EPOLLHUP ) && !( mode & AbstractEventSource::Read ) ) )
+        ev |= AbstractEventSource::Error;
+      return ev;
+    }
+
+    /// children that can not be tracked via pidfd are polled with this interval
+    constexpr int childPollIntervalMs = 100;
+  }
+
+  void TimerWheel::schedule( Id id, uint64_t deadline )
+  {
+    auto [ it, inserted ] = _deadlines.insert( std::make_pair( id, deadline ) );
+    if ( !inserted ) {
+      if ( it->second == deadline )
+        return;
+      it->second = deadline;
+    }
+
+    // deadlines in the past go into the next slot to be visited
+    const uint64_t tick = std::max( deadline, _cursor + 1 );
+    _slots[ tick % Slots ].push_back( Entry{ id, deadline } );
+  }
+
+  void TimerWheel::remove( Id id )
+  {
+    _deadlines.erase( id );
+  }
+
+  bool TimerWheel::isValid( const Entry &e ) const
+  {
+    auto it = _deadlines.find( e._id );
+    return ( it != _deadlines.end() && it->second == e._deadline );
+  }
+
+  std::vector<TimerWheel::Id> TimerWheel::expire( uint64_t now )
+  {
+    std::vector<Id> res;
+    if ( now <= _cursor )
+      return res;
+
+    // if we fell behind more than one rotation every slot needs to be visited once
+    const uint64_t ticks = std::min<uint64_t>( now - _cursor, Slots );
+    for ( uint64_t i = 1; i <= ticks; i++ ) {
+      auto &slot = _slots[ ( _cursor + i ) % Slots ];
+      for ( std::size_t j = 0; j < slot.size(); ) {
+        const Entry &e = slot[j];
+        const bool valid = isValid( e );
+        if ( valid && e._deadline > now ) {
+          j++;
+          continue;
+        }
+        if ( valid ) {
+          res.push_back( e._id );
+          _deadlines.erase( e._id );
+        }
+        slot[j] = slot.back();
+        slot.pop_back();
+      }
+    }
+    _cursor = now;
+    return res;
+  }
+
+  std::optional<uint64_t> TimerWheel::nextDeadline() const
+  {
+    if ( _deadlines.empty() )
+      return {};
+
+    // the wheel was never advanced, the cursor tells us nothing yet
+    if ( _cursor == 0 ) {
+      uint64_t next = _deadlines.begin()->second;
+      for ( const auto &d : _deadlines )
+        next = std::min( next, d.second );
+      return next;
+    }
+
+    for ( uint64_t t = _cursor + 1; t <= _cursor + Slots; t++ ) {
+      // deadlines that were already due when scheduled are kept in the first slot
+      std::optional<uint64_t> next;
+      for ( const Entry &e : _slots[ t % Slots ] ) {
+        if ( e._deadline <= t && isValid( e ) )
+          next = std::min( next.value_or( t ), e._deadline );
+      }
+      if ( next )
+        return next;
+    }
+    // all deadlines are more than one rotation away
+    return _cursor + Slots;
+  }
+
+  std::unique_ptr<EpollEventBackend> EpollEventBackend::create( EventDispatcherPrivate &d )
+  {
+    zypp::AutoFD epollFd = ::epoll_create1( EPOLL_CLOEXEC );
+    if ( epollFd == -1 ) {
+      WAR << "epoll_create1 failed: " << zypp::Errno() << std::endl;
+      return nullptr;
+    }
+
+    zypp::AutoFD wakeupFd = ::eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+    if ( wakeupFd == -1 ) {
+      WAR << "eventfd failed: " << zypp::Errno() << std::endl;
+      return nullptr;
+    }
+
+    epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = wakeupFd;
+    if ( ::epoll_ctl( epollFd, EPOLL_CTL_ADD, wakeupFd, &ev ) == -1 ) {
+      WAR << "Failed to watch the wakeup fd: " << zypp::Errno() << std::endl;
+      return nullptr;
+    }
+
+    return std::unique_ptr<EpollEventBackend>( new EpollEventBackend( d, std::move(epollFd), std::move(wakeupFd) ) );
+  }
+
+  EpollEventBackend::EpollEventBackend( EventDispatcherPrivate &d, zypp::AutoFD &&epollFd, zypp::AutoFD &&wakeupFd )
+    : _d( d )
+    , _epollFd( std::move(epollFd) )
+    , _wakeupFd( std::move(wakeupFd) )
+  { }
+
+  EpollEventBackend::~EpollEventBackend()
+  {
+    for ( auto &[pid, watch] : _children ) {
+      if ( watch._pidFd != -1 )
+        ::close( watch._pidFd );
+    }
+  }
+
+  void EpollEventBackend::updateEpoll( int fd )
+  {
+    auto it = _fdWatches.find( fd );
+    if ( it == _fdWatches.end() || it->second.empty() ) {
+      // the fd might be closed already, in that case the kernel removed it for us
+      ::epoll_ctl( _epollFd, EPOLL_CTL_DEL, fd, nullptr );
+      if ( it != _fdWatches.end() )
+        _fdWatches.erase( it );
+      return;
+    }
+
+    epoll_event ev{};
+    ev.data.fd = fd;
+    for ( const auto &w : it->second )
+      ev.events |= evModeToEpoll( w._mode );
+
+    // a closed and reused fd number is no longer known to epoll, a new one might still be
+    if ( ::epoll_ctl( _epollFd, EPOLL_CTL_MOD, fd, &ev ) == -1 ) {
+      if ( errno != ENOENT || ::epoll_ctl( _epollFd, EPOLL_CTL_ADD, fd, &ev ) == -1 )
+        ERR << "Failed to watch fd " << fd << " with epoll: " << zypp::Errno() << std::endl;
+    }
+  }
+
+  void EpollEventBackend::updateEventSource( AbstractEventSource &notifier, int fd, int mode )
+  {
+    auto &watches = _fdWatches[fd];
+    auto it = std::find_if( watches.begin(), watches.end(), [&]( const FdWatch &w ){ return w._src == &notifier; } );
+    if ( it != watches.end() )
+      it->_mode = mode;
+    else
+      watches.push_back( FdWatch{ &notifier, mode } );
+    updateEpoll( fd );
+  }
+
+  void EpollEventBackend::removeEventSource( AbstractEventSource &notifier, int fd )
+  {
+    const auto removeFrom = [&]( int watchedFd ) {
+      auto &watches = _fdWatches[watchedFd];
+      const auto oldSize = watches.size();
+      watches.erase( std::remove_if( watches.begin(), watches.end(), [&]( const FdWatch &w ){ return w._src == &notifier; } ), watches.end() );
+      return ( oldSize != watches.size() );
+    };
+
+    if ( fd != -1 ) {
+      if ( _fdWatches.count( fd ) && removeFrom( fd ) )
+        updateEpoll( fd );
+      return;
+    }
+
+    std::vector<int> changed;
+    for ( auto &[ watchedFd, watches ] : _fdWatches ) {
+      if ( removeFrom( watchedFd ) )
+        changed.push_back( watchedFd );
+    }
+    for ( int changedFd : changed )
+      updateEpoll( changedFd );
+  }
+
+  bool EpollEventBackend::dispatchFd( int fd, uint32_t events )
+  {
+    auto it = _fdWatches.find( fd );
+    if ( it == _fdWatches.end() )
+      return false;
+
+    // the callbacks might change the watches, work on a copy and make sure each watch is still active
+    const std::vector<FdWatch> watches = it->second;
+    bool dispatched = false;
+    for ( const FdWatch &w : watches ) {
+      auto curr = _fdWatches.find( fd );
+      if ( curr == _fdWatches.end() )
+        break;
+
+      auto wIt = std::find_if( curr->second.begin(), curr->second.end(), [&]( const FdWatch &cw ){ return cw._src == w._src; } );
+      if ( wIt == curr->second.end() )
+        continue;
+
+      const int ev = epollToEventTypes( events, wIt->_mode );
+      if ( !ev )
+        continue;
+
+      // we require all event objects to be used in shared_ptr form, just like the glib backend does
+      auto eventSourceLocked = w._src->shared_this<AbstractEventSource>();
+      eventSourceLocked->onFdReady( fd, ev );
+      dispatched = true;
+    }
+    return dispatched;
+  }
+
+  void EpollEventBackend::registerTimer( Timer &timer )
+  {
+    auto it = _timerIds.find( &timer );
+    if ( it == _timerIds.end() ) {
+      it = _timerIds.insert( std::make_pair( &timer, _nextTimerId++ ) ).first;
+      _timers[it->second]._timer = &timer;
+    }
+    // called again by Timer::start to move the deadline
+    _wheel.schedule( it->second, timer.expires() );
+  }
+
+  void EpollEventBackend::removeTimer( Timer &timer )
+  {
+    auto it = _timerIds.find( &timer );
+    if ( it == _timerIds.end() )
+      return;
+    _wheel.remove( it->second );
+    _timers.erase( it->second );
+    _timerIds.erase( it );
+  }
+
+  ulong EpollEventBackend::runningTimers() const
+  {
+    return _timerIds.size();
+  }
+
+  void EpollEventBackend::invokeAfter( EventDispatcher::TimeoutFunction &&callback, uint32_t timeout )
+  {
+    const auto id = _nextTimerId++;
+    auto &entry = _timers[id];
+    entry._callback = std::move(callback);
+    entry._interval = timeout;
+    _wheel.schedule( id, Timer::now() + timeout );
+  }
+
+  bool EpollEventBackend::dispatchTimers()
+  {
+    const auto expired = _wheel.expire( Timer::now() );
+    for ( const auto id : expired ) {
+      // an earlier callback might have removed this one already
+      auto it = _timers.find( id );
+      if ( it == _timers.end() )
+        continue;
+
+      if ( it->second._timer ) {
+        Timer *t = it->second._timer;
+        // emits the expired signal and restarts or stops the timer
+        t->shared_this<Timer>()->expire();
+
+        // timers that are still running and were not restarted from the signal need a new slot
+        if ( _timers.count( id ) && !_wheel.contains( id ) )
+          _wheel.schedule( id, t->expires() );
+      } else {
+        // the callback might add new timers, do not keep references into the map
+        auto cb = std::move( it->second._callback );
+        if ( cb() ) {
+          auto &entry = _timers[id];
+          entry._callback = std::move(cb);
+          _wheel.schedule( id, Timer::now() + entry._interval );
+        } else {
+          _timers.erase( id );
+        }
+      }
+    }
+    return !expired.empty();
+  }
+
+  void EpollEventBackend::trackChildProcess( int pid, EventDispatcher::WaitPidCallback &&callback )
+  {
+    untrackChildProcess( pid );
+
+    ChildWatch watch;
+    watch._callback = std::move(callback);
+    watch._pidFd    = zypp_pidfd_open( pid );
+    if ( watch._pidFd != -1 ) {
+      epoll_event ev{};
+      ev.events  = EPOLLIN;
+      ev.data.fd = watch._pidFd;
+      if ( ::epoll_ctl( _epollFd, EPOLL_CTL_ADD, watch._pidFd, &ev ) == -1 ) {
+        ::close( watch._pidFd );
+        watch._pidFd = -1;
+      }
+    }
+
+    if ( watch._pidFd == -1 ) {
+      DBG << "Unable to get a pidfd for " << pid << ", falling back to polling: " << zypp::Errno() << std::endl;
+      _polledChildren++;
+    } else {
+      _pidFds.insert( std::make_pair( watch._pidFd, pid ) );
+    }
+    _children.insert( std::make_pair( pid, std::move(watch) ) );
+  }
+
+  bool EpollEventBackend::untrackChildProcess( int pid )
+  {
+    auto it = _children.find( pid );
+    if ( it == _children.end() )
+      return false;
+
+    if ( it->second._pidFd != -1 ) {
+      ::epoll_ctl( _epollFd, EPOLL_CTL_DEL, it->second._pidFd, nullptr );
+      _pidFds.erase( it->second._pidFd );
+      ::close( it->second._pidFd );
+    } else {
+      _polledChildren--;
+    }
+    _children.erase( it );
+    return true;
+  }
+
+  bool EpollEventBackend::reapChild( int pid )
+  {
+    int status = 0;
+    const int res = eintrSafeCall( ::waitpid, pid, &status, WNOHANG );
+    if ( res == 0 )
+      return false;
+
+    auto it = _children.find( pid );
+    if ( it == _children.end() )
+      return false;
+    auto callback = std::move( it->second._callback );
+    untrackChildProcess( pid );
+
+    if ( res == -1 ) {
+      WAR << "Lost track of child process " << pid << ": " << zypp::Errno() << std::endl;
+      return false;
+    }
+
+    if ( callback )
+      callback( pid, status );
+    return true;
+  }
+
+  bool EpollEventBackend::pollChildren()
+  {
+    if ( !_polledChildren )
+      return false;
+
+    std::vector<int> pids;
+    for ( const auto &[ pid, watch ] : _children ) {
+      if ( watch._pidFd == -1 )
+        pids.push_back( pid );
+    }
+
+    bool dispatched = false;
+    for ( int pid : pids )
+      dispatched = reapChild( pid ) || dispatched;
+    return dispatched;
+  }
+
+  int EpollEventBackend::nextTimeout( bool mayBlock ) const
+  {
+    if ( !mayBlock || _idlePending )
+      return 0;
+
+    int timeout = -1;
+    if ( const auto next = _wheel.nextDeadline() ) {
+      const uint64_t now = Timer::now();
+      timeout = ( *next <= now ) ? 0 : static_cast<int>( std::min<uint64_t>( *next - now, INT_MAX ) );
+    }
+
+    if ( _polledChildren && ( timeout == -1 || timeout > childPollIntervalMs ) )
+      timeout = childPollIntervalMs;
+    return timeout;
+  }
+
+  bool EpollEventBackend::iterate( bool mayBlock )
+  {
+    std::array<epoll_event, 64> events;
+    const int ready = ::epoll_wait( _epollFd, events.data(), events.size(), nextTimeout( mayBlock ) );
+    if ( ready == -1 && errno != EINTR ) {
+      ERR << "epoll_wait failed: " << zypp::Errno() << std::endl;
+      return false;
+    }
+
+    bool dispatched = false;
+    for ( int i = 0; i < ready; i++ ) {
+      const int fd = events[i].data.fd;
+      if ( fd == _wakeupFd ) {
+        eventfd_t val = 0;
+        ::eventfd_read( _wakeupFd, &val );
+        continue;
+      }
+
+      if ( auto pidIt = _pidFds.find( fd ); pidIt != _pidFds.end() ) {
+        dispatched = reapChild( pidIt->second ) || dispatched;
+        continue;
+      }
+
+      dispatched = dispatchFd( fd, events[i].events ) || dispatched;
+    }
+
+    dispatched = dispatchTimers() || dispatched;
+    dispatched = pollChildren() || dispatched;
+
+    // idle tasks only run if there was nothing else to do, just like a glib idle source
+    if ( !dispatched && _idlePending ) {
+      _idlePending = _d.runIdleTasks();
+      dispatched = true;
+    }
+
+    return dispatched;
+  }
+
+  void EpollEventBackend::wakeup()
+  {
+    ::eventfd_write( _wakeupFd, 1 );
+  }
+
+}
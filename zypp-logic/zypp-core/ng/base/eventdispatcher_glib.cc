@@ -8,8 +8,22 @@
 #include <zypp-core/AutoDispose.h>
 #include <zypp-core/ng/base/UnixSignalSource>
 
+#include <atomic>
+#include <string_view>
+
 namespace zyppng {
 
+static std::atomic<EventDispatcher::Backend> &preferredBackendStorage ()
+{
+  static std::atomic<EventDispatcher::Backend> backend( [](){
+    const char *env = ::getenv( "ZYPP_EVENTDISPATCHER" );
+    if ( env && std::string_view( env ) == "epoll" )
+      return EventDispatcher::Backend::Epoll;
+    return EventDispatcher::Backend::Glib;
+  }() );
+  return backend;
+}
+
 static int inline readMask () {
   return ( G_IO_IN | G_IO_HUP );
 }
@@ -281,9 +295,16 @@ EventDispatcherPrivate::EventDispatcherPrivate (GMainContext *ctx , EventDispatc
   if ( ctx ) {
     _ctx = ctx;
     g_main_context_ref ( _ctx );
-  } else {
-    _ctx = g_main_context_new();
+    return;
+  }
+
+  if ( preferredBackend() == EventDispatcher::Backend::Epoll ) {
+    _epoll = EpollEventBackend::create( *this );
+    if ( _epoll )
+      return;
+    WAR << "Failed to initialize the epoll event dispatcher backend, falling back to glib" << std::endl;
   }
+  _ctx = g_main_context_new();
   // Enable this again once we switch to a full async API that requires a eventloop before calling any zypp functions
   // g_main_context_push_thread_default( _ctx );
 }
@@ -304,8 +325,11 @@ EventDispatcherPrivate::~EventDispatcherPrivate()
     g_source_unref ( _idleSource );
   }
 
+  _epoll.reset();
+
   //g_main_context_pop_thread_default( _ctx );
-  g_main_context_unref( _ctx );
+  if ( _ctx )
+    g_main_context_unref( _ctx );
 }
 
 bool EventDispatcherPrivate::runIdleTasks()
@@ -331,6 +355,11 @@ bool EventDispatcherPrivate::runIdleTasks()
 
 void EventDispatcherPrivate::enableIdleSource()
 {
+  if ( _epoll ) {
+    _epoll->enableIdle();
+    return;
+  }
+
   if ( !_idleSource ) {
     _idleSource = g_idle_source_new ();
     g_source_set_callback ( _idleSource, eventLoopIdleFunc, this, nullptr );
@@ -343,6 +372,11 @@ std::shared_ptr<EventDispatcher> EventDispatcherPrivate::create( GMainContext *c
   return std::shared_ptr<EventDispatcher>( new EventDispatcher( ctx ) );
 }
 
+EventDispatcher::Backend EventDispatcherPrivate::preferredBackend()
+{
+  return preferredBackendStorage().load();
+}
+
 void EventDispatcherPrivate::waitPidCallback( GPid pid, gint status, gpointer user_data )
 {
   EventDispatcherPrivate *that = reinterpret_cast<EventDispatcherPrivate *>( user_data );
@@ -398,6 +432,9 @@ void EventDispatcher::updateEventSource( AbstractEventSource &notifier, int fd,
   if ( notifier.eventDispatcher().lock().get() != this )
     ZYPP_THROW( zypp::Exception("Invalid event dispatcher used to update event source") );
 
+  if ( d->_epoll )
+    return d->_epoll->updateEventSource( notifier, fd, mode );
+
   AbstractEventSource *notifyPtr = &notifier;
 
   GAbstractEventSource *evSrc = nullptr;
@@ -443,6 +480,9 @@ void EventDispatcher::removeEventSource( zyppng::AbstractEventSource &notifier,
   if ( notifier.eventDispatcher().lock().get() != this )
     ZYPP_THROW( zypp::Exception("Invalid event dispatcher used to remove event source") );
 
+  if ( d->_epoll )
+    return d->_epoll->removeEventSource( notifier, fd );
+
   auto &evList = d->_eventSources;
   auto it = std::find_if( evList.begin(), evList.end(), [ ptr ]( const auto elem ){ return elem->eventSource == ptr; } );
 
@@ -476,6 +516,9 @@ void EventDispatcher::removeEventSource( zyppng::AbstractEventSource &notifier,
 void EventDispatcher::registerTimer( Timer &timer )
 {
   Z_D();
+  if ( d->_epoll )
+    return d->_epoll->registerTimer( timer );
+
   //make sure timer is not double registered
   for ( const GLibTimerSource *t : d->_runningTimers ) {
     if ( t->_t == &timer )
@@ -492,6 +535,9 @@ void EventDispatcher::registerTimer( Timer &timer )
 void EventDispatcher::removeTimer( Timer &timer )
 {
   Z_D();
+  if ( d->_epoll )
+    return d->_epoll->removeTimer( timer );
+
   auto it = std::find_if( d->_runningTimers.begin(), d->_runningTimers.end(), [ &timer ]( const GLibTimerSource *src ){
     return src->_t == &timer;
   });
@@ -549,6 +595,9 @@ bool EventDispatcher::waitForFdEvent( const int fd, int events , int &revents ,
 void EventDispatcher::trackChildProcess( int pid, std::function<void (int, int)> callback )
 {
   Z_D();
+  if ( d->_epoll )
+    return d->_epoll->trackChildProcess( pid, std::move(callback) );
+
   GlibWaitPIDData data ( pid );
   data.callback = std::move(callback);
 
@@ -560,6 +609,9 @@ void EventDispatcher::trackChildProcess( int pid, std::function<void (int, int)>
 bool EventDispatcher::untrackChildProcess(int pid)
 {
   Z_D();
+  if ( d->_epoll )
+    return d->_epoll->untrackChildProcess( pid );
+
   try {
     d->_waitPIDs.erase( pid );
   }  catch ( const std::out_of_range &e ) {
@@ -586,9 +638,22 @@ GMainContext * EventDispatcher::glibContext()
   return d_func()->_ctx;
 }
 
+void EventDispatcher::setPreferredBackend( Backend backend )
+{
+  preferredBackendStorage().store( backend );
+}
+
+EventDispatcher::Backend EventDispatcher::backend() const
+{
+  return d_func()->_epoll ? Backend::Epoll : Backend::Glib;
+}
+
 bool EventDispatcher::run_once()
 {
-  return g_main_context_iteration( d_func()->_ctx, false );
+  Z_D();
+  if ( d->_epoll )
+    return d->_epoll->iterate( false );
+  return g_main_context_iteration( d->_ctx, false );
 }
 
 void EventDispatcher::invokeOnIdleImpl(EventDispatcher::IdleFunction &&callback)
@@ -600,12 +665,16 @@ void EventDispatcher::invokeOnIdleImpl(EventDispatcher::IdleFunction &&callback)
 
 void EventDispatcher::invokeAfterImpl( TimeoutFunction &&callback, uint32_t timeout )
 {
+  Z_D();
+  if ( d->_epoll )
+    return d->_epoll->invokeAfter( std::move(callback), timeout );
+
   GlibTimeoutData *userData = new GlibTimeoutData();
   userData->_callback = std::move(callback);
 
   GSource *source = g_timeout_source_new ( timeout );
   g_source_set_callback (source, G_SOURCE_FUNC(&EventDispatcherPrivate::timeoutCallback), userData, &EventDispatcherPrivate::timeoutDestroyCallback );
-  g_source_attach (source, d_func()->_ctx );
+  g_source_attach (source, d->_ctx );
   g_source_unref (source);
 }
 
@@ -623,7 +692,10 @@ void EventDispatcher::clearUnrefLaterList ()
 
 ulong EventDispatcher::runningTimers() const
 {
-  return d_func()->_runningTimers.size();
+  Z_D();
+  if ( d->_epoll )
+    return d->_epoll->runningTimers();
+  return d->_runningTimers.size();
 }
 
 std::shared_ptr<EventDispatcher> EventDispatcher::instance()
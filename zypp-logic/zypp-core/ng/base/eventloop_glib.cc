@@ -1,4 +1,5 @@
 #include "private/eventloop_glib_p.h"
+#include "private/eventdispatcher_glib_p.h"
 #include <zypp-core/ng/base/EventDispatcher>
 
 namespace zyppng {
@@ -13,7 +14,9 @@ namespace zyppng {
   {
     Z_D();
     d->_dispatcher = std::move(disp);
-    d->_loop       = g_main_loop_new( reinterpret_cast<GMainContext*>(d->_dispatcher->nativeDispatcherHandle()), false );
+    // the epoll backend has no glib context, it is driven directly from run()
+    if ( !d->_dispatcher->d_func()->_epoll )
+      d->_loop = g_main_loop_new( reinterpret_cast<GMainContext*>(d->_dispatcher->nativeDispatcherHandle()), false );
   }
 
 
@@ -23,7 +26,8 @@ namespace zyppng {
 
   EventLoop::~EventLoop()
   {
-    g_main_loop_unref( d_func()->_loop );
+    if ( d_func()->_loop )
+      g_main_loop_unref( d_func()->_loop );
   }
 
   EventLoop::Ptr EventLoop::create( GMainContext *ctx )
@@ -40,6 +44,16 @@ namespace zyppng {
   void EventLoop::run()
   {
     Z_D();
+    if ( auto epoll = d->_dispatcher->d_func()->_epoll.get() ) {
+      zypp_defer {
+        d->_dispatcher->clearUnrefLaterList();
+      };
+      d->_quit = false;
+      while ( !d->_quit )
+        epoll->iterate( true );
+      return;
+    }
+
     g_main_context_push_thread_default( reinterpret_cast<GMainContext*>(d->_dispatcher->nativeDispatcherHandle()) );
     zypp_defer {
       d->_dispatcher->clearUnrefLaterList();
@@ -50,7 +64,13 @@ namespace zyppng {
 
   void EventLoop::quit()
   {
-    g_main_loop_quit( d_func()->_loop );
+    Z_D();
+    if ( auto epoll = d->_dispatcher->d_func()->_epoll.get() ) {
+      d->_quit = true;
+      epoll->wakeup();
+      return;
+    }
+    g_main_loop_quit( d->_loop );
   }
 
   std::shared_ptr<EventDispatcher> EventLoop::eventDispatcher() const
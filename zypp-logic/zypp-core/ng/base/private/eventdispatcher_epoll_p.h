@@ -0,0 +1,172 @@
+#ifndef ZYPP_BASE_EVENTDISPATCHER_EPOLL_P_DEFINED
+#define ZYPP_BASE_EVENTDISPATCHER_EPOLL_P_DEFINED
+
+#include <zypp-core/ng/base/eventdispatcher.h>
+#include <zypp-core/AutoDispose.h>
+
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace zyppng {
+
+  class EventDispatcherPrivate;
+
+  /*!
+   * \internal Hashed timer wheel with 1ms resolution.
+   *
+   * Each entry is put into the slot of its deadline modulo the wheel size, entries
+   * with a deadline more than one rotation in the future simply stay in their slot
+   * until the cursor passed it often enough. Scheduling and removing is O(1), removed
+   * or rescheduled entries are dropped lazily when their old slot is visited.
+   */
+  class TimerWheel
+  {
+  public:
+    using Id = uint64_t;
+    static constexpr std::size_t Slots = 512;
+
+    /*!
+     * Schedules \a id to expire at \a deadline, a previous deadline for \a id is replaced.
+     */
+    void schedule ( Id id, uint64_t deadline );
+
+    /*!
+     * Forgets about \a id, it will not be returned by \ref expire anymore.
+     */
+    void remove ( Id id );
+
+    /*!
+     * Advances the wheel to \a now and returns all ids whose deadline was reached.
+     * The returned ids are no longer scheduled.
+     */
+    std::vector<Id> expire ( uint64_t now );
+
+    /*!
+     * Returns the point in time the wheel needs to be advanced next, this might be earlier
+     * than the next real deadline if it is more than one rotation away.
+     */
+    std::optional<uint64_t> nextDeadline () const;
+
+    bool contains ( Id id ) const {
+      return _deadlines.count( id ) > 0;
+    }
+
+    bool empty () const {
+      return _deadlines.empty();
+    }
+
+    std::size_t size () const {
+      return _deadlines.size();
+    }
+
+  private:
+    struct Entry {
+      Id _id;
+      uint64_t _deadline;
+    };
+
+    bool isValid ( const Entry &e ) const;
+
+    std::array<std::vector<Entry>, Slots> _slots;
+    std::unordered_map<Id, uint64_t> _deadlines; ///< the authoritative deadline for each scheduled id
+    uint64_t _cursor = 0;                          ///< the last tick that was fully processed
+  };
+
+  /*!
+   * \internal Native EventDispatcher backend using epoll(7), an eventfd(2) for wakeups,
+   * pidfd_open(2) for child processes and a \ref TimerWheel for all timers.
+   *
+   * This is used instead of the glib main context if the dispatcher does not need to integrate
+   * with a existing glib context and the backend was selected via \ref EventDispatcher::setPreferredBackend
+   * or \c $ZYPP_EVENTDISPATCHER=epoll.
+   */
+  class EpollEventBackend
+  {
+  public:
+    /*!
+     * Creates the backend, returns a nullptr if the required kernel API is not available.
+     */
+    static std::unique_ptr<EpollEventBackend> create ( EventDispatcherPrivate &d );
+
+    ~EpollEventBackend();
+    EpollEventBackend( const EpollEventBackend & ) = delete;
+    EpollEventBackend &operator=( const EpollEventBackend & ) = delete;
+
+    void updateEventSource ( AbstractEventSource &notifier, int fd, int mode );
+    void removeEventSource ( AbstractEventSource &notifier, int fd );
+
+    void registerTimer ( Timer &timer );
+    void removeTimer ( Timer &timer );
+    ulong runningTimers () const;
+
+    void invokeAfter ( EventDispatcher::TimeoutFunction &&callback, uint32_t timeout );
+
+    void trackChildProcess ( int pid, EventDispatcher::WaitPidCallback &&callback );
+    bool untrackChildProcess ( int pid );
+
+    /*!
+     * Requests the idle tasks of the dispatcher to run once there is nothing else to do.
+     */
+    void enableIdle () {
+      _idlePending = true;
+    }
+
+    /*!
+     * Polls once for events and dispatches them, if \a mayBlock is set waits until
+     * there is something to do. Returns \c true if anything was dispatched.
+     */
+    bool iterate ( bool mayBlock );
+
+    /*!
+     * Interrupts a blocking \ref iterate, can be called from any thread.
+     */
+    void wakeup ();
+
+  private:
+    EpollEventBackend( EventDispatcherPrivate &d, zypp::AutoFD &&epollFd, zypp::AutoFD &&wakeupFd );
+
+    struct FdWatch {
+      AbstractEventSource *_src;
+      int _mode;
+    };
+
+    struct TimerEntry {
+      Timer *_timer = nullptr;                       ///< set for Timer instances
+      EventDispatcher::TimeoutFunction _callback;    ///< set for \ref invokeAfter callbacks
+      uint32_t _interval = 0;
+    };
+
+    struct ChildWatch {
+      int _pidFd = -1; ///< -1 if pidfd_open is not supported, the pid is polled then
+      EventDispatcher::WaitPidCallback _callback;
+    };
+
+    void updateEpoll ( int fd );
+    bool dispatchFd ( int fd, uint32_t events );
+    bool dispatchTimers ();
+    bool reapChild ( int pid );
+    bool pollChildren ();
+    int nextTimeout ( bool mayBlock ) const;
+
+    EventDispatcherPrivate &_d;
+    zypp::AutoFD _epollFd;
+    zypp::AutoFD _wakeupFd;
+    bool _idlePending = false;
+
+    std::unordered_map<int, std::vector<FdWatch>> _fdWatches;
+
+    TimerWheel _wheel;
+    TimerWheel::Id _nextTimerId = 0;
+    std::unordered_map<Timer *, TimerWheel::Id> _timerIds;
+    std::unordered_map<TimerWheel::Id, TimerEntry> _timers;
+
+    std::unordered_map<int, ChildWatch> _children; ///< pid -> watch
+    std::unordered_map<int, int> _pidFds;          ///< pidfd -> pid
+    std::size_t _polledChildren = 0;
+  };
+
+}
+
+#endif
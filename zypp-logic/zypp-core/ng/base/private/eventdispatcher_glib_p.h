@@ -2,6 +2,7 @@
 #define ZYPP_BASE_EVENTDISPATCHER_GLIB_P_DEFINED
 
 #include "base_p.h"
+#include "eventdispatcher_epoll_p.h"
 #include <zypp-core/ng/base/eventdispatcher.h>
 #include <glib.h>
 #include <thread>
@@ -87,6 +88,7 @@ public:
   void enableIdleSource ();
 
   static std::shared_ptr<EventDispatcher> create ( GMainContext *ctx = 0 );
+  static EventDispatcher::Backend preferredBackend ();
   static void waitPidCallback ( GPid pid, gint status, gpointer user_data );
 
   static bool timeoutCallback ( gpointer user_data );
@@ -103,6 +105,9 @@ public:
   std::queue< EventDispatcher::IdleFunction > _idleFuncs;
   std::unordered_map<int, GlibWaitPIDData> _waitPIDs;
   UnixSignalSourceWeakRef _signalSource;
+
+  /// set if the native epoll backend is used instead of \a _ctx
+  std::unique_ptr<EpollEventBackend> _epoll;
 };
 
 }
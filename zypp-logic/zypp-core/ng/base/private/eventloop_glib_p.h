@@ -5,6 +5,7 @@
 #include "threaddata_p.h"
 #include <zypp-core/ng/base/eventloop.h>
 #include <glib.h>
+#include <atomic>
 
 namespace zyppng {
 
@@ -15,7 +16,8 @@ namespace zyppng {
     EventLoopPrivate ( EventLoop &p );
 
     std::shared_ptr<EventDispatcher> _dispatcher;
-    GMainLoop *_loop = nullptr;
+    GMainLoop *_loop = nullptr;      ///< only used by the glib backend
+    std::atomic_bool _quit = false;  ///< only used by the epoll backend
 
   };
 
@@ -158,15 +158,14 @@ void Timer::start( uint64_t timeout )
   d->_requestedTimeout = timeout;
   d->_beginMs = now();
 
-  if ( !d->_isRunning ) {
-    auto ev = d->_ev.lock();
-    //if ev is null we are shutting down
-    if ( !ev )
-      return;
-    ev->registerTimer( *this );
-
-    d->_isRunning = true;
-  }
+  auto ev = d->_ev.lock();
+  //if ev is null we are shutting down
+  if ( !ev )
+    return;
+
+  // always tell the dispatcher, backends that do not poll the timer need to know about the new deadline
+  ev->registerTimer( *this );
+  d->_isRunning = true;
 
 }
 
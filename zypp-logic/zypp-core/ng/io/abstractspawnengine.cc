@@ -23,7 +23,7 @@ namespace zyppng {
 
     SpawnEngine initEngineFromEnv () {
       const std::string fBackend ( zypp::str::asString( ::getenv("ZYPP_FORK_BACKEND") ) );
-      if ( fBackend.empty() || fBackend == "auto" || fBackend == "pfork" ) {
+      if ( fBackend.empty() || fBackend == "auto" || fBackend == "pfork" || fBackend == "fork" ) {
         DBG << "Starting processes via posix fork" << std::endl;
         return SpawnEngine::PFORK;
       } else if ( fBackend == "gspawn" ) {
@@ -13,6 +13,8 @@
 #include <zypp-core/base/LogControl.h>
 
 #include <cstdint>
+#include <memory>
+#include <string_view>
 #include <iostream>
 #include <signal.h>
 #include <errno.h>
@@ -22,6 +24,7 @@
 #include <pty.h> // openpty
 #include <stdlib.h> // setenv
 #include <sys/prctl.h> // prctl(), PR_SET_PDEATHSIG
+#include <sched.h> // clone()
 
 #include <sys/syscall.h>
 #ifdef SYS_pidfd_open
@@ -31,6 +34,64 @@
 #undef  ZYPP_BASE_LOGGER_LOGGROUP
 #define ZYPP_BASE_LOGGER_LOGGROUP "zypp::exec"
 
+namespace {
+
+  // we use a control pipe to figure out if the exec actually worked,
+  // this is the approach:
+  // - create a pipe before forking
+  // - block on the read end of the pipe in the parent process
+  // - in the child process we write a error tag + errno into the pipe if we encounter any error and exit
+  // - If child setup works out, the pipe is auto closed by exec() and the parent process knows from just receiving EOF
+  //   that starting the child was successful, otherwise the blocking read in the parent will return with actual data read from the fd
+  //   which will contain the error description
+
+  enum class ChildErrType : int8_t {
+    NO_ERR,
+    CHROOT_FAILED,
+    CHDIR_FAILED,
+    EXEC_FAILED
+  };
+
+  struct ChildErr {
+    int childErrno = 0;
+    ChildErrType type = ChildErrType::NO_ERR;
+  };
+
+  // there is no glibc wrapper for close_range on older distributions
+  int zypp_close_range( unsigned int first, unsigned int last )
+  {
+#ifdef SYS_close_range
+    return ::syscall( SYS_close_range, first, last, 0 );
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+  }
+
+  bool haveCloseRange()
+  {
+    // closes nothing, but fails with ENOSYS on kernels < 5.9
+    static const bool have = ( zypp_close_range( ~0U, ~0U ) == 0 );
+    return have;
+  }
+
+  bool useVFork()
+  {
+    static const bool use = [](){
+      if ( zypp::str::asString( ::getenv("ZYPP_FORK_BACKEND") ) == "fork" ) {
+        DBG << "ZYPP_FORK_BACKEND=fork, starting processes via fork()" << std::endl;
+        return false;
+      }
+      if ( !haveCloseRange() ) {
+        DBG << "close_range(2) is not supported, starting processes via fork()" << std::endl;
+        return false;
+      }
+      return true;
+    }();
+    return use;
+  }
+}
+
 
 zyppng::AbstractDirectSpawnEngine::~AbstractDirectSpawnEngine()
 {
@@ -133,17 +194,18 @@ bool zyppng::AbstractDirectSpawnEngine::waitForExit( const std::optional<uint64_
 #endif
 }
 
-void zyppng::AbstractDirectSpawnEngine::mapExtraFds ( int controlFd )
+zyppng::AbstractDirectSpawnEngine::FdMapping zyppng::AbstractDirectSpawnEngine::planExtraFds ( int controlFd ) const
 {
   // we might have gotten other FDs to reuse, lets map them to STDERR_FILENO++
   // BUT we need to make sure the fds are not already in the range we need to map them to
   // so we first go over a list and collect those that are safe or move those that are not
-  int lastFdToKeep = STDERR_FILENO + _mapFds.size();
-  int nextBackupFd = lastFdToKeep + 1; //this we will use to count the fds upwards
+  FdMapping mapping;
+  mapping._lastFdToKeep = STDERR_FILENO + _mapFds.size();
+  int nextBackupFd = mapping._lastFdToKeep + 1; //this we will use to count the fds upwards
   std::vector<int> safeFds;
   for ( auto fd : _mapFds ) {
     // If the fds are larger than the last one we will map to, it is safe.
-    if ( fd > lastFdToKeep ) {
+    if ( fd > mapping._lastFdToKeep ) {
       safeFds.push_back( fd );
     } else {
       // we need to map the fd after the set of those we want to keep, but also make sure
@@ -155,7 +217,7 @@ void zyppng::AbstractDirectSpawnEngine::mapExtraFds ( int controlFd )
         const bool isSafe1 = std::find( _mapFds.begin(), _mapFds.end(), backupTo ) == _mapFds.end();
         const bool isSafe2 = std::find( safeFds.begin(), safeFds.end(), backupTo ) == safeFds.end();
         if ( isSafe1 && isSafe2 && ( controlFd == -1 || backupTo != controlFd) ) {
-          dup2( fd, backupTo );
+          mapping._dups.push_back( { fd, backupTo } );
           safeFds.push_back( backupTo );
           break;
         }
@@ -167,7 +229,29 @@ void zyppng::AbstractDirectSpawnEngine::mapExtraFds ( int controlFd )
   int nextFd = STDERR_FILENO;
   for ( auto fd : safeFds ) {
     nextFd++;
-    dup2( fd, nextFd );
+    mapping._dups.push_back( { fd, nextFd } );
+  }
+  return mapping;
+}
+
+void zyppng::AbstractDirectSpawnEngine::applyFdMapping( const FdMapping &mapping )
+{
+  for ( const auto &[ from, to ] : mapping._dups )
+    dup2( from, to );
+}
+
+void zyppng::AbstractDirectSpawnEngine::closeFdsAbove( int lastFdToKeep, int controlFd )
+{
+  // one syscall instead of one per possible fd, controlFD has O_CLOEXEC set so it will be cleaned up :)
+  if ( haveCloseRange() ) {
+    if ( controlFd > lastFdToKeep ) {
+      if ( controlFd > lastFdToKeep + 1 )
+        zypp_close_range( lastFdToKeep + 1, controlFd - 1 );
+      zypp_close_range( controlFd + 1, ~0U );
+    } else {
+      zypp_close_range( lastFdToKeep + 1, ~0U );
+    }
+    return;
   }
 
   const auto &canCloseFd = [&]( int fd ){
@@ -213,6 +297,13 @@ void zyppng::AbstractDirectSpawnEngine::mapExtraFds ( int controlFd )
   }
 }
 
+void zyppng::AbstractDirectSpawnEngine::mapExtraFds ( int controlFd )
+{
+  const FdMapping &mapping = planExtraFds( controlFd );
+  applyFdMapping( mapping );
+  closeFdsAbove( mapping._lastFdToKeep, controlFd );
+}
+
 void zyppng::AbstractDirectSpawnEngine::resetSignals()
 {
   // set all signal handers to their default
@@ -231,6 +322,24 @@ void zyppng::AbstractDirectSpawnEngine::resetSignals()
   pthread_sigmask ( SIG_SETMASK, &sigMask, nullptr );
 }
 
+struct zyppng::ForkSpawnEngine::VForkData
+{
+  // everything the child needs is prepared here, the child shares our memory and must not allocate
+  const char *const *argv = nullptr;
+  std::vector<std::string> envStrs;
+  std::vector<char *> envp;
+  FdMapping fdMapping;
+  int stdin_fd  = -1;
+  int stdout_fd = -1;
+  int stderr_fd = -1;
+  const char *chroot  = nullptr;
+  const char *chdirTo = nullptr;
+  int controlFd = -1;
+  pid_t ppid = -1;
+  bool switchPgid = false;
+  bool dieWithParent = false;
+};
+
 bool zyppng::ForkSpawnEngine::start( const char * const *argv, int stdin_fd, int stdout_fd, int stderr_fd )
 {
   _pid = -1;
@@ -273,27 +382,7 @@ bool zyppng::ForkSpawnEngine::start( const char * const *argv, int stdin_fd, int
   }
   DBG << "Executing" << ( _useDefaultLocale?"[C] ":" ") << _executedCommand << std::endl;
 
-  // we use a control pipe to figure out if the exec actually worked,
-  // this is the approach:
-  // - create a pipe before forking
-  // - block on the read end of the pipe in the parent process
-  // - in the child process we write a error tag + errno into the pipe if we encounter any error and exit
-  // - If child setup works out, the pipe is auto closed by exec() and the parent process knows from just receiving EOF
-  //   that starting the child was successful, otherwise the blocking read in the parent will return with actual data read from the fd
-  //   which will contain the error description
-
-  enum class ChildErrType : int8_t {
-    NO_ERR,
-    CHROOT_FAILED,
-    CHDIR_FAILED,
-    EXEC_FAILED
-  };
-
-  struct ChildErr {
-    int childErrno = 0;
-    ChildErrType type = ChildErrType::NO_ERR;
-  };
-
+  // we use a control pipe to figure out if the exec actually worked, see ChildErr
   auto controlPipe = Pipe::create( O_CLOEXEC );
   if ( !controlPipe ) {
     _execError = _("Unable to create control pipe.");
@@ -303,8 +392,25 @@ bool zyppng::ForkSpawnEngine::start( const char * const *argv, int stdin_fd, int
 
   pid_t ppid_before_fork = ::getpid();
 
+  // execvp in the vfork child searches the PATH of our own environment, so if the
+  // PATH is changed for the child we need to setenv() it in a forked child
+  const bool canVFork = useVFork() && !_use_pty && _environment.count( "PATH" ) == 0;
+
+  if ( canVFork )
+  {
+    VForkData data;
+    data.argv      = argv;
+    data.stdin_fd  = stdin_fd;
+    data.stdout_fd = stdout_fd;
+    data.stderr_fd = stderr_fd;
+    data.chroot    = _chroot.empty() ? nullptr : _chroot.c_str();
+    data.chdirTo   = ( !_chroot.empty() && !chdirTo ) ? "/" : chdirTo;
+    data.controlFd = controlPipe->writeFd;
+    data.ppid      = ppid_before_fork;
+    _pid = spawnVFork( data );
+  }
   // Create module process
-  if ( ( _pid = fork() ) == 0 )
+  else if ( ( _pid = fork() ) == 0 )
   {
 
     // child process
@@ -408,7 +514,8 @@ bool zyppng::ForkSpawnEngine::start( const char * const *argv, int stdin_fd, int
     writeErrAndExit( 129, ChildErrType::EXEC_FAILED ); // No sense in returning! I am forked away!!
     //////////////////////////////////////////////////////////////////////
   }
-  else if ( _pid == -1 )	 // Fork failed, close everything.
+
+  if ( _pid == -1 )	 // Fork failed, close everything.
   {
     _execError = zypp::str::form( _("Can't fork (%s)."), strerror(errno).c_str() );
     _exitStatus = 127;
@@ -457,6 +564,107 @@ bool zyppng::ForkSpawnEngine::start( const char * const *argv, int stdin_fd, int
   return true;
 }
 
+pid_t zyppng::ForkSpawnEngine::spawnVFork( VForkData &data )
+{
+  // the environment is passed to execvpe instead of calling setenv in the child
+  for ( char **envPtr = environ; *envPtr != nullptr; envPtr++ ) {
+    std::string_view entry( *envPtr );
+    std::string_view name = entry.substr( 0, entry.find( '=' ) );
+    if ( _environment.count( std::string(name) ) || ( _useDefaultLocale && name == "LC_ALL" ) )
+      continue;
+    data.envp.push_back( *envPtr );
+  }
+  data.envStrs.reserve( _environment.size() + 1 );
+  for ( const auto &env : _environment ) {
+    data.envStrs.push_back( env.first + "=" + env.second );
+    data.envp.push_back( data.envStrs.back().data() );
+  }
+  if ( _useDefaultLocale ) {
+    data.envStrs.push_back( "LC_ALL=C" );
+    data.envp.push_back( data.envStrs.back().data() );
+  }
+  data.envp.push_back( nullptr );
+
+  data.fdMapping     = planExtraFds( data.controlFd );
+  data.switchPgid    = _switchPgid;
+  data.dieWithParent = _dieWithParent;
+
+  // execvpe needs some stack to build the paths it tries
+  constexpr std::size_t stackSize = 128 * 1024;
+  std::unique_ptr<char[]> stack( new char[ stackSize ] );
+
+  // no signal handler must run in the child while it shares our memory,
+  // it resets all handlers before unblocking the signals again
+  sigset_t allSignals, oldMask;
+  sigfillset( &allSignals );
+  pthread_sigmask( SIG_SETMASK, &allSignals, &oldMask );
+
+  // the stack grows down on all architectures we support
+  pid_t pid = ::clone( &ForkSpawnEngine::vforkChild, stack.get() + stackSize, CLONE_VM | CLONE_VFORK | SIGCHLD, &data );
+  int cloneErrno = errno;
+
+  pthread_sigmask( SIG_SETMASK, &oldMask, nullptr );
+
+  // we return only after the child called exec or exited
+  errno = cloneErrno;
+  return pid;
+}
+
+int zyppng::ForkSpawnEngine::vforkChild( void *data )
+{
+  //////////////////////////////////////////////////////////////////////
+  // We share the memory of the parent, only async signal safe calls here,
+  // no allocations, no logging and no touching of the parents objects!
+  //////////////////////////////////////////////////////////////////////
+  const VForkData &d = *reinterpret_cast<VForkData *>( data );
+
+  const auto &writeErrAndExit = [&]( int errCode, ChildErrType type ){
+    ChildErr buf {
+      errno,
+      type
+    };
+    // a pipe write of this size is atomic
+    [[maybe_unused]] auto r = ::write( d.controlFd, &buf, sizeof(ChildErr) );
+    _exit ( errCode );
+  };
+
+  resetSignals();
+
+  if ( d.switchPgid )
+    setpgid( 0, 0);
+  if ( d.stdin_fd != -1 )
+    dup2 ( d.stdin_fd, 0); // set new stdin
+  if ( d.stdout_fd != -1 )
+    dup2 ( d.stdout_fd, 1); // set new stdout
+  if ( d.stderr_fd != -1 )
+    dup2 ( d.stderr_fd, 2); // set new stderr
+
+  if ( d.chroot && ::chroot( d.chroot ) == -1 )
+    writeErrAndExit( 128, ChildErrType::CHROOT_FAILED );
+
+  if ( d.chdirTo && ::chdir( d.chdirTo ) == -1 )
+    writeErrAndExit( 128, ChildErrType::CHDIR_FAILED );
+
+  // map the extra fds the user might have set
+  applyFdMapping( d.fdMapping );
+  closeFdsAbove( d.fdMapping._lastFdToKeep, d.controlFd );
+
+  if ( d.dieWithParent ) {
+    // process dies with us, ignore if it did not work
+    prctl( PR_SET_PDEATHSIG, SIGTERM );
+
+    // test in case the original parent exited just
+    // before the prctl() call
+    if ( getppid() != d.ppid )
+      _exit(128);
+  }
+
+  execvpe( d.argv[0], const_cast<char *const *>( d.argv ), d.envp.data() );
+  // don't want to get here
+  writeErrAndExit( 129, ChildErrType::EXEC_FAILED );
+  return 129;
+}
+
 bool zyppng::ForkSpawnEngine::usePty() const
 {
   return _use_pty;
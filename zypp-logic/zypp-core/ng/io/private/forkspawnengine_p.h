@@ -4,6 +4,9 @@
 #include "abstractspawnengine_p.h"
 #include <glib.h>
 
+#include <unistd.h>
+#include <utility>
+
 namespace zyppng {
 
   class AbstractDirectSpawnEngine : public AbstractSpawnEngine
@@ -15,13 +18,31 @@ namespace zyppng {
     bool waitForExit ( const std::optional<uint64_t> &timeout = {} ) override;
 
   protected:
+    /*!
+     * The dup2() calls needed to move the extra fds to STDERR_FILENO + 1 ... and the
+     * last fd that must stay open afterwards.
+     * Computed in the parent so the child does not need to allocate.
+     */
+    struct FdMapping {
+      std::vector<std::pair<int,int>> _dups;
+      int _lastFdToKeep = STDERR_FILENO;
+    };
+
+    FdMapping planExtraFds( int controlFd = -1 ) const;
+    static void applyFdMapping( const FdMapping &mapping );
+    static void closeFdsAbove( int lastFdToKeep, int controlFd = -1 );
+
     void mapExtraFds( int controlFd = -1 );
-    void resetSignals();
+    static void resetSignals();
   };
 
   /*!
     \internal
-    Process forking engine that's using the traditional fork() approach
+    Process forking engine that's using the traditional fork() approach.
+
+    If the kernel supports close_range(2) the child is started via a vfork like
+    clone(), which avoids copying the page tables of a possibly huge parent process.
+    The classic fork() is used for pty mode or if \c ZYPP_FORK_BACKEND is set to \c fork.
    */
   class ForkSpawnEngine : public AbstractDirectSpawnEngine
   {
@@ -31,6 +52,16 @@ namespace zyppng {
     void setUsePty ( const bool set = true );
 
   private:
+    struct VForkData;
+
+    /*!
+     * Starts the child via clone( CLONE_VM | CLONE_VFORK ), the parent's memory is
+     * not copied and the parent is suspended until the child called exec or exited.
+     * Returns the child pid or -1 and sets errno.
+     */
+    pid_t spawnVFork( VForkData &data );
+    static int vforkChild( void *data );
+
     /**
      * Set to true, if a pair of ttys is used for communication
      * instead of a pair of pipes.
@@ -55,7 +55,9 @@ namespace zyppng {
   {
     Z_D();
     if ( d->_spawnEngine->pid() >= 0 ) {
-      EventDispatcher::instance()->untrackChildProcess( d->_spawnEngine->pid() );
+      // the dispatcher might already be gone if the process outlived the loop
+      if ( auto ev = EventDispatcher::instance() )
+        ev->untrackChildProcess( d->_spawnEngine->pid() );
       DBG << "Process destroyed while still running removing from EventLoop." << std::endl;
     }
   }
@@ -163,7 +165,8 @@ namespace zyppng {
     Z_D();
     if ( d->_spawnEngine->isRunning() ) {
       // we will manually track the exit status
-      EventDispatcher::instance()->untrackChildProcess( d->_spawnEngine->pid() );
+      if ( auto ev = EventDispatcher::instance() )
+        ev->untrackChildProcess( d->_spawnEngine->pid() );
       // wait for the process to exit
       d->_spawnEngine->isRunning( true );
     }
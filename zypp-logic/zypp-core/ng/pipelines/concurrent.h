@@ -0,0 +1,201 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*/
+
+
+#ifndef ZYPP_ZYPPNG_MONADIC_CONCURRENT_H
+#define ZYPP_ZYPPNG_MONADIC_CONCURRENT_H
+
+#include <zypp-core/ng/meta/TypeTraits>
+#include <zypp-core/ng/base/cancellationtoken.h>
+#include <zypp-core/ng/pipelines/expected.h>
+#include <zypp-core/ng/pipelines/operators.h>
+#include <zypp-core/base/UserRequestException>
+
+namespace zyppng {
+
+  namespace detail {
+
+    /*!
+     * The result of a item that was not started because the operation was cancelled.
+     * Only \ref expected results can carry the error, for all others the exception is thrown.
+     */
+    template <typename Ret>
+    Ret concurrentCancelledResult() {
+      auto excp = ZYPP_EXCPT_PTR( zypp::AbortRequestException("Operation was cancelled") );
+      if constexpr ( is_instance_of_v<expected, Ret> )
+        return Ret::error( std::move(excp) );
+      else
+        std::rethrow_exception( excp );
+    }
+
+    template <typename Ret>
+    bool concurrentIsError( const Ret &res ) {
+      if constexpr ( is_instance_of_v<expected, Ret> )
+        return !res;
+      else
+        return false;
+    }
+
+    /*!
+     * Result of \ref for_each_concurrent: \c expected<void> if the items return \ref expected, \c void otherwise.
+     */
+    template <typename Ret>
+    using for_each_result_t = std::conditional_t< is_instance_of_v<expected, Ret>, expected<void>, void >;
+
+    template <typename ElementType, typename Fn, typename = void>
+    struct ConcurrentImpl;
+
+    /*!
+     * Synchronous items are simply executed one after the other.
+     */
+    template <typename ElementType, typename Fn, typename>
+    struct ConcurrentImpl {
+
+        using Ret = std::invoke_result_t<Fn, ElementType>;
+
+        template < template< class, class... > class Container,
+          typename ...CArgs >
+        static inline Container<Ret> whenAll( std::size_t, Container<ElementType, CArgs...>&& val, Fn &fn, const CancellationToken &token )
+        {
+          Container<Ret> res;
+          for ( auto &elem : val ) {
+            if ( token.cancelled() )
+              res.push_back( concurrentCancelledResult<Ret>() );
+            else
+              res.push_back( std::invoke( fn, std::move(elem) ) );
+          }
+          return res;
+        }
+
+        template < template< class, class... > class Container,
+          typename ...CArgs >
+        static inline for_each_result_t<Ret> forEach( std::size_t, Container<ElementType, CArgs...>&& val, Fn &fn, const CancellationToken &token )
+        {
+          for ( auto &elem : val ) {
+            if ( token.cancelled() )
+              return concurrentCancelledResult<for_each_result_t<Ret>>();
+
+            if constexpr ( std::is_void_v<for_each_result_t<Ret>> ) {
+              std::invoke( fn, std::move(elem) );
+            } else {
+              Ret res = std::invoke( fn, std::move(elem) );
+              if ( !res )
+                return expected<void>::error( res.error() );
+            }
+          }
+          if constexpr ( !std::is_void_v<for_each_result_t<Ret>> )
+            return expected<void>::success();
+        }
+    };
+
+  }
+
+  /*!
+   * Calls \a fn for each element of \a val, running at most \a limit of the
+   * returned asynchronous operations at the same time, and collects the results
+   * in input order.
+   *
+   * Errors of individual items are returned in their \ref expected result and do not
+   * stop the other items. If \a token is cancelled no further items are started,
+   * their result is a \ref zypp::AbortRequestException error (or the exception is
+   * thrown if the items do not return a \ref expected).
+   *
+   * \code
+   * auto r = std::move(infos)
+   *          | when_all_limited( 4, []( RepoInfo info ) -> MaybeAwaitable<expected<void>> { ... } );
+   * \endcode
+   *
+   * In synchronous code or if \a fn does not return an asynchronous operation,
+   * the items are executed one after the other.
+   */
+  template < template< class, class... > class Container,
+    typename Msg,
+    typename Transformation,
+    typename ...CArgs >
+  auto when_all_limited( std::size_t limit, Container<Msg, CArgs...>&& val, Transformation &&transformation, CancellationToken token = CancellationToken() )
+  {
+    using Impl = detail::ConcurrentImpl<Msg, std::decay_t<Transformation>>;
+    static_assert( !std::is_void_v<typename Impl::Ret>, "when_all_limited requires a result, use for_each_concurrent" );
+    return Impl::whenAll( std::max<std::size_t>( limit, 1 ), std::move(val), transformation, token );
+  }
+
+  /*!
+   * Calls \a fn for each element of \a val, running at most \a limit of the
+   * returned asynchronous operations at the same time. Items are started as
+   * soon as a slot becomes free and their results are not collected.
+   *
+   * If the items return \ref expected, the first error stops starting new
+   * items and is returned after the running items finished. Otherwise
+   * exceptions are propagated. If \a token is cancelled no further items are
+   * started and a \ref zypp::AbortRequestException is returned or thrown.
+   */
+  template < template< class, class... > class Container,
+    typename Msg,
+    typename Transformation,
+    typename ...CArgs >
+  auto for_each_concurrent( std::size_t limit, Container<Msg, CArgs...>&& val, Transformation &&transformation, CancellationToken token = CancellationToken() )
+  {
+    using Impl = detail::ConcurrentImpl<Msg, std::decay_t<Transformation>>;
+    return Impl::forEach( std::max<std::size_t>( limit, 1 ), std::move(val), transformation, token );
+  }
+
+  namespace operators {
+
+    namespace detail {
+      template <typename Transformation>
+      struct when_all_limited_helper {
+        std::size_t limit;
+        Transformation function;
+        CancellationToken token;
+
+        template< class Container >
+        auto operator()( Container&& arg ) {
+          return zyppng::when_all_limited( limit, std::forward<Container>(arg), function, token );
+        }
+      };
+
+      template <typename Transformation>
+      struct for_each_concurrent_helper {
+        std::size_t limit;
+        Transformation function;
+        CancellationToken token;
+
+        template< class Container >
+        auto operator()( Container&& arg ) {
+          return zyppng::for_each_concurrent( limit, std::forward<Container>(arg), function, token );
+        }
+      };
+    }
+
+    template <typename Transformation>
+    auto when_all_limited( std::size_t limit, Transformation&& transformation, CancellationToken token = CancellationToken() )
+    {
+      return detail::when_all_limited_helper<Transformation>{ limit, std::forward<Transformation>(transformation), std::move(token) };
+    }
+
+    template <typename Transformation>
+    auto for_each_concurrent( std::size_t limit, Transformation&& transformation, CancellationToken token = CancellationToken() )
+    {
+      return detail::for_each_concurrent_helper<Transformation>{ limit, std::forward<Transformation>(transformation), std::move(token) };
+    }
+  }
+
+}
+
+
+#ifdef ZYPP_ENABLE_ASYNC
+#include <zypp-core/ng/async/pipelines/concurrent.h>
+#endif
+
+
+#endif
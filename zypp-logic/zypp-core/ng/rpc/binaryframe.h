@@ -0,0 +1,118 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+-----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*
+*/
+
+#ifndef ZYPP_CORE_ZYPPNG_RPC_BINARYFRAME_H_INCLUDED
+#define ZYPP_CORE_ZYPPNG_RPC_BINARYFRAME_H_INCLUDED
+
+#include <zypp-core/ByteArray.h>
+#include <zypp-core/rpc/PluginFrameException.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace zyppng::rpc {
+
+  /*!
+   * Appends fixed size integers ( in network byte order ) and length prefixed
+   * strings to a \ref zypp::ByteArray. Used to build the frames of the binary
+   * RPC encoding, see \ref StompFrameStream::Binary.
+   */
+  class BinaryWriter
+  {
+  public:
+    BinaryWriter( zypp::ByteArray &target ) : _data( target ) { }
+
+    template <typename T>
+    void writeInt( T val ) {
+      static_assert( std::is_integral_v<T>, "writeInt only supports integral types" );
+      using U = std::make_unsigned_t<T>;
+      const U uval = static_cast<U>(val);
+      for ( int shift = ( sizeof(T) - 1 ) * 8; shift >= 0; shift -= 8 )
+        _data.push_back( static_cast<char>( ( uval >> shift ) & 0xFF ) );
+    }
+
+    /*!
+     * Writes \a str prefixed by its length as \a LenT
+     */
+    template <typename LenT = uint32_t>
+    void writeString( std::string_view str ) {
+      if ( str.size() > std::numeric_limits<LenT>::max() )
+        ZYPP_THROW( zypp::PluginFrameException( "Value exceeds the maximum length of a binary frame field" ) );
+      writeInt<LenT>( static_cast<LenT>( str.size() ) );
+      _data.insert( _data.end(), str.begin(), str.end() );
+    }
+
+    void writeRaw( const char *data, std::size_t len ) {
+      _data.insert( _data.end(), data, data + len );
+    }
+
+  private:
+    zypp::ByteArray &_data;
+  };
+
+  /*!
+   * Counterpart of \ref BinaryWriter, throws a \ref zypp::PluginFrameException
+   * if the data is truncated.
+   */
+  class BinaryReader
+  {
+  public:
+    BinaryReader( const char *data, std::size_t len ) : _data( data ), _len( len ) { }
+    BinaryReader( const zypp::ByteArray &data ) : BinaryReader( data.data(), data.size() ) { }
+
+    template <typename T>
+    T readInt() {
+      static_assert( std::is_integral_v<T>, "readInt only supports integral types" );
+      using U = std::make_unsigned_t<T>;
+      require( sizeof(T) );
+      U val = 0;
+      for ( std::size_t i = 0; i < sizeof(T); i++ )
+        val = static_cast<U>( ( val << 8 ) | static_cast<unsigned char>( _data[_pos++] ) );
+      return static_cast<T>(val);
+    }
+
+    template <typename LenT = uint32_t>
+    std::string readString() {
+      const auto len = readInt<LenT>();
+      require( len );
+      std::string res( _data + _pos, len );
+      _pos += len;
+      return res;
+    }
+
+    std::size_t remaining() const {
+      return _len - _pos;
+    }
+
+    const char *current() const {
+      return _data + _pos;
+    }
+
+  private:
+    void require( std::size_t bytes ) const {
+      if ( remaining() < bytes )
+        ZYPP_THROW( zypp::PluginFrameException( "Binary frame is truncated" ) );
+    }
+
+    const char *_data;
+    std::size_t _len;
+    std::size_t _pos = 0;
+  };
+
+}
+
+#endif // ZYPP_CORE_ZYPPNG_RPC_BINARYFRAME_H_INCLUDED
@@ -8,6 +8,7 @@
 ----------------------------------------------------------------------*/
 
 #include "stompframestream.h"
+#include "binaryframe.h"
 #include <zypp-core/ByteCount.h>
 #include <zypp-core/ng/core/string.h>
 
@@ -20,6 +21,68 @@ namespace zyppng {
   constexpr auto MAX_HDRLEN  = 8 * 1024;    // we might send long paths in headers
   constexpr auto MAX_BODYLEN = 1024 * 1024; // 1Mb for now, we do not want to use up all the memory
 
+  // binary frames carry their length up front, so we do not need to buffer while scanning for
+  // terminators. Like STOMP frames with a content-length we allow large bodies, but a length
+  // this big is most likely garbage on the line
+  constexpr uint32_t MAX_BINFRAMELEN = 64 * MAX_BODYLEN;
+
+  /*
+   * Layout of a binary frame, all integers in network byte order:
+   *
+   * uint32 length of the frame, not including this field
+   * uint16 length of the command, followed by the command
+   * uint16 number of headers, followed by the headers:
+   *   uint16 length of the key, followed by the key
+   *   uint32 length of the value, followed by the value
+   * the rest of the frame is the body
+   */
+  namespace {
+    zypp::ByteArray encodeBinaryFrame( const zypp::PluginFrame &frame )
+    {
+      zypp::ByteArray payload;
+      rpc::BinaryWriter w( payload );
+      w.writeString<uint16_t>( frame.command() );
+
+      const auto &headers = frame.headerList();
+      if ( headers.size() > std::numeric_limits<uint16_t>::max() )
+        ZYPP_THROW( zypp::PluginFrameException( "Too many headers for a binary frame" ) );
+
+      w.writeInt<uint16_t>( static_cast<uint16_t>( headers.size() ) );
+      for ( const auto &[key, value] : headers ) {
+        w.writeString<uint16_t>( key );
+        w.writeString<uint32_t>( value );
+      }
+
+      const auto &body = frame.body();
+      w.writeRaw( body.data(), body.size() );
+
+      if ( payload.size() > MAX_BINFRAMELEN )
+        ZYPP_THROW( zypp::PluginFrameException( "Message exceeds the maximum length of a binary frame" ) );
+
+      zypp::ByteArray res;
+      res.reserve( payload.size() + sizeof(uint32_t) );
+      rpc::BinaryWriter lenW( res );
+      lenW.writeInt<uint32_t>( static_cast<uint32_t>( payload.size() ) );
+      lenW.writeRaw( payload.data(), payload.size() );
+      return res;
+    }
+
+    zypp::PluginFrame decodeBinaryFrame( const zypp::ByteArray &payload )
+    {
+      rpc::BinaryReader r( payload );
+      zypp::PluginFrame frame( r.readString<uint16_t>() );
+
+      const auto hdrCount = r.readInt<uint16_t>();
+      for ( uint16_t i = 0; i < hdrCount; i++ ) {
+        auto key = r.readString<uint16_t>();
+        frame.addHeader( key, r.readString<uint32_t>() );
+      }
+
+      frame.setBody( zypp::ByteArray( r.current(), r.current() + r.remaining() ) );
+      return frame;
+    }
+  }
+
   InvalidMessageReceivedException::InvalidMessageReceivedException( const std::string &msg )
     : zypp::Exception( zypp::str::Str() << "Invalid Message received: (" << msg <<")" )
   { }
@@ -34,8 +97,69 @@ namespace zyppng {
       readAllMessages ();
   }
 
+  StompFrameStream::StompFrameStream( FrameQueue::Ptr recv, FrameQueue::Ptr send )
+    : _recvQueue( std::move(recv) )
+    , _sendQueue( std::move(send) )
+  {
+    connect( *_nextMessageTimer, &Timer::sigExpired, *this, &StompFrameStream::timeout );
+    _nextMessageTimer->setSingleShot(false);
+
+    _recvWatch = AsyncQueueWatch::create( _recvQueue );
+    connect( *_recvWatch, &AsyncQueueWatch::sigMessageAvailable, *this, &StompFrameStream::queueReady );
+    readAllMessages ();
+  }
+
+  StompFrameStream::~StompFrameStream()
+  {
+    // never leave a in process peer waiting for frames that will not come
+    close();
+  }
+
+  void StompFrameStream::close()
+  {
+    if ( !_sendQueue || _closed )
+      return;
+    _closed = true;
+    _sendQueue->push( std::optional<zypp::PluginFrame>() );
+  }
+
+  void StompFrameStream::takeQueuedFrames()
+  {
+    bool gotFrames = false;
+    while ( !_peerClosed ) {
+      auto frame = _recvQueue->tryPop();
+      if ( !frame )
+        break;
+      if ( !*frame ) {
+        _peerClosed = true;
+        break;
+      }
+      _messages.emplace_back( std::move(**frame) );
+      gotFrames = true;
+    }
+
+    if ( gotFrames ) {
+      _sigNextMessage.emit ();
+      if ( _messages.size() )
+        _nextMessageTimer->start(0);
+    }
+  }
+
+  void StompFrameStream::queueReady()
+  {
+    takeQueuedFrames();
+    // reported from the event loop only, so user code never sees the signal while it pulls messages
+    if ( _peerClosed && !_closedEmitted ) {
+      _closedEmitted = true;
+      _sigClosed.emit();
+    }
+  }
+
   bool StompFrameStream::readNextMessage( )
   {
+    if ( _encoding == Binary )
+      return readNextBinaryMessage();
+
     const auto &parseError = [this](){
       _parserState = ParseError;
       _pendingMessage.reset();
@@ -201,10 +325,108 @@ namespace zyppng {
           // once we have a message, exit the loop so other things can be done
           return true;
         }
+
+        case ReceiveFrameLength:
+        case ReceiveFrame: {
+          // only used by the binary parser, we switched encodings
+          _parserState = ReceiveCommand;
+          break;
+        }
       }
     }
   }
 
+  bool StompFrameStream::readNextBinaryMessage()
+  {
+    while ( true ) {
+      switch( _parserState ) {
+        case ParseError: {
+          // there is no terminator we could sync to, all data that follows is garbage
+          const auto dropped = _ioDev->readAll();
+          if ( dropped.size() )
+            WAR << "Dropped " << dropped.size() << " bytes after a invalid binary frame" << std::endl;
+          return false;
+        }
+
+        case ReceiveFrameLength: {
+          if ( _ioDev->bytesAvailable() < static_cast<int64_t>( sizeof(uint32_t) ) )
+            return false;
+
+          const auto lenBytes = _ioDev->read( sizeof(uint32_t) );
+          const auto len = rpc::BinaryReader( lenBytes ).readInt<uint32_t>();
+          if ( len > MAX_BINFRAMELEN ) {
+            ERR << "Received malformed message from peer, binary frame length exceeds: " << zypp::ByteCount( MAX_BINFRAMELEN ) << std::endl;
+            _parserState = ParseError;
+            _sigInvalidMessageReceived.emit();
+            continue;
+          }
+
+          _pendingBodyLen = len;
+          _parserState = ReceiveFrame;
+          break;
+        }
+
+        case ReceiveFrame: {
+          if ( _ioDev->bytesAvailable() < *_pendingBodyLen )
+            return false;
+
+          const auto payload = _ioDev->read( *_pendingBodyLen );
+          _pendingBodyLen.reset();
+          _parserState = ReceiveFrameLength;
+
+          try {
+            _messages.emplace_back( decodeBinaryFrame( payload ) );
+          } catch ( const zypp::Exception &e ) {
+            ZYPP_CAUGHT(e);
+            ERR << "Received malformed binary frame from peer (" << e << ")" << std::endl;
+            // the frame length was valid, so we can continue with the next frame
+            _sigInvalidMessageReceived.emit();
+            continue;
+          }
+
+          _sigNextMessage.emit ();
+
+          if ( _messages.size() ) {
+            // nag the user code until all messages have been used up
+            _nextMessageTimer->start(0);
+          }
+          return true;
+        }
+
+        case ReceiveCommand:
+        case ReceiveHeaders:
+        case ReceiveBody: {
+          // only used by the STOMP parser, we switched encodings
+          _parserState = ReceiveFrameLength;
+          break;
+        }
+      }
+    }
+  }
+
+  StompFrameStream::Encoding StompFrameStream::encoding() const
+  {
+    return _encoding;
+  }
+
+  void StompFrameStream::setEncoding( Encoding enc )
+  {
+    if ( _encoding == enc )
+      return;
+
+    if ( _pendingMessage || _pendingBodyLen )
+      WAR << "Switching the message encoding while receiving a frame, dropping it" << std::endl;
+
+    _pendingMessage.reset();
+    _pendingBodyLen.reset();
+    _encoding = enc;
+    _parserState = ( enc == Binary ? ReceiveFrameLength : ReceiveCommand );
+
+    // the peer might have sent frames in the new encoding already
+    if ( _ioDev && _ioDev->isOpen() && _ioDev->canRead() )
+      readAllMessages();
+  }
+
   void StompFrameStream::timeout(const Timer &)
   {
     if ( _messages.size() )
@@ -270,6 +492,29 @@ namespace zyppng {
     }));
 
     const bool hasMsgName = msgName.size();
+
+    if ( _recvQueue ) {
+      while ( true ) {
+        if ( _messages.size() ) {
+          if ( !hasMsgName )
+            break;
+          std::optional<zypp::PluginFrame> msg = nextMessage(msgName);
+          if ( msg ) return msg;
+        }
+
+        if ( _peerClosed )
+          return {};
+
+        auto frame = _recvQueue->pop();
+        if ( !frame ) {
+          _peerClosed = true;
+          return {};
+        }
+        _messages.emplace_back( std::move(*frame) );
+      }
+      return nextMessage (msgName);
+    }
+
     while ( !receivedInvalidMsg && _ioDev->isOpen() && _ioDev->canRead() ) {
       if ( _messages.size() ) {
         if ( hasMsgName ) {
@@ -291,9 +536,28 @@ namespace zyppng {
 
   bool zyppng::StompFrameStream::sendFrame( const zypp::PluginFrame &env )
   {
+    if ( _sendQueue ) {
+      // the peer lives in this process, hand over the frame itself
+      if ( _closed || _peerClosed )
+        return false;
+      _sendQueue->push( std::optional<zypp::PluginFrame>( env ) );
+      return true;
+    }
+
     if ( !_ioDev->canWrite () )
       return false;
 
+    if ( _encoding == Binary ) {
+      try {
+        const auto &data = encodeBinaryFrame( env );
+        return ( _ioDev->write( data ) == static_cast<int64_t>( data.size() ) );
+      } catch ( const zypp::Exception &e ) {
+        ZYPP_CAUGHT(e);
+        ERR << "Failed to serialize binary message: " << e << std::endl;
+        return false;
+      }
+    }
+
     try {
       IODeviceOStreamBuf ostrbuf(_ioDev);
       std::ostream output(&ostrbuf);
@@ -317,8 +581,18 @@ namespace zyppng {
     return _sigInvalidMessageReceived;
   }
 
+  SignalProxy<void ()> StompFrameStream::sigClosed()
+  {
+    return _sigClosed;
+  }
+
   void StompFrameStream::readAllMessages()
   {
+    if ( _recvQueue ) {
+      takeQueuedFrames();
+      return;
+    }
+
     bool cont = true;
     while ( cont && _ioDev->bytesAvailable() ) {
       cont = readNextMessage ();
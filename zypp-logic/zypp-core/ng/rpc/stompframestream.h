@@ -21,7 +21,9 @@
 #include <zypp-core/ng/base/Signals>
 #include <zypp-core/ng/base/Timer>
 #include <zypp-core/ng/io/IODevice>
+#include <zypp-core/ng/thread/AsyncQueue>
 #include <zypp-core/ng/pipelines/expected.h>
+#include <zypp-core/ng/meta/type_traits.h>
 
 #include <zypp-core/rpc/PluginFrame.h>
 
@@ -40,13 +42,46 @@ namespace zyppng {
 
   namespace rpc {
 
+    /*!
+     * Value of the content-type header of frames whose body carries a message
+     * in the typed binary encoding, see \ref toBinaryMessage
+     */
+    constexpr std::string_view BinaryContentType( "application/x-zypp-rpc" );
+    constexpr std::string_view ContentTypeHeader( "content-type" );
+
+    inline bool isBinaryMessage( const zypp::PluginFrame &message ) {
+      return message.getHeaderNT( std::string(ContentTypeHeader) ) == BinaryContentType;
+    }
+
+    template <typename T>
+    using has_binary_message_t = decltype( std::declval<const T&>().toBinaryMessage() );
+
+    template <typename T>
+    using has_from_binary_message_t = decltype( T::fromBinaryMessage( std::declval<const zypp::PluginFrame &>() ) );
+
     template <typename T>
     expected<zypp::PluginFrame> toStompMessage( const T& msg ) {
       return msg.toStompMessage();
     }
 
+    /*!
+     * Serializes \a msg with typed fields into the body of the frame, if T does not
+     * implement a binary encoding the STOMP representation is used.
+     */
+    template <typename T>
+    expected<zypp::PluginFrame> toBinaryMessage( const T& msg ) {
+      if constexpr ( std::is_detected_v<has_binary_message_t, T> )
+        return msg.toBinaryMessage();
+      else
+        return msg.toStompMessage();
+    }
+
     template <typename T>
     expected<T> fromStompMessage( const zypp::PluginFrame &message ) {
+      if constexpr ( std::is_detected_v<has_from_binary_message_t, T> ) {
+        if ( isBinaryMessage( message ) )
+          return T::fromBinaryMessage( message );
+      }
       return T::fromStompMessage( message );
     }
 
@@ -104,6 +139,14 @@ namespace zyppng {
    *
    * Implements the basic protocol for sending zypp RPC messages over a IODevice
    * using the STOMP frame format as message type.
+   *
+   * Both sides can agree to switch to the \ref Binary encoding, which sends the frames
+   * length prefixed instead of scanning for line ends and terminators. Messages implementing
+   * \a toBinaryMessage additionally keep the types of their fields, so they do not need to be
+   * converted to strings and back.
+   *
+   * Two streams in the same process can also be connected by a pair of \ref FrameQueue, the
+   * frames are then handed over as they are, without encoding them at all.
    */
   class ZYPP_API StompFrameStream : public zyppng::Base
   {
@@ -111,6 +154,17 @@ namespace zyppng {
 
       using Ptr = StompFrameStreamRef;
 
+      /*!
+       * One direction of a in process connection. A empty optional is queued as end marker
+       * when the sending side closes the connection.
+       */
+      using FrameQueue = AsyncQueue<std::optional<zypp::PluginFrame>>;
+
+      enum Encoding {
+        Stomp,  //< Text STOMP frames, understood by all peers
+        Binary  //< Length prefixed frames, only used if both sides negotiated it
+      };
+
       /*!
        * Uses the given iostream to send and receive messages.
        * If the device is already open and readable tries to read messages right away.
@@ -120,6 +174,28 @@ namespace zyppng {
         return Ptr( new StompFrameStream( std::move(iostr) ) );
       }
 
+      /*!
+       * Connects to a peer in the same process, frames are taken from \a recv and passed to
+       * the peer through \a send. Needs to be created on the thread that reads \a recv,
+       * the stream is woken up by the EventDispatcher of that thread.
+       */
+      static Ptr create( FrameQueue::Ptr recv, FrameQueue::Ptr send ) {
+        return Ptr( new StompFrameStream( std::move(recv), std::move(send) ) );
+      }
+
+      ~StompFrameStream() override;
+
+      /*!
+       * Closes a in process connection, the peer receives \ref sigClosed once it handled
+       * all frames sent before. Does nothing for streams on a IODevice, close the device instead.
+       */
+      void close();
+
+      /*!
+       * Emitted when the peer closed a in process connection.
+       */
+      SignalProxy<void()> sigClosed();
+
       /*!
        * Returns the next message in the queue, wait for the \ref sigMessageReceived signal
        * to know when new messages have arrived.
@@ -143,13 +219,25 @@ namespace zyppng {
        */
       bool sendFrame ( const zypp::PluginFrame &message );
 
+      /*!
+       * The encoding used to send and receive frames, defaults to \ref Stomp.
+       */
+      Encoding encoding() const;
+
+      /*!
+       * Switches the encoding for all following frames. Both sides need to switch at the same
+       * point in the message flow, e.g. right after the capabilities exchange, before the peer
+       * sends a frame in the new encoding.
+       */
+      void setEncoding( Encoding enc );
+
       template <typename T>
       bool sendMessage ( const T &message )
       {
         if constexpr ( std::is_same_v<T, zypp::PluginFrame> ) {
           return sendFrame( message );
         } else {
-          const auto &msg = rpc::toStompMessage(message);
+          const auto &msg = ( _encoding == Binary ? rpc::toBinaryMessage(message) : rpc::toStompMessage(message) );
           if ( !msg ) {
             ERR << "Failed to serialize message" << std::endl;
             return false;
@@ -182,24 +270,40 @@ namespace zyppng {
 
     private:
       StompFrameStream( IODevice::Ptr iostr );
+      StompFrameStream( FrameQueue::Ptr recv, FrameQueue::Ptr send );
       bool readNextMessage ();
+      void takeQueuedFrames ();
+      void queueReady ();
+      bool readNextBinaryMessage ();
       void timeout( const zyppng::Timer &);
 
       enum ParserState {
         ReceiveCommand,
         ReceiveHeaders,
         ReceiveBody,
+        ReceiveFrameLength, //< Binary encoding only
+        ReceiveFrame,       //< Binary encoding only
         ParseError
       } _parserState = ReceiveCommand;
 
+      Encoding _encoding = Stomp;
+
       std::optional<zypp::PluginFrame> _pendingMessage;
       std::optional<int64_t> _pendingBodyLen;
 
       IODevice::Ptr _ioDev;
+      FrameQueue::Ptr _recvQueue;   //< only set for in process connections
+      FrameQueue::Ptr _sendQueue;
+      std::shared_ptr<AsyncQueueWatch> _recvWatch;
+      bool _closed = false;         //< we sent the end marker
+      bool _peerClosed = false;     //< we received the end marker
+      bool _closedEmitted = false;
+
       Timer::Ptr _nextMessageTimer = Timer::create();
       std::deque<zypp::PluginFrame> _messages;
       Signal<void()> _sigNextMessage;
       Signal<void()> _sigInvalidMessageReceived;
+      Signal<void()> _sigClosed;
 
   };
 }
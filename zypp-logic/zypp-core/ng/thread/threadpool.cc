@@ -0,0 +1,255 @@
+#include "threadpool.h"
+#include "wakeup.h"
+
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/Exception.h>
+#include <zypp-core/base/String.h>
+#include <zypp-core/ng/base/EventDispatcher>
+#include <zypp-core/ng/base/SocketNotifier>
+#include <zypp-core/ng/base/private/threaddata_p.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zyppng {
+
+  class LoopInvoker::Impl
+  {
+  public:
+    void post( std::function<void()> &&fn ) {
+      {
+        std::lock_guard lk( _lock );
+        if ( !_alive )
+          return;
+        _queue.push_back( std::move(fn) );
+      }
+      _wakeup.notify();
+    }
+
+    void run() {
+      _wakeup.ack();
+      std::vector<std::function<void()>> queue;
+      {
+        std::lock_guard lk( _lock );
+        queue.swap( _queue );
+      }
+      for ( auto &fn : queue )
+        fn();
+    }
+
+    void shutdown() {
+      std::lock_guard lk( _lock );
+      _alive = false;
+      _queue.clear();
+    }
+
+    Wakeup _wakeup;
+
+  private:
+    std::mutex _lock;
+    std::vector<std::function<void()>> _queue;
+    bool _alive = true;
+  };
+
+  LoopInvoker::LoopInvoker()
+    : _pimpl( std::make_unique<Impl>() )
+  { }
+
+  LoopInvoker::~LoopInvoker()
+  { }
+
+  LoopInvoker::Ptr LoopInvoker::current()
+  {
+    struct Holder {
+      ~Holder() {
+        if ( invoker )
+          invoker->_pimpl->shutdown();
+      }
+      LoopInvoker::Ptr invoker;
+      std::weak_ptr<EventDispatcher> dispatcher;
+      std::shared_ptr<SocketNotifier> notifier;
+    };
+    thread_local Holder holder;
+
+    auto ev = EventDispatcher::instance();
+    if ( !ev )
+      ZYPP_THROW( zypp::Exception( "LoopInvoker requires a EventDispatcher in the current thread" ) );
+
+    if ( !holder.invoker )
+      holder.invoker = Ptr( new LoopInvoker() );
+
+    // a new event loop was created since the last call, watch the wakeup there
+    if ( holder.dispatcher.lock() != ev ) {
+      holder.dispatcher = ev;
+      holder.notifier = holder.invoker->_pimpl->_wakeup.makeNotifier();
+      holder.notifier->connectFunc( &SocketNotifier::sigActivated, [ impl = holder.invoker->_pimpl.get() ]( const SocketNotifier &, int ) {
+        impl->run();
+      });
+      // pick up functions posted while no loop was watching
+      holder.invoker->_pimpl->_wakeup.notify();
+    }
+    return holder.invoker;
+  }
+
+  void LoopInvoker::post( std::function<void ()> &&fn )
+  {
+    _pimpl->post( std::move(fn) );
+  }
+
+
+  class ThreadPool::Impl
+  {
+  public:
+    struct Worker {
+      std::mutex _lock;
+      std::deque<Job> _jobs;
+      std::thread _thread;
+    };
+
+    Impl( unsigned threads ) {
+      if ( threads == 0 )
+        threads = std::max( 1U, std::thread::hardware_concurrency() );
+
+      _workers.reserve( threads );
+      for ( unsigned i = 0; i < threads; ++i )
+        _workers.push_back( std::make_unique<Worker>() );
+      for ( unsigned i = 0; i < threads; ++i )
+        _workers[i]->_thread = std::thread( [this, i](){ workerMain( i ); } );
+      MIL << "ThreadPool started with " << threads << " workers" << std::endl;
+    }
+
+    ~Impl() {
+      {
+        std::lock_guard lk( _sleepLock );
+        _stop = true;
+      }
+      _sleepCv.notify_all();
+      for ( auto &w : _workers )
+        w->_thread.join();
+    }
+
+    void post( Job &&job ) {
+      // jobs posted by our own workers stay local, others are distributed
+      unsigned idx = ( _tlPool == this ) ? _tlIndex : _next.fetch_add( 1, std::memory_order_relaxed ) % _workers.size();
+      // count first, so a worker picking the job up right away never sees a negative count
+      _pending.fetch_add( 1 );
+      {
+        std::lock_guard lk( _workers[idx]->_lock );
+        _workers[idx]->_jobs.push_back( std::move(job) );
+      }
+
+      // the sleep lock is only needed if somebody sleeps. A worker going to sleep registers
+      // before it checks _pending, so either it sees our job or we see it sleeping
+      if ( _sleepers.load() > 0 ) {
+        std::lock_guard lk( _sleepLock );
+        _sleepCv.notify_one();
+      }
+    }
+
+    unsigned size() const {
+      return _workers.size();
+    }
+
+  private:
+    bool popLocal( unsigned idx, Job &job ) {
+      Worker &w = *_workers[idx];
+      std::lock_guard lk( w._lock );
+      if ( w._jobs.empty() )
+        return false;
+      job = std::move( w._jobs.back() );
+      w._jobs.pop_back();
+      return true;
+    }
+
+    bool steal( unsigned idx, Job &job ) {
+      for ( unsigned i = 1; i < _workers.size(); ++i ) {
+        Worker &w = *_workers[ (idx + i) % _workers.size() ];
+        std::lock_guard lk( w._lock );
+        if ( w._jobs.empty() )
+          continue;
+        job = std::move( w._jobs.front() );
+        w._jobs.pop_front();
+        return true;
+      }
+      return false;
+    }
+
+    void workerMain( unsigned idx ) {
+      _tlPool  = this;
+      _tlIndex = idx;
+      ThreadData::current().setName( zypp::str::Str() << "zypp-pool-" << idx );
+
+      while ( true ) {
+        Job job;
+        if ( popLocal( idx, job ) || steal( idx, job ) ) {
+          _pending.fetch_sub( 1 );
+          try {
+            job();
+          } catch ( const std::exception &e ) {
+            ERR << "Uncaught exception in ThreadPool job: " << e.what() << std::endl;
+          } catch ( ... ) {
+            ERR << "Uncaught exception in ThreadPool job" << std::endl;
+          }
+          continue;
+        }
+
+        std::unique_lock lk( _sleepLock );
+        _sleepers.fetch_add( 1 );
+        _sleepCv.wait( lk, [this](){ return _stop || _pending.load() > 0; } );
+        _sleepers.fetch_sub( 1 );
+        if ( _stop && _pending.load() == 0 )
+          return;
+      }
+    }
+
+  private:
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<unsigned> _next = 0;
+
+    std::atomic<std::size_t> _pending = 0;  ///< posted but not yet started jobs
+    std::atomic<unsigned> _sleepers = 0;    ///< workers in or about to enter the idle wait
+
+    std::mutex _sleepLock;                  ///< only taken on the idle path
+    std::condition_variable _sleepCv;
+    bool _stop = false;                     ///< guarded by _sleepLock
+
+    static thread_local Impl *_tlPool;
+    static thread_local unsigned _tlIndex;
+  };
+
+  thread_local ThreadPool::Impl *ThreadPool::Impl::_tlPool = nullptr;
+  thread_local unsigned ThreadPool::Impl::_tlIndex = 0;
+
+  ThreadPool::ThreadPool( unsigned threads )
+    : _pimpl( std::make_unique<Impl>( threads ) )
+  { }
+
+  ThreadPool::~ThreadPool()
+  { }
+
+  ThreadPool &ThreadPool::global()
+  {
+    static ThreadPool _global( [](){
+      unsigned threads = 0;
+      if ( const char *env = ::getenv( "ZYPP_THREADPOOL_SIZE" ); env && *env )
+        threads = zypp::str::strtonum<unsigned>( env );
+      return threads;
+    }() );
+    return _global;
+  }
+
+  void ThreadPool::post( Job &&job )
+  {
+    _pimpl->post( std::move(job) );
+  }
+
+  unsigned ThreadPool::size() const
+  {
+    return _pimpl->size();
+  }
+
+}
@@ -0,0 +1,115 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------*/
+#ifndef ZYPP_NG_THREAD_THREADPOOL_H_INCLUDED
+#define ZYPP_NG_THREAD_THREADPOOL_H_INCLUDED
+
+#include <zypp-core/Globals.h>
+#include <zypp-core/ng/base/cancellationtoken.h>
+
+#include <functional>
+#include <memory>
+
+namespace zyppng {
+
+  /*!
+   * A queue of functions that are executed by the event loop of the thread
+   * that created it. Functions can be posted from any thread, the owning thread
+   * is woken up via a \ref Wakeup.
+   *
+   * This is the way back from a \ref ThreadPool worker to the code that
+   * offloaded the job.
+   *
+   * \note The owning thread must run a \ref EventDispatcher.
+   */
+  class ZYPP_API LoopInvoker
+  {
+  public:
+    using Ptr = std::shared_ptr<LoopInvoker>;
+
+    /*!
+     * Returns the invoker of the calling thread, creates it on first use.
+     * The invoker stops executing functions when the thread ends, functions
+     * posted afterwards are dropped.
+     */
+    static Ptr current();
+
+    /*!
+     * Queues \a fn to be executed by the owning threads event loop.
+     * Can be called from any thread.
+     */
+    void post( std::function<void()> &&fn );
+
+    ~LoopInvoker();
+    LoopInvoker(const LoopInvoker &) = delete;
+    LoopInvoker &operator=(const LoopInvoker &) = delete;
+
+  private:
+    LoopInvoker();
+    class Impl;
+    std::unique_ptr<Impl> _pimpl;
+  };
+
+  /*!
+   * A work stealing pool of worker threads for CPU bound jobs like
+   * parsing, hashing or signature checks that would otherwise block
+   * the event loop.
+   *
+   * Each worker owns a job queue. Jobs posted from a worker are queued there
+   * and executed LIFO for cache locality, jobs posted from other threads are
+   * distributed round robin. Idle workers steal the oldest job from the other
+   * queues.
+   *
+   * Jobs must not block on other jobs of the same pool. Exceptions escaping a
+   * job are logged and dropped, use \ref zyppng::offload to get the result of a
+   * job back into a coroutine or pipeline.
+   *
+   * \sa zyppng::offload
+   */
+  class ZYPP_API ThreadPool
+  {
+  public:
+    using Job = std::function<void()>;
+
+    /*!
+     * Starts \a threads workers, \c 0 uses one per available CPU.
+     */
+    explicit ThreadPool( unsigned threads = 0 );
+
+    /*!
+     * Executes all pending jobs and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /*!
+     * The process wide pool used by \ref zyppng::offload, created on first use.
+     * The number of workers can be limited via \c $ZYPP_THREADPOOL_SIZE.
+     */
+    static ThreadPool &global();
+
+    /*!
+     * Queues \a job to be executed by one of the workers.
+     */
+    void post( Job &&job );
+
+    /*!
+     * Number of worker threads.
+     */
+    unsigned size() const;
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> _pimpl;
+  };
+
+}
+
+#endif // ZYPP_NG_THREAD_THREADPOOL_H_INCLUDED
@@ -84,6 +84,7 @@ zypp_add_sources( zypp_base_HEADERS
   base/LogControl.h
   base/LogTools.h
   base/Logger.h
+  base/Metrics.h
   base/NonCopyable.h
   base/ProfilingFormater.h
   base/ProvideNumericId
@@ -95,6 +96,7 @@ zypp_add_sources( zypp_base_HEADERS
   base/simplestreambuf.h
   base/String.h
   base/StringV.h
+  base/Trace.h
   base/TypeTraits.h
   base/Unit.h
   base/UserRequestException
@@ -113,11 +115,13 @@ zypp_add_sources( zypp_base_SRCS
   base/IOStream.cc
   base/IOTools.cc
   base/LogControl.cc
+  base/Metrics.cc
   base/ProfilingFormater.cc
   base/ReferenceCounted.cc
   base/Regex.cc
   base/String.cc
   base/StringV.cc
+  base/Trace.cc
   base/Unit.cc
   base/userrequestexception.cc
   base/Xml.cc
@@ -142,11 +146,13 @@ endif()
 
 
 zypp_add_sources( zypp_fs_SRCS
+  fs/BulkIO.cc
   fs/PathInfo.cc
   fs/TmpPath.cc
 )
 
 zypp_add_sources( zypp_fs_HEADERS
+  fs/BulkIO.h
   fs/PathInfo.h
   fs/TmpPath.h
   fs/WatchFile
@@ -256,6 +262,7 @@ zypp_add_sources( zyppng_async_HEADERS
 zypp_add_sources( zyppng_base_SRCS
   ng/base/abstracteventsource.cc
   ng/base/base.cc
+  ng/base/eventdispatcher_epoll.cc
   ng/base/eventdispatcher_glib.cc
   ng/base/eventloop_glib.cc
   ng/base/linuxhelpers.cc
@@ -273,6 +280,7 @@ zypp_add_sources( zyppng_base_HEADERS
   ng/base/autodisconnect.h
   ng/base/Base
   ng/base/base.h
+  ng/base/cancellationtoken.h
   ng/base/EventDispatcher
   ng/base/eventdispatcher.h
   ng/base/EventLoop
@@ -293,6 +301,7 @@ zypp_add_sources( zyppng_base_HEADERS
 zypp_add_sources( zyppng_base_private_HEADERS
   ng/base/private/abstracteventsource_p.h
   ng/base/private/base_p.h
+  ng/base/private/eventdispatcher_epoll_p.h
   ng/base/private/eventdispatcher_glib_p.h
   ng/base/private/eventloop_glib_p.h
   ng/base/private/linuxhelpers_p.h
@@ -356,6 +365,8 @@ zypp_add_sources( zyppng_meta_HEADERS
 zypp_add_sources( zyppng_pipelines_HEADERS
   ng/pipelines/Algorithm
   ng/pipelines/algorithm.h
+  ng/pipelines/Concurrent
+  ng/pipelines/concurrent.h
   ng/pipelines/Expected
   ng/pipelines/expected.h
   ng/pipelines/Lift
@@ -370,6 +381,7 @@ zypp_add_sources( zyppng_pipelines_HEADERS
 )
 
 zypp_add_sources( zyppng_rpc_HEADERS
+  ng/rpc/binaryframe.h
   ng/rpc/stompframestream.h
 )
 
@@ -379,6 +391,7 @@ zypp_add_sources( zyppng_rpc_SRCS
 
 zypp_add_sources( zyppng_thread_SRCS
   ng/thread/asyncqueue.cc
+  ng/thread/threadpool.cc
   ng/thread/wakeup.cpp
 )
 
@@ -386,6 +399,8 @@ zypp_add_sources( zyppng_thread_HEADERS
   ng/thread/AsyncQueue
   ng/thread/asyncqueue.h
   ng/thread/private/asyncqueue_p.h
+  ng/thread/ThreadPool
+  ng/thread/threadpool.h
   ng/thread/Wakeup
   ng/thread/wakeup.h
 )
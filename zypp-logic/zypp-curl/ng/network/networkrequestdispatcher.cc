@@ -16,6 +16,8 @@
 #include <zypp-core/ng/base/EventDispatcher>
 #include <zypp-curl/private/curlhelper_p.h>
 #include <assert.h>
+#include <array>
+#include <mutex>
 
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/String.h>
@@ -43,6 +45,44 @@ static const std::string & defaultAgentString()
   return _value;
 }
 
+namespace {
+  /*!
+   * The DNS cache and the TLS session cache shared by all requests of the process. A connection
+   * opened by one dispatcher, e.g. while warming up, makes the next one to the same host cheaper
+   * for all others. Connections themselves can not be shared, dispatchers might live in different threads.
+   */
+  struct SharedCurlData
+  {
+    SharedCurlData()
+      : _share( curl_share_init() )
+    {
+      if ( !_share )
+        return;
+      curl_share_setopt( _share, CURLSHOPT_LOCKFUNC, &SharedCurlData::lock );
+      curl_share_setopt( _share, CURLSHOPT_UNLOCKFUNC, &SharedCurlData::unlock );
+      curl_share_setopt( _share, CURLSHOPT_USERDATA, this );
+      curl_share_setopt( _share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS );
+      curl_share_setopt( _share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION );
+    }
+
+    static void lock( CURL *, curl_lock_data data, curl_lock_access, void *userptr )
+    { static_cast<SharedCurlData *>( userptr )->_locks[ data ].lock(); }
+
+    static void unlock( CURL *, curl_lock_data data, void *userptr )
+    { static_cast<SharedCurlData *>( userptr )->_locks[ data ].unlock(); }
+
+    CURLSH *_share;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> _locks;
+  };
+
+  CURLSH *sharedCurlData()
+  {
+    // never freed, easy handles might still use it while static objects are destroyed
+    static SharedCurlData *data = new SharedCurlData();
+    return data->_share;
+  }
+}
+
 
 NetworkRequestDispatcherPrivate::NetworkRequestDispatcherPrivate(  NetworkRequestDispatcher &p  )
     : BasePrivate( p )
@@ -328,6 +368,9 @@ void NetworkRequestDispatcherPrivate::setFinished( NetworkRequest &req, NetworkR
 
 bool NetworkRequestDispatcherPrivate::addRequestToMultiHandle(NetworkRequest &req)
 {
+  if ( auto share = sharedCurlData() )
+    curl_easy_setopt( req.d_func()->_easyHandle, CURLOPT_SHARE, share );
+
   CURLMcode rc = curl_multi_add_handle( _multi, req.d_func()->_easyHandle );
   if ( rc != 0 ) {
     setFinished( req, NetworkRequestErrorPrivate::fromCurlMError( rc ) );
@@ -447,6 +490,28 @@ void NetworkRequestDispatcher::enqueue(const std::shared_ptr<NetworkRequest> &re
   d->dequeuePending();
 }
 
+void NetworkRequestDispatcher::preconnect( const Url &url, const TransferSettings &settings )
+{
+  if ( !supportsProtocol( url ) )
+    return;
+
+  // only the connection matters, the path is not requested
+  Url hostUrl( url );
+  hostUrl.setPathName( "/" );
+  hostUrl.setQueryString( std::string() );
+
+  auto req = std::make_shared<NetworkRequest>( hostUrl, "/dev/null" );
+  req->setOptions( NetworkRequest::ConnectionTest );
+  req->transferSettings() = settings;
+  req->sigFinished().connect( []( NetworkRequest &r, const NetworkRequestError &err ) {
+    if ( err.isError() )
+      MIL << "Warming up the connection to " << r.url().getHost() << " failed: " << err.toString() << std::endl;
+    else
+      MIL << "Warmed up the connection to " << r.url().getHost() << std::endl;
+  });
+  enqueue( req );
+}
+
 void NetworkRequestDispatcher::setAgentString( const std::string &agent )
 {
   Z_D();
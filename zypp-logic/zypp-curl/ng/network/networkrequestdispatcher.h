@@ -10,6 +10,7 @@
 
 #include <zypp-curl/ng/network/networkrequesterror.h>
 #include <zypp-curl/ng/network/HttpHeader>
+#include <zypp-curl/ng/network/TransferSettings>
 
 namespace zyppng {
 
@@ -108,6 +109,15 @@ namespace zyppng {
        */
       void enqueue ( const std::shared_ptr<NetworkRequest> &req );
 
+      /*!
+       * Enqueues a request that only resolves and connects to the host of \a url, including
+       * the TLS handshake, without transferring any data. The DNS and TLS session caches are
+       * shared by all dispatchers of the process, so later requests to the same host, from
+       * this or any other dispatcher, can skip the name lookup and resume the TLS session.
+       * The result of the request is only logged, failures do not affect other requests.
+       */
+      void preconnect ( const Url &url, const TransferSettings &settings = TransferSettings() );
+
       /*!
        * Changes the agent header valur to \a agent.
        */
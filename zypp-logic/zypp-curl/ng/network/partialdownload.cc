@@ -0,0 +1,241 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------*/
+#include "partialdownload.h"
+#include <zypp-curl/ng/network/request.h>
+#include <zypp-curl/parser/mediablocklist.h>
+#include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/Errno.h>
+#include <zypp-core/base/String.h>
+
+#include <fstream>
+#include <vector>
+
+#include <unistd.h>
+
+namespace zyppng {
+
+  namespace {
+    constexpr std::string_view SizeKey( "size" );
+    constexpr std::string_view ChecksumTypeKey( "checksum_type" );
+    constexpr std::string_view ChecksumKey( "checksum" );
+    constexpr std::string_view ETagKey( "etag" );
+    constexpr std::string_view LastModifiedKey( "last_modified" );
+  }
+
+  PartialDownload::PartialDownload( zypp::Pathname file_r, zypp::ByteCount expectedSize_r, zypp::CheckSum expectedChecksum_r )
+    : _file( std::move(file_r) )
+    , _expectedSize( std::move(expectedSize_r) )
+    , _expectedChecksum( std::move(expectedChecksum_r) )
+  { }
+
+  zypp::Pathname PartialDownload::resumeFile() const
+  {
+    return _file.extend( ".resume" );
+  }
+
+  zypp::ByteCount PartialDownload::prepare( const zypp::media::MediaBlockList *blocks_r )
+  {
+    _offset = 0;
+    _saved  = false;
+
+    const zypp::PathInfo pi( _file );
+    if ( !pi.isFile() || pi.size() == 0 ) {
+      discard();
+      return _offset;
+    }
+
+    if ( !load() ) {
+      MIL << "No usable resume data for " << _file << ", starting over" << std::endl;
+      discard();
+      return _offset;
+    }
+
+    zypp::ByteCount::SizeType keep = pi.size();
+    // a complete file would have been moved to its target already, we can not tell what is wrong with it
+    if ( _expectedSize && keep >= zypp::ByteCount::SizeType(_expectedSize) ) {
+      MIL << "Partial download " << _file << " is not smaller than the expected size, starting over" << std::endl;
+      discard();
+      return _offset;
+    }
+
+    if ( blocks_r )
+      keep = verifiedSize( *blocks_r, keep );
+
+    if ( keep == 0 ) {
+      MIL << "No verified data in " << _file << ", starting over" << std::endl;
+      discard();
+      return _offset;
+    }
+
+    if ( keep < pi.size() && ::truncate( _file.c_str(), keep ) != 0 ) {
+      WAR << "Failed to cut " << _file << " to the verified data: " << zypp::Errno() << std::endl;
+      discard();
+      return _offset;
+    }
+
+    _offset = keep;
+    _saved  = true;
+    MIL << "Continuing download of " << _file << " at " << _offset << std::endl;
+    return _offset;
+  }
+
+  void PartialDownload::setupRequest( NetworkRequest &req ) const
+  {
+    req.transferSettings().removeHeader( "If-Range" );
+    if ( !_offset )
+      return;
+
+    req.setFileOpenMode( NetworkRequest::WriteShared );
+    req.resetRequestRanges();
+    req.addRequestRange( zypp::ByteCount::SizeType(_offset) );
+
+    // a weak ETag must not be used for If-Range, the checksum catches a changed file in that case
+    if ( haveStrongETag() )
+      req.transferSettings().addHeader( "If-Range: " + _etag );
+    else if ( !_lastModified.empty() )
+      req.transferSettings().addHeader( "If-Range: " + _lastModified );
+  }
+
+  bool PartialDownload::save( const NetworkRequest &req )
+  {
+    if ( !req.responseETag().empty() )
+      _etag = req.responseETag();
+    if ( !req.responseLastModified().empty() )
+      _lastModified = req.responseLastModified();
+    return save();
+  }
+
+  bool PartialDownload::save()
+  {
+    _saved = false;
+    if ( _file.empty() )
+      return false;
+
+    if ( !haveStrongETag() && _lastModified.empty() && _expectedChecksum.empty() ) {
+      DBG << "Download of " << _file << " can not be validated, it will not be continued" << std::endl;
+      zypp::filesystem::unlink( resumeFile() );
+      return false;
+    }
+
+    const zypp::Pathname tmp( resumeFile().extend( ".new" ) );
+    {
+      std::ofstream out( tmp.c_str() );
+      out << SizeKey << ": " << zypp::ByteCount::SizeType(_expectedSize) << "\n";
+      if ( !_expectedChecksum.empty() ) {
+        out << ChecksumTypeKey << ": " << _expectedChecksum.type() << "\n";
+        out << ChecksumKey << ": " << _expectedChecksum.checksum() << "\n";
+      }
+      if ( !_etag.empty() )
+        out << ETagKey << ": " << _etag << "\n";
+      if ( !_lastModified.empty() )
+        out << LastModifiedKey << ": " << _lastModified << "\n";
+      if ( !out.flush() ) {
+        WAR << "Failed to write " << tmp << std::endl;
+        zypp::filesystem::unlink( tmp );
+        return false;
+      }
+    }
+
+    if ( zypp::filesystem::rename( tmp, resumeFile() ) != 0 ) {
+      zypp::filesystem::unlink( tmp );
+      return false;
+    }
+    _saved = true;
+    return true;
+  }
+
+  void PartialDownload::finish()
+  {
+    zypp::filesystem::unlink( resumeFile() );
+    _offset = 0;
+    _saved  = false;
+  }
+
+  void PartialDownload::discard()
+  {
+    if ( _file.empty() )
+      return;
+    zypp::filesystem::unlink( _file );
+    finish();
+  }
+
+  bool PartialDownload::load()
+  {
+    std::ifstream in( resumeFile().c_str() );
+    if ( !in )
+      return false;
+
+    zypp::ByteCount::SizeType size = 0;
+    std::string sumType;
+    std::string sum;
+    std::string etag;
+    std::string lastModified;
+
+    for ( std::string line; std::getline( in, line ); ) {
+      const auto sep = line.find( ": " );
+      if ( sep == std::string::npos )
+        continue;
+      const std::string_view key( line.data(), sep );
+      std::string value( line.substr( sep + 2 ) );
+      if ( key == SizeKey )
+        size = zypp::str::strtonum<zypp::ByteCount::SizeType>( value );
+      else if ( key == ChecksumTypeKey )
+        sumType = std::move(value);
+      else if ( key == ChecksumKey )
+        sum = std::move(value);
+      else if ( key == ETagKey )
+        etag = std::move(value);
+      else if ( key == LastModifiedKey )
+        lastModified = std::move(value);
+    }
+
+    // the data must belong to the file the caller asks for now
+    if ( size != zypp::ByteCount::SizeType(_expectedSize) )
+      return false;
+    if ( _expectedChecksum.empty() ? !sum.empty()
+         : ( zypp::str::toLower( sumType ) != zypp::str::toLower( _expectedChecksum.type() )
+             || zypp::str::toLower( sum ) != zypp::str::toLower( _expectedChecksum.checksum() ) ) )
+      return false;
+
+    _etag = std::move(etag);
+    _lastModified = std::move(lastModified);
+    return ( haveStrongETag() || !_lastModified.empty() || !_expectedChecksum.empty() );
+  }
+
+  zypp::ByteCount::SizeType PartialDownload::verifiedSize( const zypp::media::MediaBlockList &blocks_r, zypp::ByteCount::SizeType size_r ) const
+  {
+    if ( !blocks_r.haveBlocks() || !blocks_r.haveChecksum( 0 ) )
+      return size_r;
+
+    std::ifstream in( _file.c_str(), std::ios::binary );
+    std::vector<unsigned char> buf;
+    zypp::ByteCount::SizeType good = 0;
+
+    for ( size_t blkno = 0; blkno < blocks_r.numBlocks(); blkno++ ) {
+      const auto &blk = blocks_r.getBlock( blkno );
+      if ( blk.off != off_t(good) || good + blk.size > size_r || !blocks_r.haveChecksum( blkno ) )
+        break;
+
+      buf.resize( blk.size );
+      if ( !in.read( reinterpret_cast<char *>( buf.data() ), blk.size ) || !blocks_r.checkChecksum( blkno, buf.data(), buf.size() ) ) {
+        MIL << "Block " << blkno << " of " << _file << " does not match its checksum" << std::endl;
+        break;
+      }
+      good += blk.size;
+    }
+    return good;
+  }
+
+  bool PartialDownload::haveStrongETag() const
+  {
+    return ( !_etag.empty() && !zypp::str::hasPrefix( _etag, "W/" ) );
+  }
+
+}
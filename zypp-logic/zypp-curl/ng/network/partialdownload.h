@@ -0,0 +1,143 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*
+*/
+#ifndef ZYPPNG_CURL_PARTIALDOWNLOAD_H_INCLUDED
+#define ZYPPNG_CURL_PARTIALDOWNLOAD_H_INCLUDED
+
+#include <zypp-core/Pathname.h>
+#include <zypp-core/ByteCount.h>
+#include <zypp-core/CheckSum.h>
+
+#include <string>
+
+namespace zypp::media {
+  class MediaBlockList;
+}
+
+namespace zyppng {
+
+  class NetworkRequest;
+
+  /*!
+   * Keeps the data of a interrupted download, so a later attempt can continue
+   * where the last one stopped instead of starting over.
+   *
+   * The data stays in the download target, a small file next to it ( see \ref resumeFile )
+   * stores the validators making sure it still belongs to the same remote file: the
+   * expected size and checksum given by the caller and the \c ETag and \c Last-Modified
+   * headers sent by the server. A download is only kept if it can be validated, which
+   * means the server sent a strong \c ETag or a \c Last-Modified header, or the caller
+   * knows the checksum of the complete file.
+   *
+   * The continued request asks for the remaining data with a \c If-Range header, if the
+   * file changed on the server it answers with the full file and the request fails with
+   * \ref NetworkRequestError::RangeFail. The caller is expected to \ref discard the data
+   * and start over in that case.
+   *
+   * \code
+   * PartialDownload partial( stagingFile, expectedSize, expectedChecksum );
+   * partial.prepare();           // checks what is left from the last attempt
+   * partial.setupRequest( req ); // asks for the missing data only
+   * ...
+   * partial.save( req );         // once the first data was received
+   * \endcode
+   */
+  class PartialDownload
+  {
+  public:
+    PartialDownload() = default;
+    PartialDownload( zypp::Pathname file_r, zypp::ByteCount expectedSize_r = zypp::ByteCount(), zypp::CheckSum expectedChecksum_r = zypp::CheckSum() );
+
+    const zypp::Pathname &file() const
+    { return _file; }
+
+    /*!
+     * The file storing the validators, \c <file>.resume
+     */
+    zypp::Pathname resumeFile() const;
+
+    /*!
+     * Checks the data left by a earlier attempt against the stored validators and returns
+     * the number of bytes that can be kept. If \a blocks_r has block checksums the data is
+     * verified block by block and cut after the last good block. Data that can not be reused
+     * is removed.
+     */
+    zypp::ByteCount prepare( const zypp::media::MediaBlockList *blocks_r = nullptr );
+
+    /*!
+     * The number of bytes the download continues at, \c 0 if it starts over.
+     */
+    zypp::ByteCount offset() const
+    { return _offset; }
+
+    bool resuming() const
+    { return _offset > 0; }
+
+    /*!
+     * Makes \a req request the missing data only, if \ref prepare found data to continue with.
+     * Otherwise a \c If-Range header left from a earlier attempt is removed.
+     * \note Call this after the \ref TransferSettings were assigned to the request.
+     */
+    void setupRequest( NetworkRequest &req ) const;
+
+    /*!
+     * Stores the validators sent by the server with the response to \a req. Returns \c false
+     * if the download can not be continued later, the caller should remove the data when
+     * it fails.
+     */
+    bool save( const NetworkRequest &req );
+
+    /*!
+     * Stores the current validators, see \ref save( const NetworkRequest & )
+     */
+    bool save();
+
+    /*!
+     * Whether the validators were stored by \ref save and the data should be kept if the download fails.
+     */
+    bool saved() const
+    { return _saved; }
+
+    /*!
+     * Removes the stored validators once the download was completed.
+     */
+    void finish();
+
+    /*!
+     * Removes the data and the stored validators, the next attempt starts over.
+     */
+    void discard();
+
+    void setETag( std::string etag_r )
+    { _etag = std::move(etag_r); }
+
+    void setLastModified( std::string lastModified_r )
+    { _lastModified = std::move(lastModified_r); }
+
+  private:
+    bool load();
+    zypp::ByteCount::SizeType verifiedSize( const zypp::media::MediaBlockList &blocks_r, zypp::ByteCount::SizeType size_r ) const;
+    bool haveStrongETag() const;
+
+    zypp::Pathname _file;
+    zypp::ByteCount _expectedSize;
+    zypp::CheckSum _expectedChecksum;
+    std::string _etag;
+    std::string _lastModified;
+    zypp::ByteCount _offset;
+    bool _saved = false;
+  };
+
+}
+
+#endif // ZYPPNG_CURL_PARTIALDOWNLOAD_H_INCLUDED
@@ -120,6 +120,8 @@ namespace zyppng {
     NetworkRequest::Priority            _priority = NetworkRequest::Normal;
 
     std::string _lastRedirect;	///< to log/report redirections
+    std::string _responseETag;         ///< ETag header of the last response
+    std::string _responseLastModified; ///< Last-Modified header of the last response
     zypp::Pathname _currentCookieFile = "/var/lib/YaST2/cookies";
 
     void *_easyHandle = nullptr; // the easy handle that controlling this request
@@ -186,6 +188,9 @@ namespace zyppng {
     };
 
     std::variant< pending_t, running_t, prepareNextRangeBatch_t, finished_t > _runningMode = pending_t();
+
+  private:
+    void updateMetrics( const finished_t &resState ) const;
   };
 }
 
@@ -21,6 +21,7 @@
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/StringV.h>
 #include <zypp-core/base/IOTools.h>
+#include <zypp-core/base/Metrics.h>
 #include <zypp-core/Pathname.h>
 #include <curl/curl.h>
 #include <stdio.h>
@@ -475,8 +476,11 @@ namespace zyppng {
       m._activityTimer->start( static_cast<uint64_t>( _settings.timeout() * 1000 ) );
     }
 
-    if ( !isRangeContinuation )
+    if ( !isRangeContinuation ) {
+      _responseETag.clear();
+      _responseLastModified.clear();
       _sigStarted.emit( *z_func() );
+    }
   }
 
   void NetworkRequestPrivate::dequeueNotify()
@@ -488,6 +492,22 @@ namespace zyppng {
     }
   }
 
+  void NetworkRequestPrivate::updateMetrics( const finished_t &resState ) const
+  {
+    static zypp::metrics::Counter & requests { zypp::metrics::counter( "network.requests" ) };
+    static zypp::metrics::Counter & failed   { zypp::metrics::counter( "network.requests.failed" ) };
+    requests.inc();
+    if ( resState._result.type() != NetworkRequestError::NoError )
+      failed.inc();
+
+    // per mirror
+    const std::string & host { _url.getHost() };
+    zypp::metrics::counter( "network.bytes." + host ).inc( resState._downloaded );
+    curl_off_t totalTime = 0;
+    if ( curl_easy_getinfo( _easyHandle, CURLINFO_TOTAL_TIME_T, &totalTime ) == CURLE_OK )
+      zypp::metrics::histogram( "network.request." + host ).observe( std::uint64_t(totalTime) );
+  }
+
   void NetworkRequestPrivate::setResult( NetworkRequestError &&err )
   {
     finished_t resState;
@@ -514,7 +534,8 @@ namespace zyppng {
             } else {
               constexpr size_t bufSize = 4096;
               char buf[bufSize];
-              while( auto cnt = fread(buf, 1, bufSize, rmode._outFile ) > 0 ) {
+              size_t cnt = 0;
+              while( ( cnt = fread(buf, 1, bufSize, rmode._outFile ) ) > 0 ) {
                 _fileVerification->_fileDigest.update(buf, cnt);
               }
             }
@@ -536,6 +557,7 @@ namespace zyppng {
       }
 
       rmode._outFile.reset();
+      updateMetrics( resState );
     }
 
     _runningMode = std::move( resState );
@@ -587,7 +609,7 @@ namespace zyppng {
     NetworkRequestPrivate *that = reinterpret_cast<NetworkRequestPrivate *>( clientp );
 
     if ( !std::holds_alternative<running_t>(that->_runningMode) ){
-      DBG << that->_easyHandle << " " << "Curl progress callback was called in invalid state "<< that->z_func()->state() << std::endl;
+      lDBG << that->_easyHandle << " " << "Curl progress callback was called in invalid state "<< that->z_func()->state() << std::endl;
       return -1;
     }
     auto &rmode = std::get<running_t>( that->_runningMode );
@@ -625,7 +647,7 @@ namespace zyppng {
         hdr = std::string_view();
 
       if ( !std::holds_alternative<running_t>(_runningMode) ){
-        DBG << _easyHandle << " " << "Curl headerfunction callback was called in invalid state "<< z_func()->state() << std::endl;
+        lDBG << _easyHandle << " " << "Curl headerfunction callback was called in invalid state "<< z_func()->state() << std::endl;
         return -1;
       }
       auto &rmode = std::get<running_t>( _runningMode );
@@ -648,16 +670,26 @@ namespace zyppng {
         if( statuscode == 204 && !( _options & NetworkRequest::ConnectionTest ) && !( _options & NetworkRequest::HeadRequest ) )
           assertOutputFile();
 
+        // validators of a redirect response do not describe the file
+        _responseETag.clear();
+        _responseLastModified.clear();
+
+      } else if ( zypp::strv::hasPrefixCI( hdr, "ETag:" ) ) {
+        _responseETag = str::trim( hdr.substr( 5 ), zypp::str::TRIM );
+
+      } else if ( zypp::strv::hasPrefixCI( hdr, "Last-Modified:" ) ) {
+        _responseLastModified = str::trim( hdr.substr( 14 ), zypp::str::TRIM );
+
       } else if ( zypp::strv::hasPrefixCI( hdr, "Location:" ) ) {
         _lastRedirect = hdr.substr( 9 );
-        DBG << _easyHandle << " " << "redirecting to " << _lastRedirect << std::endl;
+        lDBG << _easyHandle << " " << "redirecting to " << _lastRedirect << std::endl;
 
       } else if ( zypp::strv::hasPrefixCI( hdr, "Content-Length:") )  {
         auto lenStr = str::trim( hdr.substr( 15 ), zypp::str::TRIM );
         auto str = std::string ( lenStr.data(), lenStr.length() );
         auto len = zypp::str::strtonum<typename zypp::ByteCount::SizeType>( str.data() );
         if ( len > 0 ) {
-          DBG << _easyHandle << " " << "Got Content-Length Header: " << len << std::endl;
+          lDBG << _easyHandle << " " << "Got Content-Length Header: " << len << std::endl;
           rmode._contentLenght = zypp::ByteCount(len, zypp::ByteCount::B);
         }
       }
@@ -680,7 +712,7 @@ namespace zyppng {
     }
 
     if ( !std::holds_alternative<running_t>(_runningMode) ){
-      DBG << _easyHandle << " " << "Curl writefunction callback was called in invalid state "<< z_func()->state() << std::endl;
+      lDBG << _easyHandle << " " << "Curl writefunction callback was called in invalid state "<< z_func()->state() << std::endl;
       return -1;
     }
     auto &rmode = std::get<running_t>( _runningMode );
@@ -823,6 +855,11 @@ namespace zyppng {
     if ( state() == Running )
       return false;
 
+    if ( expected.empty() ) {
+      d->_fileVerification.reset();
+      return true;
+    }
+
     zypp::Digest fDig;
     if ( !fDig.create( expected.type () ) )
       return false;
@@ -869,6 +906,16 @@ namespace zyppng {
     return d_func()->_lastRedirect;
   }
 
+  const std::string &NetworkRequest::responseETag() const
+  {
+    return d_func()->_responseETag;
+  }
+
+  const std::string &NetworkRequest::responseLastModified() const
+  {
+    return d_func()->_responseLastModified;
+  }
+
   void *NetworkRequest::nativeHandle() const
   {
     return d_func()->_easyHandle;
@@ -995,6 +1042,19 @@ namespace zyppng {
     return d_func()->_settings;
   }
 
+  void NetworkRequest::setMaxDownloadSpeed( long bytesPerSecond )
+  {
+    Z_D();
+    d->_settings.setMaxDownloadSpeed( bytesPerSecond );
+#if CURLVERSION_AT_LEAST(7,15,5)
+    // libcurl checks the limit while receiving, so it can be changed on a running transfer
+    if ( state() == Running && d->_easyHandle ) {
+      if ( curl_easy_setopt( d->_easyHandle, CURLOPT_MAX_RECV_SPEED_LARGE, curl_off_t(bytesPerSecond) ) != CURLE_OK )
+        WAR << d->_easyHandle << " Failed to change the download speed limit" << std::endl;
+    }
+#endif
+  }
+
   NetworkRequest::State NetworkRequest::state() const
   {
     return std::visit([this](auto& arg) {
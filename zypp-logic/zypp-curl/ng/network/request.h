@@ -134,7 +134,7 @@ namespace zyppng {
     void addRequestRange ( Range &&range );
 
     /*!
-     * Sets the expected checksum for the full file.
+     * Sets the expected checksum for the full file, an empty checksum disables the check.
      * \note This will not change a running download
      */
     bool setExpectedFileChecksum( const zypp::CheckSum &expected );
@@ -153,6 +153,18 @@ namespace zyppng {
      */
     const std::string &lastRedirectInfo() const;
 
+    /*!
+     * Returns the value of the \c ETag header of the last response, empty if the
+     * server did not send one.
+     */
+    const std::string &responseETag() const;
+
+    /*!
+     * Returns the value of the \c Last-Modified header of the last response, empty if the
+     * server did not send one.
+     */
+    const std::string &responseLastModified() const;
+
     /*!
      * Returns a pointer to the native CURL easy handle
      *
@@ -231,6 +243,12 @@ namespace zyppng {
      */
     TransferSettings &transferSettings ();
 
+    /*!
+     * Changes the maximum download speed in bytes per second, \a 0 means no limit.
+     * Unlike the other \ref transferSettings this also applies to a already running request.
+     */
+    void setMaxDownloadSpeed ( long bytesPerSecond );
+
     /**
      * Returns the current state the \a HttpDownloadRequest is in
      */
@@ -11,6 +11,7 @@
 */
 
 #include "transfersettings.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -138,6 +139,15 @@ namespace zypp
     void TransferSettings::addHeader( std::string && val_r )
     { _impl->safeAddHeader( std::move(val_r) ); }
 
+    void TransferSettings::removeHeader( const std::string & name_r )
+    {
+      const std::string prefix { name_r + ":" };
+      auto &headers = _impl->_headers;
+      headers.erase( std::remove_if( headers.begin(), headers.end(), [&]( const std::string &hdr ) {
+        return str::hasPrefixCI( hdr, prefix );
+      }), headers.end() );
+    }
+
     const TransferSettings::Headers &TransferSettings::headers() const
     {
       //@TODO check if we could use a vector of std::string_view here
@@ -49,6 +49,9 @@ namespace zypp
       void addHeader( std::string && val_r );
       void addHeader( const std::string & val_r );
 
+      /** remove all headers with the field name \a name_r (case insensitive) */
+      void removeHeader( const std::string & name_r );
+
       /** returns a list of all added headers (trimmed) */
       const Headers &headers() const;
 
@@ -81,6 +81,7 @@ zypp_add_sources( zypp_curl_ng_network_SRCS
   ng/network/curlmultiparthandler.cc
   ng/network/networkrequestdispatcher.cc
   ng/network/networkrequesterror.cc
+  ng/network/partialdownload.cc
   ng/network/request.cc
 )
 
@@ -94,6 +95,8 @@ zypp_add_sources( zypp_curl_ng_network_HEADERS
   ng/network/networkrequestdispatcher.h
   ng/network/NetworkRequestError
   ng/network/networkrequesterror.h
+  ng/network/PartialDownload
+  ng/network/partialdownload.h
   ng/network/rangedesc.h
   ng/network/Request
   ng/network/request.h
@@ -13,6 +13,10 @@
 #include "mediaconfig.h"
 #include <zypp-core/Pathname.h>
 #include <zypp-core/base/String.h>
+#include <zypp-core/TriBool.h>
+
+#include <iterator>
+#include <set>
 
 namespace zypp {
 
@@ -26,6 +30,14 @@ namespace zypp {
       , download_max_silent_tries	( 1 )
       , download_transfer_timeout	( 180 )
       , download_connect_timeout        ( 60 )
+      , download_resume_partial         ( true )
+      , download_warm_up_connections    ( true )
+      , provide_warm_workers            ( 2 )
+      , provide_warm_worker_timeout     ( 30 )
+      , provide_inprocess_workers       ( true )
+      , provide_binary_rpc              ( true )
+      , provide_max_download_speed      ( 0 )
+      , provide_shared_cache_size       ( 2048 )
     { }
 
     Pathname credentials_global_dir_path;
@@ -37,6 +49,17 @@ namespace zypp {
     int download_max_silent_tries;
     int download_transfer_timeout;
     int download_connect_timeout;
+    bool download_resume_partial;
+    bool download_warm_up_connections;
+
+    int provide_warm_workers;
+    int provide_warm_worker_timeout;
+    bool provide_inprocess_workers;
+    std::set<std::string> provide_inprocess_schemes;	// if not empty only these
+    bool provide_binary_rpc;
+    long provide_max_download_speed;
+    Pathname provide_shared_cache_path;
+    long provide_shared_cache_size;
 
   };
 
@@ -87,6 +110,58 @@ namespace zypp {
         if ( d->download_transfer_timeout < 0 )		d->download_transfer_timeout = 0;
         else if ( d->download_transfer_timeout > 3600 )	d->download_transfer_timeout = 3600;
         return true;
+
+      } else if ( entry == "download.resume_partial" ) {
+        d->download_resume_partial = str::strToBool( value, d->download_resume_partial );
+        return true;
+
+      } else if ( entry == "download.warm_up_connections" ) {
+        d->download_warm_up_connections = str::strToBool( value, d->download_warm_up_connections );
+        return true;
+
+      } else if ( entry == "provide.warm_workers" ) {
+        str::strtonum(value, d->provide_warm_workers);
+        if ( d->provide_warm_workers < 0 )		d->provide_warm_workers = 0;
+        else if ( d->provide_warm_workers > 10 )	d->provide_warm_workers = 10;
+        return true;
+
+      } else if ( entry == "provide.warm_worker_timeout" ) {
+        str::strtonum(value, d->provide_warm_worker_timeout);
+        if ( d->provide_warm_worker_timeout < 1 )
+          d->provide_warm_worker_timeout = 1;
+        return true;
+
+      } else if ( entry == "provide.inprocess_workers" ) {
+        // either a boolean or the list of worker schemes to run in process
+        const TriBool enabled = str::strToTriBool( value );
+        d->provide_inprocess_schemes.clear();
+        if ( indeterminate( enabled ) ) {
+          str::split( value, std::inserter( d->provide_inprocess_schemes, d->provide_inprocess_schemes.end() ), ", \t" );
+          d->provide_inprocess_workers = !d->provide_inprocess_schemes.empty();
+        } else {
+          d->provide_inprocess_workers = bool(enabled);
+        }
+        return true;
+
+      } else if ( entry == "provide.binary_rpc" ) {
+        d->provide_binary_rpc = str::strToBool( value, d->provide_binary_rpc );
+        return true;
+
+      } else if ( entry == "provide.max_download_speed" ) {
+        str::strtonum(value, d->provide_max_download_speed);
+        if ( d->provide_max_download_speed < 0 )
+          d->provide_max_download_speed = 0;
+        return true;
+
+      } else if ( entry == "provide.shared_cache_path" ) {
+        d->provide_shared_cache_path = Pathname(value);
+        return true;
+
+      } else if ( entry == "provide.shared_cache_size" ) {
+        str::strtonum(value, d->provide_shared_cache_size);
+        if ( d->provide_shared_cache_size < 1 )
+          d->provide_shared_cache_size = 1;
+        return true;
       }
     }
     return false;
@@ -124,6 +199,37 @@ namespace zypp {
   long MediaConfig::download_connect_timeout() const
   { return d_func()->download_connect_timeout; }
 
+  bool MediaConfig::download_resume_partial() const
+  { return d_func()->download_resume_partial; }
+
+  bool MediaConfig::download_warm_up_connections() const
+  { return d_func()->download_warm_up_connections; }
+
+  long MediaConfig::provide_warm_workers() const
+  { return d_func()->provide_warm_workers; }
+
+  long MediaConfig::provide_warm_worker_timeout() const
+  { return d_func()->provide_warm_worker_timeout; }
+
+  bool MediaConfig::provide_inprocess_workers( const std::string &scheme ) const
+  {
+    Z_D();
+    return d->provide_inprocess_workers
+           && ( d->provide_inprocess_schemes.empty() || d->provide_inprocess_schemes.count( scheme ) );
+  }
+
+  bool MediaConfig::provide_binary_rpc() const
+  { return d_func()->provide_binary_rpc; }
+
+  long MediaConfig::provide_max_download_speed() const
+  { return d_func()->provide_max_download_speed; }
+
+  Pathname MediaConfig::provide_shared_cache_path() const
+  { return d_func()->provide_shared_cache_path; }
+
+  long MediaConfig::provide_shared_cache_size() const
+  { return d_func()->provide_shared_cache_size; }
+
   ZYPP_IMPL_PRIVATE(MediaConfig)
 }
 
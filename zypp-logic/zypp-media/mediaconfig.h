@@ -90,6 +90,60 @@ namespace zypp {
      */
     long download_connect_timeout() const;
 
+    /*!
+     * Whether the data of interrupted downloads is kept, so the download can be
+     * continued later instead of starting over.
+     */
+    bool download_resume_partial() const;
+
+    /*!
+     * Whether the connections to the mirrors of the repositories a resolved
+     * transaction downloads from are opened in the background, while the
+     * transaction is waiting to be confirmed.
+     */
+    bool download_warm_up_connections() const;
+
+    /*!
+     * Number of worker processes per expected worker type (http, dir) the
+     * zyppng Provide API keeps started ahead of time. \c 0 disables prestarting.
+     */
+    long provide_warm_workers() const;
+
+    /*!
+     * Time in seconds after which unused prestarted Provide workers are stopped.
+     */
+    long provide_warm_worker_timeout() const;
+
+    /*!
+     * Whether the zyppng Provide API runs the worker for \a scheme on a thread
+     * instead of a separate process. Only the workers of local schemes
+     * (dir, disk, copy) can run in process, others are never affected.
+     */
+    bool provide_inprocess_workers( const std::string &scheme ) const;
+
+    /*!
+     * Whether the zyppng Provide API offers the binary message encoding to
+     * its workers. Workers not supporting it keep using STOMP frames.
+     */
+    bool provide_binary_rpc() const;
+
+    /*!
+     * Maximum download speed in bytes per second shared by all downloads
+     * of a zyppng Provide instance. \c 0 means no limit.
+     */
+    long provide_max_download_speed() const;
+
+    /*!
+     * Directory of the content addressed \ref SharedFileCache, downloaded files with
+     * a known checksum are stored there and reused by other processes. Empty if disabled.
+     */
+    Pathname provide_shared_cache_path() const;
+
+    /*!
+     * Size limit of the \ref SharedFileCache in MiB.
+     */
+    long provide_shared_cache_size() const;
+
   private:
     MediaConfig();
     std::unique_ptr<MediaConfigPrivate> d_ptr;
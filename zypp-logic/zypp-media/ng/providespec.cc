@@ -81,6 +81,8 @@ namespace zyppng
 
     bool _mirrorsAllowed = true;
 
+    ProvideFileSpec::Priority _priority = ProvideFileSpec::Normal;
+
   public:
     /** Offer default Impl. */
     static zypp::shared_ptr<Impl> nullimpl()
@@ -275,6 +277,12 @@ namespace zyppng
   ProvideFileSpec &ProvideFileSpec::setMirrorsAllowed(bool set)
   { _pimpl->_mirrorsAllowed = std::move(set); return *this; }
 
+  ProvideFileSpec::Priority ProvideFileSpec::priority() const
+  { return _pimpl->_priority; }
+
+  ProvideFileSpec &ProvideFileSpec::setPriority( Priority prio )
+  { _pimpl->_priority = prio; return *this; }
+
   HeaderValueMap &ProvideFileSpec::customHeaders()
   { return _pimpl->_customHeaders; }
 
@@ -97,6 +97,17 @@ namespace zyppng
     friend std::ostream & dumpOn( std::ostream &str, const ProvideFileSpec &obj );
 
   public:
+    /*!
+     * Scheduling class of a request, \ref Provide dispatches requests with a higher
+     * priority before the ones with a lower priority. Requests of the same
+     * priority are dispatched in the order they were queued.
+     */
+    enum Priority {
+      Low,    //< e.g. delta rpms and source packages
+      Normal, //< packages, the default
+      High    //< repository metadata
+    };
+
     ProvideFileSpec();
 
     ProvideFileSpec(const zypp::OnMediaLocation &loc);
@@ -177,6 +188,12 @@ namespace zyppng
     /** Enables or disables the use of mirrors when fetching this file */
     ProvideFileSpec &setMirrorsAllowed( bool set = true );
 
+    /** The scheduling \ref Priority of the request ( defaults to \ref Normal ) */
+    Priority priority() const;
+
+    /** Set the \ref priority. */
+    ProvideFileSpec &setPriority( Priority prio );
+
     /*!
      * Returns a map of custom key->value pairs that can control special aspects
      * of how the provide operation is processed.
@@ -0,0 +1,270 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file zypp-media/sharedfilecache.cc
+ *
+*/
+
+#include "sharedfilecache.h"
+#include "mediaconfig.h"
+
+#include <zypp-core/AutoDispose.h>
+#include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/fs/BulkIO.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/base/Errno.h>
+#include <zypp-core/base/String.h>
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+namespace zypp {
+
+  namespace {
+
+    /** Holds a flock(2) on the lock file of the store until destroyed. */
+    class StoreLock
+    {
+    public:
+      StoreLock( const Pathname &root_r, int op_r )
+      {
+        const Pathname lockFile( root_r / ".lock" );
+        AutoFD fd;
+        if ( op_r == LOCK_EX ) {
+          if ( filesystem::assert_dir( root_r ) != 0 ) {
+            ERR << "Can not create shared file cache " << root_r << std::endl;
+            return;
+          }
+          fd = ::open( lockFile.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+        } else {
+          // readers may not be allowed to write to the store
+          fd = ::open( lockFile.c_str(), O_RDONLY | O_CLOEXEC );
+        }
+
+        if ( *fd == -1 ) {
+          if ( op_r == LOCK_EX || errno != ENOENT )
+            WAR << "Can not open " << lockFile << ": " << Errno() << std::endl;
+          return;
+        }
+
+        while ( ::flock( *fd, op_r ) == -1 ) {
+          if ( errno != EINTR ) {
+            ERR << "Can not lock " << lockFile << ": " << Errno() << std::endl;
+            return;
+          }
+        }
+        _fd = std::move(fd);
+      }
+
+      explicit operator bool() const
+      { return *_fd != -1; }
+
+    private:
+      AutoFD _fd;
+    };
+
+    /** Whether \a file_r has the content \a checksum_r claims. */
+    bool matches( const Pathname &file_r, const CheckSum &checksum_r )
+    { return str::toLower( filesystem::checksum( file_r, checksum_r.type() ) ) == str::toLower( checksum_r.checksum() ); }
+
+    /** The access time of an entry tracks when it was used last. */
+    void touchEntry( const Pathname &entry_r )
+    {
+      const struct timespec times[2] = { { 0, UTIME_NOW }, { 0, UTIME_OMIT } };
+      ::utimensat( AT_FDCWD, entry_r.c_str(), times, 0 );
+    }
+  }
+
+  SharedFileCache::SharedFileCache( Pathname root_r, ByteCount sizeLimit_r )
+    : _root( std::move(root_r) )
+    , _sizeLimit( std::move(sizeLimit_r) )
+  { }
+
+  SharedFileCache *SharedFileCache::instance()
+  {
+    static std::unique_ptr<SharedFileCache> _instance = []() -> std::unique_ptr<SharedFileCache> {
+      const MediaConfig &conf = MediaConfig::instance();
+      if ( conf.provide_shared_cache_path().empty() )
+        return nullptr;
+      MIL << "Using shared file cache " << conf.provide_shared_cache_path() << " limited to " << conf.provide_shared_cache_size() << "MiB" << std::endl;
+      return std::make_unique<SharedFileCache>( conf.provide_shared_cache_path(), ByteCount( conf.provide_shared_cache_size(), ByteCount::MiB ) );
+    }();
+    return _instance.get();
+  }
+
+  Pathname SharedFileCache::entryPath( const CheckSum &checksum_r ) const
+  {
+    if ( checksum_r.empty() )
+      return Pathname();
+
+    // the values come from repo metadata, make sure they do not leave the store
+    const std::string type( str::toLower( checksum_r.type() ) );
+    const std::string sum( str::toLower( checksum_r.checksum() ) );
+    if ( type.empty() || sum.size() < 3
+         || !std::all_of( type.begin(), type.end(), []( unsigned char c ) { return std::isalnum( c ); } )
+         || !std::all_of( sum.begin(), sum.end(), []( unsigned char c ) { return std::isxdigit( c ); } ) )
+      return Pathname();
+
+    return _root / type / sum.substr( 0, 2 ) / sum;
+  }
+
+  bool SharedFileCache::provide( const CheckSum &checksum_r, const Pathname &target_r ) const
+  {
+    const Pathname entry( entryPath( checksum_r ) );
+    if ( entry.empty() )
+      return false;
+
+    {
+      StoreLock lock( _root, LOCK_SH );
+      if ( !lock || !PathInfo( entry ).isFile() )
+        return false;
+
+      // a private copy (a reflink if possible), a link would let writers of the store change it after the check below
+      if ( filesystem::assert_dir( target_r.dirname() ) != 0 || filesystem::copyFile( entry, target_r ) != 0 ) {
+        WAR << "Failed to provide " << target_r << " from shared file cache" << std::endl;
+        return false;
+      }
+      ::chmod( target_r.c_str(), filesystem::applyUmaskTo( 0644 ) );
+    }
+
+    // anyone able to write to the store could have changed the entry, never trust its name
+    if ( !matches( target_r, checksum_r ) ) {
+      WAR << "Shared file cache entry " << entry << " does not match " << checksum_r << ", removing it" << std::endl;
+      filesystem::unlink( target_r );
+      StoreLock lock( _root, LOCK_EX );
+      if ( lock )
+        filesystem::unlink( entry );
+      return false;
+    }
+
+    touchEntry( entry );
+    DBG << "Shared file cache hit for " << checksum_r << ": " << target_r << std::endl;
+    return true;
+  }
+
+  bool SharedFileCache::add( const Pathname &file_r, const CheckSum &checksum_r, bool verified_r )
+  {
+    const Pathname entry( entryPath( checksum_r ) );
+    if ( entry.empty() )
+      return false;
+
+    const PathInfo pi( file_r );
+    if ( !pi.isFile() )
+      return false;
+
+    if ( PathInfo( entry ).isFile() ) {
+      touchEntry( entry );
+      return true;
+    }
+
+    // Entries are read only copies (reflinks if possible), so changing file_r does not change the entry.
+    // Entries starting with a dot are ignored by lookups and removed by evict.
+    const Pathname tmp( entry.dirname() / str::form( ".%s.%d.new", entry.basename().c_str(), int(::getpid()) ) );
+    if ( filesystem::assert_dir( entry.dirname() ) != 0 || filesystem::copyFile( file_r, tmp ) != 0 ) {
+      WAR << "Failed to add " << file_r << " to shared file cache" << std::endl;
+      filesystem::unlink( tmp );
+      return false;
+    }
+    ::chmod( tmp.c_str(), 0444 );
+
+    // other processes trust the entries, never add a file not matching its key
+    if ( !verified_r && !matches( tmp, checksum_r ) ) {
+      WAR << "Not adding " << file_r << " to shared file cache, it does not match " << checksum_r << std::endl;
+      filesystem::unlink( tmp );
+      return false;
+    }
+
+    StoreLock lock( _root, LOCK_EX );
+    // a concurrent evict removes the copy while we do not hold the lock
+    if ( !lock || filesystem::rename( tmp, entry ) != 0 ) {
+      WAR << "Failed to add " << file_r << " to shared file cache" << std::endl;
+      filesystem::unlink( tmp );
+      return false;
+    }
+    MIL << "Added " << file_r << " to shared file cache as " << entry << std::endl;
+
+    // other processes add entries as well, so we do not scan the store after each add
+    const auto added = _addedSinceEvict.load();
+    if ( added < 0 || added + pi.size() > ByteCount::SizeType(_sizeLimit) / 10 ) {
+      evictLocked();
+      _addedSinceEvict = 0;
+    } else {
+      _addedSinceEvict += pi.size();
+    }
+    return true;
+  }
+
+  void SharedFileCache::evict()
+  {
+    StoreLock lock( _root, LOCK_EX );
+    if ( !lock )
+      return;
+    evictLocked();
+    _addedSinceEvict = 0;
+  }
+
+  void SharedFileCache::evictLocked()
+  {
+    struct Entry {
+      time_t _atime;
+      ByteCount::SizeType _size;
+      Pathname _path;
+    };
+
+    std::vector<Entry> entries;
+    ByteCount::SizeType total = 0;
+
+    filesystem::dirForEach( _root, [&]( const Pathname &root, const char *const type ) {
+      if ( type[0] == '.' )
+        return true;
+      filesystem::dirForEach( root / type, [&]( const Pathname &typeDir, const char *const prefix ) {
+        filesystem::dirForEach( typeDir / prefix, [&]( const Pathname &prefixDir, const char *const name ) {
+          const Pathname path( prefixDir / name );
+          if ( name[0] == '.' ) {
+            // leftover of a process that died while adding, we hold the exclusive lock
+            filesystem::unlink( path );
+            return true;
+          }
+          const PathInfo pi( path, PathInfo::LSTAT );
+          if ( !pi.isFile() )
+            return true;
+          entries.push_back( Entry{ pi.atime(), pi.size(), path } );
+          total += pi.size();
+          return true;
+        });
+        return true;
+      });
+      return true;
+    });
+
+    const ByteCount::SizeType limit = _sizeLimit;
+    if ( total <= limit )
+      return;
+
+    std::sort( entries.begin(), entries.end(), []( const Entry &a, const Entry &b ) { return a._atime < b._atime; } );
+
+    uint evicted = 0;
+    for ( const auto &e : entries ) {
+      if ( total <= limit )
+        break;
+      if ( filesystem::unlink( e._path ) == 0 ) {
+        total -= e._size;
+        evicted++;
+      }
+    }
+    MIL << "Evicted " << evicted << " entries from shared file cache " << _root << ", " << ByteCount( total ) << " in use" << std::endl;
+  }
+
+} // namespace zypp
@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp-media/SharedFileCache
+ *
+*/
+#ifndef ZYPP_MEDIA_SHAREDFILECACHE_H
+#define ZYPP_MEDIA_SHAREDFILECACHE_H
+
+#include <zypp-core/Pathname.h>
+#include <zypp-core/ByteCount.h>
+#include <zypp-core/CheckSum.h>
+
+#include <atomic>
+
+namespace zypp {
+
+  /**
+   * Content addressed file store shared by all processes on the host.
+   *
+   * Files are stored by their checksum below \ref root as \c <type>/<xx>/<checksum>,
+   * so the same package or metadata file downloaded by different repos, zypper runs or
+   * containers sharing the directory is stored once. Entries are read only copies,
+   * preferably reflinks, and are copied into the target path the same way. No file is
+   * ever linked to an entry, so changing it can not change the entry and a verified
+   * target can not be changed through the store.
+   *
+   * Concurrent access is serialized by a \c flock(2) on \c <root>/.lock: lookups take
+   * a shared lock, adding and evicting entries an exclusive one.
+   *
+   * If the store grows beyond \ref sizeLimit the least recently used entries are evicted.
+   *
+   * \see MediaConfig::provide_shared_cache_path
+   */
+  class SharedFileCache
+  {
+  public:
+    SharedFileCache( Pathname root_r, ByteCount sizeLimit_r );
+
+    SharedFileCache( const SharedFileCache & ) = delete;
+    SharedFileCache &operator=( const SharedFileCache & ) = delete;
+
+    /**
+     * The store configured in \ref MediaConfig or \c nullptr if it is not enabled.
+     */
+    static SharedFileCache *instance();
+
+    const Pathname &root() const
+    { return _root; }
+
+    ByteCount sizeLimit() const
+    { return _sizeLimit; }
+
+    /**
+     * Path of the entry for \a checksum_r, empty if the checksum can not be used as key.
+     */
+    Pathname entryPath( const CheckSum &checksum_r ) const;
+
+    /**
+     * Copies the entry for \a checksum_r to \a target_r, replacing an existing file.
+     * The copy is verified against \a checksum_r, an entry not matching it is removed.
+     * \return \c true on a cache hit, \c false if there is no valid entry or copying failed.
+     */
+    bool provide( const CheckSum &checksum_r, const Pathname &target_r ) const;
+
+    /**
+     * Adds a copy of \a file_r as entry for \a checksum_r. Unless \a verified_r tells
+     * that \a file_r was already checked against \a checksum_r, the copy is verified
+     * and not added if it does not match.
+     * \return \c true if the store has an entry for \a checksum_r afterwards.
+     */
+    bool add( const Pathname &file_r, const CheckSum &checksum_r, bool verified_r = false );
+
+    /**
+     * Removes the least recently used entries until the store fits into \ref sizeLimit.
+     */
+    void evict();
+
+  private:
+    void evictLocked();
+
+    Pathname _root;
+    ByteCount _sizeLimit;
+    std::atomic<ByteCount::SizeType> _addedSinceEvict { -1 }; //< -1 until the first eviction run of this process
+  };
+
+} // namespace zypp
+
+#endif // ZYPP_MEDIA_SHAREDFILECACHE_H
@@ -21,6 +21,8 @@ function(zypp_add_media_target)
     MediaException
     mount.h
     Mount
+    SharedFileCache
+    sharedfilecache.h
   )
 
   zypp_add_sources( zypp_media_private_HEADERS
@@ -42,6 +44,7 @@ function(zypp_add_media_target)
     mediaexception.cc
     mount.cc
     ng/providespec.cc
+    sharedfilecache.cc
   )
 
   if( arg_INSTALL_HEADERS )
@@ -0,0 +1,99 @@
+#include <boost/test/unit_test.hpp>
+
+#include <zypp-media/SharedFileCache>
+#include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/fs/TmpPath.h>
+
+#include <fstream>
+
+using namespace zypp;
+
+namespace {
+  CheckSum writeFile( const Pathname &file_r, const std::string &content_r )
+  {
+    std::ofstream( file_r.c_str() ) << content_r;
+    return CheckSum::sha256FromString( content_r );
+  }
+
+  std::string readFile( const Pathname &file_r )
+  {
+    std::ifstream in( file_r.c_str() );
+    return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( add_and_provide )
+{
+  filesystem::TmpDir tmp;
+  SharedFileCache cache( tmp.path() / "store", ByteCount( 1, ByteCount::MiB ) );
+
+  const Pathname src( tmp.path() / "src" );
+  const CheckSum sum = writeFile( src, "some content" );
+
+  BOOST_CHECK( !cache.provide( sum, tmp.path() / "miss" ) );
+  BOOST_REQUIRE( cache.add( src, sum ) );
+  BOOST_CHECK( PathInfo( cache.entryPath( sum ) ).isFile() );
+
+  const Pathname target( tmp.path() / "sub" / "target" );
+  BOOST_REQUIRE( cache.provide( sum, target ) );
+  BOOST_CHECK_EQUAL( readFile( target ), "some content" );
+
+  // the target is a copy, changing it does not change the entry
+  writeFile( target, "changed content" );
+  BOOST_CHECK_EQUAL( readFile( cache.entryPath( sum ) ), "some content" );
+
+  // the entry survives the files it was copied from or to
+  filesystem::unlink( src );
+  filesystem::unlink( target );
+  BOOST_CHECK( cache.provide( sum, target ) );
+}
+
+BOOST_AUTO_TEST_CASE( reject_invalid )
+{
+  filesystem::TmpDir tmp;
+  SharedFileCache cache( tmp.path() / "store", ByteCount( 1, ByteCount::MiB ) );
+
+  const Pathname src( tmp.path() / "src" );
+  writeFile( src, "some content" );
+
+  // a file not matching its key is never added
+  const CheckSum other = CheckSum::sha256FromString( "other content" );
+  BOOST_CHECK( !cache.add( src, other ) );
+  BOOST_CHECK( !PathInfo( cache.entryPath( other ) ).isExist() );
+
+  // an entry changed in the store is not provided and removed
+  const CheckSum sum = writeFile( src, "some content" );
+  BOOST_REQUIRE( cache.add( src, sum ) );
+  filesystem::unlink( src );
+  filesystem::unlink( cache.entryPath( sum ) );
+  writeFile( cache.entryPath( sum ), "evil content" );
+  const Pathname target( tmp.path() / "target" );
+  BOOST_CHECK( !cache.provide( sum, target ) );
+  BOOST_CHECK( !PathInfo( target ).isExist() );
+  BOOST_CHECK( !PathInfo( cache.entryPath( sum ) ).isExist() );
+
+  // keys from metadata must not leave the store
+  BOOST_CHECK( cache.entryPath( CheckSum( "../sha256", "0123456789" ) ).empty() );
+  BOOST_CHECK( cache.entryPath( CheckSum( "foo", "../../etc/passwd" ) ).empty() );
+  BOOST_CHECK( cache.entryPath( CheckSum() ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( evict_lru )
+{
+  filesystem::TmpDir tmp;
+  SharedFileCache cache( tmp.path() / "store", ByteCount( 1, ByteCount::KiB ) );
+
+  const std::string block( 600, 'x' );
+  const Pathname src( tmp.path() / "src" );
+
+  const CheckSum first = writeFile( src, block + "1" );
+  BOOST_REQUIRE( cache.add( src, first ) );
+  filesystem::unlink( src );
+
+  const CheckSum second = writeFile( src, block + "2" );
+  BOOST_REQUIRE( cache.add( src, second ) );
+  filesystem::unlink( src );
+
+  cache.evict();
+  BOOST_CHECK_EQUAL( PathInfo( cache.entryPath( first ) ).isExist() + PathInfo( cache.entryPath( second ) ).isExist(), 1 );
+}
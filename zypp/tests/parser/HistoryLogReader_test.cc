@@ -1,6 +1,8 @@
+#include <fstream>
 #include <tests/lib/TestSetup.h>
 #include <zypp/parser/HistoryLogReader.h>
 #include <zypp-core/parser/ParseException>
+#include <zypp/TmpPath.h>
 
 using namespace zypp;
 
@@ -38,3 +40,53 @@ BOOST_AUTO_TEST_CASE(basic)
   HistoryLogDataInstall::Ptr p = dynamic_pointer_cast<HistoryLogDataInstall>( history[1] );
   BOOST_CHECK_EQUAL( p->userdata(), "trans|ID" ); // properly (un)escaped?
 }
+
+BOOST_AUTO_TEST_CASE(indexed)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "history" };
+  Pathname idx { file.extend( HISTORY_LOG_INDEX_SUFFIX ) };
+
+  // 1000 records, one per minute, indexed every 100 records
+  Date start { "2020-01-01 00:00:00", HISTORY_LOG_DATE_FORMAT };
+  {
+    std::ofstream out( file.c_str() );
+    std::ofstream outidx( idx.c_str() );
+    for ( unsigned i = 0; i < 1000; ++i )
+    {
+      Date date { start + i * Date::minute };
+      if ( i % 100 == 50 )
+        outidx << Date::ValueType(date) << " " << out.tellp() << std::endl;
+      out << date.form( HISTORY_LOG_DATE_FORMAT ) << "|rremove|alias" << i << "|" << std::endl;
+    }
+  }
+
+  auto read = [&]( const Date & from_r, const Date & to_r ) {
+    std::vector<std::string> ret;
+    parser::HistoryLogReader parser( file, parser::HistoryLogReader::Options(),
+      [&ret]( HistoryLogData::Ptr ptr )->bool {
+        ret.push_back( (*ptr)[HistoryLogDataRepoRemove::ALIAS_INDEX] );
+        return true;
+      } );
+    parser.readFromTo( from_r, to_r );
+    return ret;
+  };
+
+  Date from { start + 333 * Date::minute };
+  Date to   { start + 555 * Date::minute };
+  std::vector<std::string> result { read( from, to ) };
+  BOOST_CHECK_EQUAL( result.size(), 221 );
+  BOOST_CHECK_EQUAL( result.front(), "alias334" );
+  BOOST_CHECK_EQUAL( result.back(), "alias554" );
+
+  // same result without index
+  filesystem::unlink( idx );
+  BOOST_CHECK( read( from, to ) == result );
+
+  // and with an inconsistent index
+  {
+    std::ofstream outidx( idx.c_str() );
+    outidx << Date::ValueType(start + 100 * Date::minute) << " " << 4711 << std::endl;
+  }
+  BOOST_CHECK( read( from, to ) == result );
+}
@@ -110,3 +110,50 @@ BOOST_AUTO_TEST_CASE(dudata)
   ins.status().setTransact( false, ResStatus::USER );
   up3.status().setTransact( false, ResStatus::USER );
 }
+
+BOOST_AUTO_TEST_CASE(dudata_tracker)
+{
+  Pathname repodir( TEST_DIR );
+  TestSetup test( Arch_x86_64 );
+  test.loadTargetRepo( repodir/"system" );
+  test.loadRepo( repodir/"repo", "repo" );
+
+  ResPool pool( ResPool::instance() );
+  PoolItem ins( piFind( "dutest", "1.0", true ) );
+  PoolItem up1( piFind( "dutest", "1.0" ) );
+  PoolItem up3( piFind( "dutest", "3.0" ) );
+
+  DiskUsageCounter duc( { DiskUsageCounter::MountPoint( "/grow", DiskUsageCounter::MountPoint::Hint_growonly ),
+                          DiskUsageCounter::MountPoint( "/norm" ) } );
+  DiskUsageCounter::Tracker tracker( duc.getMountPoints() );
+
+  // The tracker must compute the same as a full DiskUsageCounter run, no matter
+  // whether the changes are taken from the journal, or the pool or the changed items are passed.
+  auto check = [&]( const PoolItem & changed_r ) {
+    BOOST_CHECK_EQUAL( mkByteSet( tracker.update() ), getSize( duc, pool ) );
+    BOOST_CHECK_EQUAL( mkByteSet( tracker.update( { changed_r } ) ), getSize( duc, pool ) );
+    BOOST_CHECK_EQUAL( mkByteSet( tracker.update( pool ) ), getSize( duc, pool ) );
+  };
+
+  BOOST_CHECK_EQUAL( mkByteSet( tracker.update( pool ) ), mkByteSet(  0,  0 ) );
+
+  ins.status().setTransact( true, ResStatus::USER );
+  check( ins );
+  up1.status().setTransact( true, ResStatus::USER );
+  check( up1 );
+  ins.status().setTransact( false, ResStatus::USER );
+  check( ins );
+  up1.status().setTransact( false, ResStatus::USER );
+  check( up1 );
+
+  // unknown DU falls back to the full computation
+  up3.status().setTransact( true, ResStatus::USER );
+  check( up3 );
+  ins.status().setTransact( true, ResStatus::USER );
+  check( ins );
+  up3.status().setTransact( false, ResStatus::USER );
+  check( up3 );
+  ins.status().setTransact( false, ResStatus::USER );
+  check( ins );
+  BOOST_CHECK_EQUAL( mkByteSet( tracker.update( pool ) ), mkByteSet(  0,  0 ) );
+}
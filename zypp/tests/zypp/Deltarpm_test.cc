@@ -14,6 +14,7 @@
 #include <zypp/sat/Pool.h>
 #include <zypp/repo/DeltaCandidates.h>
 #include <zypp/repo/PackageDelta.h>
+#include <zypp/repo/Applydeltarpm.h>
 #include "KeyRingTestReceiver.h"
 
 using boost::unit_test::test_case;
@@ -68,3 +69,83 @@ BOOST_AUTO_TEST_CASE(delta)
     cout << (it->edition().match("4.21.3-2") == 0) << endl;          // match returns -1,0,1
   }
 }
+
+BOOST_AUTO_TEST_CASE(delta_cost_model)
+{
+  DeltaCandidates::CostModel model;
+  const ByteCount MiB( 1, ByteCount::MiB );
+
+  // rates unknown: any delta smaller than the package
+  BOOST_CHECK( model.worthApplying( 2*MiB, 10*MiB, 50*MiB ) );
+  BOOST_CHECK( ! model.worthApplying( 10*MiB, 10*MiB, 50*MiB ) );
+  BOOST_CHECK( model.worthApplying( 2*MiB, ByteCount(), 50*MiB ) );
+
+  // saves 8s of download, rebuilding takes 12.5s
+  model.downloadRate = 1*MiB;
+  model.applyRate = 4*MiB;
+  BOOST_CHECK( ! model.worthApplying( 2*MiB, 10*MiB, 50*MiB ) );
+
+  // but just ~3s if 4 packages are rebuilt concurrently
+  model.jobs = 4;
+  BOOST_CHECK( model.worthApplying( 2*MiB, 10*MiB, 50*MiB ) );
+
+  // not on a fast connection
+  model.downloadRate = 100*MiB;
+  BOOST_CHECK( ! model.worthApplying( 2*MiB, 10*MiB, 50*MiB ) );
+}
+
+BOOST_AUTO_TEST_CASE(delta_pipeline_active)
+{
+  BOOST_CHECK( ! applydeltarpm::Pipeline::active() );
+  {
+    applydeltarpm::Pipeline outer( 1 );
+    BOOST_CHECK_EQUAL( applydeltarpm::Pipeline::active(), &outer );
+    {
+      applydeltarpm::Pipeline inner( 2 );
+      BOOST_CHECK_EQUAL( applydeltarpm::Pipeline::active(), &inner );
+      BOOST_CHECK_EQUAL( inner.jobs(), 2U );
+    }
+    BOOST_CHECK_EQUAL( applydeltarpm::Pipeline::active(), &outer );
+  }
+  BOOST_CHECK( ! applydeltarpm::Pipeline::active() );
+}
+
+BOOST_AUTO_TEST_CASE(delta_pipeline_take_after_failure)
+{
+  TmpDir tmp;
+  applydeltarpm::Pipeline pipeline( 1 );
+
+  // bogus deltas: the check fails, with or without applydeltarpm installed
+  for ( const char * name : { "a", "b" } )
+  {
+    Pathname delta( tmp.path() / (std::string(name)+".drpm") );
+    BOOST_REQUIRE_EQUAL( assert_file( delta ), 0 );
+    pipeline.enqueue( ManagedFile( delta, filesystem::unlink ), "bogus-sequence", tmp.path() / (std::string(name)+".rpm") );
+    BOOST_CHECK_EQUAL( pipeline.queuedDelta( tmp.path() / (std::string(name)+".rpm") ), delta );
+  }
+
+  BOOST_CHECK_EQUAL( pipeline.take( tmp.path() / "a.rpm" ), applydeltarpm::Pipeline::CheckFailed );
+  BOOST_CHECK( ! PathInfo( tmp.path() / "a.rpm" ).isExist() );
+  BOOST_CHECK( ! PathInfo( tmp.path() / "a.drpm" ).isExist() );	// released once done
+  BOOST_CHECK( pipeline.queuedDelta( tmp.path() / "a.rpm" ).empty() );
+  BOOST_CHECK_EQUAL( pipeline.take( tmp.path() / "a.rpm" ), applydeltarpm::Pipeline::NotQueued );
+
+  // the next job is still processed
+  BOOST_CHECK_EQUAL( pipeline.take( tmp.path() / "b.rpm" ), applydeltarpm::Pipeline::CheckFailed );
+  BOOST_CHECK( ! PathInfo( tmp.path() / "b.rpm" ).isExist() );
+  BOOST_CHECK( ! PathInfo( tmp.path() / "b.drpm" ).isExist() );
+}
+
+BOOST_AUTO_TEST_CASE(delta_pipeline_not_taken)
+{
+  TmpDir tmp;
+  Pathname delta( tmp.path() / "a.drpm" );
+  BOOST_REQUIRE_EQUAL( assert_file( delta ), 0 );
+  {
+    applydeltarpm::Pipeline pipeline( 1 );
+    pipeline.enqueue( ManagedFile( delta, filesystem::unlink ), "bogus-sequence", tmp.path() / "a.rpm" );
+    // not taken: the dtor waits for or drops the job
+  }
+  BOOST_CHECK( ! PathInfo( delta ).isExist() );
+  BOOST_CHECK( ! PathInfo( tmp.path() / "a.rpm" ).isExist() );
+}
@@ -4,12 +4,14 @@
 #include <fstream>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/Exception.h>
 #include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
 #include <zypp/Digest.h>
 
 using boost::unit_test::test_case;
@@ -33,3 +35,18 @@ BOOST_AUTO_TEST_CASE(digest)
   // FIXME i think it should throw
   BOOST_CHECK_EQUAL( Digest::digest( "lalala", str3) , "" );
 }
+
+BOOST_AUTO_TEST_CASE(digest_files)
+{
+  filesystem::TmpFile f1;
+  filesystem::TmpFile f2;
+  {
+    std::ofstream( f1.path().c_str() ) << "I will test the checksum of this";
+  }
+
+  std::vector<std::string> sums { Digest::digestFiles( "sha1", { f1.path(), f2.path(), "/nonexistent/file" } ) };
+  BOOST_REQUIRE_EQUAL( sums.size(), 3 );
+  BOOST_CHECK_EQUAL( sums[0], "142df4277c326f3549520478c188cab6e3b5d042" );
+  BOOST_CHECK_EQUAL( sums[1], "da39a3ee5e6b4b0d3255bfef95601890afd80709" );	// empty file
+  BOOST_CHECK_EQUAL( sums[2], "" );
+}
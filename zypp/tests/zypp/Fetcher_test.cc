@@ -371,6 +371,46 @@ BOOST_AUTO_TEST_CASE(enqueuedir_http)
   web.stop();
 }
 
+BOOST_AUTO_TEST_CASE(enqueuedir_http_concurrent)
+{
+    WebServer web((Pathname(TESTS_SRC_DIR) + "/zypp/data/Fetcher/remote-site").c_str(), 10001);
+    BOOST_REQUIRE( web.start() );
+
+  {
+      MediaSetAccess media( web.url(), "/" );
+      Fetcher fetcher;
+      filesystem::TmpDir dest;
+
+      fetcher.setOptions( Fetcher::AutoAddIndexes | Fetcher::ConcurrentDownloads );
+      fetcher.enqueueDir(OnMediaLocation("/complexdir"), true);
+      fetcher.start( dest.path(), media );
+
+      fetcher.reset();
+
+      BOOST_CHECK( PathInfo(dest.path() + "/complexdir/subdir2/subdir2-file1.txt").isExist() );
+      BOOST_CHECK( PathInfo(dest.path() + "/complexdir/subdir1/subdir1-file1.txt").isExist() );
+      BOOST_CHECK( PathInfo(dest.path() + "/complexdir/subdir1/subdir1-file2.txt").isExist() );
+  }
+
+  // files downloaded ahead must still be validated before they are used
+  {
+      MediaSetAccess media( web.url(), "/" );
+      Fetcher fetcher;
+      filesystem::TmpDir dest;
+
+      fetcher.setOptions( Fetcher::AutoAddIndexes | Fetcher::ConcurrentDownloads );
+      fetcher.enqueueDir(OnMediaLocation("/complexdir-broken"), true);
+      BOOST_CHECK_THROW( fetcher.start( dest.path(), media ), FileCheckException);
+      fetcher.reset();
+
+      BOOST_CHECK( PathInfo(dest.path() + "/complexdir-broken/subdir1/subdir1-file1.txt").isExist() );
+      BOOST_CHECK( ! PathInfo(dest.path() + "/complexdir-broken/subdir1/subdir1-file2.txt").isExist() );
+      BOOST_CHECK( ! PathInfo(dest.path() + "/complexdir-broken/subdir2/subdir2-file1.txt").isExist() );
+  }
+
+  web.stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 // vim: set ts=2 sts=2 sw=2 ai et:
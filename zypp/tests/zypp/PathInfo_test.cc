@@ -11,6 +11,7 @@
 #include <zypp-core/base/Exception.h>
 #include <zypp/PathInfo.h>
 #include <zypp/TmpPath.h>
+#include <zypp-core/fs/BulkIO.h>
 
 using boost::unit_test::test_suite;
 using boost::unit_test::test_case;
@@ -48,6 +49,92 @@ BOOST_AUTO_TEST_CASE(pathinfo_checksum_test)
   BOOST_REQUIRE( is_checksum( file.path(), file_md5 ) );
 }
 
+/**
+ * Test case for
+ * std::vector<std::string> checksums( const std::vector<Pathname> & files_r, const std::string & algorithm_r, unsigned queueDepth_r );
+ * std::vector<int> copyFiles( const std::vector<std::pair<Pathname, Pathname>> & jobs_r, unsigned queueDepth_r );
+ */
+BOOST_AUTO_TEST_CASE(pathinfo_bulkio_test)
+{
+  TmpDir dir;
+  std::vector<Pathname> files;
+  std::vector<std::pair<Pathname, Pathname>> copies;
+  for ( unsigned i = 0; i < 20; ++i )
+  {
+    Pathname file( dir.path() / str::numstring( i ) );
+    std::ofstream str( file.c_str() );
+    // some files span more than one block
+    std::string data( i % 3 ? i : 3 * bulkIOBlockSize + i, char( 'a' + i ) );
+    str << data;
+    str.close();
+    files.push_back( file );
+    copies.push_back( { file, dir.path() / ( str::numstring( i ) + ".copy" ) } );
+  }
+  files.push_back( dir.path() / "does-not-exist" );
+  copies.push_back( { files.back(), dir.path() / "does-not-exist.copy" } );
+
+  std::vector<std::string> sums( checksums( files, "sha256", 4 ) );
+  BOOST_REQUIRE_EQUAL( sums.size(), files.size() );
+  for ( unsigned i = 0; i < 20; ++i )
+    BOOST_CHECK_EQUAL( sums[i], checksum( files[i], "sha256" ) );
+  BOOST_CHECK( sums.back().empty() );
+
+  BOOST_CHECK( checksums( files, "no-such-algorithm" )[0].empty() );
+
+  std::vector<int> res( copyFiles( copies, 4 ) );
+  BOOST_REQUIRE_EQUAL( res.size(), copies.size() );
+  for ( unsigned i = 0; i < 20; ++i )
+  {
+    BOOST_CHECK_EQUAL( res[i], 0 );
+    BOOST_CHECK_EQUAL( checksum( copies[i].second, "sha256" ), sums[i] );
+  }
+  BOOST_CHECK_EQUAL( res.back(), EINVAL );
+  BOOST_CHECK( ! PathInfo( copies.back().second ).isExist() );
+}
+
+/**
+ * Test case for
+ * int copy_dir( const Pathname & srcpath, const Pathname & destpath );
+ * int copy_dir_content( const Pathname & srcpath, const Pathname & destpath );
+ */
+BOOST_AUTO_TEST_CASE(pathinfo_copytree_test)
+{
+  TmpDir dir;
+  const Pathname src( dir.path() / "src" );
+  BOOST_REQUIRE_EQUAL( assert_dir( src / "sub" / "subsub" ), 0 );
+  {
+    std::ofstream str( ( src / "sub" / "file" ).c_str() );
+    str << std::string( bulkIOBlockSize + 42, 'x' );
+  }
+  BOOST_REQUIRE_EQUAL( assert_file( src / "sub" / "subsub" / "empty" ), 0 );
+  BOOST_REQUIRE_EQUAL( hardlink( src / "sub" / "file", src / "hardlink" ), 0 );
+  BOOST_REQUIRE_EQUAL( symlink( "sub/file", src / "symlink" ), 0 );
+
+  const Pathname dest( dir.path() / "dest" );
+  BOOST_REQUIRE_EQUAL( assert_dir( dest ), 0 );
+  BOOST_CHECK_EQUAL( copy_dir( src, dest ), 0 );
+  BOOST_CHECK_EQUAL( copy_dir( src, dest ), EEXIST );
+
+  const Pathname copy( dest / "src" );
+  BOOST_CHECK_EQUAL( checksum( copy / "sub" / "file", "sha256" ), checksum( src / "sub" / "file", "sha256" ) );
+  BOOST_CHECK( PathInfo( copy / "sub" / "subsub" / "empty" ).isFile() );
+  BOOST_CHECK_EQUAL( PathInfo( copy / "hardlink" ).ino(), PathInfo( copy / "sub" / "file" ).ino() );
+  BOOST_CHECK_NE( PathInfo( copy / "hardlink" ).ino(), PathInfo( src / "hardlink" ).ino() );
+  BOOST_CHECK( PathInfo( copy / "symlink", PathInfo::LSTAT ).isLink() );
+  BOOST_CHECK_EQUAL( readlink( copy / "symlink" ), Pathname( "sub/file" ) );
+
+  // merging into an existing tree
+  BOOST_REQUIRE_EQUAL( unlink( copy / "sub" / "file" ), 0 );
+  BOOST_CHECK_EQUAL( copy_dir_content( src, copy ), 0 );
+  BOOST_CHECK_EQUAL( checksum( copy / "sub" / "file", "sha256" ), checksum( src / "sub" / "file", "sha256" ) );
+
+  BOOST_CHECK_EQUAL( copy_file2dir( src / "sub" / "file", dest ), 0 );
+  BOOST_CHECK_EQUAL( checksum( dest / "file", "sha256" ), checksum( src / "sub" / "file", "sha256" ) );
+
+  // a directory can't be copied into itself
+  BOOST_CHECK_EQUAL( copyTree( src, src / "sub" / "inner" ), EINVAL );
+}
+
 BOOST_AUTO_TEST_CASE(pathinfo_is_exist_test)
 {
   TmpDir dir;
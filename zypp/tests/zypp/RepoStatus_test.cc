@@ -1,4 +1,6 @@
 
+#include <fstream>
+
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/Exception.h>
 #include <zypp/TmpPath.h>
@@ -54,3 +56,24 @@ BOOST_AUTO_TEST_CASE(repostatus_test)
   BOOST_CHECK_EQUAL( r, a && (b && c) );
   BOOST_CHECK_EQUAL( r.timestamp(), c.timestamp() );	// max timestamp
 }
+
+BOOST_AUTO_TEST_CASE(repostatus_fromfiles)
+{
+  TmpDir tmp;
+  const Pathname f1 { tmp.path()/"f1" };
+  const Pathname f2 { tmp.path()/"f2" };
+  const Pathname d  { tmp.path()/"d" };
+  BOOST_REQUIRE_EQUAL( filesystem::assert_file( f1 ), 0 );
+  BOOST_REQUIRE_EQUAL( filesystem::assert_dir( d ), 0 );
+  {
+    std::ofstream( f2.c_str() ) << "some content";
+  }
+
+  const RepoStatus joined { RepoStatus( f1 ) && RepoStatus( f2 ) && RepoStatus( d ) };
+  const RepoStatus bulk { RepoStatus::fromFiles( { d, f2, tmp.path()/"missing", f1 } ) };
+  BOOST_CHECK_EQUAL( bulk.empty(), false );
+  BOOST_CHECK_EQUAL( bulk, joined );
+  BOOST_CHECK_EQUAL( bulk.timestamp(), joined.timestamp() );
+
+  BOOST_CHECK_EQUAL( RepoStatus::fromFiles( {} ).empty(), true );
+}
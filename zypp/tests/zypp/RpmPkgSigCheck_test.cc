@@ -1,6 +1,8 @@
 #include <tests/lib/TestSetup.h>
 
 #include <zypp/target/rpm/RpmDb.h>
+#include <zypp/TmpPath.h>
+#include <fstream>
 using target::rpm::RpmDb;
 
 #define DATADIR (Pathname(TESTS_SRC_DIR) / "/zypp/data/RpmPkgSigCheck")
@@ -240,6 +242,33 @@ BOOST_AUTO_TEST_CASE(signed_pkg_withkey)
   BOOST_CHECK_EQUAL( xpct, cs );
 }
 
+BOOST_AUTO_TEST_CASE(cached_signature_needs_same_file)
+{
+  filesystem::TmpDir tmp;
+  Pathname rpm { tmp.path()/"signed.rpm" };
+  BOOST_REQUIRE_EQUAL( filesystem::copy( DATADIR/"signed.rpm", rpm ), 0 );
+  CheckSum sum { CheckSum::sha256( filesystem::checksum( rpm, CheckSum::sha256Type() ) ) };
+
+  RpmDb & rpmDb { test.target().rpmDb() };
+  rpmDb.checkPackageSignatures( { { rpm, sum } } );
+  RpmDb::CheckPackageDetail detail;
+  BOOST_CHECK( rpmDb.cachedPackageSignature( rpm, sum, detail ) );
+
+  // a different file of the same size must be checked again
+  std::string data;
+  {
+    std::ifstream in( rpm.c_str(), std::ios::binary );
+    data.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  }
+  BOOST_REQUIRE( ! data.empty() );
+  data.back() ^= 0xff;
+  std::ofstream( rpm.c_str(), std::ios::binary | std::ios::trunc ) << data;
+  BOOST_REQUIRE_EQUAL( PathInfo( rpm ).size(), PathInfo( DATADIR/"signed.rpm" ).size() );
+  BOOST_CHECK( ! rpmDb.cachedPackageSignature( rpm, sum, detail ) );
+
+  RpmDb::clearPackageSignatureCache();
+}
+
 BOOST_AUTO_TEST_CASE(signed_broken_pkg_withkey)
 {
   Pathname rpm { DATADIR/"signed_broken.rpm" };
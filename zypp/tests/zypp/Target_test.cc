@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fstream>
 #include <list>
+#include <set>
 #include <string>
 
 // Boost.Test
@@ -12,11 +13,59 @@
 #include <zypp/ZYpp.h>
 #include <zypp/ZYppFactory.h>
 #include <zypp/TmpPath.h>
+#include <zypp-core/ExternalProgram.h>
+#include <zypp/target/TargetImpl.h>
+
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo.h>
+#include <solv/repo_solv.h>
+}
 
 using boost::unit_test::test_case;
 using namespace zypp;
 using namespace zypp::filesystem;
 
+namespace
+{
+  int run( ExternalProgram::Arguments cmd_r )
+  {
+    ExternalProgram prog( cmd_r, ExternalProgram::Stderr_To_Stdout );
+    for ( std::string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() )
+      BOOST_TEST_MESSAGE( output );
+    return prog.close();
+  }
+
+  int rpmdb2solv( const Pathname & root_r, const Pathname & out_r )
+  { return run( { "rpmdb2solv", "-r", root_r.asString(), "-X", "-p", (root_r/"etc/products.d").asString(), "-o", out_r.asString() } ); }
+
+  /** Solvables and their provides in a solv file. */
+  std::multiset<std::string> solvContent( const Pathname & solv_r )
+  {
+    std::multiset<std::string> ret;
+    ::Pool * pool = ::pool_create();
+    ::Repo * repo = ::repo_create( pool, "@System" );
+    if ( FILE * fp = ::fopen( solv_r.c_str(), "re" ) )
+    {
+      ::repo_add_solv( repo, fp, 0 );
+      ::fclose( fp );
+    }
+    Id p = 0;
+    ::Solvable * s = nullptr;
+    FOR_REPO_SOLVABLES( repo, p, s )
+    {
+      std::string entry { ::pool_solvable2str( pool, s ) };
+      if ( s->provides )
+        for ( Id * dp = repo->idarraydata + s->provides; *dp; ++dp )
+          ( entry += " " ) += ::pool_dep2str( pool, *dp );
+      ret.insert( std::move(entry) );
+    }
+    ::pool_free( pool );
+    return ret;
+  }
+}
+
 BOOST_AUTO_TEST_CASE(target_test)
 {
 
@@ -54,3 +103,35 @@ BOOST_AUTO_TEST_CASE(target_test)
     BOOST_CHECK_EQUAL( dlabel.summary, "A cool distribution" );
     BOOST_CHECK_EQUAL( dlabel.shortName, "" );
 }
+
+BOOST_AUTO_TEST_CASE(incremental_solv_matches_rebuild)
+{
+  filesystem::TmpDir tmp;
+  Pathname root { tmp.path() };
+  assert_dir( root / "/etc/products.d" );
+  BOOST_REQUIRE( copy( Pathname(TESTS_SRC_DIR) / "/zypp/data/Target/product.prod", root / "/etc/products.d/product.prod" ) == 0 );
+  BOOST_REQUIRE_EQUAL( run( { "rpm", "--root", root.asString(), "--initdb" } ), 0 );
+
+  Pathname before { root / "before.solv" };
+  BOOST_REQUIRE_EQUAL( rpmdb2solv( root, before ), 0 );
+
+  // install a package
+  Pathname rpm { Pathname(TESTS_SRC_DIR) / "/zypp/data/RpmPkgSigCheck/unsigned.rpm" };
+  BOOST_REQUIRE_EQUAL( run( { "rpm", "--root", root.asString(), "-i", "--justdb", "--nodeps", "--nosignature", rpm.asString() } ), 0 );
+
+  Pathname full { root / "full.solv" };
+  Pathname incremental { root / "incremental.solv" };
+  BOOST_REQUIRE_EQUAL( rpmdb2solv( root, full ), 0 );
+  BOOST_REQUIRE( target::TargetImpl::writeSolvIncremental( root, before, incremental ) );
+  BOOST_CHECK( solvContent( incremental ) == solvContent( full ) );
+  BOOST_CHECK( solvContent( incremental ) != solvContent( before ) );
+
+  // and erase it again
+  BOOST_REQUIRE_EQUAL( run( { "rpm", "--root", root.asString(), "-e", "--justdb", "--nodeps", "pkg-test42" } ), 0 );
+
+  BOOST_REQUIRE_EQUAL( rpmdb2solv( root, full ), 0 );
+  Pathname after { root / "after.solv" };
+  BOOST_REQUIRE( target::TargetImpl::writeSolvIncremental( root, incremental, after ) );
+  BOOST_CHECK( solvContent( after ) == solvContent( full ) );
+  BOOST_CHECK( solvContent( after ) == solvContent( before ) );
+}
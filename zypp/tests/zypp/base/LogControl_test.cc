@@ -0,0 +1,78 @@
+#include <tests/lib/TestSetup.h>
+#include <zypp-core/base/LogControl.h>
+#include <zypp/TmpPath.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#define BOOST_TEST_MODULE LogControl
+
+using namespace zypp;
+
+namespace
+{
+  static const unsigned threads = 8;
+  static const unsigned linesPerThread = 5000;	// more than fit into a threads log buffer
+
+  struct CountingLineWriter : public log::LineWriter
+  {
+    void writeOut( const std::string & formated_r ) override
+    { if ( formated_r.find( "LogControl_test" ) != std::string::npos ) ++_lines; }
+
+    std::atomic<unsigned> _lines { 0 };
+  };
+
+  void logFromThreads()
+  {
+    std::vector<std::thread> workers;
+    for ( unsigned t = 0; t < threads; ++t )
+    {
+      workers.emplace_back( [t]() {
+        for ( unsigned i = 0; i < linesPerThread; ++i )
+          MIL << "LogControl_test " << t << " " << i << endl;
+      } );
+    }
+    for ( auto & w : workers )
+      w.join();
+  }
+
+  template <class TPred>
+  bool waitFor( TPred pred_r )
+  {
+    for ( unsigned i = 0; i < 1000 && ! pred_r(); ++i )
+      std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+    return pred_r();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lines_are_not_lost)
+{
+  base::LogControl::instance().setOverflowPolicy( base::LogControl::OverflowPolicy::Block );
+  shared_ptr<CountingLineWriter> writer { new CountingLineWriter };
+  base::LogControl::TmpLineWriter guard( writer );
+
+  logFromThreads();
+  BOOST_CHECK( waitFor( [&]() { return writer->_lines == threads * linesPerThread; } ) );
+  BOOST_CHECK_EQUAL( writer->_lines, threads * linesPerThread );
+}
+
+BOOST_AUTO_TEST_CASE(batched_file_writes)
+{
+  filesystem::TmpDir tmp;
+  Pathname logfile { tmp.path() / "log" };
+  base::LogControl::TmpLineWriter guard( new log::FileLineWriter( logfile ) );
+
+  logFromThreads();
+  auto countLines = [&]() {
+    unsigned ret = 0;
+    std::ifstream in( logfile.c_str() );
+    for ( std::string line; std::getline( in, line ); )
+      if ( line.find( "LogControl_test" ) != std::string::npos )
+        ++ret;
+    return ret;
+  };
+  BOOST_CHECK( waitFor( [&]() { return countLines() == threads * linesPerThread; } ) );
+  BOOST_CHECK_EQUAL( countLines(), threads * linesPerThread );
+}
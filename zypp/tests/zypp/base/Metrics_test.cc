@@ -0,0 +1,72 @@
+#include <tests/lib/TestSetup.h>
+#include <zypp-core/base/Metrics.h>
+#include <zypp-core/parser/json.h>
+
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE Metrics
+
+using namespace zypp;
+
+BOOST_AUTO_TEST_CASE(registry)
+{
+  metrics::Counter & c { metrics::counter( "test.counter" ) };
+  BOOST_CHECK_EQUAL( &c, &metrics::counter( "test.counter" ) );
+  BOOST_CHECK_NE( &c, &metrics::counter( "test.other" ) );
+
+  std::vector<std::thread> workers;
+  for ( unsigned t = 0; t < 4; ++t )
+    workers.emplace_back( []() {
+      for ( unsigned i = 0; i < 1000; ++i )
+        metrics::counter( "test.counter" ).inc();
+    } );
+  for ( auto & w : workers )
+    w.join();
+  BOOST_CHECK_EQUAL( c.value(), 4000 );
+
+  metrics::Gauge & g { metrics::gauge( "test.gauge" ) };
+  g.set( 5 );
+  g.add( 3 );
+  g.sub( 10 );
+  BOOST_CHECK_EQUAL( g.value(), -2 );
+}
+
+BOOST_AUTO_TEST_CASE(histogram)
+{
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketFor( 0 ), 0 );
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketFor( 1 ), 1 );
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketFor( 2 ), 2 );
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketFor( 3 ), 2 );
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketFor( 1024 ), 11 );
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketFor( ~std::uint64_t(0) ), 64 );
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketLimit( 11 ), 2048 );
+  BOOST_CHECK_EQUAL( metrics::Histogram::bucketLimit( 64 ), 0 );
+
+  metrics::Histogram & h { metrics::histogram( "test.histogram" ) };
+  h.observe( 3 );
+  h.observe( 2 );
+  h.observe( std::chrono::milliseconds(1) );	// 1000us
+  BOOST_CHECK_EQUAL( h.count(), 3 );
+  BOOST_CHECK_EQUAL( h.sum(), 1005 );
+  BOOST_CHECK_EQUAL( h.bucket( 2 ), 2 );
+  BOOST_CHECK_EQUAL( h.bucket( 10 ), 1 );
+
+  { metrics::ScopedTimer timer { metrics::histogram( "test.timer" ) }; }
+  BOOST_CHECK_EQUAL( metrics::histogram( "test.timer" ).count(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE(json_dump)
+{
+  metrics::counter( "test.dump" ).inc( 7 );
+  metrics::histogram( "test.dumphist" ).observe( 5 );
+
+  json::Object dump { metrics::asJSON() };
+  BOOST_REQUIRE( dump.contains( "counters" ) );
+  BOOST_REQUIRE( dump.contains( "gauges" ) );
+  BOOST_REQUIRE( dump.contains( "histograms" ) );
+
+  const std::string & js { dump.asJSON() };
+  BOOST_CHECK( js.find( "\"test.dump\": 7" ) != std::string::npos );
+  BOOST_CHECK( js.find( "\"8\": 1" ) != std::string::npos );	// 5 is counted in bucket [4,8)
+}
@@ -202,6 +202,21 @@ BOOST_AUTO_TEST_CASE(testsplitEscapedWithEmpty)
   BOOST_CHECK_EQUAL(v.size(), 4);
 }
 
+BOOST_AUTO_TEST_CASE(testsplitEscapedView)
+{
+  // a view into a larger buffer is split up to its end, not up to the NUL
+  std::string buf( "a|b\\|c||d|e|f" );
+  std::string_view line( buf.data(), 8 );
+  std::vector<std::string> v;
+
+  BOOST_CHECK_EQUAL( splitEscaped( line, std::back_inserter(v), "|", true ), 4 );
+  BOOST_REQUIRE_EQUAL( v.size(), 4 );
+  BOOST_CHECK_EQUAL( v[0], "a" );
+  BOOST_CHECK_EQUAL( v[1], "b\\" );
+  BOOST_CHECK_EQUAL( v[2], "c" );
+  BOOST_CHECK_EQUAL( v[3], "" );
+}
+
 BOOST_AUTO_TEST_CASE(test_escape)
 {
   std::string badass = "bad|ass\\|worse";
@@ -0,0 +1,39 @@
+#include <tests/lib/TestSetup.h>
+#include <zypp-core/base/Trace.h>
+#include <zypp/TmpPath.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#define BOOST_TEST_MODULE Trace
+
+using namespace zypp;
+
+BOOST_AUTO_TEST_CASE(trace_spans)
+{
+  // must be set before the first trace call
+  filesystem::TmpDir tmp;
+  Pathname tracefile { tmp.path() / "trace.json" };
+  ::setenv( "ZYPP_TRACEFILE", tracefile.c_str(), 1 );
+  BOOST_REQUIRE( debug::traceEnabled() );
+
+  // a threads events are written when the thread ends
+  std::thread worker( []() {
+    ZYPP_TRACE_SPAN_DETAIL( "outer", "with \"quotes\"", "zypp" );
+    { ZYPP_TRACE_SPAN( "inner" ); }
+    debug::traceInstant( "instant", "test" );
+  } );
+  worker.join();
+
+  std::ifstream in { tracefile.c_str() };
+  std::string content { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+  BOOST_CHECK_EQUAL( content.substr( 0, 2 ), "[\n" );
+  BOOST_CHECK( content.find( "\"name\":\"process_name\"" ) != std::string::npos );
+  BOOST_CHECK( content.find( "{\"name\":\"outer\",\"cat\":\"zypp\",\"ph\":\"X\"" ) != std::string::npos );
+  BOOST_CHECK( content.find( "\"args\":{\"detail\":\"with \\\"quotes\\\"\"}" ) != std::string::npos );
+  BOOST_CHECK( content.find( "{\"name\":\"inner\",\"cat\":\"zypp\",\"ph\":\"X\"" ) != std::string::npos );
+  BOOST_CHECK( content.find( "{\"name\":\"instant\",\"cat\":\"test\",\"ph\":\"i\"" ) != std::string::npos );
+  // inner ends first
+  BOOST_CHECK( content.find( "\"inner\"" ) < content.find( "\"outer\"" ) );
+}
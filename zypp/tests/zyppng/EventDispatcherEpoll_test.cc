@@ -0,0 +1,148 @@
+#include <boost/test/unit_test.hpp>
+#include <zypp-core/ng/base/EventLoop>
+#include <zypp-core/ng/base/EventDispatcher>
+#include <zypp-core/ng/base/SocketNotifier>
+#include <zypp-core/ng/base/Timer>
+#include <zypp-core/AutoDispose.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+  /// creates all dispatchers of a test with the epoll backend
+  struct EpollBackend {
+    EpollBackend() {
+      zyppng::EventDispatcher::setPreferredBackend( zyppng::EventDispatcher::Backend::Epoll );
+    }
+    ~EpollBackend() {
+      zyppng::EventDispatcher::setPreferredBackend( zyppng::EventDispatcher::Backend::Glib );
+    }
+  };
+}
+
+BOOST_FIXTURE_TEST_CASE( epoll_timers, EpollBackend )
+{
+  zyppng::EventLoop::Ptr loop = zyppng::EventLoop::create();
+  BOOST_REQUIRE( loop->eventDispatcher()->backend() == zyppng::EventDispatcher::Backend::Epoll );
+
+  zyppng::Timer::Ptr t1 = zyppng::Timer::create();
+  zyppng::Timer::Ptr t2 = zyppng::Timer::create();
+  zyppng::Timer::Ptr single = zyppng::Timer::create();
+  zyppng::Timer::Ptr restarted = zyppng::Timer::create();
+
+  int hitT1 = 0;
+  int hitT2 = 0;
+  int hitSingle = 0;
+  int hitRestarted = 0;
+  int executedIdle = 0;
+  int invokedAfter = 0;
+
+  t1->sigExpired().connect( [ &hitT1 ]( zyppng::Timer & ) {
+    hitT1++;
+  });
+
+  t2->sigExpired().connect( [ & ]( zyppng::Timer & ){
+    BOOST_REQUIRE_GT( hitT1, 0 );
+    hitT2++;
+    if ( hitT2 >= 3 )
+      loop->quit();
+  });
+
+  single->setSingleShot( true );
+  single->sigExpired().connect( [ &hitSingle ]( zyppng::Timer & ){
+    hitSingle++;
+  });
+
+  // moving the deadline of a running timer to the front must be honored
+  restarted->setSingleShot( true );
+  restarted->sigExpired().connect( [ & ]( zyppng::Timer & ){
+    BOOST_REQUIRE_EQUAL( hitT1, 0 );
+    hitRestarted++;
+  });
+
+  zyppng::EventDispatcher::invokeOnIdle( [ &executedIdle ](){ executedIdle++; return ( executedIdle < 2 ); } );
+  zyppng::EventDispatcher::invokeAfter( [ &invokedAfter ](){ invokedAfter++; return ( invokedAfter < 2 ); }, 5 );
+
+  restarted->start( 10000 );
+  t1->start( 10 );
+  t2->start( 15 );
+  single->start( 2 );
+  restarted->start( 1 );
+
+  loop->run();
+
+  BOOST_REQUIRE_EQUAL( executedIdle, 2 );
+  BOOST_REQUIRE_EQUAL( invokedAfter, 2 );
+  BOOST_REQUIRE_GE ( hitT1, 3 );
+  BOOST_REQUIRE_EQUAL( hitT2, 3 );
+  BOOST_REQUIRE_EQUAL( hitSingle, 1 );
+  BOOST_REQUIRE_EQUAL( hitRestarted, 1 );
+
+  t1->stop();
+  t2->stop();
+
+  BOOST_REQUIRE_EQUAL( loop->eventDispatcher()->runningTimers(), 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( epoll_fds, EpollBackend )
+{
+  zyppng::EventLoop::Ptr loop = zyppng::EventLoop::create();
+
+  int fds[2];
+  BOOST_REQUIRE_EQUAL( ::pipe( fds ), 0 );
+  zypp::AutoFD readEnd( fds[0] );
+  zypp::AutoFD writeEnd( fds[1] );
+
+  std::string received;
+  auto notifier = zyppng::SocketNotifier::create( readEnd, zyppng::SocketNotifier::Read );
+  notifier->sigActivated().connect( [ & ]( const zyppng::SocketNotifier &, int ev ) {
+    BOOST_REQUIRE( ev & zyppng::SocketNotifier::Read );
+    char buf[16];
+    const auto r = ::read( readEnd, buf, sizeof(buf) );
+    BOOST_REQUIRE_GT( r, 0 );
+    received.append( buf, r );
+    if ( received == "hello" )
+      loop->quit();
+  });
+
+  zyppng::EventDispatcher::invokeAfter( [ & ](){
+    BOOST_REQUIRE_EQUAL( ::write( writeEnd, "hello", 5 ), 5 );
+    return false;
+  }, 1 );
+
+  loop->run();
+  BOOST_REQUIRE_EQUAL( received, "hello" );
+
+  // a disabled notifier must not fire anymore
+  notifier->setEnabled( false );
+  BOOST_REQUIRE_EQUAL( ::write( writeEnd, "x", 1 ), 1 );
+  BOOST_REQUIRE( !loop->eventDispatcher()->run_once() );
+}
+
+BOOST_FIXTURE_TEST_CASE( epoll_child, EpollBackend )
+{
+  zyppng::EventLoop::Ptr loop = zyppng::EventLoop::create();
+
+  const pid_t pid = ::fork();
+  BOOST_REQUIRE_NE( pid, -1 );
+  if ( pid == 0 )
+    ::_exit( 3 );
+
+  int exitCode = -1;
+  loop->eventDispatcher()->trackChildProcess( pid, [ & ]( int p, int status ) {
+    BOOST_REQUIRE_EQUAL( p, pid );
+    exitCode = WIFEXITED( status ) ? WEXITSTATUS( status ) : -1;
+    loop->quit();
+  });
+
+  loop->run();
+  BOOST_REQUIRE_EQUAL( exitCode, 3 );
+}
+
+BOOST_FIXTURE_TEST_CASE( epoll_no_glib_context, EpollBackend )
+{
+  zyppng::EventLoop::Ptr loop = zyppng::EventLoop::create();
+  BOOST_REQUIRE( loop->eventDispatcher()->backend() == zyppng::EventDispatcher::Backend::Epoll );
+  BOOST_REQUIRE( loop->eventDispatcher()->glibContext() == nullptr );
+  BOOST_REQUIRE( loop->eventDispatcher()->nativeDispatcherHandle() == nullptr );
+}
@@ -734,3 +734,50 @@ BOOST_DATA_TEST_CASE(nwdispatcher_multipart_many_chunks_dl, bdata::make( withSSL
   }
 }
 
+
+BOOST_DATA_TEST_CASE(nwdispatcher_preconnect, bdata::make( withSSL ), withSSL )
+{
+  std::string dummyContent = "This is just some dummy content,\nto test downloading and signals.";
+
+  auto ev = zyppng::EventLoop::create();
+
+  WebServer web((zypp::Pathname(TESTS_SHARED_DIR)/"data"/"dummywebroot").c_str(), 10001, withSSL );
+  int handlerCalls = 0;
+  web.addRequestHandler("getData", [&]( WebServer::Request &req ){
+    handlerCalls++;
+    WebServer::makeResponse("200 OK", dummyContent )( req );
+  });
+  BOOST_REQUIRE( web.start() );
+
+  auto disp = std::make_shared<zyppng::NetworkRequestDispatcher>();
+  disp->run();
+  disp->sigQueueFinished().connect( [&ev]( const zyppng::NetworkRequestDispatcher& ){
+    ev->quit();
+  });
+
+  std::vector<zyppng::NetworkRequestError> finished;
+  disp->sigDownloadFinished().connect( [&]( zyppng::NetworkRequestDispatcher &, zyppng::NetworkRequest &req ){
+    finished.push_back( req.error() );
+  });
+
+  zyppng::Url weburl (web.url());
+  weburl.setPathName("/handler/getData");
+
+  // the warm up only connects, nothing is requested
+  disp->preconnect( weburl, web.transferSettings() );
+  if ( disp->count () ) ev->run();
+
+  BOOST_REQUIRE_EQUAL( finished.size(), 1 );
+  BOOST_REQUIRE( !finished.front().isError() );
+  BOOST_REQUIRE_EQUAL( handlerCalls, 0 );
+
+  zypp::filesystem::TmpFile targetFile;
+  auto reqData = std::make_shared<zyppng::NetworkRequest>( weburl, targetFile.path() );
+  reqData->transferSettings() = web.transferSettings();
+  disp->enqueue( reqData );
+  if ( disp->count () ) ev->run();
+
+  BOOST_TEST_REQ_SUCCESS( reqData );
+  BOOST_REQUIRE_EQUAL( handlerCalls, 1 );
+  BOOST_REQUIRE_EQUAL( TestTools::readFile ( targetFile.path() ), dummyContent );
+}
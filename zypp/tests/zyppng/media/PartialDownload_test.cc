@@ -0,0 +1,103 @@
+#include <boost/test/unit_test.hpp>
+
+#include <zypp-curl/ng/network/PartialDownload>
+#include <zypp-curl/parser/MediaBlockList>
+#include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/fs/TmpPath.h>
+#include <zypp-core/Digest.h>
+
+#include <fstream>
+
+using zyppng::PartialDownload;
+using zypp::ByteCount;
+using zypp::CheckSum;
+using zypp::Pathname;
+using zypp::PathInfo;
+
+namespace {
+  void writeFile( const Pathname &file_r, const std::string &content_r )
+  {
+    std::ofstream( file_r.c_str() ) << content_r;
+  }
+
+  std::string readFile( const Pathname &file_r )
+  {
+    std::ifstream in( file_r.c_str() );
+    return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( resume_needs_validators )
+{
+  zypp::filesystem::TmpDir tmp;
+  const Pathname part( tmp.path() / "file.part" );
+
+  // nothing to validate the data with, it is not kept
+  writeFile( part, "0123" );
+  PartialDownload noValidators( part, ByteCount(10) );
+  noValidators.setETag( "W/\"weak\"" );
+  BOOST_CHECK( !noValidators.save() );
+  BOOST_CHECK( !PathInfo( noValidators.resumeFile() ).isExist() );
+  BOOST_CHECK_EQUAL( PartialDownload( part, ByteCount(10) ).prepare(), ByteCount(0) );
+  BOOST_CHECK( !PathInfo( part ).isExist() );
+
+  writeFile( part, "0123" );
+  PartialDownload first( part, ByteCount(10) );
+  first.setETag( "\"abc\"" );
+  BOOST_REQUIRE( first.save() );
+
+  PartialDownload second( part, ByteCount(10) );
+  BOOST_CHECK_EQUAL( second.prepare(), ByteCount(4) );
+  BOOST_CHECK( second.resuming() );
+
+  second.finish();
+  BOOST_CHECK( !PathInfo( second.resumeFile() ).isExist() );
+  BOOST_CHECK( PathInfo( part ).isExist() );
+}
+
+BOOST_AUTO_TEST_CASE( resume_other_file )
+{
+  zypp::filesystem::TmpDir tmp;
+  const Pathname part( tmp.path() / "file.part" );
+  const CheckSum sum = CheckSum::sha256FromString( "0123456789" );
+
+  writeFile( part, "0123" );
+  BOOST_REQUIRE( PartialDownload( part, ByteCount(10), sum ).save() );
+
+  // the caller asks for a different file now
+  PartialDownload other( part, ByteCount(10), CheckSum::sha256FromString( "something else" ) );
+  BOOST_CHECK_EQUAL( other.prepare(), ByteCount(0) );
+  BOOST_CHECK( !PathInfo( part ).isExist() );
+  BOOST_CHECK( !PathInfo( other.resumeFile() ).isExist() );
+
+  // a complete file is not continued
+  writeFile( part, "0123456789" );
+  BOOST_REQUIRE( PartialDownload( part, ByteCount(10), sum ).save() );
+  BOOST_CHECK_EQUAL( PartialDownload( part, ByteCount(10), sum ).prepare(), ByteCount(0) );
+}
+
+BOOST_AUTO_TEST_CASE( resume_verify_blocks )
+{
+  zypp::filesystem::TmpDir tmp;
+  const Pathname part( tmp.path() / "file.part" );
+  const CheckSum sum = CheckSum::sha256FromString( "aaaabbbbcccc" );
+
+  zypp::media::MediaBlockList blocks( 12 );
+  const std::string content( "aaaabbbbcccc" );
+  for ( size_t i = 0; i < 3; i++ ) {
+    const auto blkno = blocks.addBlock( i * 4, 4 );
+    zypp::Digest dig;
+    BOOST_REQUIRE( dig.create( zypp::Digest::sha1() ) );
+    dig.update( content.data() + i * 4, 4 );
+    auto digest = dig.digestVector();
+    blocks.setChecksum( blkno, zypp::Digest::sha1(), int( digest.size() ), digest.data() );
+  }
+
+  // second block is broken, the third one is incomplete
+  writeFile( part, "aaaaXbbbcc" );
+  BOOST_REQUIRE( PartialDownload( part, ByteCount(12), sum ).save() );
+
+  PartialDownload partial( part, ByteCount(12), sum );
+  BOOST_CHECK_EQUAL( partial.prepare( &blocks ), ByteCount(4) );
+  BOOST_CHECK_EQUAL( readFile( part ), "aaaa" );
+}
@@ -439,3 +439,125 @@ BOOST_AUTO_TEST_CASE(SerializeFrame)
   BOOST_REQUIRE_EQUAL( received->bodyRef().asStringView(), "Somedata");
 
 }
+
+BOOST_AUTO_TEST_CASE(SerializeBinaryFrame)
+{
+  int pipeFds[2] { -1, -1 };
+  BOOST_REQUIRE( g_unix_open_pipe( pipeFds, FD_CLOEXEC, nullptr ) );
+
+  auto loop = zyppng::EventLoop::create();
+  auto dataSourceRead = zyppng::AsyncDataSource::create();
+  auto dataSourceWrite = zyppng::AsyncDataSource::create();
+
+  BOOST_REQUIRE( dataSourceRead->openFds( { pipeFds[0] } ) );
+  BOOST_REQUIRE( dataSourceWrite->openFds( {}, pipeFds[1] ) );
+
+  // binary frames do not need any escaping, so use all the characters STOMP would choke on
+  zypp::PluginFrame data("COMMAND");
+  data.addHeader ("header1", "value:with\nnewline");
+  data.addHeader ("header2", "");
+  data.setBody   ( zypp::ByteArray("Some\0data\n", 10) );
+
+  auto sender = zyppng::StompFrameStream::create ( dataSourceWrite );
+  sender->setEncoding( zyppng::StompFrameStream::Binary );
+  BOOST_REQUIRE( sender->sendFrame( data ) );
+  BOOST_REQUIRE( sender->sendFrame( zypp::PluginFrame("SECOND") ) );
+
+  std::vector<zypp::PluginFrame> received;
+  bool receivedErr = false;
+  bool timedOut    = false;
+
+  auto msgQueue = zyppng::StompFrameStream::create ( dataSourceRead );
+  msgQueue->setEncoding( zyppng::StompFrameStream::Binary );
+  msgQueue->connectFunc( &zyppng::StompFrameStream::sigMessageReceived, [&](){
+    while ( auto msg = msgQueue->nextMessage () )
+      received.push_back( std::move(*msg) );
+    if ( received.size() == 2 )
+      loop->quit();
+  });
+
+  msgQueue->connectFunc( &zyppng::StompFrameStream::sigInvalidMessageReceived, [&](){
+    receivedErr = true;
+    loop->quit();
+  });
+
+  // make sure we are not stuck
+  auto timer = zyppng::Timer::create();
+  timer->start( 1000 );
+  timer->connectFunc( &zyppng::Timer::sigExpired, [&]( auto & ){
+    timedOut = true;
+    loop->quit();
+  });
+
+  loop->run();
+
+  ::close( pipeFds[0] );
+
+  BOOST_REQUIRE( !timedOut );
+  BOOST_REQUIRE( !receivedErr );
+  BOOST_REQUIRE_EQUAL( received.size(), 2 );
+  BOOST_REQUIRE_EQUAL( received[0].command(), "COMMAND" );
+  BOOST_REQUIRE_EQUAL( received[0].headerSize(), 2 );
+  BOOST_REQUIRE_EQUAL( received[0].getHeader("header1", {}), "value:with\nnewline" );
+  BOOST_REQUIRE_EQUAL( received[0].getHeader("header2", "notset"), "" );
+  BOOST_REQUIRE( received[0].body() == zypp::ByteArray("Some\0data\n", 10) );
+  BOOST_REQUIRE_EQUAL( received[1].command(), "SECOND" );
+  BOOST_REQUIRE( received[1].body().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(ReceiveBinaryFrameTooLong)
+{
+  int pipeFds[2] { -1, -1 };
+  BOOST_REQUIRE( g_unix_open_pipe( pipeFds, FD_CLOEXEC, nullptr ) );
+
+  auto loop = zyppng::EventLoop::create();
+  auto dataSource = zyppng::AsyncDataSource::create();
+  BOOST_REQUIRE( dataSource->openFds( { pipeFds[0] } ) );
+
+  bool received    = false;
+  bool receivedErr = false;
+  bool timedOut    = false;
+
+  auto msgQueue = zyppng::StompFrameStream::create ( dataSource );
+  msgQueue->setEncoding( zyppng::StompFrameStream::Binary );
+  msgQueue->connectFunc( &zyppng::StompFrameStream::sigMessageReceived, [&](){
+    received = true;
+    loop->quit();
+  });
+
+  msgQueue->connectFunc( &zyppng::StompFrameStream::sigInvalidMessageReceived, [&](){
+    receivedErr = true;
+    loop->quit();
+  });
+
+  // make sure we are not stuck
+  auto timer = zyppng::Timer::create();
+  timer->start( 1000 );
+  timer->connectFunc( &zyppng::Timer::sigExpired, [&]( auto & ){
+    timedOut = true;
+    loop->quit();
+  });
+
+  {
+    // a STOMP frame is read as a huge length prefix
+    std::string_view text (
+          "COMMAND\n"
+          "\n"
+          "Hello\0", 15
+    );
+
+    std::thread writer( []( int writeFd, std::string_view text ){
+      ::write( writeFd, text.data(), text.length() );
+      ::close( writeFd );
+    }, pipeFds[1], text );
+
+    loop->run();
+    writer.join();
+  }
+
+  ::close( pipeFds[0] );
+
+  BOOST_REQUIRE( !received );
+  BOOST_REQUIRE( !timedOut );
+  BOOST_REQUIRE( receivedErr );
+}
@@ -0,0 +1,180 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include <tests/lib/TestSetup.h>
+#undef  INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "argparse.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include <zypp-core/AutoDispose.h>
+#include <zypp-core/ng/base/EventLoop>
+#include <zypp-core/ng/base/EventDispatcher>
+#include <zypp-core/ng/base/SocketNotifier>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... [ARGS]..." << endl;
+  cerr << "    Compare the glib and epoll EventDispatcher backends: dispatched events per second and" << endl;
+  cerr << "    the latency of waking up a idle loop from another thread." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  struct Pipe
+  {
+    Pipe() {
+      int fds[2];
+      if ( ::pipe( fds ) != 0 )
+        ZYPP_THROW( Exception( "pipe failed" ) );
+      _read  = zypp::AutoFD( fds[0] );
+      _write = zypp::AutoFD( fds[1] );
+    }
+    zypp::AutoFD _read;
+    zypp::AutoFD _write;
+  };
+
+  double perSecond( unsigned count_r, Clock::duration dur_r )
+  { return count_r / std::chrono::duration<double>( dur_r ).count(); }
+
+  /** Ping pong of a single byte between two pipes, each transfer is one fd event. */
+  void fdEvents( const std::string & tag_r, unsigned count_r )
+  {
+    auto loop = zyppng::EventLoop::create();
+    Pipe ping;
+    Pipe pong;
+    unsigned events = 0;
+
+    const auto forward = [&]( int from, int to ) {
+      char c;
+      if ( ::read( from, &c, 1 ) != 1 )
+        return;
+      if ( ++events >= count_r )
+        loop->quit();
+      else
+        (void)! ::write( to, &c, 1 );
+    };
+
+    auto n1 = zyppng::SocketNotifier::create( ping._read, zyppng::SocketNotifier::Read );
+    n1->connectFunc( &zyppng::SocketNotifier::sigActivated, [&]( const zyppng::SocketNotifier &, int ) { forward( ping._read, pong._write ); } );
+    auto n2 = zyppng::SocketNotifier::create( pong._read, zyppng::SocketNotifier::Read );
+    n2->connectFunc( &zyppng::SocketNotifier::sigActivated, [&]( const zyppng::SocketNotifier &, int ) { forward( pong._read, ping._write ); } );
+
+    auto start = Clock::now();
+    (void)! ::write( ping._write, "x", 1 );
+    loop->run();
+    cout << str::Format( "%-28s %12.0f events/s" ) % ( tag_r+" fd events" ) % perSecond( events, Clock::now() - start ) << endl;
+  }
+
+  /** Zero timeout callbacks that reschedule themselves, measures the timer bookkeeping. */
+  void timerEvents( const std::string & tag_r, unsigned count_r )
+  {
+    auto loop = zyppng::EventLoop::create();
+    unsigned fired = 0;
+    constexpr unsigned parallel = 64;
+
+    auto start = Clock::now();
+    for ( unsigned i = 0; i < parallel; ++i ) {
+      zyppng::EventDispatcher::invokeAfter( [&]() {
+        if ( ++fired >= count_r ) {
+          loop->quit();
+          return false;
+        }
+        return true;
+      }, 0 );
+    }
+    loop->run();
+    cout << str::Format( "%-28s %12.0f events/s" ) % ( tag_r+" timers" ) % perSecond( fired, Clock::now() - start ) << endl;
+  }
+
+  /** Another thread wakes up the idle loop, measures the time until the notifier fired. */
+  void wakeupLatency( const std::string & tag_r, unsigned count_r )
+  {
+    auto loop = zyppng::EventLoop::create();
+    Pipe p;
+    std::vector<int64_t> latencies;
+    latencies.reserve( count_r );
+
+    auto n = zyppng::SocketNotifier::create( p._read, zyppng::SocketNotifier::Read );
+    n->connectFunc( &zyppng::SocketNotifier::sigActivated, [&]( const zyppng::SocketNotifier &, int ) {
+      int64_t sent = 0;
+      if ( ::read( p._read, &sent, sizeof(sent) ) != sizeof(sent) )
+        return;
+      latencies.push_back( Clock::now().time_since_epoch().count() - sent );
+      if ( latencies.size() >= count_r )
+        loop->quit();
+    });
+
+    std::thread writer( [&]() {
+      for ( unsigned i = 0; i < count_r; ++i ) {
+        std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+        int64_t now = Clock::now().time_since_epoch().count();
+        (void)! ::write( p._write, &now, sizeof(now) );
+      }
+    });
+    loop->run();
+    writer.join();
+
+    std::sort( latencies.begin(), latencies.end() );
+    const auto us = []( int64_t ns_r ) { return std::chrono::duration<double, std::micro>( Clock::duration( ns_r ) ).count(); };
+    cout << str::Format( "%-28s %9.1f us median %9.1f us p99" ) % ( tag_r+" wakeup latency" )
+            % us( latencies[latencies.size() / 2] ) % us( latencies[latencies.size() * 99 / 100] ) << endl;
+  }
+
+  void run( const std::string & tag_r, zyppng::EventDispatcher::Backend backend_r, unsigned count_r )
+  {
+    zyppng::EventDispatcher::setPreferredBackend( backend_r );
+    fdEvents( tag_r, count_r );
+    timerEvents( tag_r, count_r );
+    wakeupLatency( tag_r, std::min( count_r, 2000U ) );
+  }
+}
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  unsigned count = 100000;
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",	"Print help and exit." )
+    ( "count",	"Number of events per measurement (default 100000).", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  if ( result.count( "count" ) )
+    count = str::strtonum<unsigned>( result["count"].arg() );
+  if ( ! count )
+    return errexit( "--count must be a positive number" );
+
+  // go...
+  base::LogControl::TmpLineWriter shutUp;
+  run( "glib: ", zyppng::EventDispatcher::Backend::Glib, count );
+  run( "epoll:", zyppng::EventDispatcher::Backend::Epoll, count );
+
+  return 0;
+}
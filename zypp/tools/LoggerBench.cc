@@ -0,0 +1,96 @@
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include <tests/lib/TestSetup.h>
+#undef  INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "argparse.h"
+
+#include <chrono>
+#include <iostream>
+#include <zypp-core/base/LogControl.h>
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... [ARGS]..." << endl;
+  cerr << "    Measure the cost of log lines with logging disabled and enabled." << endl;
+  cerr << options_r << endl;
+  return return_r;
+}
+
+namespace
+{
+  /** Some formatting work the lazy macros can skip. */
+  std::string expensive( unsigned i_r )
+  { return str::numstring( i_r ) + ":" + str::hexstring( i_r ) + ":" + str::octstring( i_r ); }
+
+  /** Discards all lines after they were formatted. */
+  struct NullLineWriter : public log::LineWriter
+  {
+    void writeOut( const std::string & ) override
+    {}
+  };
+
+  template <class TFnc>
+  void measure( const std::string & name_r, unsigned count_r, TFnc && fnc_r )
+  {
+    auto start = std::chrono::steady_clock::now();
+    for ( unsigned i = 0; i < count_r; ++i )
+      fnc_r( i );
+    auto dur = std::chrono::steady_clock::now() - start;
+    cout << str::Format( "%-32s %10.1f ns/line" ) % name_r
+            % ( double(std::chrono::duration_cast<std::chrono::nanoseconds>( dur ).count()) / count_r ) << endl;
+  }
+
+  void run( const std::string & tag_r, unsigned count_r )
+  {
+    measure( tag_r+" DBG",  count_r, []( unsigned i ) { DBG  << "line " << expensive( i ) << endl; } );
+    measure( tag_r+" lDBG", count_r, []( unsigned i ) { lDBG << "line " << expensive( i ) << endl; } );
+    measure( tag_r+" XXX",  count_r, []( unsigned i ) { XXX  << "line " << expensive( i ) << endl; } );
+    measure( tag_r+" lXXX", count_r, []( unsigned i ) { lXXX << "line " << expensive( i ) << endl; } );
+  }
+}
+
+int main( int argc, char * argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+
+  unsigned count = 100000;
+
+  argparse::Options options;
+  options.add()
+    ( "help,h",	"Print help and exit." )
+    ( "count",	"Number of lines to log per measurement (default 100000).", argparse::Option::Arg::required )
+    ;
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) )
+    return usage( options );
+
+  if ( result.count( "count" ) )
+    count = str::strtonum<unsigned>( result["count"].arg() );
+  if ( ! count )
+    return errexit( "--count must be a positive number" );
+
+  // go...
+  {
+    base::LogControl::TmpLineWriter shutUp;
+    run( "disabled:", count );
+  }
+  {
+    base::LogControl::TmpLineWriter nullWriter( new NullLineWriter );
+    run( "enabled: ", count );
+  }
+
+  return 0;
+}
@@ -33,7 +33,7 @@ try {
   }
 
   zypp::Fetcher fetcher;
-  fetcher.setOptions( zypp::Fetcher::AutoAddIndexes );
+  fetcher.setOptions( zypp::Fetcher::AutoAddIndexes | zypp::Fetcher::ConcurrentDownloads );
   fetcher.enqueueDir( zypp::OnMediaLocation( oRemoteDir ), oRecursive );
 
   zypp::KeyRing::setDefaultAccept( zypp::KeyRing::TRUST_KEY_TEMPORARILY );
@@ -0,0 +1,51 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*
+*/
+#ifndef ZYPPNG_CORE_NG_ASYNC_OFFLOAD_H_INCLUDED
+#define ZYPPNG_CORE_NG_ASYNC_OFFLOAD_H_INCLUDED
+
+#include <zypp-core/ng/async/awaitable.h>
+#include <zypp-core/ng/thread/threadpool.h>
+#include <zypp-core/base/UserRequestException>
+
+#include <functional>
+
+namespace zyppng {
+
+  /*!
+   * Synchronous build variant of \ref offload: there is no event loop to keep
+   * responsive, so \a fn is executed in place and its result returned directly.
+   *
+   * \sa See `offload.h` in zyppng for the asynchronous variant.
+   */
+  template <typename Fn>
+  decltype(auto) offload( Fn &&fn, CancellationToken token = CancellationToken() )
+  {
+    if ( token.cancelled() )
+      ZYPP_THROW( zypp::AbortRequestException("Offloaded job was cancelled") );
+    if constexpr ( std::is_invocable_v<Fn&, const CancellationToken &> )
+      return std::invoke( fn, token );
+    else
+      return std::invoke( fn );
+  }
+
+  /*!
+   * Source compatible with the asynchronous variant, \a pool is not used.
+   */
+  template <typename Fn>
+  decltype(auto) offload( Fn &&fn, CancellationToken token, ThreadPool & )
+  { return offload( std::forward<Fn>(fn), std::move(token) ); }
+
+}
+
+#endif
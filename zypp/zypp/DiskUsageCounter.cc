@@ -12,20 +12,27 @@
 extern "C"
 {
 #include <sys/statvfs.h>
+#include <fcntl.h>
+#include <poll.h>
 }
 
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
 
 #include <zypp-core/base/Easy.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/DtorReset>
 #include <zypp-core/base/String.h>
+#include <zypp-core/AutoDispose.h>
 
 #include <zypp/DiskUsageCounter.h>
 #include <zypp-core/ExternalProgram.h>
 #include <zypp/sat/Pool.h>
 #include <zypp/sat/detail/PoolImpl.h>
+#include <zypp/sat/LookupAttr.h>
+#include <zypp/base/SerialNumber.h>
 
 using std::endl;
 
@@ -37,22 +44,17 @@ namespace zypp
   namespace
   { /////////////////////////////////////////////////////////////////
 
-    DiskUsageCounter::MountPointSet calcDiskUsage( DiskUsageCounter::MountPointSet result, const Bitmap & installedmap_r )
+    /** Raw libsolv disk usage changes per mount point in \a mps_r. */
+    std::vector< ::DUChanges> calcDUChanges( const DiskUsageCounter::MountPointSet & mps_r, const Bitmap & installedmap_r )
     {
-      if ( result.empty() )
-      {
-        // partitioning is not set
-        return result;
-      }
-
       sat::Pool satpool( sat::Pool::instance() );
 
       // init libsolv result vector with mountpoints
       static const ::DUChanges _initdu = { 0, 0, 0, 0 };
-      std::vector< ::DUChanges> duchanges( result.size(), _initdu );
+      std::vector< ::DUChanges> duchanges( mps_r.size(), _initdu );
       {
         unsigned idx = 0;
-        for_( it, result.begin(), result.end() )
+        for_( it, mps_r.begin(), mps_r.end() )
         {
           duchanges[idx].path = it->dir.c_str();
           if ( it->growonly )
@@ -65,19 +67,37 @@ namespace zypp
                              const_cast<Bitmap &>(installedmap_r),
                              &duchanges[0],
                              duchanges.size() );
+      return duchanges;
+    }
+
+    /** Used size of \a mp_r after installation in KiB. */
+    inline long long pkgSize( const DiskUsageCounter::MountPoint & mp_r, long long kbytes_r, long long files_r )
+    {
+      // Limit estimated waste (half block per file) as it does not apply to
+      // btrfs, which reports up to 64K blocksize (bsc#974275,bsc#965322)
+      static const ByteCount blockAdjust( 2, ByteCount::K ); // (files * blocksize) / 2 / 1K; result value in K!
+
+      return mp_r.used_size          // current usage
+           + kbytes_r                // package data size
+           + ( files_r * ( mp_r.fstype == "btrfs" ? 4096 : mp_r.block_size ) / blockAdjust ); // half block per file
+    }
+
+    DiskUsageCounter::MountPointSet calcDiskUsage( DiskUsageCounter::MountPointSet result, const Bitmap & installedmap_r )
+    {
+      if ( result.empty() )
+      {
+        // partitioning is not set
+        return result;
+      }
+
+      std::vector< ::DUChanges> duchanges { calcDUChanges( result, installedmap_r ) };
 
       // and process the result
       {
         unsigned idx = 0;
         for_( it, result.begin(), result.end() )
         {
-          // Limit estimated waste (half block per file) as it does not apply to
-          // btrfs, which reports up to 64K blocksize (bsc#974275,bsc#965322)
-          static const ByteCount blockAdjust( 2, ByteCount::K ); // (files * blocksize) / 2 / 1K; result value in K!
-
-          it->pkg_size = it->used_size          // current usage
-                       + duchanges[idx].kbytes  // package data size
-                       + ( duchanges[idx].files * ( it->fstype == "btrfs" ? 4096 : it->block_size ) / blockAdjust ); // half block per file
+          it->pkg_size = pkgSize( *it, duchanges[idx].kbytes, duchanges[idx].files );
           ++idx;
         }
       }
@@ -85,6 +105,71 @@ namespace zypp
       return result;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class MountTableCache
+    /// \brief The result of \ref DiskUsageCounter::detectMountPoints.
+    ///
+    /// Valid until the kernel reports a change of the mount table
+    /// (/proc/self/mounts being pollable for POLLPRI, see proc(5)).
+    ///////////////////////////////////////////////////////////////////
+    struct MountTableCache
+    {
+      static MountTableCache & instance()
+      {
+        static MountTableCache _instance;
+        return _instance;
+      }
+
+      /** Whether a cached result for \a rootdir_r is available. */
+      bool valid( const std::string & rootdir_r ) const
+      {
+        if ( _watch == -1 || rootdir_r != _rootdir )
+          return false;
+        struct pollfd pfd { _watch, POLLPRI, 0 };
+        return ::poll( &pfd, 1, 0 ) == 0;	// no change, no error
+      }
+
+      /** Start watching the mount table; must be called before parsing it. */
+      void watch()
+      {
+        _watch = AutoFD( ::open( "/proc/self/mounts", O_RDONLY | O_CLOEXEC ) );
+        _rootdir.clear();
+      }
+
+      /** Remember the parsed result. */
+      void remember( const std::string & rootdir_r, const DiskUsageCounter::MountPointSet & mps_r )
+      {
+        if ( _watch == -1 )
+          return;
+        _rootdir = rootdir_r;
+        _mps = mps_r;
+      }
+
+      /** The cached result with freshly queried filesystem sizes. */
+      DiskUsageCounter::MountPointSet refreshed() const
+      {
+        DiskUsageCounter::MountPointSet ret;
+        const std::string prfx { _rootdir != "/" ? _rootdir : std::string() };
+        for ( DiskUsageCounter::MountPoint mp : _mps )
+        {
+          struct statvfs sb;
+          if ( statvfs( (prfx + mp.dir).c_str(), &sb ) == 0 && sb.f_blocks != 0 && sb.f_bsize != 0 )
+          {
+            mp.total_size = ((long long)sb.f_blocks)*sb.f_bsize/1024;
+            mp.used_size  = ((long long)(sb.f_blocks - sb.f_bfree))*sb.f_bsize/1024;
+          }
+          ret.insert( std::move(mp) );
+        }
+        return ret;
+      }
+
+      std::mutex _lock;
+    private:
+      AutoFD _watch { -1 };
+      std::string _rootdir;
+      DiskUsageCounter::MountPointSet _mps;
+    };
+
     /////////////////////////////////////////////////////////////////
   } // namespace
   ///////////////////////////////////////////////////////////////////
@@ -128,6 +213,12 @@ namespace zypp
 
   DiskUsageCounter::MountPointSet DiskUsageCounter::detectMountPoints( const std::string & rootdir )
   {
+    MountTableCache & cache { MountTableCache::instance() };
+    std::lock_guard<std::mutex> guard( cache._lock );
+    if ( cache.valid( rootdir ) )
+      return cache.refreshed();
+    cache.watch();
+
     DiskUsageCounter::MountPointSet ret;
 
     typedef std::map<std::string, MountPoint> Btrfsfilter;
@@ -331,6 +422,7 @@ namespace zypp
     for ( auto && bmp : btrfsfilter )
       ret.insert( std::move(bmp.second) );
 
+    cache.remember( rootdir, ret );
     return ret;
   }
 
@@ -341,6 +433,204 @@ namespace zypp
     return ret;
   }
 
+  ///////////////////////////////////////////////////////////////////
+  /// \class DiskUsageCounter::Tracker::Impl
+  /// \brief DiskUsageCounter::Tracker implementation.
+  ///////////////////////////////////////////////////////////////////
+  class DiskUsageCounter::Tracker::Impl
+  {
+  public:
+    Impl( MountPointSet mps_r )
+    : _mps { std::move(mps_r) }
+    { reset(); }
+
+    const MountPointSet & mps() const
+    { return _mps; }
+
+    MountPointSet update( const ResPool & pool_r )
+    {
+      // we look at all items, so earlier changes are covered
+      ResStatus::takeTransactJournal();
+      if ( _poolWatcher.remember( pool_r.serial() ) )
+        reset();
+      const bool fillOwners = _statusOwner.empty();
+      for ( const PoolItem & pi : pool_r )
+      {
+        if ( fillOwners )
+          _statusOwner.emplace( &pi.status(), pi.satSolvable().id() );
+        process( pi );
+      }
+      _initialized = true;
+      return result( pool_r );
+    }
+
+    MountPointSet update()
+    {
+      ResStatus::TransactJournal journal { ResStatus::takeTransactJournal() };
+      ResPool pool { ResPool::instance() };
+      if ( ! _initialized || journal.overflow || _poolWatcher.isDirty( pool.serial() ) )
+        return update( pool );	// need a full scan
+
+      for ( const ResStatus * status : journal.changed )
+      {
+        // statuses not owned by a pool item (copies, backups) are not found
+        auto range { _statusOwner.equal_range( status ) };
+        for ( auto it = range.first; it != range.second; ++it )
+          process( pool.find( sat::Solvable( it->second ) ) );
+      }
+      return result( pool );
+    }
+
+    MountPointSet update( const std::vector<PoolItem> & changed_r )
+    {
+      ResPool pool { ResPool::instance() };
+      if ( ! _initialized || _poolWatcher.isDirty( pool.serial() ) )
+        return update( pool );	// need a full scan
+      for ( const PoolItem & pi : changed_r )
+        process( pi );
+      return result( pool );
+    }
+
+  private:
+    /** Disk usage of a solvable per mount point. */
+    struct Usage
+    {
+      long long kbytes = 0;
+      long long files = 0;
+    };
+
+    struct CacheEntry
+    {
+      bool hasDu = false;
+      std::vector<Usage> usage;
+    };
+
+    /** +1: to be installed, -1: to be deleted, 0: no change */
+    static int transactSign( const PoolItem & pi_r )
+    { return pi_r.status().transacts() ? ( pi_r.status().isInstalled() ? -1 : 1 ) : 0; }
+
+    void reset()
+    {
+      _duCache.clear();
+      _state.clear();
+      _added.assign( _mps.size(), Usage() );
+      _removed.assign( _mps.size(), Usage() );
+      _noDuInstalls = 0;
+      _initialized = false;
+      _statusOwner.clear();
+    }
+
+    /** The solvables cached disk usage per mount point. */
+    const CacheEntry & duOf( sat::Solvable solv_r )
+    {
+      auto it = _duCache.find( solv_r.id() );
+      if ( it != _duCache.end() )
+        return it->second;
+
+      CacheEntry & entry { _duCache[solv_r.id()] };
+      entry.hasDu = ! sat::LookupAttr( sat::SolvAttr::diskusage, solv_r ).empty();
+      entry.usage.assign( _mps.size(), Usage() );
+      if ( entry.hasDu && ! _mps.empty() )
+      {
+        Bitmap bitmap( Bitmap::poolSize );
+        bitmap.set( solv_r.id() );
+
+        // temp. unset @system Repo
+        DtorReset tmp( sat::Pool::instance().get()->installed );
+        sat::Pool::instance().get()->installed = nullptr;
+
+        std::vector< ::DUChanges> duchanges { calcDUChanges( _mps, bitmap ) };
+        for ( unsigned idx = 0; idx < duchanges.size(); ++idx )
+          entry.usage[idx] = { duchanges[idx].kbytes, duchanges[idx].files };
+      }
+      return entry;
+    }
+
+    /** Add (\a factor_r 1) or revert (\a factor_r -1) a solvables contribution. */
+    void apply( sat::Solvable solv_r, int sign_r, int factor_r )
+    {
+      const CacheEntry & entry { duOf( solv_r ) };
+      if ( sign_r > 0 && ! entry.hasDu )
+        _noDuInstalls += factor_r;
+
+      std::vector<Usage> & sums { sign_r > 0 ? _added : _removed };
+      for ( unsigned idx = 0; idx < sums.size(); ++idx )
+      {
+        sums[idx].kbytes += factor_r * entry.usage[idx].kbytes;
+        sums[idx].files  += factor_r * entry.usage[idx].files;
+      }
+    }
+
+    void process( const PoolItem & pi_r )
+    {
+      sat::Solvable solv { pi_r.satSolvable() };
+      int sign = transactSign( pi_r );
+      auto it = _state.find( solv.id() );
+      int old = ( it == _state.end() ? 0 : it->second );
+      if ( sign == old )
+        return;
+
+      if ( old )
+        apply( solv, old, -1 );
+      if ( sign )
+      {
+        apply( solv, sign, 1 );
+        _state[solv.id()] = sign;
+      }
+      else
+        _state.erase( it );
+    }
+
+    MountPointSet result( const ResPool & pool_r ) const
+    {
+      if ( _noDuInstalls )
+        return DiskUsageCounter( _mps ).disk_usage( pool_r );	// libsolv needs to guess
+
+      MountPointSet ret { _mps };
+      unsigned idx = 0;
+      for_( it, ret.begin(), ret.end() )
+      {
+        long long kbytes = _added[idx].kbytes;
+        long long files  = _added[idx].files;
+        if ( ! it->growonly )
+        {
+          kbytes -= _removed[idx].kbytes;
+          files  -= _removed[idx].files;
+        }
+        it->pkg_size = pkgSize( *it, kbytes, files );
+        ++idx;
+      }
+      return ret;
+    }
+
+  private:
+    MountPointSet _mps;
+    SerialNumberWatcher _poolWatcher;
+    bool _initialized = false;
+    std::unordered_map<sat::detail::SolvableIdType,CacheEntry> _duCache;
+    std::unordered_map<sat::detail::SolvableIdType,int> _state;	///< transactSign of all transacting solvables
+    std::vector<Usage> _added;		///< summed up usage of solvables to be installed
+    std::vector<Usage> _removed;	///< summed up usage of solvables to be deleted
+    unsigned _noDuInstalls = 0;		///< number of solvables to be installed without disk usage data
+    std::unordered_multimap<const ResStatus *,sat::detail::SolvableIdType> _statusOwner;	///< pool items sharing a status, to resolve the transact journal
+  };
+
+  DiskUsageCounter::Tracker::Tracker( MountPointSet mps_r )
+  : _pimpl { new Impl( std::move(mps_r) ) }
+  {}
+
+  const DiskUsageCounter::MountPointSet & DiskUsageCounter::Tracker::getMountPoints() const
+  { return _pimpl->mps(); }
+
+  DiskUsageCounter::MountPointSet DiskUsageCounter::Tracker::update( const ResPool & pool_r )
+  { return _pimpl->update( pool_r ); }
+
+  DiskUsageCounter::MountPointSet DiskUsageCounter::Tracker::update( const std::vector<PoolItem> & changed_r )
+  { return _pimpl->update( changed_r ); }
+
+  DiskUsageCounter::MountPointSet DiskUsageCounter::Tracker::update()
+  { return _pimpl->update(); }
+
   std::ostream & operator<<( std::ostream & str, const DiskUsageCounter::MountPoint & obj )
   {
      str << "dir:[" << obj.dir << "] [ bs: " << obj.blockSize()
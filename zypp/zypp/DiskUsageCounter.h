@@ -19,6 +19,7 @@
 
 #include <zypp/ResPool.h>
 #include <zypp/Bitmap.h>
+#include <zypp-core/base/PtrTypes.h>
 #include <zypp-core/base/Flags.h>
 
 ///////////////////////////////////////////////////////////////////
@@ -173,6 +174,9 @@ namespace zypp
      * If we happen to detect snapshotting btrfs partitions, the MountPoint::growonly
      * hint is set. Disk usage computation will assume that deleted packages will not
      * free any space (kept in a snapshot).
+     *
+     * The mount table is parsed once and cached until the kernel reports a
+     * change (mount/umount). Filesystem sizes are refreshed on each call.
      */
     static MountPointSet detectMountPoints( const std::string & rootdir = "/" );
 
@@ -205,6 +209,58 @@ namespace zypp
       return disk_usage( bitmap );
     }
 
+  public:
+    ///////////////////////////////////////////////////////////////////
+    /// \class DiskUsageCounter::Tracker
+    /// \brief Incrementally compute disk usage of the current transaction.
+    ///
+    /// Like \ref DiskUsageCounter::disk_usage(const ResPool &), but the per
+    /// solvable disk usage and the transaction state computed last time are
+    /// remembered. An \ref update just processes the solvables whose transact
+    /// status changed since then, \ref update() finds them without walking
+    /// the pool. The cache is dropped if the pools content
+    /// changes (repos added or removed).
+    ///
+    /// \note If a package without disk usage data is to be installed, libsolv
+    /// estimates its size from the installed package it replaces. This is not
+    /// a per solvable property, so we fall back to a full computation while
+    /// such a package is in the transaction.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_API Tracker
+    {
+    public:
+      /** Ctor taking the MountPointSet to compute */
+      Tracker( MountPointSet mps_r );
+
+      /** The MountPointSet to compute */
+      const MountPointSet & getMountPoints() const;
+
+      /** Compute disk usage if the current transaction woud be commited.
+       * Only solvables whose transact status changed since the last
+       * update contribute computational cost.
+       */
+      MountPointSet update( const ResPool & pool_r );
+
+      /** Compute disk usage if the current transaction woud be commited,
+       * assuming just the transact status of \a changed_r changed since
+       * the last update (O(changes)).
+       */
+      MountPointSet update( const std::vector<PoolItem> & changed_r );
+
+      /** Compute disk usage if the current transaction woud be commited,
+       * revisiting just the items whose transact status changed according to
+       * the \ref ResStatus::TransactJournal. Falls back to a scan of the pool
+       * if the journal overflowed or the pools content changed.
+       * \note Uses the journal of the calling thread.
+       */
+      MountPointSet update();
+
+    public:
+      class Impl;               ///< Implementation class.
+    private:
+      RW_pointer<Impl> _pimpl;	///< Pointer to implementation.
+    };
+
   private:
     MountPointSet _mps;
   };
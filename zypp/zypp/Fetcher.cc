@@ -13,6 +13,8 @@
 #include <fstream>
 #include <list>
 #include <map>
+#include <set>
+#include <algorithm>
 
 #include <zypp-core/base/Easy.h>
 #include <zypp-core/base/LogControl.h>
@@ -24,6 +26,7 @@
 #include <zypp/Fetcher.h>
 #include <zypp/ZYppFactory.h>
 #include <zypp/CheckSum.h>
+#include <zypp-media/mediaconfig.h>
 #include <zypp-core/base/UserRequestException>
 #include <zypp/parser/susetags/ContentFileReader.h>
 #include <zypp/parser/susetags/RepoIndex.h>
@@ -280,6 +283,12 @@ namespace zypp
        */
       void provideToDest( MediaSetAccess & media_r, const Pathname & destDir_r , const FetcherJob_Ptr & jobp_r );
 
+      /**
+       * Starts downloading the files of the jobs following \a next_r in the
+       * background, see \ref Fetcher::ConcurrentDownloads.
+       */
+      void precacheJobs( MediaSetAccess & media_r, const Pathname & destDir_r, std::list<FetcherJob_Ptr>::const_iterator next_r );
+
   private:
     friend Impl * rwcowClone<Impl>( const Impl * rhs );
     /** clone for RWCOW_pointer */
@@ -287,6 +296,8 @@ namespace zypp
     { return new Impl( *this ); }
 
     std::list<FetcherJob_Ptr>   _resources;
+    // jobs already handed to MediaSetAccess::precacheFiles
+    std::set<FetcherJob_Ptr> _precached;
     std::set<FetcherIndex_Ptr,SameFetcherIndex> _indexes;
     std::set<CacheInfo> _caches;
     // checksums read from the indexes
@@ -379,6 +390,7 @@ namespace zypp
     _indexes.clear();
     _checksums.clear();
     _dircontent.clear();
+    _precached.clear();
   }
 
   void Fetcher::Impl::setMediaSetAccess( MediaSetAccess &media )
@@ -638,6 +650,45 @@ namespace zypp
     }
   }
 
+  void Fetcher::Impl::precacheJobs( MediaSetAccess & media_r, const Pathname & destDir_r, std::list<FetcherJob_Ptr>::const_iterator next_r )
+  {
+    const long window = std::max( 1L, MediaConfig::instance().download_max_concurrent_connections() );
+
+    std::vector<OnMediaLocation> files;
+    long ahead = 0;
+    for ( ; next_r != _resources.end() && ahead < window; ++next_r )
+    {
+      const FetcherJob_Ptr & jobp { *next_r };
+      if ( jobp->flags & FetcherJob::Directory )
+        continue;
+
+      ++ahead;
+      if ( ! _precached.insert( jobp ).second )
+        continue;
+
+      // a file that is likely found in a cache is not downloaded ahead, locateInCache checks it later
+      const Pathname inCachePath { mapToCachePath( jobp->location ) };
+      if ( PathInfo( destDir_r / inCachePath ).isExist()
+           || std::any_of( _caches.begin(), _caches.end(), [&]( const CacheInfo & cacheInfo ) { return PathInfo( cacheInfo._pathName / inCachePath ).isExist(); } ) )
+        continue;
+
+      files.push_back( jobp->location );
+    }
+
+    if ( files.empty() )
+      return;
+
+    try
+    {
+      media_r.precacheFiles( files );
+    }
+    catch ( const Exception & excpt )
+    {
+      // the files are provided one by one then
+      ZYPP_CAUGHT( excpt );
+    }
+  }
+
   // helper class to consume a content file
   struct ContentReaderHelper : public parser::susetags::ContentFileReader
   {
@@ -811,9 +862,12 @@ namespace zypp
     progress.sendTo(progress_receiver);
 
     downloadAndReadIndexList(media, dest_dir);
+    _precached.clear();
 
-    for ( const FetcherJob_Ptr & jobp : _resources )
+    for ( auto it = _resources.begin(); it != _resources.end(); ++it )
     {
+      const FetcherJob_Ptr & jobp { *it };
+
       if ( jobp->flags & FetcherJob::Directory )
       {
           const OnMediaLocation location(jobp->location);
@@ -882,6 +936,11 @@ namespace zypp
           jobp->checkers.push_back(digest_check);
       }
 
+      // Queue the next files, their transfers run along with this file's download.
+      // They do not progress while this file is validated and copied, see ConcurrentDownloads.
+      if ( _options & Fetcher::ConcurrentDownloads )
+        precacheJobs( media, dest_dir, std::next( it ) );
+
       // Provide and validate the file. If the file was not transferred
       // and no exception was thrown, it was an optional file.
       provideToDest( media, dest_dir, jobp );
@@ -139,6 +139,16 @@ namespace zypp
        * it is downloaded and read.
        */
       AutoAddIndexes = AutoAddContentFileIndexes | AutoAddChecksumsIndexes,
+      /**
+       * The next files are queued for download while the current one is
+       * downloaded, so their transfers run at the same time. They only make
+       * progress while the media waits for a download, not while a file is
+       * validated or copied to the destination. The number of files queued
+       * ahead is limited by \ref MediaConfig::download_max_concurrent_connections.
+       * Only media supporting \ref MediaSetAccess::precacheFiles make
+       * use of it, others provide the files one by one.
+       */
+      ConcurrentDownloads = 0x0004,
     };
     ZYPP_DECLARE_FLAGS(Options, Option);
 
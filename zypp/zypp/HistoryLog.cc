@@ -17,6 +17,7 @@
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/IOStream.h>
+#include <zypp-core/base/InputStream>
 
 #include <zypp/PathInfo.h>
 #include <zypp-core/Date.h>
@@ -108,10 +109,72 @@ namespace zypp
     Pathname		_fname;
     Pathname		_fnameLastFail;
 
+    /** Sidecar index of the history file (\ref HISTORY_LOG_INDEX_SUFFIX).
+     * Lines of "<seconds since epoch> <offset>" pointing to the start of a
+     * record, written every \ref _indexChunk bytes. It helps the
+     * \ref parser::HistoryLogReader to seek to a date.
+     */
+    const off_t		_indexChunk = 64 * 1024;
+    off_t		_indexLast = -1;	///< offset of the last index entry (-1: none)
+    bool		_indexLoaded = false;	///< whether _indexLast was initialized
+
+    inline void indexReset()
+    {
+      _indexLast = -1;
+      _indexLoaded = false;
+    }
+
+    /** Remember the upcoming records offset in the index if necessary. */
+    inline void indexRecord( const Date & date_r )
+    {
+      if ( ! _log.is_open() )
+        return;
+      PathInfo pi( _fname );
+      if ( ! pi.isFile() )
+        return;	// e.g. /dev/null
+
+      const Pathname iname { _fname.extend( HISTORY_LOG_INDEX_SUFFIX ) };
+      if ( ! _indexLoaded )
+      {
+        if ( PathInfo( iname ).isFile() )
+        {
+          iostr::forEachLine( InputStream( iname ), []( int, std::string line_r )->bool {
+            _indexLast = str::strtonum<off_t>( str::stripLastWord( line_r ) );
+            return true;
+          } );
+        }
+        _indexLoaded = true;
+      }
+
+      if ( _indexLast > pi.size() )
+      {
+        // history was rotated: start a new index
+        MIL << "Reset history index " << iname << endl;
+        filesystem::unlink( iname );
+        _indexLast = -1;
+      }
+      else if ( _indexLast >= 0 && pi.size() - _indexLast < _indexChunk )
+        return;
+
+      std::ofstream idx( iname.c_str(), std::ios::out|std::ios::app );
+      idx << (Date::ValueType)date_r << " " << pi.size() << endl;
+      if ( idx )
+        _indexLast = pi.size();
+    }
+
+    /** Timestamp of a new record; maintains the index. */
+    inline string recordTimestamp()
+    {
+      Date now { Date::now() };
+      indexRecord( now );
+      return now.form( HISTORY_LOG_DATE_FORMAT );
+    }
+
     inline void openLog()
     {
       if ( _fname.empty() )
         _fname = ZConfig::instance().historyLogFile();
+      indexReset();
 
       _log.clear();
       _log.open( _fname.asString().c_str(), std::ios::out|std::ios::app );
@@ -171,6 +234,7 @@ namespace zypp
     _fname = ZConfig::instance().historyLogFile();
     if ( _fname != "/dev/null" )  // no need to redirect /dev/null into the target
       _fname = rootdir / _fname;
+    indexReset();
     filesystem::assert_dir( _fname.dirname() );
     MIL << "installation log file " << _fname << endl;
 
@@ -222,7 +286,7 @@ namespace zypp
   void HistoryLog::stampCommand()
   {
     _log
-      << timestamp()							// 1 timestamp
+      << recordTimestamp()						// 1 timestamp
       << _sep << HistoryActionID::STAMP_COMMAND.asString(true)		// 2 action
       << _sep << userAtHostname()					// 3 requested by
       << _sep << cmdline()						// 4 command
@@ -237,7 +301,7 @@ namespace zypp
     const Package::constPtr p = asKind<Package>(pi.resolvable());
 
     _log
-      << timestamp()							// 1 timestamp
+      << recordTimestamp()						// 1 timestamp
       << _sep << HistoryActionID::INSTALL.asString(true)		// 2 action
       << _sep << p->name()						// 3 name
       << _sep << p->edition()						// 4 evr
@@ -265,7 +329,7 @@ namespace zypp
     const Package::constPtr p = asKind<Package>(pi.resolvable());
 
     _log
-      << timestamp()							// 1 timestamp
+      << recordTimestamp()						// 1 timestamp
       << _sep << HistoryActionID::REMOVE.asString(true)			// 2 action
       << _sep << p->name()						// 3 name
       << _sep << p->edition()						// 4 evr
@@ -289,7 +353,7 @@ namespace zypp
   void HistoryLog::addRepository(const RepoInfo & repo)
   {
     _log
-      << timestamp()							// 1 timestamp
+      << recordTimestamp()						// 1 timestamp
       << _sep << HistoryActionID::REPO_ADD.asString(true)		// 2 action
       << _sep << str::escape(repo.alias(), _sep)			// 3 alias
       << _sep << str::escape(repo.url().asString(), _sep)		// 4 primary URL
@@ -301,7 +365,7 @@ namespace zypp
   void HistoryLog::removeRepository(const RepoInfo & repo)
   {
     _log
-      << timestamp()							// 1 timestamp
+      << recordTimestamp()						// 1 timestamp
       << _sep << HistoryActionID::REPO_REMOVE.asString(true)		// 2 action
       << _sep << str::escape(repo.alias(), _sep)			// 3 alias
       << _sep << str::escape(ZConfig::instance().userData(), _sep)	// 4 userdata
@@ -315,7 +379,7 @@ namespace zypp
     if (oldrepo.alias() != newrepo.alias())
     {
       _log
-        << timestamp()							// 1 timestamp
+        << recordTimestamp()						// 1 timestamp
         << _sep << HistoryActionID::REPO_CHANGE_ALIAS.asString(true)	// 2 action
         << _sep << str::escape(oldrepo.alias(), _sep)			// 3 old alias
         << _sep << str::escape(newrepo.alias(), _sep)			// 4 new alias
@@ -325,7 +389,7 @@ namespace zypp
     if ( oldrepo.url() != newrepo.url() )
     {
       _log
-        << timestamp()							// 1 timestamp
+        << recordTimestamp()						// 1 timestamp
         << _sep << HistoryActionID::REPO_CHANGE_URL.asString(true)	// 2 action
         << _sep << str::escape(oldrepo.url().asString(), _sep)		// 3 old url
         << _sep << str::escape(newrepo.url().asString(), _sep)		// 4 new url
@@ -340,7 +404,7 @@ namespace zypp
     const Patch::constPtr p = asKind<Patch>(pi.resolvable());
 
     _log
-      << timestamp()							// 1 timestamp
+      << recordTimestamp()						// 1 timestamp
       << _sep << HistoryActionID::PATCH_STATE_CHANGE.asString(true)	// 2 action
       << _sep << p->name()						// 3 name
       << _sep << p->edition()						// 4 evr
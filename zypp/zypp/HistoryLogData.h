@@ -24,6 +24,7 @@
 #include <zypp/Patch.h>
 
 #define HISTORY_LOG_DATE_FORMAT "%Y-%m-%d %H:%M:%S"
+#define HISTORY_LOG_INDEX_SUFFIX ".idx"
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
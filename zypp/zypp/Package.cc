@@ -15,6 +15,7 @@
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/String.h>
 #include <zypp-core/base/StringV.h>
+#include <zypp-core/fs/BulkIO.h>
 #include <zypp/Package.h>
 #include <zypp/sat/LookupAttr.h>
 #include <zypp/ZYppFactory.h>
@@ -123,6 +124,39 @@ namespace zyppintern
 
     return pi.path();		// the right one
   }
+
+  /** Batch version of \ref cachedLocation, the cached files are verified concurrently. */
+  std::vector<Pathname> cachedLocations( const std::vector<std::pair<OnMediaLocation, RepoInfo>> & items_r )
+  {
+    std::vector<Pathname> ret( items_r.size() );
+    std::vector<std::size_t> pending;
+    std::vector<std::pair<Pathname, std::string>> files;
+
+    for ( std::size_t idx = 0; idx < items_r.size(); ++idx )
+    {
+      const auto & [ loc, repo ] = items_r[idx];
+      if ( loc.checksum().empty() )
+      {
+        ret[idx] = cachedLocation( loc, repo );	// rare, needs to compare with the repo
+        continue;
+      }
+
+      Pathname path( repo.packagesPath() / repo::RepoMediaAccess::mapToCachePath( repo, loc ) );
+      if ( ! PathInfo( path ).isExist() )
+        continue;		// no file in cache
+
+      pending.push_back( idx );
+      files.push_back( { std::move(path), loc.checksum().type() } );
+    }
+
+    const std::vector<std::string> sums { filesystem::checksums( files ) };
+    for ( std::size_t i = 0; i < pending.size(); ++i )
+    {
+      if ( sums[i] == items_r[pending[i]].first.checksum().checksum() )
+        ret[pending[i]] = files[i].first;	// the right one
+    }
+    return ret;
+  }
 } // namespace zyppintern
 ///////////////////////////////////////////////////////////////////
 
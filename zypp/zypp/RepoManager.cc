@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <zypp-core/Digest.h>
+#include <zypp-core/base/Trace.h>
 #include <zypp-core/ng/pipelines/Lift>
 #include <zypp/ng/progressobserveradaptor.h>
 #include <zypp/ng/context.h>
@@ -141,6 +142,7 @@ namespace zypp
 
   void RepoManager::refreshMetadata( const RepoInfo &info, RawMetadataRefreshPolicy policy, const ProgressData::ReceiverFnc & progressrcv )
   {
+    ZYPP_TRACE_SPAN_DETAIL( "RepoManager::refreshMetadata", info.alias(), "zypp" );
     // Suppress (interactive) media::MediaChangeReport if we have fallback URLs
     zypp::media::ScopedDisableMediaChangeReport guard( info.repoOrigins().hasFallbackUrls() );
     return _pimpl->ngMgr().refreshMetadata( info, policy, nullptr ).unwrap();
@@ -157,6 +159,7 @@ namespace zypp
 
   void RepoManager::buildCache( const RepoInfo &info, CacheBuildPolicy policy, const ProgressData::ReceiverFnc & progressrcv )
   {
+    ZYPP_TRACE_SPAN_DETAIL( "RepoManager::buildCache", info.alias(), "zypp" );
     callback::SendReport<ProgressReport> report;
     auto adapt = zyppng::ProgressObserverAdaptor( progressrcv, report );
     return _pimpl->ngMgr().buildCache( info, policy, adapt.observer() ).unwrap();
@@ -169,7 +172,10 @@ namespace zypp
   { return _pimpl->ngMgr().isCached( info ).unwrap(); }
 
   void RepoManager::loadFromCache( const RepoInfo &info, const ProgressData::ReceiverFnc & progressrcv )
-  { return _pimpl->ngMgr().loadFromCache( info, nullptr ).unwrap(); }
+  {
+    ZYPP_TRACE_SPAN_DETAIL( "RepoManager::loadFromCache", info.alias(), "zypp" );
+    return _pimpl->ngMgr().loadFromCache( info, nullptr ).unwrap();
+  }
 
   void RepoManager::cleanCacheDirGarbage( const ProgressData::ReceiverFnc & progressrcv )
   { return _pimpl->ngMgr().cleanCacheDirGarbage( nullptr ).unwrap(); }
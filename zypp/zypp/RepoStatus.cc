@@ -14,8 +14,10 @@
 #include <fstream>
 #include <optional>
 #include <set>
+#include <vector>
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/String.h>
+#include <zypp-core/Digest.h>
 #include <zypp/RepoStatus.h>
 #include <zypp/RepoInfo.h>
 #include <zypp/PathInfo.h>
@@ -221,6 +223,29 @@ namespace zypp
     return ret;
   }
 
+  RepoStatus RepoStatus::fromFiles( const std::vector<Pathname> & paths_r )
+  {
+    RepoStatus ret;
+    std::vector<Pathname> files;
+    std::vector<Date> mtimes;
+    for ( const auto & path : paths_r )
+    {
+      PathInfo info( path );
+      if ( info.isFile() )
+      {
+        files.push_back( path );
+        mtimes.push_back( Date( info.mtime() ) );
+      }
+      else
+        ret = ret && RepoStatus( path );
+    }
+
+    const std::vector<std::string> sums { Digest::digestFiles( "SHA256", files ) };
+    for ( std::size_t i = 0; i < files.size(); ++i )
+      ret = ret && RepoStatus( sums[i], mtimes[i] );
+    return ret;
+  }
+
   void RepoStatus::saveToCookieFile( const Pathname & path_r ) const
   {
     std::ofstream file(path_r.c_str());
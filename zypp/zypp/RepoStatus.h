@@ -13,6 +13,7 @@
 #define ZYPP2_REPOSTATUS_H
 
 #include <iosfwd>
+#include <vector>
 #include <zypp-core/base/PtrTypes.h>
 #include <zypp/CheckSum.h>
 #include <zypp-core/Date.h>
@@ -88,6 +89,12 @@ namespace zypp
      */
     static RepoStatus fromCookieFileUseMtime( const Pathname & path );
 
+    /** Combined status of all \a paths_r.
+     * Same as joining the \ref RepoStatus of each path via \c &&,
+     * but regular files are hashed concurrently.
+     */
+    static RepoStatus fromFiles( const std::vector<Pathname> & paths_r );
+
     /** Save the status information to a cookie file
      * \throws Exception if the file can't be saved
      * \see \ref fromCookieFile
@@ -25,6 +25,40 @@ namespace zypp
   const ResStatus ResStatus::toBeUninstalledDueToUpgrade (INSTALLED,   UNDETERMINED, TRANSACT, EXPLICIT_INSTALL, DUE_TO_UPGRADE);
   const ResStatus ResStatus::toBeUninstalledDueToObsolete(INSTALLED,   UNDETERMINED, TRANSACT, EXPLICIT_INSTALL, DUE_TO_OBSOLETE);
 
+  namespace
+  {
+    /** Changes kept until the journal is taken, ~ the number of solvables a big transaction touches. */
+    constexpr std::size_t transactJournalLimit = 64 * 1024;
+
+    ResStatus::TransactJournal & transactJournal()
+    {
+      thread_local ResStatus::TransactJournal _journal;
+      return _journal;
+    }
+  } // namespace
+
+  void ResStatus::journalTransactChange( const ResStatus * status_r )
+  {
+    TransactJournal & journal { transactJournal() };
+    if ( journal.overflow )
+      return;
+    if ( journal.changed.size() >= transactJournalLimit )
+    {
+      journal.changed.clear();
+      journal.changed.shrink_to_fit();
+      journal.overflow = true;
+      return;
+    }
+    journal.changed.push_back( status_r );
+  }
+
+  ResStatus::TransactJournal ResStatus::takeTransactJournal()
+  {
+    TransactJournal ret;
+    std::swap( ret, transactJournal() );
+    return ret;
+  }
+
   ///////////////////////////////////////////////////////////////////
   //
   //	METHOD NAME : ResStatus::ResStatus
@@ -14,6 +14,8 @@
 
 #include <inttypes.h>
 #include <iosfwd>
+#include <type_traits>
+#include <vector>
 #include <zypp/Bit.h>
 #include <zypp-core/Globals.h>
 
@@ -165,8 +167,10 @@ namespace zypp
 
     ResStatus(const ResStatus &) = default;
     ResStatus(ResStatus &&) noexcept = default;
-    ResStatus &operator=(const ResStatus &) = default;
-    ResStatus &operator=(ResStatus &&) noexcept = default;
+    ResStatus &operator=(const ResStatus & rhs )
+    { assignBitfield( rhs._bitfield ); return *this; }
+    ResStatus &operator=(ResStatus && rhs ) noexcept
+    { assignBitfield( rhs._bitfield ); return *this; }
 
     /** Debug helper returning the bitfield.
      * It's save to expose the bitfield, as it can't be used to
@@ -381,7 +385,7 @@ namespace zypp
     {
         bit::BitField<FieldType> savBitfield = _bitfield;
         bool ret = setTransactValue( newVal_r, causer_r );
-        _bitfield = savBitfield;
+        assignBitfield( savBitfield );
         return ret;
     }
 
@@ -426,7 +430,7 @@ namespace zypp
     {
         bit::BitField<FieldType> savBitfield = _bitfield;
         bool ret = setLock( to_r, causer_r );
-        _bitfield = savBitfield;
+        assignBitfield( savBitfield );
         return ret;
     }
 
@@ -470,7 +474,7 @@ namespace zypp
     {
         bit::BitField<FieldType> savBitfield = _bitfield;
         bool ret = setTransact (val_r, causer);
-        _bitfield = savBitfield;
+        assignBitfield( savBitfield );
         return ret;
     }
 
@@ -526,7 +530,7 @@ namespace zypp
     {
         bit::BitField<FieldType> savBitfield = _bitfield;
         bool ret = setSoftTransact( val_r, causer, causerLimit_r );
-        _bitfield = savBitfield;
+        assignBitfield( savBitfield );
         return ret;
     }
 
@@ -543,7 +547,7 @@ namespace zypp
     {
         bit::BitField<FieldType> savBitfield = _bitfield;
         bool ret = setToBeInstalled (causer);
-        _bitfield = savBitfield;
+        assignBitfield( savBitfield );
         return ret;
     }
 
@@ -557,7 +561,7 @@ namespace zypp
     {
         bit::BitField<FieldType> savBitfield = _bitfield;
         bool ret = setToBeUninstalled (causer);
-        _bitfield = savBitfield;
+        assignBitfield( savBitfield );
         return ret;
     }
 
@@ -602,7 +606,7 @@ namespace zypp
     {
         bit::BitField<FieldType> savBitfield = _bitfield;
         bool ret = setToBeUninstalledSoft ();
-        _bitfield = savBitfield;
+        assignBitfield( savBitfield );
         return ret;
     }
 
@@ -658,10 +662,28 @@ namespace zypp
         return false;
 
       // Ok, we take it all..
-      _bitfield = newStatus_r._bitfield;
+      assignBitfield( newStatus_r._bitfield );
       return true;
     }
 
+    /** \name Transact journal.
+     * The addresses of all ResStatus whose \ref TransactValue changed on the
+     * calling thread are recorded, so a consumer like the disk usage tracker can
+     * revisit just the changed items instead of scanning the whole pool. Only
+     * one consumer should take the journal. If it is not taken for too long,
+     * further changes are not recorded but \c overflow is set.
+     */
+    //@{
+    struct TransactJournal
+    {
+      std::vector<const ResStatus *> changed;	///< may contain duplicates and temporaries
+      bool overflow = false;			///< changes were dropped, all items need to be checked
+    };
+
+    /** Return and clear the calling threads journal. */
+    static TransactJournal takeTransactJournal();
+    //@}
+
     /** \name Builtin ResStatus constants. */
     //@{
     static const ResStatus toBeInstalled;
@@ -688,7 +710,24 @@ namespace zypp
     */
     template<class TField>
       void fieldValueAssign( FieldType val_r )
-    { _bitfield.assign<TField>( val_r ); }
+    {
+      if constexpr ( std::is_same_v<TField,TransactField> )
+      {
+        if ( ! _bitfield.isEqual<TField>( val_r ) )
+          journalTransactChange( this );
+      }
+      _bitfield.assign<TField>( val_r );
+    }
+
+    /** Take all bits, noting a \ref TransactValue change in the journal. */
+    void assignBitfield( const BitFieldType & bits_r )
+    {
+      if ( _bitfield.value<TransactField>() != bits_r.value<TransactField>() )
+        journalTransactChange( this );
+      _bitfield = bits_r;
+    }
+
+    static void journalTransactChange( const ResStatus * status_r );
 
     /** compare two values.
     */
@@ -740,7 +779,7 @@ namespace zypp
         {}
 
         void replay()
-        { if ( _status ) _status->_bitfield = _bitfield; }
+        { if ( _status ) _status->assignBitfield( _bitfield ); }
 
       private:
         ResStatus *             _status;
@@ -18,6 +18,8 @@
 #include <zypp/solver/detail/Testcase.h>
 #include <zypp/solver/detail/ItemCapKind.h>
 #include <zypp/sat/Transaction.h>
+#include <zypp/ResPool.h>
+#include <zypp/target/private/commitpackagepreloader_p.h>
 
 
 ///////////////////////////////////////////////////////////////////
@@ -60,10 +62,20 @@ namespace zypp
   { return _pimpl->verifySystem(); }
 
   bool Resolver::resolvePool ()
-  { return _pimpl->resolvePool(); }
+  {
+    bool ret = _pimpl->resolvePool();
+    if ( ret )
+      CommitPackagePreloader::warmUpConnections( ResPool::instance() ); // connect to the mirrors while the transaction gets confirmed
+    return ret;
+  }
 
   bool Resolver::resolveQueue( solver::detail::SolverQueueItemList & queue )
-  { return _pimpl->resolveQueue(queue); }
+  {
+    bool ret = _pimpl->resolveQueue(queue);
+    if ( ret )
+      CommitPackagePreloader::warmUpConnections( ResPool::instance() ); // connect to the mirrors while the transaction gets confirmed
+    return ret;
+  }
 
   void Resolver::undo()
   { _pimpl->undo(); }
@@ -13,6 +13,8 @@
 #include <iostream>
 #include <optional>
 #include <map>
+#include <algorithm>
+#include <thread>
 #include <zypp-core/APIConfig.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/IOStream.h>
@@ -335,6 +337,8 @@ namespace zypp
         , repoLabelIsAlias              ( false )
         , download_use_deltarpm   	( APIConfig(LIBZYPP_CONFIG_USE_DELTARPM_BY_DEFAULT) )
         , download_use_deltarpm_always  ( false )
+        , download_deltarpm_jobs        ( 0 )
+        , download_deltarpm_apply_rate  ( 4 )
         , download_media_prefer_download( true )
         , download_mediaMountdir	( "/var/adm/mount" )
         , commit_downloadMode		( DownloadDefault )
@@ -434,6 +438,14 @@ namespace zypp
               {
                 download_use_deltarpm_always = str::strToBool( value, download_use_deltarpm_always );
               }
+              else if ( entry == "download.use_deltarpm.jobs" )
+              {
+                str::strtonum( value, download_deltarpm_jobs );
+              }
+              else if ( entry == "download.use_deltarpm.apply_rate" )
+              {
+                str::strtonum( value, download_deltarpm_apply_rate );
+              }
               else if ( entry == "download.media_preference" )
               {
                 download_media_prefer_download.restoreToDefault( str::compareCI( value, "volatile" ) != 0 );
@@ -655,6 +667,8 @@ namespace zypp
 
     bool download_use_deltarpm;
     bool download_use_deltarpm_always;
+    unsigned download_deltarpm_jobs;
+    unsigned download_deltarpm_apply_rate;
     DefaultOption<bool> download_media_prefer_download;
     DefaultOption<Pathname> download_mediaMountdir;
 
@@ -1059,6 +1073,16 @@ namespace zypp
   bool ZConfig::download_use_deltarpm_always() const
   { return download_use_deltarpm() && _pimpl->download_use_deltarpm_always; }
 
+  unsigned ZConfig::download_deltarpm_jobs() const
+  {
+    if ( _pimpl->download_deltarpm_jobs )
+      return _pimpl->download_deltarpm_jobs;
+    return std::max( std::thread::hardware_concurrency(), 1U );
+  }
+
+  ByteCount ZConfig::download_deltarpm_apply_rate() const
+  { return ByteCount( _pimpl->download_deltarpm_apply_rate, ByteCount::MiB ); }
+
   bool ZConfig::download_media_prefer_download() const
   { return _pimpl->download_media_prefer_download; }
 
@@ -23,6 +23,7 @@
 #include <zypp/Arch.h>
 #include <zypp/Locale.h>
 #include <zypp-core/Pathname.h>
+#include <zypp-core/ByteCount.h>
 #include <zypp/IdString.h>
 #include <zypp-core/TriBool.h>
 #include <zypp/ResolverFocus.h>
@@ -352,6 +353,17 @@ namespace zypp
        */
       bool download_use_deltarpm_always() const;
 
+      /** Number of deltarpms rebuilt concurrently while packages are downloaded in advance.
+       * Config option <tt>download.use_deltarpm.jobs (0)</tt>, \c 0 means one per CPU core.
+       */
+      unsigned download_deltarpm_jobs() const;
+
+      /** Estimated amount of installed package data \c applydeltarpm rebuilds per second.
+       * Used to skip deltas whose reconstruction takes longer than downloading the full package.
+       * Config option <tt>download.use_deltarpm.apply_rate (4 MiB)</tt>, \c 0 always uses the deltas.
+       */
+      ByteCount download_deltarpm_apply_rate() const;
+
       /**
        * Hint which media to prefer when installing packages (download vs. CD).
        * \see class \ref media::MediaPriority
@@ -20,6 +20,7 @@ extern "C"
 #include <zypp-core/base/Logger.h>
 #include <zypp/base/Measure.h>
 #include <zypp-core/base/String.h>
+#include <zypp-core/base/Trace.h>
 
 using std::endl;
 
@@ -148,6 +149,7 @@ namespace zypp
         _glevel += "..";
         log() << _level << "START MEASURE(" << _ident << ")" << endl;
         _start.get();
+        _traceBegin = traceNow();
       }
 
       Impl(const Impl &) = delete;
@@ -162,12 +164,14 @@ namespace zypp
         std::ostream & str( log() << _level << "MEASURE(" << _ident << ") " );
         dumpMeasure( str );
         _glevel.erase( 0, 2 );
+        traceComplete( _ident, "measure", _traceBegin );
       }
 
       void restart()
       {
         log() << _level << "RESTART MEASURE(" << _ident << ")" << endl;
         _start = _stop;
+        _traceBegin = traceNow();
       }
 
       void elapsed( const std::string & tag_r = std::string() ) const
@@ -177,6 +181,7 @@ namespace zypp
         std::ostream & str( log() << _level << "ELAPSED(" << _ident << ") " );
         dumpMeasure( str, tag_r );
         _elapsed = _stop;
+        traceInstant( _ident, "measure", tag_r );
       }
 
       /** Return the log stream. */
@@ -207,6 +212,7 @@ namespace zypp
       mutable unsigned _seq;
       mutable Tm       _elapsed;
       mutable Tm       _stop;
+      std::int64_t     _traceBegin = 0;	///< span recorded in \ref traceComplete
 
       std::ostream *   _log = nullptr;
     };
@@ -65,6 +65,26 @@ namespace zypp {
 
   namespace media {
 
+    namespace {
+      /** A new empty file next to \a target_r, removed unless its dispose is reset. */
+      ManagedFile makeTempFile( const Pathname &target_r, const Url &fileurl_r )
+      {
+        ManagedFile destNew { target_r.extend( ".new.zypp.XXXXXX" ) };
+        AutoFREE<char> buf { ::strdup( (*destNew).c_str() ) };
+        if( ! buf ) {
+          ERR << "out of memory for temp file name" << endl;
+          ZYPP_THROW(MediaSystemException(fileurl_r, "out of memory for temp file name"));
+        }
+
+        AutoFD tmp_fd { ::mkostemp( buf, O_CLOEXEC ) };
+        if( tmp_fd == -1 ) {
+          ERR << "mkstemp failed for file '" << destNew << "'" << endl;
+          ZYPP_THROW(MediaWriteException(destNew));
+        }
+        return ManagedFile( (*buf), filesystem::unlink );
+      }
+    }
+
     MediaCurl2::MediaCurl2(const MirroredOrigin origin_r,
                            const Pathname & attach_point_hint_r )
       : MediaNetworkCommonHandler( origin_r, attach_point_hint_r,
@@ -111,6 +131,8 @@ namespace zypp {
 
     void MediaCurl2::disconnectFrom()
     {
+      cancelPrecache();
+
       // clear effective settings
       clearTransferSettings();
     }
@@ -133,6 +155,9 @@ namespace zypp {
       OptionalDownloadProgressReport reportfilter( srcFile.optional() );
       callback::SendReport<DownloadProgressReport> report;
 
+      if ( const_cast<MediaCurl2 *>(this)->takePrecached( srcFile, target, report ) )
+        return;
+
       const auto &mirrOrder = mirrorOrder (srcFile);
       for ( unsigned mirr : mirrOrder ) {
         MIL << "Trying to fetch file " << srcFile << " via URL: " << _origin[mirr].url() << std::endl;
@@ -154,20 +179,7 @@ namespace zypp {
             ZYPP_THROW( MediaSystemException(fileurl, "System error on " + dest.dirname().asString()) );
           }
 
-          ManagedFile destNew { target.extend( ".new.zypp.XXXXXX" ) }; {
-            AutoFREE<char> buf { ::strdup( (*destNew).c_str() ) };
-            if( ! buf ) {
-              ERR << "out of memory for temp file name" << endl;
-              ZYPP_THROW(MediaSystemException(fileurl, "out of memory for temp file name"));
-            }
-
-            AutoFD tmp_fd { ::mkostemp( buf, O_CLOEXEC ) };
-            if( tmp_fd == -1 ) {
-              ERR << "mkstemp failed for file '" << destNew << "'" << endl;
-              ZYPP_THROW(MediaWriteException(destNew));
-            }
-            destNew = ManagedFile( (*buf), filesystem::unlink );
-          }
+          ManagedFile destNew { makeTempFile( target, fileurl ) };
 
           DBG << "dest: " << dest << endl;
           DBG << "temp: " << destNew << endl;
@@ -255,6 +267,10 @@ namespace zypp {
         }
         catch (MediaException & excpt_r)
         {
+          // the user aborted, do not continue downloading the next files either
+          if ( typeid(excpt_r) == typeid( MediaRequestCancelledException ) )
+            const_cast<MediaCurl2 *>(this)->cancelPrecache();
+
           // check if we can retry on the next mirror
           if( !canTryNextMirror ( excpt_r ) || ( mirr == mirrOrder.back() ) ) {
             // rewrite the exception to contain the correct pathname and url
@@ -274,6 +290,105 @@ namespace zypp {
       }
     }
 
+    void MediaCurl2::precacheFiles( const std::vector<OnMediaLocation> &files )
+    {
+      for ( const auto &file : files ) {
+        // zchunk files are built from ranges of the local copy, leave them to getFileCopy
+        if ( _precache.count( file.filename() ) || !file.deltafile().empty() )
+          continue;
+
+        const auto &mirrOrder = mirrorOrder( file );
+        if ( mirrOrder.empty() )
+          continue;
+
+        const unsigned mirr = mirrOrder.front();
+        const auto &myOrigin = _origin[mirr];
+        if ( !myOrigin.url().isValid() || myOrigin.url().getHost().empty() )
+          continue;
+
+        const Url fileurl( getFileUrl( mirr, file.filename() ) );
+        try {
+          const Pathname dest = localPath( file.filename() ).absolutename();
+          if( assert_dir( dest.dirname() ) ) {
+            DBG << "assert_dir " << dest.dirname() << " failed" << endl;
+            continue;
+          }
+
+          PrecacheData data;
+          data._staging = makeTempFile( dest, fileurl );
+          data._reqData._mirrorIdx = mirr;
+          data._reqData._req = std::make_shared<zyppng::NetworkRequest>( clearQueryString(fileurl), data._staging, zyppng::NetworkRequest::WriteShared /*do not truncate*/ );
+          data._reqData._req->transferSettings() = myOrigin.getConfig<TransferSettings>( MIRR_SETTINGS_KEY.data() );
+          data._reqData._req->setExpectedFileSize( file.downloadSize() );
+          // a broken download fails right away and is fetched again by getFileCopy
+          if ( !file.checksum().empty() )
+            data._reqData._req->setExpectedFileChecksum( file.checksum() );
+
+          DBG << "Precaching " << file.filename() << " from " << fileurl << endl;
+          _executor->enqueueRequest( data._reqData._req );
+          _precache.insert( std::make_pair( file.filename(), std::move(data) ) );
+
+        } catch ( const Exception &excpt ) {
+          ZYPP_CAUGHT( excpt );
+        }
+      }
+    }
+
+    bool MediaCurl2::takePrecached( const OnMediaLocation &srcFile, const Pathname &target, callback::SendReport<DownloadProgressReport> &report )
+    {
+      auto it = _precache.find( srcFile.filename() );
+      if ( it == _precache.end() )
+        return false;
+
+      PrecacheData data { std::move(it->second) };
+      _precache.erase( it );
+
+      const auto &req = data._reqData._req;
+      const Pathname dest = target.absolutename();
+
+      // a failed download is fetched again by getFileCopy, which continues this report
+      report->start( req->url(), dest );
+      if ( !_executor->waitForRequest( req, &report ) ) {
+        MIL << "Precaching " << srcFile.filename() << " aborted by the user" << endl;
+        cancelPrecache();
+        report->finish( req->url(), DownloadProgressReport::ERROR, req->error().toString() );
+        ZYPP_THROW( MediaRequestCancelledException( req->error().toString() ) );
+      }
+      if ( req->hasError() ) {
+        MIL << "Precaching " << srcFile.filename() << " failed: " << req->error().toString() << ", downloading it again." << endl;
+        return false;
+      }
+
+      if( assert_dir( dest.dirname() ) ) {
+        DBG << "assert_dir " << dest.dirname() << " failed" << endl;
+        return false;
+      }
+
+      // apply umask
+      if ( ::chmod( data._staging->c_str(), filesystem::applyUmaskTo( 0644 ) ) )
+      {
+        ERR << "Failed to chmod file " << data._staging << endl;
+      }
+
+      if ( rename( data._staging, dest ) != 0 ) {
+        ERR << "Rename failed" << endl;
+        return false;
+      }
+      data._staging.resetDispose();
+
+      report->finish( req->url(), DownloadProgressReport::NO_ERROR, "" );
+
+      DBG << "done (precached): " << PathInfo(dest) << endl;
+      return true;
+    }
+
+    void MediaCurl2::cancelPrecache()
+    {
+      for ( auto &[ filename, data ] : _precache )
+        _executor->cancelRequest( data._reqData._req );
+      _precache.clear();
+    }
+
     bool MediaCurl2::getDoesFileExist( const Pathname & filename ) const
     {
       DBG << filename.asString() << endl;
@@ -14,11 +14,14 @@
 
 #include <zypp-core/ng/base/zyppglobal.h>
 #include <zypp-core/base/Flags.h>
+#include <zypp-core/ManagedFile.h>
 #include <zypp/ZYppCallbacks.h>
 #include <zypp/media/MediaNetworkCommonHandler.h>
 
 #include <curl/curl.h>
 
+#include <map>
+
 namespace zyppng {
   ZYPP_FWD_DECL_TYPE_WITH_REFS (EventDispatcher);
   ZYPP_FWD_DECL_TYPE_WITH_REFS (NetworkRequestDispatcher);
@@ -82,6 +85,13 @@ class MediaCurl2 : public MediaNetworkCommonHandler
 
     ~MediaCurl2() override { try { release(); } catch(...) {} }
 
+    /**
+     * Starts downloading \a files in the background, a later \ref getFileCopy
+     * of one of them waits for its download instead of starting a new one.
+     * Files failing to download are downloaded again when requested.
+     */
+    void precacheFiles( const std::vector<OnMediaLocation> &files ) override;
+
   protected:
     /**
      * check the url is supported by the curl library
@@ -98,8 +108,22 @@ class MediaCurl2 : public MediaNetworkCommonHandler
 
     bool tryZchunk( RequestData &reqData, const OnMediaLocation &srcFile , const Pathname & target, callback::SendReport<DownloadProgressReport> & report  );
 
+    /**
+     * Moves the precached \a srcFile to \a target, returns \c false if it needs to be downloaded.
+     * The progress of a still running download is sent to \a report. If the user aborts, all
+     * precached downloads are cancelled and a \ref MediaRequestCancelledException is thrown.
+     */
+    bool takePrecached( const OnMediaLocation &srcFile, const Pathname &target, callback::SendReport<DownloadProgressReport> &report );
+    void cancelPrecache();
+
   private:
+    struct PrecacheData {
+      RequestData _reqData;
+      ManagedFile _staging;
+    };
+
     internal::MediaNetworkRequestExecutorRef _executor;
+    std::map<Pathname, PrecacheData> _precache;
 };
 ZYPP_DECLARE_OPERATORS_FOR_FLAGS(MediaCurl2::RequestOptions);
 
@@ -40,7 +40,7 @@ namespace zypp::internal {
             return;
 
           progTracker->updateStats( dlTotal, dlNow );
-          if ( !(*report)->progress( progTracker->_dnlPercent, req.url(), progTracker-> _drateTotal, progTracker->_drateLast ) )
+          if ( !(*report)->progress( progTracker->_dnlPercent, req.url(), progTracker->_drateTotal, progTracker->_drateLast ) )
             _nwDispatcher->cancel ( req );
 
         }),
@@ -63,8 +63,9 @@ namespace zypp::internal {
       _nwDispatcher->enqueue ( req );
       loop->run();
 
-      // once the request is done there should be nothing there anymore
-      if ( _nwDispatcher->count () != 0 ) {
+      // once the request is done it should not be queued anymore, requests enqueued
+      // via enqueueRequest might still be running though
+      if ( req->state() == zyppng::NetworkRequest::Pending || req->state() == zyppng::NetworkRequest::Running ) {
         ZYPP_THROW( zypp::Exception("Unexpected request count after finishing MediaCurl2 request!") );
       }
 
@@ -155,4 +156,51 @@ namespace zypp::internal {
 
     if ( report ) (*report)->finish( req->url(), zypp::media::DownloadProgressReport::NO_ERROR, "" );
   }
+
+  void MediaNetworkRequestExecutor::enqueueRequest( const zyppng::NetworkRequestRef &req )
+  {
+    _nwDispatcher->run();
+    _nwDispatcher->enqueue( req );
+  }
+
+  bool MediaNetworkRequestExecutor::waitForRequest( const zyppng::NetworkRequestRef &req, callback::SendReport<media::DownloadProgressReport> *report )
+  {
+    if ( req->state() != zyppng::NetworkRequest::Pending && req->state() != zyppng::NetworkRequest::Running )
+      return true;
+
+    bool aborted = false;
+    std::optional<internal::ProgressTracker> progTracker;
+    if ( report )
+      progTracker = internal::ProgressTracker();
+
+    auto loop = zyppng::EventLoop::create();
+    std::vector<zyppng::connection> signalConnections {
+      req->sigProgress().connect( [&]( zyppng::NetworkRequest &req, off_t dlTotal, off_t dlNow, off_t, off_t ){
+        if ( !report || !progTracker )
+          return;
+
+        progTracker->updateStats( dlTotal, dlNow );
+        if ( !(*report)->progress( progTracker->_dnlPercent, req.url(), progTracker->_drateTotal, progTracker->_drateLast ) ) {
+          aborted = true;
+          _nwDispatcher->cancel ( req );
+        }
+      }),
+      req->sigFinished().connect( [&]( zyppng::NetworkRequest &, const zyppng::NetworkRequestError & ) {
+        loop->quit();
+      })
+    };
+    zypp_defer {
+      std::for_each( signalConnections.begin(), signalConnections.end(), []( auto &conn ) { conn.disconnect(); });
+    };
+
+    _nwDispatcher->run();
+    loop->run();
+    return !aborted;
+  }
+
+  void MediaNetworkRequestExecutor::cancelRequest( const zyppng::NetworkRequestRef &req )
+  {
+    if ( req->state() == zyppng::NetworkRequest::Pending || req->state() == zyppng::NetworkRequest::Running )
+      _nwDispatcher->cancel( *req );
+  }
 }
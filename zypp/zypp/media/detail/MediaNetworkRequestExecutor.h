@@ -39,6 +39,24 @@ namespace zypp::internal
     MediaNetworkRequestExecutor();
     void executeRequest(zyppng::NetworkRequestRef &req, callback::SendReport<media::DownloadProgressReport> *report = nullptr );
 
+    /*!
+     * Enqueues \a req without waiting for it, it makes progress whenever a request
+     * is executed or waited for. The result is not evaluated, no reports are sent.
+     */
+    void enqueueRequest( const zyppng::NetworkRequestRef &req );
+
+    /*!
+     * Blocks until \a req, previously passed to \ref enqueueRequest, is finished.
+     * If \a report is given the progress of \a req is sent to it. Returns \c false
+     * if the user aborted via the report, \a req is cancelled in that case.
+     */
+    bool waitForRequest( const zyppng::NetworkRequestRef &req, callback::SendReport<media::DownloadProgressReport> *report = nullptr );
+
+    /*!
+     * Cancels \a req if it is still pending or running.
+     */
+    void cancelRequest( const zyppng::NetworkRequestRef &req );
+
     zyppng::SignalProxy<void( const zypp::Url &url, media::TransferSettings &settings, const std::string &availAuthTypes, bool firstTry, bool &canContinue )> sigAuthRequired() {
       return _sigAuthRequired;
     }
@@ -13,7 +13,10 @@
 #include <fstream>
 #include <unordered_set>
 #include <iterator>
+#include <atomic>
+#include <thread>
 #include <stdio.h>
+#include <pwd.h>
 #include <zypp-core/base/LogControl.h>
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/String.h>
@@ -25,6 +28,7 @@
 #include <zypp-core/base/Regex.h>
 #include <zypp-core/base/IOStream.h>
 #include <zypp-core/base/InputStream>
+#include <zypp-core/base/Env.h>
 #include <zypp/target/rpm/librpmDb.h>
 
 #include <zypp/misc/CheckAccessDeleted.h>
@@ -173,6 +177,138 @@ namespace zypp
     };
 
 
+    /////////////////////////////////////////////////////////////////
+    /// \class ProcScanner
+    /// \brief Native replacement for 'lsof -n -FpcuLRftkn0 -K i'.
+    ///
+    /// Scans /proc/<pid>/{status,exe,maps} and produces the same
+    /// NUL separated lines lsof would print for the deleted executables
+    /// and libraries a process accesses. Other lsof output is omitted, as
+    /// it would be filtered by \ref CheckAccessDeleted::Impl::addCacheIf
+    /// anyway (e.g. open file descriptors).
+    ///
+    /// PIDs are scanned in parallel by a pool of worker threads.
+    /////////////////////////////////////////////////////////////////
+    struct ProcScanner
+    {
+      /** lsof output lines of one PID; empty if the PID is to be ignored. */
+      using Lines = std::vector<std::string>;
+
+      /** Whether /proc is usable and lsof is not explicitly requested. */
+      static bool usable()
+      {
+        if ( env::getenvBool( "ZYPP_CHECKACCESSDELETED_LSOF" ) )
+          return false;
+        return PathInfo( "/proc/self/maps" ).isFile();
+      }
+
+      /** Scan all PIDs except the ones \a skipPid_r returns \c true for. */
+      std::vector<std::pair<pid_t,Lines>> scan( const std::function<bool(pid_t)> & skipPid_r ) const
+      {
+        std::vector<std::pair<pid_t,Lines>> ret;
+        filesystem::dirForEach( "/proc", [&ret]( const Pathname &, const char *const name_r ) {
+          pid_t pid = 0;
+          if ( *name_r >= '1' && *name_r <= '9' && str::strtonum( name_r, pid ) )
+            ret.push_back( std::make_pair( pid, Lines() ) );
+          return true;
+        });
+
+        std::atomic<std::size_t> next { 0 };
+        auto worker = [&]() {
+          for ( std::size_t idx = next++; idx < ret.size(); idx = next++ )
+          {
+            if ( ! skipPid_r( ret[idx].first ) )
+              ret[idx].second = scanPid( ret[idx].first );
+          }
+        };
+
+        unsigned nthreads = std::min<std::size_t>( std::max( 1U, std::thread::hardware_concurrency() ), ret.size() );
+        std::vector<std::thread> threads;
+        threads.reserve( nthreads );
+        for ( unsigned i = 0; i < nthreads; ++i )
+          threads.emplace_back( worker );
+        for ( auto & t : threads )
+          t.join();
+
+        return ret;
+      }
+
+    private:
+      static std::string field( char type_r, const std::string & value_r )
+      { return std::string( 1, type_r ) + value_r + '\0'; }
+
+      /** Strip a " (deleted)" suffix; return whether it was present. */
+      static bool stripDeleted( std::string & path_r )
+      {
+        static const std::string_view suffix { " (deleted)" };
+        if ( ! str::hasSuffix( path_r, suffix ) )
+          return false;
+        path_r.erase( path_r.size() - suffix.size() );
+        return true;
+      }
+
+      static std::string loginName( const std::string & uid_r )
+      {
+        uid_t uid = str::strtonum<uid_t>( uid_r );
+        struct passwd pwd;
+        struct passwd * result = nullptr;
+        char buf[1024];
+        if ( ::getpwuid_r( uid, &pwd, buf, sizeof(buf), &result ) != 0 || ! result )
+          return uid_r;	// lsof prints the UID if there is no login name
+        return result->pw_name;
+      }
+
+      Lines scanPid( pid_t pid_r ) const
+      {
+        Lines ret;
+        const Pathname pidDir { Pathname("/proc") / str::numstring( pid_r ) };
+
+        // process line (pcuLR)
+        std::string ppid;
+        std::string uid;
+        iostr::forEachLine( InputStream( pidDir/"status" ), [&]( int, std::string line_r )->bool {
+          if ( str::hasPrefix( line_r, "PPid:" ) )
+            ppid = str::trim( line_r.substr( 5 ) );
+          else if ( str::hasPrefix( line_r, "Uid:" ) )
+          {
+            line_r.erase( 0, 4 );
+            uid = str::stripFirstWord( line_r, true );	// the real UID
+          }
+          return ppid.empty() || uid.empty();
+        });
+        if ( uid.empty() )
+          return ret;	// process is gone
+
+        std::string command;
+        iostr::forEachLine( InputStream( pidDir/"comm" ), [&]( int, std::string line_r )->bool {
+          command = std::move(line_r);
+          return false;
+        });
+
+        ret.push_back( field( 'p', str::numstring( pid_r ) ) + field( 'c', command ) + field( 'u', uid )
+                     + field( 'L', loginName( uid ) ) + field( 'R', ppid ) + '\n' );
+
+        // deleted executable
+        std::string exe { filesystem::readlink( pidDir/"exe" ).asString() };
+        if ( stripDeleted( exe ) )
+          ret.push_back( field( 'f', "txt" ) + field( 't', "REG" ) + field( 'n', exe ) + '\n' );
+
+        // deleted memory mapped files
+        std::unordered_set<std::string> seen;
+        iostr::forEachLine( InputStream( pidDir/"maps" ), [&]( int, std::string line_r )->bool {
+          // address perms offset dev inode [pathname]
+          std::string::size_type pos = line_r.find( '/' );
+          if ( pos == std::string::npos )
+            return true;
+          std::string path { line_r.substr( pos ) };
+          if ( stripDeleted( path ) && seen.insert( path ).second )
+            ret.push_back( field( 'f', "DEL" ) + field( 't', "REG" ) + field( 'n', path ) + '\n' );
+          return true;
+        });
+        return ret;
+      }
+    };
+
     /** bsc#1099847: Check for lsof version < 4.90 which does not support '-K i'
      * Just a quick check to allow code15 libzypp runnig in a code12 environment.
      * bsc#1036304: '-K i' was backported to older lsof versions, indicated by
@@ -197,6 +333,8 @@ namespace zypp
     void addCacheIf( CacheEntry & cache_r, const std::string & line_r, std::vector<std::string> *debMap = nullptr );
 
     std::map<pid_t,CacheEntry> filterInput( externalprogram::ExternalDataSource &source );
+    std::map<pid_t,CacheEntry> filterInput( const function<std::string()> & nextLine_r, const function<bool(pid_t)> & skipPid_r );
+    std::map<pid_t,CacheEntry> scanProc();
     CheckAccessDeleted::size_type createProcInfo( const std::map<pid_t,CacheEntry> &in );
 
     std::vector<CheckAccessDeleted::ProcInfo> _data;
@@ -391,24 +529,49 @@ namespace zypp
   }
 
   std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::filterInput( externalprogram::ExternalDataSource &source )
+  {
+    FilterRunsInContainer runsInLXC;
+    MIL << "Silently scanning lsof output..." << endl;
+    zypp::base::LogControl::TmpLineWriter shutUp;	// suppress excessive readdir etc. logging in runsInLXC
+    return filterInput( [&source]() { return source.receiveLine( 30 * 1000 ); },
+                        [this,&runsInLXC]( pid_t pid_r ) { return !_fromLsofFileMode && runsInLXC( pid_r ); } );
+  }
+
+  std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::scanProc()
+  {
+    FilterRunsInContainer runsInLXC;
+    MIL << "Silently scanning /proc..." << endl;
+    zypp::base::LogControl::TmpLineWriter shutUp;	// suppress excessive readdir etc. logging in runsInLXC
+    // NOTE: omit PIDs running in a (lxc/docker) container (checked by the scanners worker threads)
+    const auto scanned { ProcScanner().scan( runsInLXC ) };
+
+    auto pidIt = scanned.begin();
+    std::size_t lineIdx = 0;
+    return filterInput( [&]() -> std::string {
+                          for ( ; pidIt != scanned.end(); ++pidIt, lineIdx = 0 ) {
+                            if ( lineIdx < pidIt->second.size() )
+                              return pidIt->second[lineIdx++];
+                          }
+                          return std::string();
+                        },
+                        []( pid_t ) { return false; } );
+  }
+
+  std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::filterInput( const function<std::string()> & nextLine_r, const function<bool(pid_t)> & skipPid_r )
   {
     // cachemap: PID => (deleted files)
-    // NOTE: omit PIDs running in a (lxc/docker) container
     std::map<pid_t,CacheEntry> cachemap;
 
     bool debugEnabled = !_debugFile.empty();
 
     pid_t cachepid = 0;
-    FilterRunsInContainer runsInLXC;
-    MIL << "Silently scanning lsof output..." << endl;
-    zypp::base::LogControl::TmpLineWriter shutUp;	// suppress excessive readdir etc. logging in runsInLXC
-    for( std::string line = source.receiveLine( 30 * 1000 ); ! line.empty(); line = source.receiveLine(  30 * 1000  ) )
+    for( std::string line = nextLine_r(); ! line.empty(); line = nextLine_r() )
     {
       // NOTE: line contains '\0' separeated fields!
       if ( line[0] == 'p' )
       {
         str::strtonum( line.c_str()+1, cachepid );	// line is "p<PID>\0...."
-        if ( _fromLsofFileMode || !runsInLXC( cachepid ) ) {
+        if ( !skipPid_r( cachepid ) ) {
           if ( debugEnabled ) {
             auto &pidMad = debugMap[cachepid];
             if ( pidMad.empty() )
@@ -432,13 +595,17 @@ namespace zypp
 
   CheckAccessDeleted::size_type CheckAccessDeleted::check( bool verbose_r  )
   {
+    _pimpl->_verbose = verbose_r;
+    _pimpl->_fromLsofFileMode = false;
+
+    if ( ProcScanner::usable() )
+      return _pimpl->createProcInfo( _pimpl->scanProc() );
+
+    // Fallback: parse lsof output
     static const char* argv[] = { "lsof", "-n", "-FpcuLRftkn0", "-K", "i", NULL };
     if ( lsofNoOptKi() )
       argv[3] = NULL;
 
-    _pimpl->_verbose = verbose_r;
-    _pimpl->_fromLsofFileMode = false;
-
     ExternalProgram prog( argv, ExternalProgram::Discard_Stderr );
     std::map<pid_t,CacheEntry> cachemap;
 
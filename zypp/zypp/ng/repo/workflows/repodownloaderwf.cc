@@ -80,13 +80,13 @@ namespace zyppng {
         }
 
         auto providerRef = _dlContext->zyppContext()->provider();
-          return provider()->provide( _media, _masterIndex, ProvideFileSpec().setDownloadSize( zypp::ByteCount( 20, zypp::ByteCount::MB ) ).setMirrorsAllowed( false ) )
+          return provider()->provide( _media, _masterIndex, ProvideFileSpec().setPriority( ProvideFileSpec::High ).setDownloadSize( zypp::ByteCount( 20, zypp::ByteCount::MB ) ).setMirrorsAllowed( false ) )
           | and_then( [this]( ProvideRes && masterres ) {
             // update the gpg keys provided by the repo
             return RepoInfoWorkflow::fetchGpgKeys( _dlContext->zyppContext(), _dlContext->repoInfo() )
             | and_then( [this](){
               // fetch signature and maybe key file
-              return provider()->provide( _media, _sigpath, ProvideFileSpec().setOptional( true ).setDownloadSize( zypp::ByteCount( 20, zypp::ByteCount::MB ) ).setMirrorsAllowed( false ) )
+              return provider()->provide( _media, _sigpath, ProvideFileSpec().setPriority( ProvideFileSpec::High ).setOptional( true ).setDownloadSize( zypp::ByteCount( 20, zypp::ByteCount::MB ) ).setMirrorsAllowed( false ) )
 
               | and_then( Provide::copyResultToDest ( provider(), _destdir / _sigpath ) )
 
@@ -109,7 +109,7 @@ namespace zyppng {
                     }
 
                     // we did not get the key via gpgUrl downloads, lets fallback
-                    return provider()->provide( _media, _keypath, ProvideFileSpec().setOptional( true ).setDownloadSize( zypp::ByteCount( 20, zypp::ByteCount::MB ) ).setMirrorsAllowed(needsMirrorToFetchKey) )
+                    return provider()->provide( _media, _keypath, ProvideFileSpec().setPriority( ProvideFileSpec::High ).setOptional( true ).setDownloadSize( zypp::ByteCount( 20, zypp::ByteCount::MB ) ).setMirrorsAllowed(needsMirrorToFetchKey) )
                     | and_then( Provide::copyResultToDest ( provider(), _destdir / _keypath ) )
                     | and_then( [this]( zypp::ManagedFile keyFile ) {
 
@@ -186,7 +186,7 @@ namespace zyppng {
 
             // Chain the next download to the previous one
             chain = std::move(chain) | and_then([this, extpath, extdest, pluginPtr]() {
-              return provider()->provide( _media, extpath, ProvideFileSpec().setOptional( false ).setMirrorsAllowed( false ) )
+              return provider()->provide( _media, extpath, ProvideFileSpec().setPriority( ProvideFileSpec::High ).setOptional( false ).setMirrorsAllowed( false ) )
               | and_then( Provide::copyResultToDest( provider(), extdest ) )
               | and_then( [this]( zypp::ManagedFile downloaded_r ) {
                 _dlContext->files().push_back( std::move(downloaded_r) );
@@ -357,7 +357,7 @@ namespace zyppng {
                  }
                | or_else ([ this, file = file, keyid = keyid, cacheFile ] ( auto ) mutable -> MaybeAwaitable<expected<zypp::PublicKey>> {
                    auto providerRef = _dlContext->zyppContext()->provider();
-                   return providerRef->provide( _media, file, ProvideFileSpec().setOptional(true).setMirrorsAllowed(false) )
+                   return providerRef->provide( _media, file, ProvideFileSpec().setPriority( ProvideFileSpec::High ).setOptional(true).setMirrorsAllowed(false) )
                       | and_then( Provide::copyResultToDest( providerRef, _destdir / file ) )
                       | and_then( [this, providerRef, file, keyid , cacheFile = std::move(cacheFile)]( zypp::ManagedFile &&res ) {
 
@@ -39,7 +39,7 @@ namespace zyppng::RpmmdWorkflows {
       {}
 
       MaybeAwaitable<expected<zypp::RepoStatus>> execute() {
-        return _ctx->zyppContext()->provider()->provide( _handle, _ctx->repoInfo().path() / "/repodata/repomd.xml" , ProvideFileSpec().setMirrorsAllowed(false) )
+        return _ctx->zyppContext()->provider()->provide( _handle, _ctx->repoInfo().path() / "/repodata/repomd.xml" , ProvideFileSpec().setPriority( ProvideFileSpec::High ).setMirrorsAllowed(false) )
           | [this]( expected<ProvideRes> repomdFile ) {
 
               if ( !repomdFile )
@@ -48,7 +48,7 @@ namespace zyppng::RpmmdWorkflows {
               zypp::RepoStatus status ( repomdFile->file() );
 
               if ( !status.empty() && _ctx->repoInfo ().requireStatusWithMediaFile()) {
-                return _ctx->zyppContext()->provider()->provide( _handle, "/media.1/media"  , ProvideFileSpec().setMirrorsAllowed(false) )
+                return _ctx->zyppContext()->provider()->provide( _handle, "/media.1/media"  , ProvideFileSpec().setPriority( ProvideFileSpec::High ).setMirrorsAllowed(false) )
                   | [status = std::move(status)]( expected<ProvideRes> mediaFile ) mutable {
                       if ( mediaFile ) {
                         return make_expected_success( status && zypp::RepoStatus( mediaFile->file()) );
@@ -123,7 +123,7 @@ namespace zyppng::RpmmdWorkflows {
 
                     return transform_collect  ( std::move(requiredFiles), [this]( zypp::OnMediaLocation file ) {
 
-                      return DownloadWorkflow::provideToCacheDir( _ctx, _mediaHandle, file.filename(), ProvideFileSpec(file) )
+                      return DownloadWorkflow::provideToCacheDir( _ctx, _mediaHandle, file.filename(), ProvideFileSpec(file).setPriority( ProvideFileSpec::High ) )
                           | inspect ( incProgress( _progressObserver ) );
 
                     }) | and_then ( [this]( std::vector<zypp::ManagedFile> &&dlFiles ) {
@@ -48,7 +48,7 @@ namespace zyppng::SuseTagsWorkflows {
       {}
 
       MaybeAwaitable<expected<zypp::RepoStatus>> execute() {
-        return _ctx->zyppContext()->provider()->provide( _handle, _ctx->repoInfo().path() / "content" , ProvideFileSpec().setMirrorsAllowed(false) )
+        return _ctx->zyppContext()->provider()->provide( _handle, _ctx->repoInfo().path() / "content" , ProvideFileSpec().setPriority( ProvideFileSpec::High ).setMirrorsAllowed(false) )
           | [this]( expected<ProvideRes> contentFile ) {
 
               // mandatory master index is missing -> stay empty
@@ -58,7 +58,7 @@ namespace zyppng::SuseTagsWorkflows {
               zypp::RepoStatus status ( contentFile->file() );
 
               if ( !status.empty() /* && _ctx->repoInfo().requireStatusWithMediaFile() */ ) {
-                return _ctx->zyppContext()->provider()->provide( _handle, "/media.1/media"  , ProvideFileSpec().setMirrorsAllowed(false) )
+                return _ctx->zyppContext()->provider()->provide( _handle, "/media.1/media"  , ProvideFileSpec().setPriority( ProvideFileSpec::High ).setMirrorsAllowed(false) )
                   | [status = std::move(status)]( expected<ProvideRes> mediaFile ) mutable {
                       if ( mediaFile ) {
                         return make_expected_success(status && zypp::RepoStatus( mediaFile->file()) );
@@ -275,7 +275,7 @@ namespace zyppng::SuseTagsWorkflows {
 
                     return transform_collect  ( std::move(requiredFiles), [this]( zypp::OnMediaLocation file ) {
 
-                      return DownloadWorkflow::provideToCacheDir( _ctx, _mediaHandle, file.filename(), ProvideFileSpec(file) )
+                      return DownloadWorkflow::provideToCacheDir( _ctx, _mediaHandle, file.filename(), ProvideFileSpec(file).setPriority( ProvideFileSpec::High ) )
                           | inspect ( incProgress( _progressObserver ) );
 
                     }) | and_then ( [this]( std::vector<zypp::ManagedFile> &&dlFiles ) {
@@ -15,6 +15,7 @@
 #include <zypp-core/AutoDispose.h>
 #include <zypp-core/base/Regex.h>
 #include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/ng/pipelines/Concurrent>
 #include <zypp-core/ng/pipelines/MTry>
 #include <zypp-core/ng/pipelines/Transform>
 #include <zypp-core/ng/pipelines/wait.h>
@@ -60,6 +61,12 @@ namespace zyppng
   } // namespace env
 
   namespace {
+    /** Max. number of repositories refreshed at the same time by \ref RepoManager::refreshMetadata.
+     * Each refresh downloads and parses the metadata of one repo, a few in parallel keep the
+     * network busy without flooding the mirrors.
+     */
+    constexpr std::size_t maxParallelRefresh = 4;
+
     /** Delete \a cachePath_r subdirs not matching known aliases in \a repoEscAliases_r (must be sorted!)
      * \note bnc#891515: Auto-cleanup only zypp.conf default locations. Otherwise
      * we'd need some magic file to identify zypp cache directories. Without this
@@ -334,13 +341,14 @@ namespace zyppng
         switch ( repokind.toEnum() )
         {
           case zypp::repo::RepoType::RPMMD_e :
-            status = RepoStatus( productdatapath/"repodata/repomd.xml");
             if ( info.requireStatusWithMediaFile() )
-              status = status && RepoStatus( mediarootpath/"media.1/media" );
+              status = RepoStatus::fromFiles( { productdatapath/"repodata/repomd.xml", mediarootpath/"media.1/media" } );
+            else
+              status = RepoStatus( productdatapath/"repodata/repomd.xml");
             break;
 
           case zypp::repo::RepoType::YAST2_e :
-            status = RepoStatus( productdatapath/"content" ) && RepoStatus( mediarootpath/"media.1/media" );
+            status = RepoStatus::fromFiles( { productdatapath/"content", mediarootpath/"media.1/media" } );
             break;
 
           case zypp::repo::RepoType::RPMPLAINDIR_e :
@@ -891,7 +899,7 @@ namespace zyppng
     ProgressObserver::setup( myProgress, "Refreshing repositories" , 1 );
 
     auto r = std::move(infos)
-        | transform( [this, policy, myProgress]( const RepoInfo &info ) {
+        | when_all_limited( maxParallelRefresh, [this, policy, myProgress]( const RepoInfo &info ) {
 
         auto subProgress = ProgressObserver::makeSubTask( myProgress, 1.0, zypp::str::Str() << _("Refreshing Repository: ") << info.alias(), 3 );
 
@@ -10,13 +10,23 @@
 /** \file HistoryLogReader.cc
  *
  */
+extern "C"
+{
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+}
 #include <iostream>
+#include <algorithm>
+#include <string_view>
 
 #include <utility>
 #include <zypp-core/base/InputStream>
 #include <zypp-core/base/IOStream.h>
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/parser/ParseException>
+#include <zypp-core/AutoDispose.h>
+#include <zypp-core/fs/PathInfo.h>
 
 #include <zypp/parser/HistoryLogReader.h>
 
@@ -28,6 +38,134 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
   namespace parser
   {
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      ///////////////////////////////////////////////////////////////////
+      /// \class MappedHistory
+      /// \brief Read-only memory map of an uncompressed history file.
+      ///
+      /// Not \ref usable if the file can not be mapped or is compressed
+      /// (e.g. rotated). The \ref InputStream based parser must be used then.
+      ///////////////////////////////////////////////////////////////////
+      struct MappedHistory
+      {
+        MappedHistory( const Pathname & file_r )
+        {
+          AutoFD fd { ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC ) };
+          struct stat st;
+          if ( fd == -1 || ::fstat( fd, &st ) != 0 || ! S_ISREG( st.st_mode ) )
+            return;
+
+          size_t size = st.st_size;
+          if ( size )
+          {
+            void * addr = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( addr == MAP_FAILED )
+            {
+              WAR << "Can't mmap " << file_r << ": " << str::strerror( errno ) << endl;
+              return;
+            }
+            ::madvise( addr, size, MADV_SEQUENTIAL );
+            _map = AutoDispose<void*>( addr, [size]( void * addr_r ) { ::munmap( addr_r, size ); } );
+            _data = std::string_view( static_cast<const char *>(addr), size );
+
+            // gzip or zstd compressed
+            if ( _data.substr( 0, 2 ) == "\x1f\x8b" || _data.substr( 0, 4 ) == "\x28\xb5\x2f\xfd" )
+              return;
+          }
+          _usable = true;
+        }
+
+        bool usable() const
+        { return _usable; }
+
+        std::string_view data() const
+        { return _data; }
+
+        /** Line number of the line starting at \a offset_r (for messages). */
+        unsigned lineNo( std::string_view::size_type offset_r ) const
+        { return std::count( _data.begin(), _data.begin() + offset_r, '\n' ) + 1; }
+
+        /** Date of the record starting at \a offset_r. */
+        Date recordDate( std::string_view::size_type offset_r ) const
+        {
+          std::string_view line { _data.substr( offset_r, _data.find_first_of( "|\n", offset_r ) - offset_r ) };
+          return Date( std::string( line ), HISTORY_LOG_DATE_FORMAT );
+        }
+
+        /** Offset of the first record which may be dated after \a date_r.
+         * Uses the sidecar index written by \ref HistoryLog if present
+         * and consistent with the data. Otherwise returns \c 0.
+         */
+        std::string_view::size_type seek( const Pathname & file_r, const Date & date_r ) const
+        {
+          const Pathname iname { file_r.extend( HISTORY_LOG_INDEX_SUFFIX ) };
+          if ( ! PathInfo( iname ).isFile() )
+            return 0;
+
+          std::string_view::size_type ret = 0;
+          Date retDate;
+          iostr::forEachLine( InputStream( iname ), [&]( int, std::string line_r )->bool {
+            Date date { str::strtonum<Date::ValueType>( str::stripFirstWord( line_r ) ) };
+            std::string_view::size_type offset = str::strtonum<std::string_view::size_type>( line_r );
+            if ( date >= date_r || offset >= _data.size() || offset < ret )
+              return false;	// done or stale
+            ret = offset;
+            retDate = date;
+            return true;
+          } );
+
+          // Must point to the start of a record with the expected date
+          if ( ret && ( _data[ret-1] != '\n' || recordDate( ret ) != retDate ) )
+          {
+            WAR << "Ignore inconsistent history index " << iname << endl;
+            return 0;
+          }
+          DBG << "History index " << iname << ": start at offset " << ret << " for " << date_r << endl;
+          return ret;
+        }
+
+        /** Invoke \a fnc_r( line, offset ) for each line starting at \a offset_r
+         * until it returns \c false. Comments are skipped.
+         */
+        template <class TFnc>
+        void forEachRecord( std::string_view::size_type offset_r, TFnc && fnc_r ) const
+        {
+          while ( offset_r < _data.size() )
+          {
+            std::string_view::size_type eol = _data.find( '\n', offset_r );
+            if ( eol == std::string_view::npos )
+              eol = _data.size();
+            std::string_view line { _data.substr( offset_r, eol - offset_r ) };
+            if ( ! line.empty() && line[0] != '#' && ! fnc_r( line, offset_r ) )
+              break;
+            offset_r = eol + 1;
+          }
+        }
+
+      private:
+        AutoDispose<void*> _map;
+        std::string_view _data;
+        bool _usable = false;
+      };
+
+      /** Trimmed action field of a record, without splitting the line. */
+      inline std::string_view actionField( std::string_view line_r )
+      {
+        std::string_view::size_type b = line_r.find( '|' );
+        if ( b == std::string_view::npos )
+          return std::string_view();
+        std::string_view::size_type e = line_r.find( '|', ++b );
+        std::string_view ret { line_r.substr( b, e == std::string_view::npos ? e : e - b ) };
+        while ( ! ret.empty() && ret.front() == ' ' )
+          ret.remove_prefix( 1 );
+        while ( ! ret.empty() && ret.back() == ' ' )
+          ret.remove_suffix( 1 );
+        return ret;
+      }
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
 
   /////////////////////////////////////////////////////////////////////
   //
@@ -42,7 +180,17 @@ namespace zypp
     , _callback( std::move(callback_r) )
     {}
 
-    bool parseLine( const std::string & line_r, unsigned int lineNr_r );
+    /** Parse a record; \a lineNr_r is invoked to compute the line number for messages. */
+    template <class TLineNr>
+    bool parseLine( std::string_view line_r, TLineNr && lineNr_r );
+
+    bool parseLine( const std::string & line_r, unsigned lineNr_r )
+    { return parseLine( std::string_view( line_r ), [lineNr_r]() { return lineNr_r; } ); }
+
+    /** Parse the mapped records dated in [\a fromDate_r, \a toDate_r).
+     * Callback semantics like \ref readFromTo.
+     */
+    void readMapped( const MappedHistory & history_r, const Date * fromDate_r, const Date * toDate_r, const ProgressData::ReceiverFnc & progress_r );
 
     void readAll( const ProgressData::ReceiverFnc & progress_r );
     void readFrom( const Date & date_r, const ProgressData::ReceiverFnc & progress_r );
@@ -59,24 +207,26 @@ namespace zypp
     Pathname _filename;
     Options  _options;
     ProcessData _callback;
-    std::set<std::string> _actionfilter;
+    std::set<std::string,std::less<>> _actionfilter;
   };
 
-  bool HistoryLogReader::Impl::parseLine( const std::string & line_r, unsigned lineNr_r )
+  template <class TLineNr>
+  bool HistoryLogReader::Impl::parseLine( std::string_view line_r, TLineNr && lineNr_r )
   {
+    // filter before splitting
+    if ( !_actionfilter.empty() && !_actionfilter.count( actionField( line_r ) ) )
+      return true;
+
     // parse into fields
     HistoryLogData::FieldVector fields;
     str::splitEscaped( line_r, std::back_inserter(fields), "|", true );
 
     if ( fields.size() < 2 ) {
-      WAR << "Ignore invalid history log entry on line #" << lineNr_r << " '"<< line_r << "'" << endl;
+      WAR << "Ignore invalid history log entry on line #" << lineNr_r() << " '"<< line_r << "'" << endl;
       return true;	// At least an action field[1] is needed!
     }
     fields[1] = str::trim( std::move(fields[1]) );	// for whatever reason writer is padding the action field
 
-    if ( !_actionfilter.empty() && !_actionfilter.count( fields[1] ) )
-      return true;
-
     // move into data class
     HistoryLogData::Ptr data;
     try
@@ -88,13 +238,13 @@ namespace zypp
       ZYPP_CAUGHT( excpt );
       if ( _options.testFlag( IGNORE_INVALID_ITEMS ) )
       {
-        WAR << "Ignore invalid history log entry on line #" << lineNr_r << " '"<< line_r << "'" << endl;
+        WAR << "Ignore invalid history log entry on line #" << lineNr_r() << " '"<< line_r << "'" << endl;
         return true;
       }
       else
       {
-        ERR << "Invalid history log entry on line #" << lineNr_r << " '"<< line_r << "'" << endl;
-        ParseException newexcpt( str::Str() << "Error in history log on line #" << lineNr_r );
+        ERR << "Invalid history log entry on line #" << lineNr_r() << " '"<< line_r << "'" << endl;
+        ParseException newexcpt( str::Str() << "Error in history log on line #" << lineNr_r() );
         newexcpt.remember( excpt );
         ZYPP_THROW( newexcpt );
       }
@@ -103,14 +253,50 @@ namespace zypp
     // consume data
     if ( _callback && !_callback( data ) )
     {
-      WAR << "Stop parsing requested by consumer callback on line #" << lineNr_r << endl;
+      WAR << "Stop parsing requested by consumer callback on line #" << lineNr_r() << endl;
       return false;
     }
     return true;
   }
 
+  void HistoryLogReader::Impl::readMapped( const MappedHistory & history_r, const Date * fromDate_r, const Date * toDate_r, const ProgressData::ReceiverFnc & progress_r )
+  {
+    std::string_view::size_type start = fromDate_r ? history_r.seek( _filename, *fromDate_r ) : 0;
+
+    ProgressData pd;
+    pd.sendTo( progress_r );
+    pd.toMin();
+
+    bool pastFromDate = ! fromDate_r;
+    history_r.forEachRecord( start, [&]( std::string_view line_r, std::string_view::size_type offset_r )->bool {
+      pd.tick();
+      if ( toDate_r || ! pastFromDate )
+      {
+        Date logDate { history_r.recordDate( offset_r ) };
+
+        // past toDate - stop reading
+        if ( toDate_r && logDate >= *toDate_r )
+          return false;
+
+        // past fromDate - start reading
+        if ( ! pastFromDate && logDate > *fromDate_r )
+          pastFromDate = true;
+      }
+
+      if ( ! pastFromDate )
+        return true;
+      return parseLine( line_r, [&history_r,offset_r]() { return history_r.lineNo( offset_r ); } );
+    } );
+
+    pd.toMax();
+  }
+
   void HistoryLogReader::Impl::readAll( const ProgressData::ReceiverFnc & progress_r )
   {
+    MappedHistory history( _filename );
+    if ( history.usable() )
+      return readMapped( history, nullptr, nullptr, progress_r );
+
     InputStream is( _filename );
     iostr::EachLine line( is );
 
@@ -133,6 +319,10 @@ namespace zypp
 
   void HistoryLogReader::Impl::readFrom( const Date & date_r, const ProgressData::ReceiverFnc & progress_r )
   {
+    MappedHistory history( _filename );
+    if ( history.usable() )
+      return readMapped( history, &date_r, nullptr, progress_r );
+
     InputStream is( _filename );
     iostr::EachLine line( is );
 
@@ -171,6 +361,10 @@ namespace zypp
 
   void HistoryLogReader::Impl::readFromTo( const Date & fromDate_r, const Date & toDate_r, const ProgressData::ReceiverFnc & progress_r )
   {
+    MappedHistory history( _filename );
+    if ( history.usable() )
+      return readMapped( history, &fromDate_r, &toDate_r, progress_r );
+
     InputStream is( _filename );
     iostr::EachLine line( is );
 
@@ -10,6 +10,13 @@
  *
 */
 #include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/String.h>
@@ -19,6 +26,7 @@
 #include <zypp-core/AutoDispose.h>
 #include <zypp/PathInfo.h>
 #include <zypp-core/TriBool.h>
+#include <zypp-core/ng/thread/threadpool.h>
 
 using std::endl;
 
@@ -35,6 +43,9 @@ namespace zypp
       const Pathname   applydeltarpm_prog( "/usr/bin/applydeltarpm" );
       const str::regex applydeltarpm_tick ( "([0-9]+) percent finished" );
 
+      /** The most recently created \ref Pipeline. */
+      Pipeline * activePipeline = nullptr;
+
       /******************************************************************
        **
        **	FUNCTION NAME : applydeltarpm
@@ -70,6 +81,8 @@ namespace zypp
     {
       // To track changes in availability of applydeltarpm.
       static TriBool _last = indeterminate;
+      static std::mutex _lastMutex;	// checks may run in Pipeline jobs
+      std::lock_guard<std::mutex> lock( _lastMutex );
       PathInfo prog( applydeltarpm_prog );
       bool have = prog.isX();
       if ( _last == have )
@@ -187,6 +200,185 @@ namespace zypp
       return true;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class Pipeline::Impl
+    /// \brief Pipeline implementation.
+    ///
+    /// Jobs are queued in order and processed by up to \c _jobs runners
+    /// on a \ref zyppng::ThreadPool of the pipeline's own. The runners block
+    /// on applydeltarpm, on the global pool they would hold back the short
+    /// jobs it is meant for. A runner processes queued jobs until the queue
+    /// is empty. A job stays in \c _jobsByRpm until it was taken.
+    ///////////////////////////////////////////////////////////////////
+    class Pipeline::Impl : private base::NonCopyable
+    {
+    public:
+      struct Job
+      {
+        ManagedFile _delta;
+        Pathname    _deltaName;	// kept for reports after _delta was released
+        std::string _sequenceinfo;
+        Result      _result = NotQueued;
+        bool        _done = false;
+      };
+
+    public:
+      explicit Impl( unsigned jobs_r )
+      : _jobs( jobs_r ? jobs_r : std::max( std::thread::hardware_concurrency(), 1U ) )
+      {}
+
+      ~Impl()
+      {
+        {
+          // jobs not yet started are dropped
+          std::unique_lock<std::mutex> lock( _mutex );
+          _stop = true;
+          _finished.wait( lock, [this](){ return _running == 0; } );
+        }
+        _executor.reset();
+
+        // nobody asked for them
+        for ( const auto & [rpm, job] : _jobsByRpm )
+        {
+          if ( job._result == Done )
+          {
+            DBG << "Remove rebuilt rpm not taken " << rpm << endl;
+            filesystem::unlink( rpm );
+          }
+        }
+      }
+
+      unsigned jobs() const
+      { return _jobs; }
+
+      void enqueue( ManagedFile delta_r, std::string sequenceinfo_r, Pathname new_r )
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        if ( _jobsByRpm.count( new_r ) )
+        {
+          WAR << "Rebuild of " << new_r << " is already queued" << endl;
+          return;
+        }
+
+        Job & job( _jobsByRpm[new_r] );
+        job._deltaName = delta_r.value();
+        job._delta = std::move(delta_r);
+        job._sequenceinfo = std::move(sequenceinfo_r);
+        _queue.push_back( new_r );
+        MIL << "Queued rebuild of " << new_r << " (" << _queue.size() << " waiting)" << endl;
+
+        if ( _running < _jobs )
+        {
+          // the threads are started with the first job, many pipelines never get one
+          if ( ! _executor )
+            _executor.reset( new zyppng::ThreadPool( _jobs ) );
+          ++_running;
+          _executor->post( [this](){ work(); } );
+        }
+      }
+
+      Pathname queuedDelta( const Pathname & new_r ) const
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        auto it = _jobsByRpm.find( new_r );
+        return ( it == _jobsByRpm.end() ? Pathname() : it->second._deltaName );
+      }
+
+      Result take( const Pathname & new_r )
+      {
+        std::unique_lock<std::mutex> lock( _mutex );
+        auto it = _jobsByRpm.find( new_r );
+        if ( it == _jobsByRpm.end() )
+          return NotQueued;
+
+        _finished.wait( lock, [&it](){ return it->second._done; } );
+        Result ret = it->second._result;
+        _jobsByRpm.erase( it );
+        return ret;
+      }
+
+    private:
+      void work()
+      {
+        std::unique_lock<std::mutex> lock( _mutex );
+        while ( true )
+        {
+          if ( _stop || _queue.empty() )
+          {
+            --_running;
+            _finished.notify_all();
+            return;
+          }
+
+          Pathname rpm( _queue.front() );
+          _queue.pop_front();
+          // std::map: the job stays in place, only take removes it once it is done
+          Job & job( _jobsByRpm[rpm] );
+          Pathname delta( job._deltaName );
+          std::string sequenceinfo( job._sequenceinfo );
+          lock.unlock();
+
+          Result result = Done;
+          if ( ! check( sequenceinfo ) )
+            result = CheckFailed;
+          else if ( ! provide( delta, rpm ) )
+            result = ApplyFailed;
+
+          if ( result == Done )
+            MIL << "Rebuilt " << rpm << endl;
+          else
+            WAR << "Failed to rebuild " << rpm << " (" << ( result == CheckFailed ? "check" : "apply" ) << ")" << endl;
+
+          lock.lock();
+          job._result = result;
+          job._done = true;
+          job._delta.reset();	// no longer needed
+          _finished.notify_all();
+        }
+      }
+
+    private:
+      const unsigned _jobs;
+      mutable std::mutex _mutex;
+      std::condition_variable _finished;
+      std::map<Pathname,Job> _jobsByRpm;
+      std::deque<Pathname> _queue;
+      unsigned _running = 0;
+      bool _stop = false;
+      std::unique_ptr<zyppng::ThreadPool> _executor;	///< runs the runners, created on demand
+
+    public:
+      Pipeline * _previous = nullptr;
+    };
+
+    Pipeline::Pipeline( unsigned jobs_r )
+    : _pimpl( new Impl( jobs_r ) )
+    {
+      _pimpl->_previous = activePipeline;
+      activePipeline = this;
+    }
+
+    Pipeline::~Pipeline()
+    {
+      if ( activePipeline == this )
+        activePipeline = _pimpl->_previous;
+    }
+
+    Pipeline * Pipeline::active()
+    { return activePipeline; }
+
+    unsigned Pipeline::jobs() const
+    { return _pimpl->jobs(); }
+
+    void Pipeline::enqueue( ManagedFile delta_r, std::string sequenceinfo_r, Pathname new_r )
+    { _pimpl->enqueue( std::move(delta_r), std::move(sequenceinfo_r), std::move(new_r) ); }
+
+    Pathname Pipeline::queuedDelta( const Pathname & new_r ) const
+    { return _pimpl->queuedDelta( new_r ); }
+
+    Pipeline::Result Pipeline::take( const Pathname & new_r )
+    { return _pimpl->take( new_r ); }
+
     /////////////////////////////////////////////////////////////////
   } // namespace applydeltarpm
   ///////////////////////////////////////////////////////////////////
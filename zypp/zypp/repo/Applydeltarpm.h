@@ -14,9 +14,12 @@
 
 #include <iosfwd>
 #include <string>
+#include <memory>
 
 #include <zypp-core/base/Function.h>
+#include <zypp-core/base/NonCopyable.h>
 #include <zypp-core/Pathname.h>
+#include <zypp/ManagedFile.h>
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -74,6 +77,64 @@ namespace zypp
                   const Progress & report_r = Progress() );
     //@}
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class Pipeline
+    /// \brief Rebuild rpms from deltas in the background.
+    ///
+    /// While a \c Pipeline exists, \ref repo::PackageProvider hands the
+    /// \ref check and \ref provide of a downloaded delta over to it, so the
+    /// next packages can be downloaded meanwhile. Up to \ref jobs rpms are
+    /// rebuilt concurrently, each by its own applydeltarpm process. The
+    /// result is picked up by \ref take when the package is provided.
+    ///
+    /// Rpms not taken until the \c Pipeline is destructed are removed.
+    ///
+    /// \note Only the most recently created \c Pipeline is \ref active.
+    ///////////////////////////////////////////////////////////////////
+    class Pipeline : private base::NonCopyable
+    {
+    public:
+      /** Result of a queued job. */
+      enum Result
+      {
+        NotQueued,	///< nothing queued for the rpm
+        CheckFailed,	///< the installed files do not match the delta
+        ApplyFailed,	///< rebuilding the rpm failed
+        Done		///< the rpm was rebuilt
+      };
+
+    public:
+      /** Ctor, \c 0 \a jobs_r means one job per CPU core. */
+      explicit Pipeline( unsigned jobs_r = 0 );
+
+      /** Dtor, waits for the running jobs. */
+      ~Pipeline();
+
+      /** The active \c Pipeline or \c nullptr. */
+      static Pipeline * active();
+
+      /** The number of rpms rebuilt concurrently. */
+      unsigned jobs() const;
+
+      /** Queue rebuilding \a new_r from \a delta_r, checked against \a sequenceinfo_r.
+       * \a delta_r is released once the job is done.
+       */
+      void enqueue( ManagedFile delta_r, std::string sequenceinfo_r, Pathname new_r );
+
+      /** The delta used by the job for \a new_r, empty if none was queued or it was already taken. */
+      Pathname queuedDelta( const Pathname & new_r ) const;
+
+      /** Wait for the job rebuilding \a new_r and return its result.
+       * On success \a new_r is owned by the caller, otherwise it does not exist.
+       */
+      Result take( const Pathname & new_r );
+
+    public:
+      class Impl;
+    private:
+      std::unique_ptr<Impl> _pimpl;
+    };
+
     /////////////////////////////////////////////////////////////////
   } // namespace applydeltarpm
   ///////////////////////////////////////////////////////////////////
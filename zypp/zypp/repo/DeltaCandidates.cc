@@ -13,6 +13,7 @@ extern "C"
 
 #include <iostream>
 #include <utility>
+#include <algorithm>
 #include <zypp-core/base/Logger.h>
 #include <zypp/Repository.h>
 #include <zypp/repo/DeltaCandidates.h>
@@ -105,6 +106,35 @@ namespace zypp
       return candidates;
     }
 
+    std::list<DeltaRpm> DeltaCandidates::deltaRpms( const Package::constPtr & package, const CostModel & costModel_r ) const
+    {
+      std::list<DeltaRpm> candidates( deltaRpms( package ) );
+      if ( package )
+      {
+        candidates.remove_if( [&]( const DeltaRpm & delta_r ) {
+          if ( costModel_r.worthApplying( delta_r.location().downloadSize(), package->downloadSize(), package->installSize() ) )
+            return false;
+          MIL << "Skip delta " << delta_r.location().filename() << ": rebuilding " << package << " takes longer than downloading it" << endl;
+          return true;
+        } );
+      }
+      return candidates;
+    }
+
+    bool DeltaCandidates::CostModel::worthApplying( const ByteCount & deltaSize_r, const ByteCount & packageSize_r, const ByteCount & installSize_r ) const
+    {
+      if ( ! packageSize_r )
+        return true;	// nothing to compare with
+      if ( deltaSize_r >= packageSize_r )
+        return false;
+      if ( ! downloadRate || ! applyRate )
+        return true;
+
+      const double savedTime = double( packageSize_r - deltaSize_r ) / double( downloadRate );
+      const double applyTime = double( installSize_r ) / ( double( applyRate ) * std::max( jobs, 1U ) );
+      return applyTime < savedTime;
+    }
+
     std::ostream & operator<<( std::ostream & str, const DeltaCandidates & obj )
     {
       return str << *obj._pimpl;
@@ -41,6 +41,27 @@ namespace zypp
       /** Implementation  */
       struct Impl;
 
+      /**
+       * \short Decides whether rebuilding a package from a delta pays off
+       *
+       * A delta saves the download of the difference between the package and
+       * the delta size, but \c applydeltarpm needs time to rebuild the package
+       * from the installed files. The time depends on the installed size of
+       * the package, as the payload needs to be compressed again.
+       */
+      struct ZYPP_API CostModel
+      {
+        ByteCount downloadRate;	///< Bytes downloaded per second, \c 0 if unknown.
+        ByteCount applyRate;	///< Bytes of installed size rebuilt per second, \c 0 if unknown.
+        unsigned  jobs = 1;	///< Number of packages rebuilt concurrently.
+
+        /** Whether rebuilding a package of \a installSize_r from a delta of \a deltaSize_r
+         * is expected to take less time than downloading the \a packageSize_r difference.
+         * If a rate is unknown, the delta is used if it is smaller than the package.
+         */
+        bool worthApplying( const ByteCount & deltaSize_r, const ByteCount & packageSize_r, const ByteCount & installSize_r ) const;
+      };
+
     public:
       DeltaCandidates();
 
@@ -58,6 +79,9 @@ namespace zypp
 
       std::list<packagedelta::DeltaRpm> deltaRpms(const Package::constPtr & package) const;
 
+      /** \overload Omitting deltas the \a costModel_r considers not worth applying. */
+      std::list<packagedelta::DeltaRpm> deltaRpms( const Package::constPtr & package, const CostModel & costModel_r ) const;
+
     private:
       /** Pointer to implementation */
       RWCOW_pointer<Impl> _pimpl;
@@ -12,12 +12,16 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <chrono>
+#include <map>
 #include <zypp/repo/PackageDelta.h>
 #include <zypp-core/base/Logger.h>
 #include <zypp-core/base/Gettext.h>
 #include <utility>
 #include <zypp-core/base/UserRequestException>
 #include <zypp-core/base/NonCopyable.h>
+#include <zypp-media/SharedFileCache>
+#include <zypp-media/MediaConfig>
 #include <zypp/repo/PackageProvider.h>
 #include <zypp/repo/Applydeltarpm.h>
 #include <zypp/repo/PackageDelta.h>
@@ -66,6 +70,120 @@ namespace zypp
     };
 
 
+    namespace
+    {
+      ///////////////////////////////////////////////////////////////////
+      /// \class DownloadRate
+      /// \brief Throughput of the package and delta downloads seen so far.
+      ///
+      /// Feeds the \ref DeltaCandidates::CostModel. Until enough data was
+      /// downloaded, the configured download speed limit is used if any.
+      ///////////////////////////////////////////////////////////////////
+      class DownloadRate
+      {
+      public:
+        static DownloadRate & instance()
+        {
+          static DownloadRate _instance;
+          return _instance;
+        }
+
+        void add( const ByteCount & bytes_r, std::chrono::steady_clock::duration time_r )
+        {
+          _bytes += bytes_r;
+          _time += time_r;
+        }
+
+        /** Bytes per second, \c 0 if unknown. */
+        ByteCount perSecond() const
+        {
+          ByteCount ret;
+          if ( _bytes >= ByteCount( 1, ByteCount::MiB ) && _time.count() > 0 )	// too little to tell
+            ret = ByteCount::SizeType( double(_bytes) / std::chrono::duration<double>( _time ).count() );
+
+          const long limit = MediaConfig::instance().download_max_download_speed();
+          if ( limit > 0 && ( ! ret || ret > limit ) )
+            ret = limit;
+          return ret;
+        }
+
+      private:
+        ByteCount _bytes;
+        std::chrono::steady_clock::duration _time = std::chrono::steady_clock::duration::zero();
+      };
+
+      ///////////////////////////////////////////////////////////////////
+      /// \class TransferTimeReport
+      /// \brief Time spent transferring files, from their start to their finish report.
+      ///
+      /// Connected while a file is provided, all reports are passed on to the
+      /// receiver connected before. Files taken from a cache send no report, so
+      /// \ref time stays zero for them. Checking the file happens after the
+      /// finish report and is not included.
+      ///////////////////////////////////////////////////////////////////
+      struct TransferTimeReport : public callback::ReceiveReport<media::DownloadProgressReport>
+      {
+        using BaseType = callback::ReceiveReport<ReportType>;
+
+        TransferTimeReport()
+        : _oldRec( Distributor::instance().getReceiver() )
+        { connect(); }
+
+        TransferTimeReport( const TransferTimeReport & ) = delete;
+        TransferTimeReport & operator=( const TransferTimeReport & ) = delete;
+
+        ~TransferTimeReport() override
+        { if ( _oldRec ) Distributor::instance().setReceiver( *_oldRec ); else Distributor::instance().noReceiver(); }
+
+        /** Summed time of the successful transfers. */
+        std::chrono::steady_clock::duration time() const
+        { return _time; }
+
+        void start( const Url & file_r, Pathname localfile_r ) override
+        {
+          _started[file_r.asString()] = std::chrono::steady_clock::now();
+          if ( _oldRec )
+            _oldRec->start( file_r, localfile_r );
+          else
+            BaseType::start( file_r, localfile_r );
+        }
+
+        bool progress( int value_r, const Url & file_r, double dbps_avg_r = -1, double dbps_current_r = -1 ) override
+        {
+          if ( _oldRec )
+            return _oldRec->progress( value_r, file_r, dbps_avg_r, dbps_current_r );
+          return BaseType::progress( value_r, file_r, dbps_avg_r, dbps_current_r );
+        }
+
+        Action problem( const Url & file_r, Error error_r, const std::string & description_r ) override
+        {
+          if ( _oldRec )
+            return _oldRec->problem( file_r, error_r, description_r );
+          return BaseType::problem( file_r, error_r, description_r );
+        }
+
+        void finish( const Url & file_r, Error error_r, const std::string & reason_r ) override
+        {
+          auto it = _started.find( file_r.asString() );
+          if ( it != _started.end() )
+          {
+            if ( error_r == NO_ERROR )
+              _time += std::chrono::steady_clock::now() - it->second;
+            _started.erase( it );
+          }
+          if ( _oldRec )
+            _oldRec->finish( file_r, error_r, reason_r );
+          else
+            BaseType::finish( file_r, error_r, reason_r );
+        }
+
+      private:
+        Receiver * _oldRec;
+        std::map<std::string, std::chrono::steady_clock::time_point> _started;
+        std::chrono::steady_clock::duration _time = std::chrono::steady_clock::duration::zero();
+      };
+    } // namespace
+
     ///////////////////////////////////////////////////////////////////
     //	class PackageProviderPolicy
     ///////////////////////////////////////////////////////////////////
@@ -103,6 +221,10 @@ namespace zypp
 
       /** Whether the package is cached. */
       virtual bool isCached() const = 0;
+
+      /** Download a delta and queue rebuilding the package in the active \ref applydeltarpm::Pipeline. */
+      virtual bool prefetchDelta() const
+      { return false; }
     };
 
     ///////////////////////////////////////////////////////////////////
@@ -187,7 +309,28 @@ namespace zypp
         ProvideFilePolicy policy;
         policy.progressCB( bind( &Base::progressPackageDownload, this, _1 ) );
         policy.fileChecker( bind( &Base::rpmSigFileChecker, this, _1 ) );
-        return _access.provideFile( _package->repoInfo(), loc, policy );
+        return provideFile( _package->repoInfo(), loc, policy );
+      }
+
+      /** Provide a file via \ref _access, adding downloads to the \ref DownloadRate.
+       * Only the transfer itself is measured, files found in a cache are not counted.
+       */
+      ManagedFile provideFile( const RepoInfo & info_r, const OnMediaLocation & loc_r, const ProvideFilePolicy & policy_r ) const
+      {
+        std::chrono::steady_clock::duration transferTime;
+        ManagedFile ret;
+        {
+          TransferTimeReport transferReport;
+          ret = _access.provideFile( info_r, loc_r, policy_r );
+          transferTime = transferReport.time();
+        }
+        if ( info_r.url().schemeIsDownloading() && transferTime.count() > 0 )
+        {
+          PathInfo pi( ret );
+          if ( pi.isFile() )
+            DownloadRate::instance().add( pi.size(), transferTime );
+        }
+        return ret;
       }
 
     protected:
@@ -304,7 +447,10 @@ namespace zypp
         RpmDb::CheckPackageDetail detail;
         if ( _target )
         {
-          ret = _target->rpmDb().checkPackageSignature( path_r, detail );
+          if ( _target->rpmDb().cachedPackageSignature( path_r, _package->location().checksum(), detail ) )
+            ret = RpmDb::CHK_OK;	// verified in advance by RpmDb::checkPackageSignatures
+          else
+            ret = _target->rpmDb().checkPackageSignature( path_r, detail );
           if ( ret == RpmDb::CHK_NOSIG && !isMandatory_r )
           {
             WAR << "Relax CHK_NOSIG: Config says unsigned packages are OK" << endl;
@@ -353,7 +499,7 @@ namespace zypp
       TPackagePtr		_package;
       RepoMediaAccess &		_access;
 
-    private:
+    protected:
       using ScopedGuard = shared_ptr<void>;
 
       ScopedGuard newReport() const
@@ -367,6 +513,7 @@ namespace zypp
                                             std::ref(_report) ) );
       }
 
+    private:
       mutable bool               _retry;
       mutable shared_ptr<Report> _report;
       mutable Target_Ptr         _target;
@@ -418,6 +565,42 @@ namespace zypp
         }
       }
 
+      // Check the shared file cache
+      if ( SharedFileCache * sharedCache = SharedFileCache::instance() )
+      {
+        const OnMediaLocation & loc( _package->location() );
+        const Pathname & dest( info.packagesPath() / info.path() / loc.filename() );
+        if ( sharedCache->provide( loc.checksum(), dest ) )
+        {
+          report()->start( _package, sharedCache->entryPath( loc.checksum() ).asFileUrl() );
+          ret = ManagedFile( dest );
+          if ( ! info.effectiveKeepPackages() )
+            ret.setDispose( filesystem::unlink );
+
+          // the store is shared with other processes, check the package like a downloaded one
+          try
+          {
+            rpmSigFileChecker( dest );
+          }
+          catch ( const RpmSigCheckException & excpt )
+          {
+            ZYPP_CAUGHT( excpt );
+            ERR << "Package from shared file cache failed the signature check " << _package << endl;
+            ret.setDispose( filesystem::unlink );
+            ret.reset();
+            if ( excpt.action() != repo::DownloadResolvableReport::RETRY )
+              ZYPP_THROW(AbortRequestException("User requested to abort"));
+          }
+
+          if ( ! ret->empty() )
+          {
+            MIL << "provided Package from shared file cache " << _package << " at " << ret << endl;
+            report()->finish( _package, repo::DownloadResolvableReport::NO_ERROR, std::string() );
+            return ret; // <-- shared file cache hit
+          }
+        }
+      }
+
       if ( info.repoOriginsEmpty() )
         ZYPP_THROW(Exception("No url in repository."));
 
@@ -521,6 +704,10 @@ namespace zypp
         throw;
       }
 
+      // the package was checked when it was provided, the entry is a copy
+      if ( SharedFileCache * sharedCache = SharedFileCache::instance() )
+        sharedCache->add( *ret, _package->location().checksum(), true );
+
       report()->finish( _package, repo::DownloadResolvableReport::NO_ERROR, std::string() );
       MIL << "provided Package " << _package << " at " << ret << endl;
       return ret;
@@ -542,14 +729,35 @@ namespace zypp
       , _deltas( std::move(deltas_r) )
       {}
 
+    public:
+      bool prefetchDelta() const override;
+
     protected:
       ManagedFile doProvidePackage() const override;
 
     private:
       using DeltaRpm = packagedelta::DeltaRpm;
 
+      /** The deltas worth trying, none if deltas are not used. */
+      std::list<DeltaRpm> usableDeltas() const;
+
+      /** Download the delta if the quick check says it may be applied. */
+      ManagedFile provideDelta( const DeltaRpm & delta_r ) const;
+
       ManagedFile tryDelta( const DeltaRpm & delta_r ) const;
 
+      /** Pick up the rpm rebuilt from \a delta_r in the background. */
+      ManagedFile takeDelta( applydeltarpm::Pipeline & pipeline_r, const Pathname & delta_r ) const;
+
+      /** Check the rebuilt rpm and move it into the cache. */
+      ManagedFile cacheDelta() const;
+
+      Pathname cachedest() const
+      { return _package->repoInfo().packagesPath() / _package->repoInfo().path() / _package->location().filename(); }
+
+      Pathname builddest() const
+      { return cachedest().extend( ".drpm" ); }
+
       bool progressDeltaDownload( int value ) const
       { return report()->progressDeltaDownload( value ); }
 
@@ -564,33 +772,83 @@ namespace zypp
     };
     ///////////////////////////////////////////////////////////////////
 
-    ManagedFile RpmPackageProvider::doProvidePackage() const
+    bool RpmPackageProvider::prefetchDelta() const
     {
-      // check whether to process patch/delta rpms
-      // FIXME we only check the first url for now.
-      if ( ZConfig::instance().download_use_deltarpm()
-        && ( _package->repoInfo().url().schemeIsDownloading() || ZConfig::instance().download_use_deltarpm_always() ) )
+      applydeltarpm::Pipeline * pipeline = applydeltarpm::Pipeline::active();
+      if ( ! pipeline || isCached() )
+        return false;
+      if ( ! pipeline->queuedDelta( builddest() ).empty() )
+        return true;
+
+      std::list<DeltaRpm> deltaRpms( usableDeltas() );
+      if ( deltaRpms.empty() )
+        return false;
+
+      // just the delta download events, the package itself is reported when it is provided
+      ScopedGuard guardReport( newReport() );
+      for ( const DeltaRpm & deltaRpm : deltaRpms )
       {
-        std::list<DeltaRpm> deltaRpms;
-        _deltas.deltaRpms( _package ).swap( deltaRpms );
+        DBG << "prefetchDelta " << deltaRpm << endl;
+        ManagedFile delta( provideDelta( deltaRpm ) );
+        if ( ! delta->empty() )
+        {
+          pipeline->enqueue( std::move(delta), deltaRpm.baseversion().sequenceinfo(), builddest() );
+          break;
+        }
+      }
+      return ! pipeline->queuedDelta( builddest() ).empty();
+    }
 
-        if ( ! deltaRpms.empty() && queryInstalled() && applydeltarpm::haveApplydeltarpm() )
+    ManagedFile RpmPackageProvider::doProvidePackage() const
+    {
+      // the delta was downloaded in advance, don't try the others if it failed
+      if ( applydeltarpm::Pipeline * pipeline = applydeltarpm::Pipeline::active() )
+      {
+        const Pathname & delta( pipeline->queuedDelta( builddest() ) );
+        if ( ! delta.empty() )
         {
-          for_( it, deltaRpms.begin(), deltaRpms.end())
-          {
-            DBG << "tryDelta " << *it << endl;
-            ManagedFile ret( tryDelta( *it ) );
-            if ( ! ret->empty() )
-              return ret;
-          }
+          ManagedFile ret( takeDelta( *pipeline, delta ) );
+          if ( ! ret->empty() )
+            return ret;
+          return Base::doProvidePackage();
         }
       }
 
+      for ( const DeltaRpm & deltaRpm : usableDeltas() )
+      {
+        DBG << "tryDelta " << deltaRpm << endl;
+        ManagedFile ret( tryDelta( deltaRpm ) );
+        if ( ! ret->empty() )
+          return ret;
+      }
+
       // no patch/delta -> provide full package
       return Base::doProvidePackage();
     }
 
-    ManagedFile RpmPackageProvider::tryDelta( const DeltaRpm & delta_r ) const
+    std::list<packagedelta::DeltaRpm> RpmPackageProvider::usableDeltas() const
+    {
+      std::list<DeltaRpm> deltaRpms;
+
+      // check whether to process patch/delta rpms
+      // FIXME we only check the first url for now.
+      if ( ZConfig::instance().download_use_deltarpm()
+        && ( _package->repoInfo().url().schemeIsDownloading() || ZConfig::instance().download_use_deltarpm_always() ) )
+      {
+        DeltaCandidates::CostModel costModel;
+        costModel.downloadRate = DownloadRate::instance().perSecond();
+        costModel.applyRate = ZConfig::instance().download_deltarpm_apply_rate();
+        if ( applydeltarpm::Pipeline * pipeline = applydeltarpm::Pipeline::active() )
+          costModel.jobs = pipeline->jobs();
+
+        _deltas.deltaRpms( _package, costModel ).swap( deltaRpms );
+        if ( ! deltaRpms.empty() && ! ( queryInstalled() && applydeltarpm::haveApplydeltarpm() ) )
+          deltaRpms.clear();
+      }
+      return deltaRpms;
+    }
+
+    ManagedFile RpmPackageProvider::provideDelta( const DeltaRpm & delta_r ) const
     {
       if ( delta_r.baseversion().edition() != Edition::noedition
            && ! queryInstalled( delta_r.baseversion().edition() ) )
@@ -606,7 +864,7 @@ namespace zypp
         {
           ProvideFilePolicy policy;
           policy.progressCB( bind( &RpmPackageProvider::progressDeltaDownload, this, _1 ) );
-          delta = _access.provideFile( delta_r.repository().info(), delta_r.location(), policy );
+          delta = provideFile( delta_r.repository().info(), delta_r.location(), policy );
           // bsc#1245672: delta rpms are optional resources.
           // ProvideFile however always returns a managed file if no Exception occurred.
           // So the caller has to check whether the optional file actually exists.
@@ -622,6 +880,14 @@ namespace zypp
           return ManagedFile();
         }
       report()->finishDeltaDownload();
+      return delta;
+    }
+
+    ManagedFile RpmPackageProvider::tryDelta( const DeltaRpm & delta_r ) const
+    {
+      ManagedFile delta( provideDelta( delta_r ) );
+      if ( delta->empty() )
+        return ManagedFile();
 
       report()->startDeltaApply( delta );
       if ( ! applydeltarpm::check( delta_r.baseversion().sequenceinfo() ) )
@@ -631,27 +897,50 @@ namespace zypp
         }
 
       // Build the package
-      Pathname cachedest( _package->repoInfo().packagesPath() / _package->repoInfo().path() / _package->location().filename() );
-      Pathname builddest( cachedest.extend( ".drpm" ) );
-
-      if ( ! applydeltarpm::provide( delta, builddest,
+      if ( ! applydeltarpm::provide( delta, builddest(),
                                      bind( &RpmPackageProvider::progressDeltaApply, this, _1 ) ) )
         {
           report()->problemDeltaApply( _("applydeltarpm failed.") );
           return ManagedFile();
         }
-      ManagedFile builddestCleanup( builddest, filesystem::unlink );
+      return cacheDelta();
+    }
+
+    ManagedFile RpmPackageProvider::takeDelta( applydeltarpm::Pipeline & pipeline_r, const Pathname & delta_r ) const
+    {
+      report()->startDeltaApply( delta_r );
+      switch ( pipeline_r.take( builddest() ) )
+      {
+        case applydeltarpm::Pipeline::Done:
+          break;
+
+        case applydeltarpm::Pipeline::CheckFailed:
+          report()->problemDeltaApply( _("applydeltarpm check failed.") );
+          return ManagedFile();
+
+        case applydeltarpm::Pipeline::NotQueued:
+        case applydeltarpm::Pipeline::ApplyFailed:
+          report()->problemDeltaApply( _("applydeltarpm failed.") );
+          return ManagedFile();
+      }
+      progressDeltaApply( 100 );
+      return cacheDelta();
+    }
+
+    ManagedFile RpmPackageProvider::cacheDelta() const
+    {
+      ManagedFile builddestCleanup( builddest(), filesystem::unlink );
       report()->finishDeltaApply();
 
       // Check and move it into the cache
       // Here the rpm itself is ready. If the packages sigcheck fails, it
       // makes no sense to return a ManagedFile() and fallback to download the
       // full rpm. It won't be different. So let the exceptions escape...
-      rpmSigFileChecker( builddest );
-      if ( filesystem::hardlinkCopy( builddest, cachedest ) != 0 )
-        ZYPP_THROW( Exception( str::Str() << "Can't hardlink/copy " << builddest << " to " << cachedest ) );
+      rpmSigFileChecker( builddest() );
+      if ( filesystem::hardlinkCopy( builddest(), cachedest() ) != 0 )
+        ZYPP_THROW( Exception( str::Str() << "Can't hardlink/copy " << builddest() << " to " << cachedest() ) );
 
-      return ManagedFile( cachedest, filesystem::unlink );
+      return ManagedFile( cachedest(), filesystem::unlink );
     }
 
     ///////////////////////////////////////////////////////////////////
@@ -722,6 +1011,9 @@ namespace zypp
     bool PackageProvider::isCached() const
     { return _pimpl->isCached(); }
 
+    bool PackageProvider::prefetchDelta() const
+    { return _pimpl->prefetchDelta(); }
+
   } // namespace repo
   ///////////////////////////////////////////////////////////////////
 } // namespace zypp
@@ -92,6 +92,12 @@ namespace zypp
       /** Whether the package is cached. */
       bool isCached() const;
 
+      /** Download a delta and queue rebuilding the package in the active
+       * \ref applydeltarpm::Pipeline, so \ref providePackage just picks up
+       * the result. Returns whether a rebuild is queued.
+       */
+      bool prefetchDelta() const;
+
     public:
       struct Impl;              ///< Implementation class.
     private:
@@ -22,6 +22,7 @@
 #include <zypp-core/fs/WatchFile>
 #include <zypp-core/parser/Sysconfig>
 #include <zypp-core/base/IOStream.h>
+#include <zypp-core/base/Metrics.h>
 
 #include <zypp/ZConfig.h>
 
@@ -282,6 +283,8 @@ namespace zypp
 
       void PoolImpl::prepare() const
       {
+        static metrics::Histogram & prepareTime { metrics::histogram( "pool.prepare" ) };
+        metrics::ScopedTimer timer { prepareTime };
         // additional /etc/sysconfig/storage check:
         static WatchFile sysconfigFile( sysconfigStoragePath(), WatchFile::NO_INIT );
         if ( sysconfigFile.hasChanged() )
@@ -298,6 +301,8 @@ namespace zypp
         if ( ! _pool->whatprovides )
         {
           MIL << "pool_createwhatprovides..." << endl;
+          static metrics::Histogram & whatprovidesTime { metrics::histogram( "pool.createwhatprovides" ) };
+          metrics::ScopedTimer wpTimer { whatprovidesTime };
 
           ::pool_addfileprovides( _pool );
           ::pool_createwhatprovides( _pool );
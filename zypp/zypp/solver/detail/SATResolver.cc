@@ -33,6 +33,8 @@ extern "C"
 
 #include <zypp-core/base/LogTools.h>
 #include <zypp-core/base/Gettext.h>
+#include <zypp-core/base/Metrics.h>
+#include <zypp-core/base/Trace.h>
 #include <zypp/base/Algorithm.h>
 
 #include <zypp/ZConfig.h>
@@ -711,6 +713,9 @@ bool
 SATResolver::solving(const CapabilitySet & requires_caps,
                      const CapabilitySet & conflict_caps)
 {
+    ZYPP_TRACE_SPAN( "SATResolver::solving", "solver" );
+    static metrics::Histogram & solveTime { metrics::histogram( "solver.solve" ) };
+    metrics::ScopedTimer timer { solveTime };
     sat::Pool::instance().prepare();
 
     // Solve !
@@ -862,6 +867,8 @@ SATResolver::solving(const CapabilitySet & requires_caps,
 
     if (solver_problem_count(_satSolver) > 0 )
     {
+        static metrics::Counter & failedRuns { metrics::counter( "solver.failed" ) };
+        failedRuns.inc();
         ERR << "Solverrun finished with an ERROR" << endl;
         return false;
     }
@@ -106,6 +106,15 @@ namespace zypp
       return ret;
     }
 
+    bool RepoProvidePackage::prefetchDelta( const PoolItem & pi_r )
+    {
+      if ( ! pi_r.isKind<Package>() )
+        return false;
+      repo::DeltaCandidates deltas( _impl->_repos, pi_r.name() );
+      repo::PackageProvider pkgProvider( _impl->_access, pi_r, deltas, _impl->_packageProviderPolicy );
+      return pkgProvider.prefetchDelta();
+    }
+
     ///////////////////////////////////////////////////////////////////
     //
     //	CLASS NAME : CommitPackageCache
@@ -44,6 +44,11 @@ namespace zypp
       /** Provide package optionally fron cache only. */
       ManagedFile operator()( const PoolItem & pi, bool fromCache_r );
 
+      /** Download a delta for the package and queue rebuilding it in the active
+       * \ref applydeltarpm::Pipeline. \see \ref repo::PackageProvider::prefetchDelta
+       */
+      bool prefetchDelta( const PoolItem & pi );
+
     private:
       struct Impl;
       RW_pointer<Impl> _impl;
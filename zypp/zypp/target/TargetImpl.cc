@@ -16,6 +16,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <unordered_set>
 
 #include <sys/types.h>
 #include <dirent.h>
@@ -29,6 +30,8 @@
 #include <zypp-core/base/UserRequestException>
 #include <zypp/base/Json.h>
 #include <zypp-core/base/Env.h>
+#include <zypp-core/base/Metrics.h>
+#include <zypp-core/base/Trace.h>
 
 #include <zypp/ZConfig.h>
 #include <zypp/ZYppFactory.h>
@@ -54,6 +57,7 @@
 
 #include <zypp/parser/ProductFileReader.h>
 #include <zypp/repo/SrcPackageProvider.h>
+#include <zypp/repo/Applydeltarpm.h>
 
 #include <zypp/sat/Pool.h>
 #include <zypp/sat/detail/PoolImpl.h>
@@ -100,6 +104,13 @@ using std::endl;
 extern "C"
 {
 #include <solv/repo_rpmdb.h>
+#include <solv/repo_solv.h>
+#include <solv/repo_write.h>
+#include <solv/repo_products.h>
+#if __has_include(<solv/repo_autopattern.h>)
+#include <solv/repo_autopattern.h>
+#define ZYPP_HAVE_REPO_AUTOPATTERN 1
+#endif
 #include <solv/chksum.h>
 }
 namespace zypp
@@ -127,6 +138,22 @@ namespace zypp
     inline RepoStatus rpmDbRepoStatus( const Pathname & root_r )
     { return RepoStatus( rpmDbStateHash( root_r ), Date() ); }
 
+    /** The RepoStatus the @System solv file cookie is compared to. */
+    inline RepoStatus systemSolvRepoStatus( const Pathname & root_r )
+    { return rpmDbRepoStatus( root_r ) && RepoStatus( root_r/"etc/products.d" ); }
+
+    /** system-hook: Send notification to plugins after the @System solv file changed. */
+    inline void sendPackageSetChanged( const Pathname & root_r )
+    {
+      if ( root_r == "/" )
+      {
+        PluginExecutor plugins;
+        plugins.load( ZConfig::instance().pluginsPath()/"system" );
+        if ( plugins )
+          plugins.send( PluginFrame( "PACKAGESETCHANGED" ) );
+      }
+    }
+
   } // namespace target
 } // namespace
 ///////////////////////////////////////////////////////////////////
@@ -1121,7 +1148,7 @@ namespace zypp
       bool build_rpm_solv = true;
       // lets see if the rpm solv cache exists
 
-      RepoStatus rpmstatus( rpmDbRepoStatus(_root) && RepoStatus(_root/"etc/products.d") );
+      RepoStatus rpmstatus( systemSolvRepoStatus( _root ) );
 
       bool solvexisted = PathInfo(rpmsolv).isExist();
       if ( solvexisted )
@@ -1244,13 +1271,7 @@ namespace zypp
         sat::updateSolvFileIndex( rpmsolv );	// content digest for zypper bash completion
 
         // system-hook: Finally send notification to plugins
-        if ( root() == "/" )
-        {
-          PluginExecutor plugins;
-          plugins.load( ZConfig::instance().pluginsPath()/"system" );
-          if ( plugins )
-            plugins.send( PluginFrame( "PACKAGESETCHANGED" ) );
-        }
+        sendPackageSetChanged( root() );
       }
       else
       {
@@ -1261,6 +1282,149 @@ namespace zypp
       return build_rpm_solv;
     }
 
+    RepoStatus TargetImpl::solvCacheStatus() const
+    {
+      Pathname base = solvfilesPath();
+      if ( ! PathInfo( base/"solv" ).isExist() || ! PathInfo( base/"cookie" ).isExist() )
+        return RepoStatus();
+
+      RepoStatus status { RepoStatus::fromCookieFile( base/"cookie" ) };
+      if ( status != systemSolvRepoStatus( _root ) )
+        return RepoStatus();
+      return status;
+    }
+
+    bool TargetImpl::updateCacheIncremental( const RepoStatus & precommitStatus_r, const ZYppCommitResult & result_r )
+    {
+#ifndef ZYPP_HAVE_REPO_AUTOPATTERN
+      return false;	// can't autogenerate pattern/product/... in-process
+#else
+      if ( precommitStatus_r.empty() || solvfilesPathIsTemp() )
+        return false;
+
+      Pathname base = solvfilesPath();
+      Pathname rpmsolv       = base/"solv";
+      Pathname rpmsolvcookie = base/"cookie";
+
+      // The solv file must still describe the rpmdb the commit started with,
+      // otherwise someone else modified it meanwhile.
+      if ( ! PathInfo( rpmsolv ).isExist() || RepoStatus::fromCookieFile( rpmsolvcookie ) != precommitStatus_r )
+      {
+        MIL << "Incremental update: cookie diverged since commit start" << endl;
+        return false;
+      }
+
+      RepoStatus rpmstatus( systemSolvRepoStatus( _root ) );
+      if ( rpmstatus == precommitStatus_r )
+        return false;	// nothing changed, buildCache will just confirm the cookie
+
+      if ( rpm().dbPath() != rpm::librpmDb::suggestedDbPath( _root ) )
+        return false;	// libsolv can only read rpms default dbpath
+
+      // What the commit did to the rpmdb (as "name-evr.arch")
+      std::unordered_set<std::string> installed;
+      std::unordered_set<std::string> erased;
+      for ( const sat::Transaction::Step & step : result_r.transactionStepList() )
+      {
+        if ( step.stepStage() != sat::Transaction::STEP_DONE || step.stepType() == sat::Transaction::TRANSACTION_IGNORE )
+          continue;
+        sat::Solvable solv { step.satSolvable() };
+        if ( ! solv || ! solv.isKind<Package>() )
+          continue;
+        std::string nevra { ::pool_solvable2str( sat::Pool::instance().get(), solv.get() ) };
+        if ( step.stepType() == sat::Transaction::TRANSACTION_ERASE )
+          erased.insert( std::move(nevra) );
+        else
+          installed.insert( std::move(nevra) );
+      }
+      if ( installed.empty() && erased.empty() )
+        return false;
+
+      // Patch the old solv file in a scratch pool and verify the
+      // result reflects exactly the commit steps.
+      filesystem::TmpFile tmpsolv( filesystem::TmpFile::makeSibling( rpmsolv ) );
+      if ( ! tmpsolv )
+        return false;
+      auto verify = [&]( sat::detail::CPool * pool_r, sat::detail::CRepo * repo_r ) {
+        unsigned stillErased = 0;
+        sat::detail::SolvableIdType p = 0;
+        ::Solvable * s = nullptr;
+        FOR_REPO_SOLVABLES( repo_r, p, s )
+        {
+          std::string nevra { ::pool_solvable2str( pool_r, s ) };
+          if ( installed.erase( nevra ) == 0 && erased.count( nevra ) )
+            ++stillErased;
+        }
+        if ( ! installed.empty() || stillErased )
+        {
+          WAR << "Incremental update: rpmdb diverges from the commit steps (" << installed.size() << " missing, " << stillErased << " not erased)" << endl;
+          return false;
+        }
+        return true;
+      };
+      if ( ! writeSolvIncremental( _root, rpmsolv, tmpsolv.path(), verify ) )
+        return false;
+
+      if ( filesystem::rename( tmpsolv, rpmsolv ) != 0 )
+        return false;
+      // if this fails, don't bother throwing exceptions
+      filesystem::chmod( rpmsolv, 0644 );
+
+      rpmstatus.saveToCookieFile( rpmsolvcookie );
+      sat::updateSolvFileIndex( rpmsolv );	// content digest for zypper bash completion
+      MIL << "Incremental update of " << rpmsolv << " done." << endl;
+
+      // system-hook: Finally send notification to plugins
+      sendPackageSetChanged( root() );
+      return true;
+#endif
+    }
+
+    bool TargetImpl::writeSolvIncremental( const Pathname & root_r, const Pathname & refsolv_r, const Pathname & outsolv_r,
+                                           const std::function<bool(sat::detail::CPool*,sat::detail::CRepo*)> & verify_r )
+    {
+#ifndef ZYPP_HAVE_REPO_AUTOPATTERN
+      return false;	// can't autogenerate pattern/product/... in-process
+#else
+      // Headers of packages already present in the reference solv file
+      // are reused, only new ones are read from the rpmdb. Erased ones are dropped.
+      AutoDispose<sat::detail::CPool*> pool { ::pool_create(), ::pool_free };
+      ::pool_set_rootdir( pool, root_r.c_str() );
+      ::Repo * repo = ::repo_create( pool, sat::Pool::systemRepoAlias().c_str() );
+      ::Repodata * data = ::repo_add_repodata( repo, 0 );
+      {
+        AutoFILE reffp { ::fopen( refsolv_r.c_str(), "re" ) };
+        if ( ! reffp )
+          return false;
+        if ( ::repo_add_rpmdb_reffp( repo, reffp, REPO_USE_ROOTDIR | REPO_REUSE_REPODATA | REPO_NO_INTERNALIZE ) != 0 )
+        {
+          WAR << "Incremental update: reading the rpmdb failed: " << ::pool_errstr( pool ) << endl;
+          return false;
+        }
+      }
+      // Same as 'rpmdb2solv -X -p <root>/etc/products.d' in buildCache: Products
+      // are taken from products.d, so none must be generated from the packages.
+      if ( PathInfo( Pathname::assertprefix( root_r, "/etc/products.d" ) ).isDir() )
+        ::repo_add_products( repo, "/etc/products.d", REPO_USE_ROOTDIR | REPO_REUSE_REPODATA | REPO_NO_INTERNALIZE );
+      ::repodata_internalize( data );
+      ::repo_add_autopattern( repo, ADD_NO_AUTOPRODUCTS );
+
+      if ( verify_r && ! verify_r( pool, repo ) )
+        return false;
+
+      FILE * fp = ::fopen( outsolv_r.c_str(), "we" );
+      if ( ! fp )
+        return false;
+      int ret = ::repo_write( repo, fp );
+      if ( ::fclose( fp ) != 0 || ret != 0 )
+      {
+        WAR << "Incremental update: failed to write " << outsolv_r << endl;
+        return false;
+      }
+      return true;
+#endif
+    }
+
     void TargetImpl::reload()
     {
         load( false );
@@ -1438,6 +1602,15 @@ namespace zypp
       // ----------------------------------------------------------------- //
 
       MIL << "TargetImpl::commit(<pool>, " << policy_r << ")" << endl;
+      ZYPP_TRACE_SPAN( "TargetImpl::commit", "commit" );
+      static metrics::Histogram & commitTime { metrics::histogram( "target.commit" ) };
+      metrics::ScopedTimer timer { commitTime };
+
+      // If the @System solv file matches the rpmdb before we modify it, it can
+      // be updated incrementally after the commit (no full rpmdb2solv run).
+      RepoStatus precommitSolvStatus;
+      if ( ! policy_r.dryRun() )
+        precommitSolvStatus = solvCacheStatus();
 
       ///////////////////////////////////////////////////////////////////
       // Compute transaction:
@@ -1561,7 +1734,8 @@ namespace zypp
       if ( ! policy_r.dryRun() || policy_r.downloadMode() == DownloadOnly )
       {
         // Prepare the package cache. Pass all items requiring download.
-        CommitPackageCache packageCache;
+        RepoProvidePackage repoProvidePackage;
+        CommitPackageCache packageCache( repoProvidePackage );
         packageCache.setCommitList( steps.begin(), steps.end() );
 
         bool miss = false;
@@ -1576,7 +1750,44 @@ namespace zypp
             miss = preloader->missed ();
           }
 
+          if ( !miss && preloader ) {
+            // Verify digests and signatures of the preloaded packages concurrently.
+            // PackageProvider later just looks up the verdict instead of checking
+            // each package serially while providing it.
+            std::vector<std::pair<Pathname,CheckSum>> toVerify;
+            for ( const auto & [pi, path] : preloader->preloadedFiles() ) {
+              if ( pi.repoInfo().pkgGpgCheck() )
+                toVerify.push_back( std::make_pair( path, pi.lookupLocation().checksum() ) );
+            }
+            if ( ! toVerify.empty() )
+              rpm().checkPackageSignatures( toVerify );
+          }
+
           if ( !miss ) {
+            // Download the deltas first. The packages are rebuilt in the background
+            // while the remaining ones are downloaded and picked up by packageCache.get.
+            std::optional<applydeltarpm::Pipeline> deltaPipeline;
+            if ( ZConfig::instance().download_use_deltarpm() && applydeltarpm::haveApplydeltarpm() )
+            {
+              deltaPipeline.emplace( ZConfig::instance().download_deltarpm_jobs() );
+              for_( it, steps.begin(), steps.end() )
+              {
+                if ( it->stepType() != sat::Transaction::TRANSACTION_INSTALL
+                  && it->stepType() != sat::Transaction::TRANSACTION_MULTIINSTALL )
+                  continue;
+
+                try
+                {
+                  repoProvidePackage.prefetchDelta( PoolItem( *it ) );
+                }
+                catch ( const Exception & exp )
+                {
+                  // the package is provided as usual below
+                  ZYPP_CAUGHT( exp );
+                }
+              }
+            }
+
             // Preload the cache. Until now this means pre-loading all packages.
             // Once DownloadInHeaps is fully implemented, this will change and
             // we may actually have more than one heap.
@@ -1703,7 +1914,20 @@ namespace zypp
       ///////////////////////////////////////////////////////////////////
       if ( ! policy_r.dryRun() )
       {
-        buildCache();
+        if ( ! updateCacheIncremental( precommitSolvStatus, result ) )
+          buildCache();
+      }
+
+      {
+        static metrics::Counter & stepsDone   { metrics::counter( "target.commit.steps.done" ) };
+        static metrics::Counter & stepsFailed { metrics::counter( "target.commit.steps.failed" ) };
+        for ( const sat::Transaction::Step & step : result.transactionStepList() )
+        {
+          if ( step.stepStage() == sat::Transaction::STEP_DONE )
+            stepsDone.inc();
+          else if ( step.stepStage() == sat::Transaction::STEP_ERROR )
+            stepsFailed.inc();
+        }
       }
 
       MIL << "TargetImpl::commit(<pool>, " << policy_r << ") returns: " << result << endl;
@@ -1764,6 +1988,7 @@ namespace zypp
       for_( step, steps.begin(), steps.end() )
       {
         PoolItem citem( *step );
+        ZYPP_TRACE_SPAN_DETAIL( "commit step", debug::traceEnabled() ? citem.satSolvable().asString() : std::string(), "commit" );
         if ( step->stepType() == sat::Transaction::TRANSACTION_IGNORE )
         {
           if ( citem->isKind<Package>() )
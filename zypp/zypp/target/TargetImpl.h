@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <set>
+#include <functional>
 
 #include <zypp/base/ReferenceCounted.h>
 #include <zypp-core/base/NonCopyable.h>
@@ -31,6 +32,7 @@
 #include <zypp/target/HardLocksFile.h>
 #include <zypp/ManagedFile.h>
 #include <zypp/VendorAttr.h>
+#include <zypp/RepoStatus.h>
 
 ///////////////////////////////////////////////////////////////////
 namespace zypp
@@ -109,6 +111,28 @@ namespace zypp
       void clearCache();
 
       bool buildCache();
+
+    private:
+      /** The @System solv files cookie if it matches the current rpmdb, otherwise an empty RepoStatus. */
+      RepoStatus solvCacheStatus() const;
+
+      /** Patch the @System solv file in-process after a commit.
+       * Only packages added by the commit are read from the rpmdb. Returns \c false
+       * if the solv file did not match \a precommitStatus_r or the rpmdb diverges
+       * from the commits transaction steps. \ref buildCache must do a full
+       * rebuild in this case.
+       */
+      bool updateCacheIncremental( const RepoStatus & precommitStatus_r, const ZYppCommitResult & result_r );
+
+    public:
+      /** Write the \c @System solv file for the rpmdb below \a root_r to \a outsolv_r.
+       * Package headers present in \a refsolv_r are reused, so only packages added
+       * since it was written are read from the rpmdb. The result must equal a full
+       * rebuild via rpmdb2solv in \ref buildCache. \a verify_r may reject the patched
+       * repo before it is written. Returns \c false if the file was not written.
+       */
+      static bool writeSolvIncremental( const Pathname & root_r, const Pathname & refsolv_r, const Pathname & outsolv_r,
+                                        const std::function<bool(sat::detail::CPool*,sat::detail::CRepo*)> & verify_r = {} );
       //@}
 
     public:
@@ -11,12 +11,27 @@
 #include <zypp-curl/transfersettings.h>
 #include <zypp-curl/ng/network/networkrequestdispatcher.h>
 #include <zypp-curl/ng/network/request.h>
+#include <zypp-curl/ng/network/PartialDownload>
 #include <zypp/repo/RepoProvideFile.h>
 #include <zypp/MediaSetAccess.h>
 #include <zypp/Package.h>
 #include <zypp/SrcPackage.h>
 #include <zypp/ZConfig.h>
 #include <zypp-core/base/Env.h>
+#include <zypp/ResPool.h>
+
+#include <zypp-core/ng/base/Timer>
+#include <zypp-core/AutoDispose.h>
+
+#include <atomic>
+#include <thread>
+
+namespace zyppintern
+{
+  using namespace zypp;
+  // in Package.cc
+  std::vector<Pathname> cachedLocations( const std::vector<std::pair<OnMediaLocation, RepoInfo>> & items_r );
+} // namespace zyppintern
 
 namespace zypp {
 
@@ -35,15 +50,77 @@ namespace zypp {
       return bool(envstate);
     }
 
-    zypp::Pathname pckCachedLocation ( const PoolItem &pck ) {
-      if ( pck.isKind<Package>() ) {
-        return pck->asKind<Package>()->cachedLocation();
-      } else if ( pck.isKind<SrcPackage>() ) {
-        return pck->asKind<SrcPackage>()->cachedLocation();
+    /** The cached locations of \a pcks, verifying the checksums of all cached files at once. */
+    std::vector<zypp::Pathname> pckCachedLocations ( const std::vector<PoolItem> &pcks ) {
+      std::vector<std::pair<OnMediaLocation, RepoInfo>> items;
+      items.reserve( pcks.size() );
+      for ( const auto &pck : pcks ) {
+        items.push_back( { pck->lookupLocation(), pck.repoInfo() } );
       }
-      return {};
+      return zyppintern::cachedLocations( items );
     }
 
+    /** Opens the connections to the mirrors of a transaction in the background, see \ref CommitPackagePreloader::warmUpConnections. */
+    struct ConnectionWarmUp
+    {
+      ~ConnectionWarmUp()
+      { cancel(); }
+
+      /** Starts the warm up in a new thread. A resolve must never wait for it, so nothing is done while a previous one still runs. */
+      void start( std::vector<std::pair<Url, media::TransferSettings>> &&targets_r )
+      {
+        if ( _running ) {
+          MIL << "Connection warm up still running, not starting another one" << std::endl;
+          return;
+        }
+        if ( _thread.joinable() )
+          _thread.join();	// already done, does not block
+
+        _cancel = false;
+        _running = true;
+        _thread = std::thread( [ this, targets = std::move(targets_r) ](){
+          OnScopeExit done( [this](){ _running = false; } );
+          auto ev = zyppng::EventLoop::create();
+          auto dispatcher = std::make_shared<zyppng::NetworkRequestDispatcher>();
+          dispatcher->setMaximumConcurrentConnections( -1 );
+          dispatcher->sigQueueFinished().connect( [&]( zyppng::NetworkRequestDispatcher & ){ ev->quit(); } );
+
+          auto cancelCheck = zyppng::Timer::create();
+          cancelCheck->sigExpired().connect( [&]( zyppng::Timer & ){
+            if ( _cancel ) {
+              dispatcher->cancelAll( "Connection warm up cancelled" );
+              ev->quit();
+            }
+          });
+          cancelCheck->start( 100 );
+
+          for ( const auto &[ url, settings ] : targets )
+            dispatcher->preconnect( url, settings );
+          dispatcher->run();
+          if ( dispatcher->count() )
+            ev->run();
+        });
+      }
+
+      /** Stops a running warm up, returns within about 100ms. */
+      void cancel()
+      {
+        _cancel = true;
+        if ( _thread.joinable() )
+          _thread.join();
+      }
+
+    private:
+      std::thread _thread;
+      std::atomic<bool> _running = false;
+      std::atomic<bool> _cancel = false;
+    };
+
+    ConnectionWarmUp &connectionWarmUp()
+    {
+      static ConnectionWarmUp _warmUp;
+      return _warmUp;
+    }
   }
 
   struct RepoUrl {
@@ -147,8 +224,18 @@ namespace zypp {
         }
       }
 
-      // we download into a temp file so that we don't leave broken files in case of errors or a crash
-      _tmpFile = filesystem::TmpFile::asManagedFile( _targetPath.dirname(), _targetPath.basename() );
+      // we download into a temp file so that we don't leave broken files in case of errors or a crash,
+      // the data of a interrupted download is kept there if we can continue it later
+      const Pathname partFile( _targetPath.extend( ".part" ) );
+      _partial = zyppng::PartialDownload( partFile, loc.downloadSize(), loc.checksum() );
+      if ( MediaConfig::instance().download_resume_partial() )
+        _partial.prepare();
+      else
+        _partial.discard();
+
+      _tmpFile = ManagedFile( partFile, filesystem::unlink );
+      if ( _partial.saved() )
+        _tmpFile.resetDispose();
 
       if ( _s == Pending ) {
         // init case, set up request
@@ -166,6 +253,7 @@ namespace zypp {
 
       _s = SimpleDl;
       _req->transferSettings() = settings;
+      setupPartial();
       _parent._dispatcher->enqueue(_req);
     }
 
@@ -175,6 +263,47 @@ namespace zypp {
 
   private:
 
+    /**
+     * Makes the request continue the partial download of the current job, or start
+     * over if there is none. A continued download is verified against the checksum
+     * of the package.
+     */
+    void setupPartial() {
+      _req->resetRequestRanges();
+      _req->setFileOpenMode( zyppng::NetworkRequest::WriteExclusive );
+      _req->setExpectedFileChecksum( _partial.resuming() ? _job.lookupLocation().checksum() : CheckSum() );
+      _partial.setupRequest( *_req );
+    }
+
+    /**
+     * Drops the data of the current job, the next request starts over.
+     */
+    void discardPartial() {
+      _partial.discard();
+      _tmpFile = ManagedFile( _partial.file(), filesystem::unlink );
+      setupPartial();
+    }
+
+    /**
+     * Keeps the data of a interrupted download to continue it later, everything else is removed.
+     */
+    void finishPartial( const zyppng::NetworkRequestError &err ) {
+      switch ( err.type() ) {
+        case zyppng::NetworkRequestError::Cancelled:
+        case zyppng::NetworkRequestError::ConnectionFailed:
+        case zyppng::NetworkRequestError::TemporaryProblem:
+        case zyppng::NetworkRequestError::Timeout:
+        case zyppng::NetworkRequestError::Http2Error:
+        case zyppng::NetworkRequestError::Http2StreamError:
+          if ( _partial.saved() )
+            MIL << "Keeping " << _partial.file() << " to continue the download later" << std::endl;
+          break;
+        default:
+          _partial.discard();
+          break;
+      }
+    }
+
     // TODO some smarter logic that selects mirrors
     bool prepareMirror( ) {
 
@@ -257,9 +386,17 @@ namespace zypp {
     }
 
     void onRequestProgress( zyppng::NetworkRequest &req, zypp::ByteCount count ) {
+      // the validators are stored as soon as we have the headers, so the data survives even if we are killed
+      if ( !_partial.saved() && MediaConfig::instance().download_resume_partial() && _partial.save( req ) )
+        _tmpFile.resetDispose();
+
       if ( !_started ) {
         _started = true;
 
+        // the data of a continued download counts as downloaded
+        if ( _partial.resuming() )
+          _parent.reportBytesDownloaded( _partial.offset() );
+
         callback::UserData userData( "CommitPreloadReport/fileStart" );
         userData.set( "Url", _req->url() );
         _parent._report->fileStart( _targetPath, userData );
@@ -281,6 +418,7 @@ namespace zypp {
         // apply umask and move the _tmpFile into _targetPath
         if ( filesystem::chmodApplyUmask( _tmpFile, 0644 ) == 0 && filesystem::rename( _tmpFile, _targetPath ) == 0 ) {
           _tmpFile.resetDispose(); // rename consumed the file, no need to unlink.
+          _partial.finish();
           finishCurrentJob ( _targetPath, req.url(), media::CommitPreloadReport::NO_ERROR, asString( _("done") ), false );
         } else {
           // error
@@ -289,6 +427,23 @@ namespace zypp {
       } else {
         // handle errors and auth
         const auto &error = req.error();
+
+        // the server sent the full file or the data does not match, the partial data is useless
+        if ( _partial.resuming() ) {
+          switch ( error.type() ) {
+            case zyppng::NetworkRequestError::RangeFail:
+            case zyppng::NetworkRequestError::InvalidChecksum:
+            case zyppng::NetworkRequestError::ExceededMaxLen:
+            case zyppng::NetworkRequestError::MissingData:
+              MIL << "Continuing the download of " << req.url() << " failed ( " << error.toString() << " ), starting over." << std::endl;
+              discardPartial();
+              _parent._dispatcher->enqueue( _req );
+              return;
+            default:
+              break;
+          }
+        }
+
         switch ( error.type() ) {
           case zyppng::NetworkRequestError::InternalError:
           case zyppng::NetworkRequestError::InvalidChecksum:
@@ -325,6 +480,9 @@ namespace zypp {
                 _req->setUrl( url );
                 _req->transferSettings () = settings;
 
+                // the validators of the partial data belong to the old mirror
+                discardPartial();
+
                 _parent._dispatcher->enqueue( _req );
                 return;
 
@@ -337,6 +495,7 @@ namespace zypp {
             }
 
             ERR << "No mirror found, giving up on file: " << req.url() << std::endl;
+            finishPartial( error );
             finishCurrentJob ( _targetPath, req.url(), media::CommitPreloadReport::NOT_FOUND, req.extendedErrorString(), true );
             break;
           }
@@ -354,10 +513,12 @@ namespace zypp {
               return;
             }
 
+            finishPartial( error );
             finishCurrentJob ( _targetPath, req.url(), media::CommitPreloadReport::ACCESS_DENIED, req.extendedErrorString(), true );
             break;
 
           } case zyppng::NetworkRequestError::Cancelled: {
+            finishPartial( error );
             finishCurrentJob ( _targetPath, req.url(), media::CommitPreloadReport::ERROR, req.extendedErrorString(), true );
             break;
           }
@@ -380,6 +541,8 @@ namespace zypp {
 
       if ( e != media::CommitPreloadReport::NO_ERROR &&  fatal )
         _parent._missedDownloads = true;
+      else if ( e == media::CommitPreloadReport::NO_ERROR )
+        _parent._preloadedFiles.push_back( std::make_pair( _job, localPath ) );
 
       _parent._report->fileDone( localPath, e, userData );
     }
@@ -421,6 +584,7 @@ namespace zypp {
 
     PoolItem    _job;
     ManagedFile _tmpFile;
+    zyppng::PartialDownload _partial;
     zypp::Pathname _targetPath;
     bool _started = false;
     bool _firstAuth = true;
@@ -439,8 +603,56 @@ namespace zypp {
   CommitPackagePreloader::CommitPackagePreloader()
   {}
 
+  void CommitPackagePreloader::warmUpConnections( const ResPool &pool_r )
+  {
+    if ( !preloadEnabled() || !MediaConfig::instance().download_warm_up_connections() )
+      return;
+
+    // no preload without a receiver for the report, so nothing to warm up for
+    if ( !callback::SendReport<media::CommitPreloadReport>::connected() )
+      return;
+
+    std::set<Repository::IdType> repos;
+    for ( const PoolItem &pi : pool_r ) {
+      if ( pi.status().isToBeInstalled() && ( pi->isKind<Package>() || pi->isKind<SrcPackage>() ) )
+        repos.insert( pi.repository().id() );
+    }
+
+    // the preload workers spread over the mirrors, connect to as many as they will use
+    const auto maxMirrors = std::max( 1L, MediaConfig::instance().download_max_concurrent_connections() );
+    std::set<std::string> hosts;
+    std::vector<std::pair<Url, media::TransferSettings>> targets;
+    for ( const auto repoId : repos ) {
+      try {
+        const auto urls { downloadUrls( Repository( repoId ).info() ) };
+        for ( std::size_t i = 0; i < urls.size() && i < std::size_t(maxMirrors); ++i ) {
+          Url url( urls[i].baseUrl );
+          if ( !hosts.insert( url.getScheme() + "://" + url.getHost() + ":" + url.getPort() ).second )
+            continue;
+
+          media::TransferSettings settings;
+          ::internal::prepareSettingsAndUrl( url, settings );
+          // the warm up must not keep the process alive for long
+          settings.setConnectTimeout( std::min( settings.connectTimeout(), 10L ) );
+          targets.push_back( std::make_pair( std::move(url), std::move(settings) ) );
+        }
+      } catch ( const zypp::Exception &e ) {
+        ZYPP_CAUGHT( e );
+      }
+    }
+
+    if ( targets.empty() )
+      return;
+
+    MIL << "Warming up the connections to " << targets.size() << " mirrors" << std::endl;
+    connectionWarmUp().start( std::move(targets) );
+  }
+
   void CommitPackagePreloader::preloadTransaction( const std::vector<sat::Transaction::Step> &steps)
   {
+    // whatever the warm up resolved so far is in the shared DNS and TLS session caches, the preload does the rest
+    connectionWarmUp().cancel();
+
     if ( !preloadEnabled() ) {
       MIL << "CommitPackagePreloader disabled" << std::endl;
       return;
@@ -466,6 +678,7 @@ namespace zypp {
     _requiredBytes   = 0;
     _downloadedBytes = 0;
     _missedDownloads = false;
+    _preloadedFiles.clear();
     _lastProgressUpdate.reset();
 
     zypp_defer {
@@ -473,6 +686,7 @@ namespace zypp {
       _pTracker.reset();
     };
 
+    std::vector<PoolItem> candidates;
     for ( const auto &step : steps ) {
       switch ( step.stepType() )
       {
@@ -496,10 +710,18 @@ namespace zypp {
       if ( pi->lookupLocation().checksum().empty() )
         continue;
 
-      // check if Package is cached already
-      if( !pckCachedLocation(pi).empty() )
+      candidates.push_back( pi );
+    }
+
+    // check which Packages are cached already
+    const std::vector<Pathname> cached { pckCachedLocations( candidates ) };
+
+    for ( std::size_t i = 0; i < candidates.size(); ++i ) {
+      if( !cached[i].empty() )
         continue;
 
+      const PoolItem &pi = candidates[i];
+
       auto repoDlsIter = _dlRepoInfo.find( pi.repository().id() );
       if ( repoDlsIter == _dlRepoInfo.end() ) {
 
@@ -509,39 +731,11 @@ namespace zypp {
           return;
         }
 
-        // filter base URLs that do not download
-        std::vector<RepoUrl> repoUrls;
-        const auto origins = pi.repoInfo().repoOrigins();
-        for ( const auto &origin: origins ) {
-          std::for_each( origin.begin(), origin.end(), [&]( const zypp::OriginEndpoint &u ) {
-            media::UrlResolverPlugin::HeaderList custom_headers;
-            Url url = media::UrlResolverPlugin::resolveUrl(u.url(), custom_headers);
-
-            if ( media::MediaHandlerFactory::handlerType(url) != media::MediaHandlerFactory::MediaCURLType )
-              return;
-
-            // use geo IP if available
-            {
-              const auto rewriteUrl = media::MediaNetworkCommonHandler::findGeoIPRedirect( url );
-              if ( rewriteUrl.isValid () )
-                url = rewriteUrl;
-            }
-
-            if ( !pi.repoInfo().path().emptyOrRoot() )
-              url.appendPathName( pi.repoInfo().path() );
-
-            MIL << "Adding Url: " << url << " to the mirror set" << std::endl;
-
-            repoUrls.push_back( RepoUrl {
-                                  .baseUrl = std::move(url),
-                                  .headers = std::move(custom_headers)
-                                } );
-          });
-        }
+        std::vector<RepoUrl> repoUrls { downloadUrls( pi.repoInfo() ) };
 
         // skip this solvable if it has no downloading base URLs
         if( repoUrls.empty() ) {
-          MIL << "Skipping predownload for " << step.satSolvable() << " no downloading URL" << std::endl;
+          MIL << "Skipping predownload for " << pi.satSolvable() << " no downloading URL" << std::endl;
           continue;
         }
 
@@ -607,6 +801,40 @@ namespace zypp {
     MIL << "Preloading done, mirror stats end" << std::endl;
   }
 
+  std::vector<CommitPackagePreloader::RepoUrl> CommitPackagePreloader::downloadUrls( const RepoInfo &repoInfo_r )
+  {
+    // filter base URLs that do not download
+    std::vector<RepoUrl> repoUrls;
+    const auto origins = repoInfo_r.repoOrigins();
+    for ( const auto &origin: origins ) {
+      std::for_each( origin.begin(), origin.end(), [&]( const zypp::OriginEndpoint &u ) {
+        media::UrlResolverPlugin::HeaderList custom_headers;
+        Url url = media::UrlResolverPlugin::resolveUrl(u.url(), custom_headers);
+
+        if ( media::MediaHandlerFactory::handlerType(url) != media::MediaHandlerFactory::MediaCURLType )
+          return;
+
+        // use geo IP if available
+        {
+          const auto rewriteUrl = media::MediaNetworkCommonHandler::findGeoIPRedirect( url );
+          if ( rewriteUrl.isValid () )
+            url = rewriteUrl;
+        }
+
+        if ( !repoInfo_r.path().emptyOrRoot() )
+          url.appendPathName( repoInfo_r.path() );
+
+        MIL << "Adding Url: " << url << " to the mirror set" << std::endl;
+
+        repoUrls.push_back( RepoUrl {
+                              .baseUrl = std::move(url),
+                              .headers = std::move(custom_headers)
+                            } );
+      });
+    }
+    return repoUrls;
+  }
+
   void CommitPackagePreloader::cleanupCaches()
   {
     if ( !preloadEnabled() ) {
@@ -623,6 +851,11 @@ namespace zypp {
     return _missedDownloads;
   }
 
+  const std::vector<std::pair<PoolItem, Pathname>> &CommitPackagePreloader::preloadedFiles() const
+  {
+    return _preloadedFiles;
+  }
+
   void CommitPackagePreloader::reportBytesDownloaded(ByteCount newBytes)
   {
     // throttle progress updates to one time per second
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <deque>
+#include <vector>
 #include <chrono>
 
 namespace zyppng {
@@ -28,16 +29,30 @@ ZYPP_FWD_DECL_TYPE_WITH_REFS(NetworkRequest);
 
 namespace zypp {
 
+class ResPool;
+
 class CommitPackagePreloader
 {
   using clock = std::chrono::steady_clock;
 public:
   CommitPackagePreloader();
 
+  /**
+   * Resolves and connects to the mirrors the packages to be installed in \a pool_r
+   * would be preloaded from, in a background thread. Called by \ref zypp::Resolver once
+   * the solver found a transaction, so the connections are ready when it is committed.
+   * Nothing is started while a previous warm up still runs, \ref preloadTransaction
+   * cancels a running one. The DNS and TLS session caches are shared with its dispatcher.
+   */
+  static void warmUpConnections( const ResPool &pool_r );
+
   void preloadTransaction( const std::vector<sat::Transaction::Step> &steps );
   void cleanupCaches();
   bool missed() const;
 
+  /** The packages successfully preloaded and the location of their file. */
+  const std::vector<std::pair<PoolItem, Pathname>> &preloadedFiles() const;
+
 private:
   class PreloadWorker;
   struct RepoUrl {
@@ -51,10 +66,14 @@ private:
     std::vector<RepoUrl> _baseUrls;
   };
 
+  /** The base URLs of \a repoInfo_r packages can be downloaded from. */
+  static std::vector<RepoUrl> downloadUrls( const RepoInfo &repoInfo_r );
+
   void reportBytesDownloaded ( ByteCount newBytes );
 
   std::map<Repository::IdType, RepoDownloadData> _dlRepoInfo;
   std::deque<PoolItem> _requiredDls;
+  std::vector<std::pair<PoolItem, Pathname>> _preloadedFiles;
   std::vector<zyppng::Ref<PreloadWorker>> _workers;
   ByteCount _requiredBytes;
   ByteCount _downloadedBytes;
@@ -29,6 +29,13 @@ extern "C"
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include <zypp-core/base/StringV.h>
 #include <zypp-core/base/Logger.h>
@@ -56,6 +63,7 @@ extern "C"
 #include <zypp/ZYppFactory.h>
 #include <zypp/ZConfig.h>
 #include <zypp-core/base/IOTools.h>
+#include <zypp-core/ng/thread/threadpool.h>
 
 using std::endl;
 using namespace zypp::filesystem;
@@ -798,6 +806,7 @@ void RpmDb::importPubkey( const PublicKey & pubkey_r )
 void RpmDb::removePubkey( const PublicKey & pubkey_r )
 {
   FAILIFNOTINITIALIZED;
+  clearPackageSignatureCache();	// removing trust may invalidate OK verdicts
 
   // check if the key is in the rpm database and just
   // return if it does not.
@@ -1102,7 +1111,11 @@ void RpmDb::getData( const std::string & name_r, const Edition & ed_r,
 ///////////////////////////////////////////////////////////////////
 namespace
 {
-  struct RpmlogCapture : public std::vector<std::string>
+  /** Result lines of a signature check (as printed by 'rpm -Kv'). */
+  struct RpmlogLines : public std::vector<std::string>
+  {};
+
+  struct RpmlogCapture : public RpmlogLines
   {
     RpmlogCapture()
     {
@@ -1135,7 +1148,7 @@ namespace
     int _oldMask = 0;
   };
 
-  std::ostream & operator<<( std::ostream & str, const RpmlogCapture & obj )
+  std::ostream & operator<<( std::ostream & str, const RpmlogLines & obj )
   {
     char sep = '\0';
     for ( const auto & l : obj ) {
@@ -1146,6 +1159,8 @@ namespace
   }
 
 
+  RpmDb::CheckPackageResult evalCheckPackageSig( const Pathname & path_r, int res, const RpmlogLines & vresult, bool requireGPGSig_r, RpmDb::CheckPackageDetail & detail_r );
+
   RpmDb::CheckPackageResult doCheckPackageSig( const Pathname & path_r,			// rpm file to check
                                                const Pathname & root_r,			// target root
                                                bool  requireGPGSig_r,			// whether no gpg signature is to be reported
@@ -1182,6 +1197,15 @@ namespace
     ts = rpmtsFree(ts);
     ::Fclose( fd );
 
+    return evalCheckPackageSig( path_r, res, vresult, requireGPGSig_r, detail_r );
+  }
+
+  RpmDb::CheckPackageResult evalCheckPackageSig( const Pathname & path_r,		// rpm file checked
+                                                 int res,				// rpms overall result
+                                                 const RpmlogLines & vresult,		// rpms result lines
+                                                 bool  requireGPGSig_r,			// whether no gpg signature is to be reported
+                                                 RpmDb::CheckPackageDetail & detail_r )	// detailed result
+  {
     // Check the individual signature/disgest results:
 
     // To.map back known result strings to enum, everything else is CHK_ERROR.
@@ -1339,6 +1363,57 @@ namespace
     return ret;
   }
 
+  /** Identifies the file a verdict was made for, any change to it or its replacement changes this. */
+  struct FileIdentity
+  {
+    dev_t _dev = 0;
+    ino_t _ino = 0;
+    off_t _size = -1;
+    struct timespec _mtime {};
+    struct timespec _ctime {};
+
+    static FileIdentity of( const Pathname & path_r )
+    {
+      FileIdentity ret;
+      struct stat st;
+      if ( ::stat( path_r.c_str(), &st ) == 0 && S_ISREG( st.st_mode ) )
+        ret = { st.st_dev, st.st_ino, st.st_size, st.st_mtim, st.st_ctim };
+      return ret;
+    }
+
+    explicit operator bool() const
+    { return _size != -1; }
+
+    bool operator==( const FileIdentity & rhs ) const
+    {
+      return _dev == rhs._dev && _ino == rhs._ino && _size == rhs._size
+          && _mtime.tv_sec == rhs._mtime.tv_sec && _mtime.tv_nsec == rhs._mtime.tv_nsec
+          && _ctime.tv_sec == rhs._ctime.tv_sec && _ctime.tv_nsec == rhs._ctime.tv_nsec;
+    }
+  };
+
+  /** Positive \ref RpmDb::checkPackageSignatures verdicts per root and package checksum. */
+  struct PackageSignatureCache
+  {
+    struct Verdict
+    {
+      FileIdentity _file;	// the file checked
+      RpmDb::CheckPackageDetail _detail;
+    };
+
+    static PackageSignatureCache & instance()
+    {
+      static PackageSignatureCache _instance;
+      return _instance;
+    }
+
+    static std::string key( const Pathname & root_r, const CheckSum & checksum_r )
+    { return str::Str() << root_r << "|" << checksum_r.checksum(); }
+
+    std::mutex _lock;
+    std::unordered_map<std::string,Verdict> _verdicts;
+  };
+
 } // namespace
 ///////////////////////////////////////////////////////////////////
 //
@@ -1354,6 +1429,144 @@ RpmDb::CheckPackageResult RpmDb::checkPackage( const Pathname & path_r )
 RpmDb::CheckPackageResult RpmDb::checkPackageSignature( const Pathname & path_r, RpmDb::CheckPackageDetail & detail_r )
 { return doCheckPackageSig( path_r, root(), true/*requireGPGSig_r*/, detail_r ); }
 
+void RpmDb::checkPackageSignatures( const std::vector<std::pair<Pathname,CheckSum>> & packages_r, unsigned parallel_r )
+{
+  FAILIFNOTINITIALIZED;
+  if ( packages_r.empty() )
+    return;
+
+  // Verify the files digest first, then the signature. librpms logging and
+  // locale handling are process global, so we can't run rpmVerifySignatures
+  // in threads. Each thread drives an 'rpm -Kv' instead, which prints the
+  // same result lines we parse in-process.
+  zyppng::ThreadPool & pool { zyppng::ThreadPool::global() };
+  if ( parallel_r == 0 )
+    parallel_r = pool.size();
+  parallel_r = std::min<unsigned>( parallel_r, packages_r.size() );
+
+  // Shared with the helpers posted to the pool. The caller checks packages as
+  // well and only waits for the helpers that already started.
+  struct State
+  {
+    std::atomic<std::size_t> _next { 0 };
+    std::atomic<unsigned> _verified { 0 };
+    std::function<void( std::size_t )> _check;
+    std::size_t _count = 0;
+    std::mutex _lock;
+    std::condition_variable _done;
+    unsigned _running = 0;
+    bool _closed = false;
+
+    void work()
+    {
+      for ( std::size_t idx = _next++; idx < _count; idx = _next++ )
+        _check( idx );
+    }
+  };
+  auto state = std::make_shared<State>();
+  state->_count = packages_r.size();
+
+  PackageSignatureCache & cache { PackageSignatureCache::instance() };
+  state->_check = [&]( std::size_t idx ) {
+    const auto & [path, checksum] = packages_r[idx];
+    // remember the file before reading it, changes while checking invalidate the verdict
+    const FileIdentity file { FileIdentity::of( path ) };
+    if ( checksum.empty() || ! file )
+      return;
+    if ( CheckSum( checksum.type(), std::ifstream( path.c_str() ) ) != checksum )
+    {
+      WAR << path << " does not match checksum " << checksum << endl;
+      return;
+    }
+
+    const char * argv[] = {
+#if defined(WORKAROUNDRPMPWDBUG)
+      "#/",
+#endif
+      "rpm", "--root", _root.c_str(), "--dbpath", _dbPath.c_str(), "-Kv", "--", path.c_str(), nullptr
+    };
+    ExternalProgram prog( argv, ExternalProgram::Stderr_To_Stdout, false, -1, true/*default_locale*/ );
+    RpmlogLines vresult;
+    for ( std::string line = prog.receiveLine(); ! line.empty(); line = prog.receiveLine() )
+    {
+      if ( line.back() == '\n' )
+        line.pop_back();
+      vresult.push_back( std::move(line) );
+    }
+    int res = prog.close();
+
+    RpmDb::CheckPackageDetail detail;
+    if ( evalCheckPackageSig( path, res, vresult, true/*requireGPGSig_r*/, detail ) != RpmDb::CHK_OK )
+      return;	// will be rechecked and reported when the package is provided
+    if ( ! ( FileIdentity::of( path ) == file ) )
+    {
+      WAR << path << " changed while checking its signature" << endl;
+      return;
+    }
+
+    std::lock_guard<std::mutex> guard( cache._lock );
+    cache._verdicts[PackageSignatureCache::key( _root, checksum )] = { file, std::move(detail) };
+    ++state->_verified;
+  };
+
+  for ( unsigned i = 1; i < parallel_r; ++i )
+  {
+    pool.post( [state]() {
+      {
+        std::lock_guard<std::mutex> guard( state->_lock );
+        if ( state->_closed )
+          return;
+        ++state->_running;
+      }
+      state->work();
+      std::lock_guard<std::mutex> guard( state->_lock );
+      --state->_running;
+      state->_done.notify_all();
+    });
+  }
+  state->work();
+  {
+    std::unique_lock<std::mutex> guard( state->_lock );
+    state->_closed = true;
+    state->_done.wait( guard, [&](){ return state->_running == 0; } );
+  }
+
+  MIL << "Verified " << state->_verified << " of " << packages_r.size() << " package signatures using up to " << parallel_r << " threads" << endl;
+}
+
+bool RpmDb::cachedPackageSignature( const Pathname & path_r, const CheckSum & checksum_r, CheckPackageDetail & detail_r ) const
+{
+  if ( checksum_r.empty() )
+    return false;
+
+  // the verdict only applies to the very file that was checked, not a changed or replaced one
+  const FileIdentity file { FileIdentity::of( path_r ) };
+  if ( ! file )
+    return false;
+
+  PackageSignatureCache & cache { PackageSignatureCache::instance() };
+  std::lock_guard<std::mutex> guard( cache._lock );
+  auto it = cache._verdicts.find( PackageSignatureCache::key( _root, checksum_r ) );
+  if ( it == cache._verdicts.end() )
+    return false;
+  if ( ! ( it->second._file == file ) )
+  {
+    WAR << path_r << " is not the file checked for " << checksum_r << ", the cached signature check does not apply" << endl;
+    return false;
+  }
+
+  detail_r = it->second._detail;
+  DBG << path_r << " [0-Signature is OK] (cached)" << endl;
+  return true;
+}
+
+void RpmDb::clearPackageSignatureCache()
+{
+  PackageSignatureCache & cache { PackageSignatureCache::instance() };
+  std::lock_guard<std::mutex> guard( cache._lock );
+  cache._verdicts.clear();
+}
+
 
 // determine changed files of installed package
 bool
@@ -417,6 +417,33 @@ public:
    */
   CheckPackageResult checkPackageSignature( const Pathname & path_r, CheckPackageDetail & detail_r );
 
+  /**
+   * Concurrently check the signatures of many rpm files on disk (like \ref checkPackageSignature).
+   *
+   * Positive verdicts are remembered per package \ref CheckSum and can be
+   * looked up via \ref cachedPackageSignature. Anything else is not remembered
+   * and needs to be rechecked (and reported) the usual way. The checks run on
+   * the calling thread and the \ref zyppng::ThreadPool::global.
+   *
+   * @param packages_r the rpm files to check and their checksums
+   * @param parallel_r max. number of concurrent checks (\c 0: the size of the pool)
+   */
+  void checkPackageSignatures( const std::vector<std::pair<Pathname,CheckSum>> & packages_r, unsigned parallel_r = 0 );
+
+  /**
+   * Whether \ref checkPackageSignatures found the signature of \a path_r to be OK.
+   * The verdict only applies if \a path_r is still the file that was checked: same inode,
+   * size, mtime and ctime. The file is not read again.
+   *
+   * @param path_r which file to check
+   * @param checksum_r the files checksum
+   * @param detail_r Return detailed rpm log messages (if \c true is returned)
+   */
+  bool cachedPackageSignature( const Pathname & path_r, const CheckSum & checksum_r, CheckPackageDetail & detail_r ) const;
+
+  /** Forget all verdicts remembered by \ref checkPackageSignatures. */
+  static void clearPackageSignatureCache();
+
   /** install rpm package
    *
    * @param filename file to install
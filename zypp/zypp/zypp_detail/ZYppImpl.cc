@@ -144,13 +144,12 @@ namespace zypp
       {
         setPartitions( DiskUsageCounter::detectMountPoints() );
       }
-      return _disk_usage->disk_usage(pool());
+      return _disk_usage->update();
     }
 
     void ZYppImpl::setPartitions(const DiskUsageCounter::MountPointSet &mp)
     {
-      _disk_usage.reset(new DiskUsageCounter());
-      _disk_usage->setMountPoints(mp);
+      _disk_usage.reset(new DiskUsageCounter::Tracker(mp));
     }
 
     DiskUsageCounter::MountPointSet ZYppImpl::getPartitions() const
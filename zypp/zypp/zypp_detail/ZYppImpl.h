@@ -134,8 +134,8 @@ namespace zypp
       KeyRing_Ptr _keyring;
       /** */
       Pathname _home_path;
-      /** defined mount points, used for disk usage counting */
-      shared_ptr<DiskUsageCounter> _disk_usage;
+      /** defined mount points, used for (incremental) disk usage counting */
+      shared_ptr<DiskUsageCounter::Tracker> _disk_usage;
     };
     ///////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,165 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*
+*/
+#ifndef ZYPPNG_CORE_NG_ASYNC_OFFLOAD_H_INCLUDED
+#define ZYPPNG_CORE_NG_ASYNC_OFFLOAD_H_INCLUDED
+
+#include <zypp-core/ng/async/awaitable.h>
+#include <zypp-core/ng/thread/threadpool.h>
+#include <zypp-core/base/Exception.h>
+#include <zypp-core/base/UserRequestException>
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+
+namespace zyppng {
+
+  namespace detail {
+
+    template <typename Fn>
+    decltype(auto) invokeOffloaded( Fn &fn, const CancellationToken &token ) {
+      if constexpr ( std::is_invocable_v<Fn&, const CancellationToken &> )
+        return std::invoke( fn, token );
+      else
+        return std::invoke( fn );
+    }
+
+    template <typename Fn>
+    using offload_result_t = std::decay_t<decltype( invokeOffloaded( std::declval<Fn&>(), std::declval<const CancellationToken &>() ) )>;
+
+    /*!
+     * State shared between the awaiting coroutine and the pool job.
+     * The result is written by the worker before the completion is posted
+     * to the \ref LoopInvoker, whose lock orders it before the read on the loop thread.
+     */
+    template <typename T>
+    struct OffloadState {
+      std::conditional_t<std::is_void_v<T>, std::optional<bool>, std::optional<T>> _result;
+      std::exception_ptr _error;
+      std::coroutine_handle<> _handle;
+      CancellationToken _token;
+      // only touched by the loop thread:
+      bool _resumed  = false;
+      bool _detached = false;  ///< the awaiter is gone, do not resume
+    };
+  }
+
+  /*!
+   * Awaiter returned by \ref offload. Posts the job to the pool when the
+   * coroutine suspends and resumes it on the originating threads event loop
+   * once the job finished.
+   *
+   * If the awaiting coroutine is destroyed before the job finished, the job's
+   * \ref CancellationToken is cancelled and the result is dropped.
+   */
+  template <typename Fn>
+  class OffloadAwaiter
+  {
+  public:
+    using value_type = detail::offload_result_t<Fn>;
+
+    OffloadAwaiter( Fn fn, CancellationToken token, ThreadPool &pool )
+      : _fn( std::move(fn) )
+      , _pool( &pool )
+      , _state( std::make_shared<detail::OffloadState<value_type>>() )
+    {
+      _state->_token = std::move(token);
+    }
+
+    OffloadAwaiter( const OffloadAwaiter & ) = delete;
+    OffloadAwaiter &operator=( const OffloadAwaiter & ) = delete;
+    OffloadAwaiter( OffloadAwaiter && ) = default;
+    OffloadAwaiter &operator=( OffloadAwaiter && ) = default;
+
+    ~OffloadAwaiter() {
+      if ( _state && !_state->_resumed ) {
+        // coroutine destroyed while waiting
+        _state->_detached = true;
+        _state->_token.cancel();
+      }
+    }
+
+    bool await_ready() const noexcept {
+      return false;
+    }
+
+    void await_suspend( std::coroutine_handle<> cont ) {
+      _state->_handle = cont;
+      _pool->post( [ state = _state, invoker = LoopInvoker::current(), fn = std::make_shared<Fn>( std::move(_fn) ) ]() {
+        if ( state->_token.cancelled() ) {
+          state->_error = ZYPP_EXCPT_PTR( zypp::AbortRequestException("Offloaded job was cancelled") );
+        } else {
+          try {
+            if constexpr ( std::is_void_v<value_type> ) {
+              detail::invokeOffloaded( *fn, state->_token );
+              state->_result = true;
+            } else {
+              state->_result = detail::invokeOffloaded( *fn, state->_token );
+            }
+          } catch ( ... ) {
+            state->_error = std::current_exception();
+          }
+        }
+        invoker->post( [ state ](){
+          if ( state->_detached )
+            return;
+          state->_resumed = true;
+          state->_handle.resume();
+        });
+      });
+    }
+
+    value_type await_resume() {
+      if ( _state->_error )
+        std::rethrow_exception( _state->_error );
+      if constexpr ( !std::is_void_v<value_type> )
+        return std::move( *_state->_result );
+    }
+
+  private:
+    Fn _fn;
+    ThreadPool *_pool;
+    std::shared_ptr<detail::OffloadState<value_type>> _state;
+  };
+
+  /*!
+   * Runs the CPU bound function \a fn on \a pool and resumes the awaiting
+   * coroutine on the event loop of the calling thread with its result.
+   * Exceptions thrown by \a fn are rethrown by the co_await.
+   *
+   * If \a fn accepts a \ref CancellationToken it is passed the token of the job,
+   * which is cancelled if the awaiting coroutine is destroyed or \a token is cancelled
+   * by the caller. A job cancelled before it started is not run and throws a
+   * \ref zypp::AbortRequestException.
+   *
+   * \code
+   * Task<std::string> calcChecksum( zypp::Pathname file ) {
+   *   co_return co_await offload( [file]() { return zypp::filesystem::sha256sum( file ); } );
+   * }
+   * \endcode
+   *
+   * Code that has to compile in the synchronous legacy build as well uses
+   * <tt>zypp_co_await offload(...)</tt>, there \a fn is simply executed in place.
+   *
+   * \note \a fn runs in a different thread, it must not touch objects owned by the event loop.
+   */
+  template <typename Fn>
+  OffloadAwaiter<std::decay_t<Fn>> offload( Fn &&fn, CancellationToken token = CancellationToken(), ThreadPool &pool = ThreadPool::global() )
+  {
+    return OffloadAwaiter<std::decay_t<Fn>>( std::forward<Fn>(fn), std::move(token), pool );
+  }
+
+}
+
+#endif
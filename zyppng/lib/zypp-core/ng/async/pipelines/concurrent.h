@@ -0,0 +1,173 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*/
+
+
+#ifndef ZYPP_ZYPPNG_MONADIC_ASYNC_CONCURRENT_H
+#define ZYPP_ZYPPNG_MONADIC_ASYNC_CONCURRENT_H
+
+#include <zypp-core/ng/async/awaitable.h>
+#include <zypp-core/ng/async/task.h>
+#include <zypp-core/ng/async/pipelines/wait.hpp>
+#include <zypp-core/ng/meta/TypeTraits>
+
+#include <list>
+#include <optional>
+#include <vector>
+
+namespace zyppng {
+
+  namespace detail {
+
+    template <typename ElementType, typename Fn, typename>
+    struct ConcurrentImpl;
+
+    /*!
+     * Keeps up to \c limit of the asynchronous items running at the same time,
+     * a new one is started as soon as a running one finished.
+     *
+     * \a fn and \a val are taken by value, the returned Task is lazy and might
+     * outlive the arguments passed to \ref when_all_limited.
+     */
+    template <typename ElementType, typename Fn>
+    requires( Awaitable< std::invoke_result_t<Fn, ElementType> > )
+    struct ConcurrentImpl< ElementType, Fn, void> {
+
+        using Op  = std::invoke_result_t<Fn, ElementType>;
+        using Ret = awaitable_res_type_t<Op>;
+        using TaskType = Task<Ret>;
+
+        static TaskType asTask( Op op ) {
+          if constexpr ( std::is_void_v<Ret> )
+            co_await std::move(op);
+          else
+            co_return co_await std::move(op);
+        }
+
+        struct Running {
+          std::size_t _idx;
+          TaskType _task;
+        };
+
+        /*!
+         * Starts new items while there are free slots and \a startMore returns \c true,
+         * passes finished items to \a onReady and waits until one of the running items finished.
+         * Returns the number of items that were started.
+         */
+        template < template< class, class... > class Container,
+          typename StartMore,
+          typename OnReady,
+          typename ...CArgs >
+        static Task<std::size_t> run( std::size_t limit, Container<ElementType, CArgs...> val, Fn fn, StartMore startMore, OnReady onReady )
+        {
+          // a list, so the tasks never move while they are polled
+          std::list<Running> running;
+          std::size_t started = 0;
+          auto next = val.begin();
+
+          while ( true ) {
+            while ( running.size() < limit && next != val.end() && startMore() ) {
+              if constexpr ( std::is_same_v<Op, TaskType> )
+                running.push_back( Running{ started++, std::invoke( fn, std::move(*next) ) } );
+              else
+                running.push_back( Running{ started++, asTask( std::invoke( fn, std::move(*next) ) ) } );
+              running.back()._task.start();
+              ++next;
+            }
+
+            if ( running.empty() )
+              break;
+
+            bool gotReady = false;
+            for ( auto i = running.begin(); i != running.end(); ) {
+              if ( !i->_task.isReady() ) {
+                ++i;
+                continue;
+              }
+              onReady( i->_idx, i->_task );
+              i = running.erase( i );
+              gotReady = true;
+            }
+            if ( gotReady )
+              continue;
+
+            std::vector<TaskType *> pending;
+            pending.reserve( running.size() );
+            for ( auto &r : running )
+              pending.push_back( &r._task );
+
+            if ( co_await coro_poll( std::move(pending) ) == 0 )
+              DBG << "coro_poll returned without ready elems" << std::endl;
+          }
+          co_return started;
+        }
+
+        template < template< class, class... > class Container,
+          typename ...CArgs >
+        static Task<Container<Ret>> whenAll( std::size_t limit, Container<ElementType, CArgs...> val, Fn fn, CancellationToken token )
+        {
+          std::vector<std::optional<Ret>> results( val.size() );
+
+          co_await run( limit, std::move(val), std::move(fn),
+            [&](){ return !token.cancelled(); },
+            [&]( std::size_t idx, TaskType &t ) { results[idx].emplace( std::move( t.get() ) ); }
+          );
+
+          Container<Ret> res;
+          std::back_insert_iterator<Container<Ret>> insert_iter(res);
+          for ( auto &r : results ) {
+            if ( r )
+              insert_iter = std::move(*r);
+            else
+              insert_iter = concurrentCancelledResult<Ret>();
+          }
+          co_return res;
+        }
+
+        template < template< class, class... > class Container,
+          typename ...CArgs >
+        static Task<for_each_result_t<Ret>> forEach( std::size_t limit, Container<ElementType, CArgs...> val, Fn fn, CancellationToken token )
+        {
+          using Result = for_each_result_t<Ret>;
+          const std::size_t count = val.size();
+          std::optional<std::exception_ptr> firstError;
+
+          std::size_t started = co_await run( limit, std::move(val), std::move(fn),
+            [&](){ return !firstError && !token.cancelled(); },
+            [&]( std::size_t, TaskType &t ) {
+              if constexpr ( std::is_void_v<Result> ) {
+                t.get();
+              } else {
+                if ( concurrentIsError( t.get() ) && !firstError )
+                  firstError = t.get().error();
+              }
+            }
+          );
+
+          if constexpr ( std::is_void_v<Result> ) {
+            if ( started < count )
+              concurrentCancelledResult<Result>();
+          } else {
+            if ( firstError )
+              co_return Result::error( *firstError );
+            if ( started < count )
+              co_return concurrentCancelledResult<Result>();
+            co_return Result::success();
+          }
+        }
+    };
+
+  }
+
+}
+
+#endif
@@ -136,7 +136,7 @@ namespace operators {
    *  forwarding them as one
    */
   inline auto join ( ) {
-    return detail::JoinHelper();
+    return zyppng::detail::JoinHelper();
   }
 }
 
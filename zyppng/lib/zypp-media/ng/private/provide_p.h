@@ -26,15 +26,21 @@
 #include <zypp-core/ng/base/Timer>
 #include <zypp-core/ManagedFile.h>
 
+#include <chrono>
+
 namespace zyppng {
 
   namespace constants {
     constexpr std::string_view DEFAULT_PROVIDE_WORKER_PATH = ZYPP_WORKER_PATH;
     constexpr std::string_view ATTACHED_MEDIA_SUFFIX = "-media";
-    constexpr auto DEFAULT_ACTIVE_CONN_PER_HOST = 5;   //< how many simultanious connections to the same host are allowed
+    constexpr auto DEFAULT_ACTIVE_CONN_PER_HOST = 5;   //< how many simultanious connections to the same host are used initially
+    constexpr auto MIN_ACTIVE_CONN_PER_HOST     = 1;   //< lower bound of the adaptive connection limit per host
+    constexpr auto MAX_ACTIVE_CONN_PER_HOST     = 10;  //< upper bound of the adaptive connection limit per host
+    constexpr auto THROUGHPUT_WINDOW            = std::chrono::seconds(2); //< minimum time the throughput of a queue is measured before adapting its connection limit
     constexpr auto DEFAULT_ACTIVE_CONN          = 10;  //< how many simultanious connections are allowed
     constexpr auto DEFAULT_MAX_DYNAMIC_WORKERS  = 20;
     constexpr auto DEFAULT_CPU_WORKERS          = 4;
+    constexpr std::string_view PRESTARTED_WORKER_SCHEMES[] = { "http", "dir" }; //< workers kept warm in the ProvideWorkerPool
   }
 
   class ProvideQueue;
@@ -66,6 +72,12 @@ namespace zyppng {
 
     std::string effectiveScheme ( const std::string &scheme ) const;
 
+    /*!
+     * Returns true if the worker for the effective \a scheme should run on a thread of
+     * this process instead of a separate worker process.
+     */
+    bool useThreadWorker ( const std::string &scheme ) const;
+
     void onPulseTimeout ( Timer & );
     void onQueueIdle ();
     void onItemStateChanged ( ProvideItem &item );
@@ -74,6 +86,17 @@ namespace zyppng {
     std::optional<zypp::ManagedFile> addToFileCache ( const zypp::Pathname &downloadedFile );
     bool isInCache ( const zypp::Pathname &downloadedFile ) const;
 
+    /*!
+     * Looks up the file described by \a spec in the \ref zypp::SharedFileCache. On a hit the
+     * entry is linked into the working directory and the file is returned.
+     */
+    std::optional<zypp::ManagedFile> provideFromSharedCache ( const ProvideFileSpec &spec );
+
+    /*!
+     * Stores the \a downloadedFile described by \a spec in the \ref zypp::SharedFileCache
+     */
+    void addToSharedCache ( const zypp::Pathname &downloadedFile, const ProvideFileSpec &spec );
+
     bool isRunning() const;
 
     const zypp::Pathname &workerPath() const;
@@ -99,6 +122,12 @@ namespace zyppng {
   protected:
     void doSchedule (Timer &);
 
+    /*!
+     * Splits the \ref zypp::MediaConfig::provide_max_download_speed budget evenly between all file requests
+     * the downloading workers currently have, requests already sent to a worker get the new share as well.
+     */
+    void updateBandwidthShares ();
+
     //@TODO should we make those configurable?
     std::unordered_map< std::string, std::string > _workerAlias {
       {"ftp"  ,"http"},
@@ -120,6 +149,7 @@ namespace zyppng {
 
     std::list< ProvideItemRef > _items; //< The list of running provide Items, each of them can spawn multiple requests
     uint32_t _nextRequestId = 0; //< The next request ID , we use controller wide unique IDs instead of worker locals IDs , its easier to track
+    uint32_t _nextSharedCacheId = 0; //< Used to give files linked from the shared cache unique names
 
     struct QueueItem {
       std::string _schemeName;
@@ -30,14 +30,14 @@ namespace zyppng {
   }
 }
 
-#define XXX_PRV if( zyppng::provideDebugEnabled() ) XXX
-#define DBG_PRV if( zyppng::provideDebugEnabled() ) DBG
-#define MIL_PRV if( zyppng::provideDebugEnabled() ) MIL
-#define WAR_PRV if( zyppng::provideDebugEnabled() ) WAR
-#define ERR_PRV if( zyppng::provideDebugEnabled() ) ERR
-#define SEC_PRV if( zyppng::provideDebugEnabled() ) SEC
-#define INT_PRV if( zyppng::provideDebugEnabled() ) INT
-#define USR_PRV if( zyppng::provideDebugEnabled() ) USR
+#define XXX_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP, zypp::base::logger::E_XXX )
+#define DBG_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP"++", zypp::base::logger::E_MIL )
+#define MIL_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP, zypp::base::logger::E_MIL )
+#define WAR_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP, zypp::base::logger::E_WAR )
+#define ERR_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP, zypp::base::logger::E_ERR )
+#define SEC_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP, zypp::base::logger::E_SEC )
+#define INT_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP, zypp::base::logger::E_INT )
+#define USR_PRV L_ENV_CONSTR( ZYPP_MEDIA_PROVIDER_DEBUG, ZYPP_BASE_LOGGER_LOGGROUP, zypp::base::logger::E_USR )
 
 
 #endif // ZYPP_MEDIA_NG_PROVIDEDBG_P_H_INCLUDED
@@ -76,6 +76,18 @@ namespace zyppng {
       _origin.clearMirrors ();
     }
 
+    /*!
+     * The scheduling priority, attach and detach requests always use \ref ProvideFileSpec::High
+     * since all file requests for a medium are waiting for them.
+     */
+    ProvideFileSpec::Priority priority() const {
+      return _priority;
+    }
+
+    void setPriority( ProvideFileSpec::Priority prio ) {
+      _priority = prio;
+    }
+
     void clearForRestart () {
       _pastRedirects.clear();
       _activeUrl.reset();
@@ -90,6 +102,7 @@ namespace zyppng {
     std::vector<zypp::Url>   _pastRedirects;
     std::optional<zypp::Url> _activeUrl;
     ProvideQueueWeakRef _myQueue;
+    ProvideFileSpec::Priority _priority = ProvideFileSpec::High;
   };
 
   class ProvideItemPrivate : public BasePrivate
@@ -100,6 +113,7 @@ namespace zyppng {
       ProvideItem::State _itemState = ProvideItem::Uninitialized;
       std::chrono::steady_clock::time_point _itemStarted;
       std::chrono::steady_clock::time_point _itemFinished;
+      std::int64_t _traceBegin = 0;	///< begin of the items trace span
       std::optional<ProvideItem::ItemStats> _prevStats;
       std::optional<ProvideItem::ItemStats> _currStats;
       Signal<void( ProvideItem &item, ProvideItem::State oldState, ProvideItem::State newState )> _sigStateChanged;
@@ -34,6 +34,11 @@
   Each message is serialized into a STOMP frame and sent over the communication medium.
   STOMP is basically a HTTP like protocol, see https://stomp.github.io and \sa zypp::PluginFrame for details.
 
+  The controller can offer a more compact binary encoding by setting PROVIDER_BINARY_ENCODING in the configuration. A worker
+  supporting it answers with the BinaryEncoding flag set in its capabilities, after that message both sides send length prefixed
+  frames and ProvideMessages carry typed fields instead of strings, see \sa zyppng::StompFrameStream::Binary. Workers not knowing
+  about it simply ignore the configuration value and the STOMP encoding is used.
+
   Communication channel:
   ----------------------
   Communication between the worker processes and the zypp main process will happen via the standard unix file descriptors:
@@ -217,6 +222,8 @@
       string delta_file   -> local path to a file that is supposed to be used for delta downloads
       int64  expected_filesize    -> The expected download filesize, workers should fail if a server does not reports the exact same filesize
       bool   check_existance_only -> this will NOT download the file but only query the server if its existant
+      int64  max_download_speed   -> bytes per second the worker may use for this request, the share of the controllers
+                                     bandwidth budget. Workers that can not limit their bandwidth ignore this.
 
   - Code: 601 - Cancel
     Desc: Sent by the controller if a request should be cancelled. The worker should stop the given request and return a
@@ -249,6 +256,13 @@
     Fields:
       required string url       -> the attachment URL containing the controller generated ID string to uniquely identify a attached medium, e.g. dvd://<attachId>/
 
+  - Code: 604 - UpdateProvide
+    Desc: Sent by the controller to change parameters of a Provide request that was already sent to the worker,
+          e.g. when the bandwidth budget is split again because other downloads started or finished.
+          Requests the worker does not know anymore are ignored, no answer to the controller is expected.
+    Fields:
+      int64  max_download_speed   -> new value for the max_download_speed field of the Provide request
+
 
   Worker -> Controller requests
   -----------------------------
@@ -342,6 +356,7 @@ namespace zyppng {
     Cancel              = 601,
     Attach              = 602,
     Detach              = 603,
+    UpdateProvide       = 604,
     LastControllerCode  = 699,
 
     FirstWorkerCode     = 700,
@@ -379,6 +394,8 @@ namespace zyppng {
       ZyppLogFormat  = 4,   // The worker writes messages to stderr in zypp log format
       FileArtifacts  = 8,   // The results of this worker are artifacts, which means they need to be cleaned up. This is implicit for all downloading workers. For all mounting workers this is ignored.
                             // CPU bound workers can use it to signal they leave artifact files behind that need to be cleaned up
+      BinaryEncoding = 16,  // The worker switches to the binary message encoding right after sending its capabilities. Only set if the
+                            // controller offered it in the configuration, see PROVIDER_BINARY_ENCODING
     };
 
     explicit WorkerCaps();
@@ -456,6 +473,7 @@ namespace zyppng {
     constexpr std::string_view ExpectedFilesize ("expected_filesize");
     constexpr std::string_view CheckExistOnly ("check_existance_only");
     constexpr std::string_view FileHeaderSize ("file_header_size");
+    constexpr std::string_view MaxDownloadSpeed ("max_download_speed"); //< bytes per second the worker may use for this request, set by the scheduler
   }
 
   namespace AttachMsgFields
@@ -517,6 +535,13 @@ namespace zyppng {
     expected<zypp::PluginFrame>     toStompMessage() const;
     static expected<ProvideMessage> fromStompMessage( const zypp::PluginFrame &msg );
 
+    /*!
+     * Encodes the message into the body of the frame, keeping the types of the
+     * values. Only used if controller and worker negotiated the binary encoding.
+     */
+    expected<zypp::PluginFrame>     toBinaryMessage() const;
+    static expected<ProvideMessage> fromBinaryMessage( const zypp::PluginFrame &msg );
+
     static ProvideMessage createProvideStarted  ( const uint32_t reqId, const zypp::Url &url , const std::optional<std::string> &localFilename = {}, const std::optional<std::string> &stagingFilename = {} );
     static ProvideMessage createProvideFinished ( const uint32_t reqId, const std::string &localFilename , bool cacheHit );
     static ProvideMessage createAttachFinished  ( const uint32_t reqId, const std::optional<std::string> &localMountPoint = {} );
@@ -534,6 +559,7 @@ namespace zyppng {
                                                   , bool checkExistOnly = false );
 
     static ProvideMessage createCancel          ( const uint32_t reqId );
+    static ProvideMessage createUpdateProvide   ( const uint32_t reqId, int64_t maxDownloadSpeed );
 
     static ProvideMessage createAttach( const uint32_t reqId
                                       , const zypp::Url &url
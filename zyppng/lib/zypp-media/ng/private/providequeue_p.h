@@ -17,15 +17,72 @@
 #include "providefwd_p.h"
 #include "providemessage_p.h"
 #include <zypp-media/ng/Provide>
+#include <zypp-media/ng/ProvideSpec>
 #include <zypp-core/ng/io/Process>
 #include <zypp-core/ByteCount.h>
 
 #include <deque>
 #include <chrono>
+#include <optional>
+#include <algorithm>
 
 namespace zyppng {
 
   ZYPP_FWD_DECL_TYPE_WITH_REFS (StompFrameStream);
+  class ProvideThreadWorker;
+
+  /*!
+   * Returns the position in the priority ordered range [\a begin, \a end) a request with
+   * priority \a prio is inserted at: behind all entries with the same or a higher priority,
+   * so requests of the same priority keep their order. \a prioOf returns the priority of an entry.
+   */
+  template <typename Iter, typename PrioOf>
+  Iter priorityInsertPos( Iter begin, Iter end, ProvideFileSpec::Priority prio, PrioOf &&prioOf )
+  {
+    return std::find_if( begin, end, [&]( const auto &other ) { return prioOf( other ) < prio; } );
+  }
+
+  /*!
+   * Adapts how many requests a downloading \ref ProvideQueue hands to its worker at the same time.
+   * The throughput is measured over windows of at least the given duration, only windows in which
+   * all slots were in use are compared: if the throughput improved by more than 10% the limit is raised
+   * by one, if it dropped by more than 20% it is lowered by one.
+   */
+  class AdaptiveConnectionLimit
+  {
+  public:
+    using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
+
+    AdaptiveConnectionLimit( uint initial, uint min, uint max, std::chrono::steady_clock::duration window );
+
+    uint limit () const;
+
+    /*!
+     * A request was handed to the worker, \a active is the number of requests the queue runs now.
+     */
+    void activated ( uint active, TimePoint now = std::chrono::steady_clock::now() );
+
+    /*!
+     * A request that transferred \a bytes finished, \a active is the number of requests the queue runs
+     * including the finished one. Returns the throughput of the window if this closed one.
+     */
+    std::optional<double> finished ( const zypp::ByteCount &bytes, uint active, TimePoint now = std::chrono::steady_clock::now() );
+
+    /*!
+     * The queue ran out of requests, time spent idle would distort the measured throughput.
+     */
+    void idle ();
+
+  private:
+    uint _limit;
+    uint _min;
+    uint _max;
+    std::chrono::steady_clock::duration _window;
+    std::optional<TimePoint> _windowStart;
+    zypp::ByteCount _windowBytes;
+    uint _windowPeakActive = 0;
+    double _lastRate = 0; //< bytes per second of the last window the queue was saturated in
+  };
 
   class ProvideQueue : public Base
   {
@@ -91,6 +148,18 @@ namespace zyppng {
      */
     zypp::ByteCount expectedProvideSize() const;
 
+    /*!
+     * How many requests the scheduler should hand to this queue at the same time.
+     * For downloading workers this adapts to the observed throughput, see \ref AdaptiveConnectionLimit.
+     */
+    uint connectionLimit () const;
+
+    /*!
+     * Sets the bytes per second each file request of this queue may download with. Requests
+     * already sent to the worker are updated via a \ref ProvideMessage::Code::UpdateProvide message.
+     */
+    void setBandwidthShare ( int64_t share );
+
     /*!
      * Returns the hostname this worker belongs to.
      * If the worker was not associated with a hostname this will return a empty string.
@@ -109,6 +178,8 @@ namespace zyppng {
     void processReadyRead( int channel );
     void procFinished ( int exitCode );
     uint32_t nextRequestId();
+    void trackActivated ();
+    void trackFinished ( const zypp::ByteCount &bytes );
 
     /*!
      * Dequeues the request referenced by \a it.
@@ -128,14 +199,18 @@ namespace zyppng {
     uint8_t  _crashCounter = 0;
     Config _capabilities;
     zypp::Pathname _currentExe;
+    zypp::Pathname _workDir;
     std::string _myHostname;
     ProvidePrivate &_parent;
     std::deque< Item > _waitQueue;
     std::list< Item >  _activeItems;
     Process::Ptr _workerProc;
+    std::unique_ptr<ProvideThreadWorker> _threadWorker; //< set instead of _workerProc if the scheme uses a in process worker
     StompFrameStreamRef _messageStream;
     Signal<void()> _sigIdle;
     std::optional<TimePoint> _idleSince;
+
+    AdaptiveConnectionLimit _connLimit;
   };
 
 }
@@ -0,0 +1,78 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*
+*/
+#ifndef ZYPP_MEDIA_PRIVATE_PROVIDE_THREAD_WORKER_P_H_INCLUDED
+#define ZYPP_MEDIA_PRIVATE_PROVIDE_THREAD_WORKER_P_H_INCLUDED
+
+#include <zypp-core/ng/rpc/stompframestream.h>
+
+#include <memory>
+#include <string>
+
+namespace zyppng {
+
+  /*!
+   * Runs the worker of a local scheme ( dir, disk and copy ) inside the controller process,
+   * instead of spawning the worker executable.
+   *
+   * The \ref ProvideQueue talks to the worker using the same messages it exchanges with
+   * worker processes, but they are passed through a pair of in memory queues as they are,
+   * without encoding them. So scheduling and error handling of the queue do not change,
+   * while the process startup, the serialization and the pipe round trips are gone.
+   *
+   * The worker runs as a job on \ref ThreadPool::global. It occupies its pool thread as long
+   * as the queue lives, so at most one less worker than the pool has threads are hosted at a
+   * time. If no thread is left \ref start fails and the queue uses the worker executable.
+   */
+  class ProvideThreadWorker
+  {
+  public:
+    /*!
+     * Returns true if there is a in process worker implementation for \a scheme
+     */
+    static bool supportsScheme( const std::string &scheme );
+
+    ProvideThreadWorker( std::string scheme );
+    ~ProvideThreadWorker();
+
+    ProvideThreadWorker( const ProvideThreadWorker & ) = delete;
+    ProvideThreadWorker &operator=( const ProvideThreadWorker & ) = delete;
+
+    /*!
+     * Posts the worker to the thread pool. Returns false if the scheme is not supported
+     * or all pool threads that may host workers are taken.
+     */
+    bool start();
+    bool isRunning() const;
+
+    /*!
+     * Closes the connection and blocks until the worker returned its pool thread.
+     */
+    void stop();
+
+    /*!
+     * The controller side of the connection, only valid after \ref start.
+     * When the worker exits \ref StompFrameStream::sigClosed is emitted.
+     */
+    StompFrameStreamRef messageStream() const;
+
+  private:
+    struct JobState;
+    std::string _scheme;
+    std::shared_ptr<JobState> _job;
+    StompFrameStreamRef _stream;
+  };
+
+}
+
+#endif
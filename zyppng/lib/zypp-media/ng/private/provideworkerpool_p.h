@@ -0,0 +1,102 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\----------------------------------------------------------------------/
+*
+* This file contains private API, this might break at any time between releases.
+* You have been warned!
+*
+*/
+#ifndef ZYPP_MEDIA_PRIVATE_PROVIDE_WORKER_POOL_P_H_INCLUDED
+#define ZYPP_MEDIA_PRIVATE_PROVIDE_WORKER_POOL_P_H_INCLUDED
+
+#include <zypp-core/ng/io/Process>
+#include <zypp-core/ng/base/Timer>
+#include <zypp-core/Pathname.h>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+
+namespace zyppng {
+
+  class EventDispatcher;
+
+  /*!
+   * Keeps worker processes started ahead of time, so the first requests of a
+   * \ref Provide instance do not have to wait for the worker executables to start up.
+   *
+   * A prestarted worker did not receive its configuration yet, the \ref ProvideQueue
+   * taking it over sends it. That's why the workers can be shared by all \ref Provide
+   * instances running on the same thread. Taken workers are replaced in the background,
+   * if the pool is not used for \ref idleTimeout all of its workers are stopped.
+   *
+   * Workers belong to the event dispatcher they were started with, if the thread
+   * switches to a new one the pool is cleared.
+   */
+  class ProvideWorkerPool
+  {
+  public:
+    ~ProvideWorkerPool();
+
+    ProvideWorkerPool( const ProvideWorkerPool & ) = delete;
+    ProvideWorkerPool &operator=( const ProvideWorkerPool & ) = delete;
+
+    /*!
+     * The pool of the current thread
+     */
+    static ProvideWorkerPool &instance();
+
+    /*!
+     * Keep \a count prestarted workers of the executable \a exe around. Missing workers are
+     * started in the next idle phase of the event loop.
+     */
+    void reserve( const zypp::Pathname &exe, uint count );
+
+    /*!
+     * Takes a running worker process for \a exe out of the pool, the worker is waiting for
+     * its configuration message. Returns a nullptr if there is no prestarted worker.
+     */
+    Process::Ptr take( const zypp::Pathname &exe );
+
+    /*!
+     * Number of prestarted workers for \a exe
+     */
+    uint available( const zypp::Pathname &exe ) const;
+
+    std::chrono::milliseconds idleTimeout() const;
+    void setIdleTimeout( std::chrono::milliseconds timeout );
+
+    /*!
+     * Stops all prestarted workers and forgets about the reservations.
+     */
+    void clear();
+
+  private:
+    ProvideWorkerPool();
+    void scheduleRefill();
+    void refill();
+    void touch();
+    void onIdleTimeout( Timer & );
+    void onWorkerFinished( Process *proc );
+
+    struct Entry {
+      uint _wanted = 0;
+      std::deque<std::pair<Process::Ptr, sigc::connection>> _workers;
+    };
+
+    std::unordered_map<std::string, Entry> _entries;
+    std::weak_ptr<EventDispatcher> _ev;
+    Timer::Ptr _idleTimer;
+    std::chrono::milliseconds _idleTimeout;
+    bool _refillPending = false;
+  };
+
+}
+
+#endif
@@ -18,6 +18,8 @@ namespace zyppng {
   constexpr std::string_view ANON_ID_CONF("zconfig://media/AnonymousId");
   constexpr std::string_view ATTACH_POINT("zconfig://media/AttachPoint");
   constexpr std::string_view PROVIDER_ROOT("zconfig://media/ProviderRoot");
+  constexpr std::string_view PROVIDER_BINARY_ENCODING("zconfig://media/BinaryEncoding"); //< The controller understands the binary message encoding, see WorkerCaps::BinaryEncoding
+  constexpr std::string_view RESUME_PARTIAL("zconfig://media/ResumePartial"); //< Keep the data of interrupted downloads and continue them later, see MediaConfig::download_resume_partial
 
 
   // request related settings:
@@ -2,14 +2,21 @@
 #include "private/providedbg_p.h"
 #include "private/providequeue_p.h"
 #include "private/provideitem_p.h"
+#include "private/provideworkerpool_p.h"
+#include "private/providethreadworker_p.h"
+#include "private/provideres_p.h"
 #include <zypp-core/ng/io/IODevice>
 #include <zypp-core/ng/async/iotask.h>
 #include <zypp-core/Url.h>
 #include <zypp-core/base/DtorReset>
 #include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/base/Metrics.h>
 #include <zypp-media/MediaException>
 #include <zypp-media/FileCheckException>
 #include <zypp-media/CDTools>
+#include <zypp-media/MediaConfig>
+#include <zypp-media/SharedFileCache>
+#include <zypp-core/ng/thread/threadpool.h>
 
 // required to generate uuids
 #include <glib.h>
@@ -19,6 +26,19 @@ L_ENV_CONSTR_DEFINE_FUNC(ZYPP_MEDIA_PROVIDER_DEBUG)
 
 namespace zyppng {
 
+  namespace {
+    /*!
+     * Orders requests by descending priority, requests that were released
+     * during scheduling are sorted to the end.
+     */
+    bool higherPriority( const ProvideRequestRef &a, const ProvideRequestRef &b )
+    {
+      if ( !a || !b )
+        return ( a && !b );
+      return ( a->priority() > b->priority() );
+    }
+  }
+
   ProvidePrivate::ProvidePrivate(zypp::filesystem::Pathname &&workDir, Provide &pub)
     : BasePrivate(pub)
     , _workDir( std::move(workDir) )
@@ -180,6 +200,12 @@ namespace zyppng {
     // we are scheduling now, everything that triggered the timer until now we can forget about
     _scheduleTrigger->stop();
 
+    // requests queued while scheduling were appended, restore the priority order
+    for ( auto &q : _queues ) {
+      if ( !std::is_sorted( q._requests.begin(), q._requests.end(), higherPriority ) )
+        std::stable_sort( q._requests.begin(), q._requests.end(), higherPriority );
+    }
+
     for( auto queueIter = _queues.begin(); queueIter != _queues.end(); queueIter ++ ) {
 
       const auto &scheme = queueIter->_schemeName;
@@ -211,6 +237,8 @@ namespace zyppng {
       const auto isSingleInstance = ( (config.cfg_flags() & ProvideQueue::Config::SingleInstance) == ProvideQueue::Config::SingleInstance );
       if ( config.worker_type() == ProvideQueue::Config::Downloading && !isSingleInstance ) {
 
+        const int64_t maxDownloadSpeed = zypp::MediaConfig::instance().provide_max_download_speed();
+
         for( auto i = queue.begin (); i != queue.end(); ) {
 
           // this is the only place where we remove elements from the queue when the scheduling flag is active
@@ -289,7 +317,7 @@ namespace zyppng {
             for ( auto i = mirrsWithoutWorker.begin (); i != mirrsWithoutWorker.end(); ) {
               const auto &u = *i;
               if ( u.getHost() == workerQueue->hostname() ) {
-                if ( workerQueue->requestCount() < constants::DEFAULT_ACTIVE_CONN_PER_HOST )
+                if ( workerQueue->requestCount() < workerQueue->connectionLimit() )
                   possibleHostWorkers.push_back( {u, workerQueue.get()} );
                 i = mirrsWithoutWorker.erase( i );
                 // we can not stop after removing the first hit, since there could be multiple mirrors with the same hostname
@@ -313,6 +341,12 @@ namespace zyppng {
             break;
           }
 
+          // first estimate of the share, updateBandwidthShares splits the budget again once the scheduler is done
+          if ( maxDownloadSpeed > 0 && item->code() == ProvideMessage::Code::Prov ) {
+            const int64_t expectedConns = existingConnections + std::distance( i, queue.end() );
+            item->provideMessage().setValue( ProvideMsgFields::MaxDownloadSpeed, std::max<int64_t>( 1, maxDownloadSpeed / std::max<int64_t>( 1, expectedConns ) ) );
+          }
+
           // if no workers are running, take the first mirror and start a worker for it
           // if < nr of workers are running, use a mirror we do not have a conn yet to
           if ( existingTypeWorkers < constants::DEFAULT_MAX_DYNAMIC_WORKERS
@@ -695,6 +729,30 @@ namespace zyppng {
         }
       }
     }
+
+    updateBandwidthShares();
+  }
+
+  void ProvidePrivate::updateBandwidthShares()
+  {
+    const int64_t maxDownloadSpeed = zypp::MediaConfig::instance().provide_max_download_speed();
+    if ( maxDownloadSpeed <= 0 )
+      return;
+
+    // every file request handed to a downloading worker may be transferring, split the budget between all of them
+    int64_t requests = 0;
+    for ( const auto &[ queueName, workerQueue ] : _workerQueues ) {
+      if ( ProvideQueue::Config::Downloading == workerQueue->workerConfig().worker_type() )
+        requests += workerQueue->requestCount();
+    }
+    if ( !requests )
+      return;
+
+    const int64_t share = std::max<int64_t>( 1, maxDownloadSpeed / requests );
+    for ( const auto &[ queueName, workerQueue ] : _workerQueues ) {
+      if ( ProvideQueue::Config::Downloading == workerQueue->workerConfig().worker_type() )
+        workerQueue->setBandwidthShare( share );
+    }
   }
 
   std::list<ProvideItemRef> &ProvidePrivate::items()
@@ -761,17 +819,53 @@ namespace zyppng {
       return {};
     }
 
+    static zypp::metrics::Counter & cacheHits   { zypp::metrics::counter( "provide.filecache.hits" ) };
+    static zypp::metrics::Counter & cacheMisses { zypp::metrics::counter( "provide.filecache.misses" ) };
+
     auto i = _fileCache.insert( { key, FileCacheItem() } );
     if ( !i.second ) {
       // file did already exist in the cache, return the shared data
+      cacheHits.inc();
       i.first->second._deathTimer.reset();
       return i.first->second._file;
     }
+    cacheMisses.inc();
 
     i.first->second._file = zypp::ManagedFile( downloadedFile, zypp::filesystem::unlink );
     return i.first->second._file;
   }
 
+  std::optional<zypp::ManagedFile> ProvidePrivate::provideFromSharedCache( const ProvideFileSpec &spec )
+  {
+    auto sharedCache = zypp::SharedFileCache::instance();
+    if ( !sharedCache || spec.checkExistsOnly() || spec.checksum().empty() )
+      return {};
+
+    static zypp::metrics::Counter & cacheHits   { zypp::metrics::counter( "provide.sharedcache.hits" ) };
+    static zypp::metrics::Counter & cacheMisses { zypp::metrics::counter( "provide.sharedcache.misses" ) };
+
+    // concurrent requests can ask for the same file, each one gets its own link
+    const std::string name = zypp::str::Format("%1%-%2%") % spec.checksum().checksum() % _nextSharedCacheId++;
+    const zypp::Pathname target = _workDir / "shared-cache" / name;
+    if ( !sharedCache->provide( spec.checksum(), target ) ) {
+      cacheMisses.inc();
+      return {};
+    }
+    cacheHits.inc();
+    return zypp::ManagedFile( target, zypp::filesystem::unlink );
+  }
+
+  void ProvidePrivate::addToSharedCache( const zypp::Pathname &downloadedFile, const ProvideFileSpec &spec )
+  {
+    auto sharedCache = zypp::SharedFileCache::instance();
+    if ( !sharedCache || spec.checkExistsOnly() || spec.checksum().empty() )
+      return;
+    // copying and verifying the file must not block the event loop, the file cache keeps it for a while
+    ThreadPool::global().post( [ sharedCache, file = downloadedFile, sum = spec.checksum() ](){
+      sharedCache->add( file, sum );
+    });
+  }
+
   bool ProvidePrivate::isInCache ( const zypp::Pathname &downloadedFile ) const
   {
     const auto &key = downloadedFile.asString();
@@ -821,7 +915,13 @@ namespace zyppng {
       return (qItem._schemeName == schemeName);
     });
     if ( existingQ != _queues.end() ) {
-      existingQ->_requests.push_back(req);
+      auto &requests = existingQ->_requests;
+      if ( _isScheduling ) {
+        // the scheduler is iterating the queue, it is sorted again at the start of the next run
+        requests.push_back(req);
+      } else {
+        requests.insert( std::upper_bound( requests.begin(), requests.end(), req, higherPriority ), req );
+      }
     } else {
       _queues.push_back( ProvidePrivate::QueueItem{ schemeName, {req} } );
     }
@@ -880,6 +980,12 @@ namespace zyppng {
     return ss;
   }
 
+  bool ProvidePrivate::useThreadWorker( const std::string &scheme ) const
+  {
+    return ProvideThreadWorker::supportsScheme( scheme )
+           && zypp::MediaConfig::instance().provide_inprocess_workers( scheme );
+  }
+
   void ProvidePrivate::onPulseTimeout( Timer & )
   {
     DBG_PRV << "Pulse timeout" << std::endl;
@@ -1087,6 +1193,13 @@ namespace zyppng {
       co_return  expected<ProvideRes>::error( ZYPP_EXCPT_PTR ( zypp::media::MediaException("No valid mirrors available") )) ;
     }
 
+    if ( auto cached = d->provideFromSharedCache( request ) ) {
+      auto resObj = std::make_shared<ProvideResourceData>();
+      resObj->_myFile      = std::move(*cached);
+      resObj->_resourceUrl = sanitizedOrigin.authority().url();
+      co_return expected<ProvideRes>::success( ProvideRes( resObj ) );
+    }
+
     IOTaskAwaiter< expected<ProvideRes> > p;
     auto op = ProvideFileItem::create( p, sanitizedOrigin, request, *d );
     p.registerDestroyCallback([ myProvide = std::weak_ptr(op)]( bool wasReady ){
@@ -1132,6 +1245,14 @@ namespace zyppng {
         ep.url().appendPathName( fileName );
     }
 
+    if ( auto cached = d->provideFromSharedCache( request ) ) {
+      auto resObj = std::make_shared<ProvideResourceData>();
+      resObj->_mediaHandle = MediaHandle( *this, (*i) );
+      resObj->_myFile      = std::move(*cached);
+      resObj->_resourceUrl = fileOrigin.authority().url();
+      co_return expected<ProvideRes>::success( ProvideRes( resObj ) );
+    }
+
     IOTaskAwaiter< expected<ProvideRes> > p;
     auto op = ProvideFileItem::create( p, fileOrigin, request, *d );
     op->setMediaRef( MediaHandle( *this, (*i) ));
@@ -1214,6 +1335,17 @@ namespace zyppng {
     Z_D();
     d->_isRunning = true;
     d->_pulseTimer->start( 5000 );
+
+    if ( const auto warm = zypp::MediaConfig::instance().provide_warm_workers(); warm > 0 ) {
+      auto &pool = ProvideWorkerPool::instance();
+      for ( const auto &scheme : constants::PRESTARTED_WORKER_SCHEMES ) {
+        // in process workers are started on demand, they are cheap
+        if ( d->useThreadWorker( std::string(scheme) ) )
+          continue;
+        pool.reserve( d->_workerPath / ( "zypp-media-" + std::string(scheme) ), warm );
+      }
+    }
+
     d->schedule( ProvidePrivate::ProvideStart );
     if ( d->_log ) d->_log->provideStart();
   }
@@ -17,6 +17,8 @@
 #include <zypp-core/base/UserRequestException>
 #include "mediaverifier.h"
 #include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/base/Trace.h>
+#include <zypp-core/base/Metrics.h>
 
 using namespace std::literals;
 
@@ -73,7 +75,9 @@ namespace zyppng {
         m.addValue( i->first, val );
     }
 
-    return expected<ProvideRequestRef>::success( ProvideRequestRef( new ProvideRequest(&owner, origin, std::move(m)) ) );
+    ProvideRequestRef req( new ProvideRequest(&owner, origin, std::move(m)) );
+    req->setPriority( spec.priority() );
+    return expected<ProvideRequestRef>::success( std::move(req) );
   }
 
   expected<ProvideRequestRef> ProvideRequest::createDetach( const zypp::Url &url )
@@ -427,6 +431,8 @@ namespace zyppng {
 
       if ( started ) {
         d->_itemStarted = std::chrono::steady_clock::now();
+        if ( zypp::debug::traceEnabled() )
+          d->_traceBegin = zypp::debug::traceNow();
         pulse();
         if ( log ) log->itemStart( *this );
       }
@@ -435,6 +441,11 @@ namespace zyppng {
         d->_itemFinished = std::chrono::steady_clock::now();
         pulse();
         if ( log) log->itemDone( *this );
+        static zypp::metrics::Histogram & itemTime { zypp::metrics::histogram( "provide.item" ) };
+        if ( d->_itemStarted.time_since_epoch().count() )
+          itemTime.observe( d->_itemFinished - d->_itemStarted );
+        if ( d->_traceBegin )
+          zypp::debug::traceComplete( "ProvideItem", "provide", d->_traceBegin, _runningReq ? _runningReq->url().asString() : std::string() );
         d->_parent.dequeueItem(this);
       }
       // CAREFUL, 'this' might be invalid from here on
@@ -643,6 +654,9 @@ namespace zyppng {
             }
           }
 
+          if ( !cacheHit )
+            provider().addToSharedCache( locFilename, _initialSpec );
+
         } else {
           resFile = zypp::ManagedFile( zypp::filesystem::Pathname(locFilename) );
           if ( fileNeedsCleanup && !checkExistsOnly )
@@ -9,6 +9,7 @@
 
 #include "private/providemessage_p.h"
 #include <zypp-core/ng/rpc/stompframestream.h>
+#include <zypp-core/ng/rpc/binaryframe.h>
 
 #include <zypp-core/Url.h>
 #include <string_view>
@@ -144,43 +145,40 @@ namespace zyppng {
   ProvideMessage::ProvideMessage()
   { }
 
-  expected<zyppng::ProvideMessage> ProvideMessage::create(const zypp::PluginFrame &msg)
+  static bool isValidCode( const uint32_t c )
   {
-    if ( msg.command() != ProvideMessage::typeName ) {
-      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR( InvalidMessageReceivedException("Message is not of type WorkerCaps") ) );
-    }
-
-    const std::string &codeStr = msg.getHeaderNT( std::string(ProvideMessageFields::RequestCode) );
-    if ( codeStr.empty () ) {
-      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid message, PluginFrame has no requestId header.")) );
-    }
-
-    const auto c = zyppng::str::safe_strtonum<uint32_t>( codeStr ).value_or ( NoCode );
-    const auto validCode =    ( c >= ProvideMessage::Code::FirstInformalCode    && c <= ProvideMessage::Code::LastInformalCode  )
-                           || ( c >= ProvideMessage::Code::FirstSuccessCode     && c <= ProvideMessage::Code::LastSuccessCode   )
-                           || ( c >= ProvideMessage::Code::FirstRedirCode       && c <= ProvideMessage::Code::LastRedirCode     )
-                           || ( c >= ProvideMessage::Code::FirstClientErrCode   && c <= ProvideMessage::Code::LastClientErrCode )
-                           || ( c >= ProvideMessage::Code::FirstSrvErrCode      && c <= ProvideMessage::Code::LastSrvErrCode    )
-                           || ( c >= ProvideMessage::Code::FirstControllerCode  && c <= ProvideMessage::Code::LastControllerCode)
-                           || ( c >= ProvideMessage::Code::FirstWorkerCode      && c <= ProvideMessage::Code::LastWorkerCode    );
-    if ( !validCode ) {
-      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid code in PluginFrame")) );
-    }
-
-    const std::string & idStr = msg.getHeaderNT( std::string(ProvideMessageFields::RequestId) );
-    if ( idStr.empty () ) {
-      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid message, PluginFrame has no requestId header.")) );
-    }
+    return    ( c >= ProvideMessage::Code::FirstInformalCode    && c <= ProvideMessage::Code::LastInformalCode  )
+           || ( c >= ProvideMessage::Code::FirstSuccessCode     && c <= ProvideMessage::Code::LastSuccessCode   )
+           || ( c >= ProvideMessage::Code::FirstRedirCode       && c <= ProvideMessage::Code::LastRedirCode     )
+           || ( c >= ProvideMessage::Code::FirstClientErrCode   && c <= ProvideMessage::Code::LastClientErrCode )
+           || ( c >= ProvideMessage::Code::FirstSrvErrCode      && c <= ProvideMessage::Code::LastSrvErrCode    )
+           || ( c >= ProvideMessage::Code::FirstControllerCode  && c <= ProvideMessage::Code::LastControllerCode)
+           || ( c >= ProvideMessage::Code::FirstWorkerCode      && c <= ProvideMessage::Code::LastWorkerCode    );
+  }
 
-    const auto &maybeId = zyppng::str::safe_strtonum<uint>( idStr );
-    if ( !maybeId ) {
-      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid message, can not parse requestId header.")) );
+  // binary messages keep the type of the field, the value is only checked, not parsed
+  template <typename T>
+  static zyppng::expected<void> doParseField( const HeaderValue &val, ProvideMessage &t, std::string_view msgtype, std::string_view name ) {
+    if constexpr ( std::is_same_v<T, int64_t> ) {
+      if ( val.isInt() ) {
+        t.addValue( name, static_cast<int64_t>( val.asInt() ) );
+        return zyppng::expected<void>::success();
+      }
     }
+    if ( !std::holds_alternative<T>( val.asVariant() ) )
+      return zyppng::expected<void>::error( ZYPP_EXCPT_PTR( InvalidMessageReceivedException( zypp::str::Str() << "Parse error " << msgtype << ", Field " << name << " has invalid type" ) ) );
 
-    ProvideMessage pMessage;
-    pMessage.setCode ( static_cast<MessageCodes>(c) );
-    pMessage.setRequestId ( *maybeId );
+    t.addValue( name, val );
+    return zyppng::expected<void>::success();
+  }
 
+  /*!
+   * Validates the fields of a message and adds them to \a pMessage, \a headers is either
+   * the string header list of a STOMP frame or the typed values of a binary message.
+   */
+  template <typename HeaderList>
+  static expected<ProvideMessage> parseFields( ProvideMessage &&pMessage, const HeaderList &headers )
+  {
     #define DEF_REQ_FIELD( fname ) bool has_##fname = false
 
     #define PARSE_FIELD( msgtype, fname, ftype, _C_ ) \
@@ -199,7 +197,7 @@ namespace zyppng {
     #define OR_HANDLE_UNKNOWN_FIELD( fname, val ) else HANDLE_UNKNOWN_FIELD( fname, val )
 
     #define BEGIN_PARSE_HEADERS \
-    for ( const auto &header : msg.headerList() ) { \
+    for ( const auto &header : headers ) { \
       const auto &name = header.first;  \
       const auto &val  = header.second;
 
@@ -214,7 +212,7 @@ namespace zyppng {
       if ( !has_##fname ) \
         return expected<ProvideMessage>::error( ZYPP_EXCPT_PTR( InvalidMessageReceivedException( zypp::str::Str() << #msgtype <<" message does not contain required " << #fname << " field" ) ) )
 
-    auto validateErrorMsg = [&]( const auto &msg ){
+    auto validateErrorMsg = [&](){
       DEF_REQ_FIELD(reason);
       BEGIN_PARSE_HEADERS
         PARSE_REQ_FIELD ( Error, reason, std::string )
@@ -226,6 +224,7 @@ namespace zyppng {
       return expected<ProvideMessage>::success( std::move(pMessage) );
     };
 
+    const auto c = pMessage.code();
     switch ( c )
     {
       case ProvideMessage::Code::ProvideStarted: {
@@ -313,7 +312,7 @@ namespace zyppng {
       case ProvideMessage::Code::MediaChangeAbort:
       case ProvideMessage::Code::MediaChangeSkip:
       case ProvideMessage::Code::InternalError: {
-        return validateErrorMsg(msg);
+        return validateErrorMsg();
       }
       case ProvideMessage::Code::Prov: {
         DEF_REQ_FIELD(url);
@@ -324,6 +323,7 @@ namespace zyppng {
           OR_PARSE_OPT_FIELD ( Provide, expected_filesize, int64_t )
           OR_PARSE_OPT_FIELD ( Provide, check_existance_only, bool )
           OR_PARSE_OPT_FIELD ( Provide, file_header_size, int64_t )
+          OR_PARSE_OPT_FIELD ( Provide, max_download_speed, int64_t )
           OR_HANDLE_UNKNOWN_FIELD( name, val )
         END_PARSE_HEADERS
         FAIL_IF_NOT_SEEN_REQ_FIELD( Provide, url );
@@ -336,6 +336,13 @@ namespace zyppng {
         END_PARSE_HEADERS
         return expected<ProvideMessage>::success( std::move(pMessage) );
 
+      case ProvideMessage::Code::UpdateProvide: {
+        BEGIN_PARSE_HEADERS
+          PARSE_OPT_FIELD ( UpdateProvide, max_download_speed, int64_t )
+          OR_HANDLE_UNKNOWN_FIELD( name, val )
+        END_PARSE_HEADERS
+        return expected<ProvideMessage>::success( std::move(pMessage) );
+      }
       case ProvideMessage::Code::Attach: {
         std::exception_ptr error;
 
@@ -409,7 +416,7 @@ namespace zyppng {
       default: {
         // all error messages have the same format
         if ( c >= ProvideMessage::Code::FirstClientErrCode && c <= ProvideMessage::Code::LastSrvErrCode ) {
-          return validateErrorMsg(msg);
+          return validateErrorMsg();
         }
       }
     }
@@ -418,6 +425,43 @@ namespace zyppng {
     return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Unknown code in PluginFrame")) );
   }
 
+  expected<zyppng::ProvideMessage> ProvideMessage::create(const zypp::PluginFrame &msg)
+  {
+    if ( msg.command() != ProvideMessage::typeName ) {
+      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR( InvalidMessageReceivedException("Message is not of type WorkerCaps") ) );
+    }
+
+    // the peer switched to the binary encoding
+    if ( rpc::isBinaryMessage( msg ) )
+      return fromBinaryMessage( msg );
+
+    const std::string &codeStr = msg.getHeaderNT( std::string(ProvideMessageFields::RequestCode) );
+    if ( codeStr.empty () ) {
+      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid message, PluginFrame has no requestId header.")) );
+    }
+
+    const auto c = zyppng::str::safe_strtonum<uint32_t>( codeStr ).value_or ( NoCode );
+    if ( !isValidCode( c ) ) {
+      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid code in PluginFrame")) );
+    }
+
+    const std::string & idStr = msg.getHeaderNT( std::string(ProvideMessageFields::RequestId) );
+    if ( idStr.empty () ) {
+      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid message, PluginFrame has no requestId header.")) );
+    }
+
+    const auto &maybeId = zyppng::str::safe_strtonum<uint>( idStr );
+    if ( !maybeId ) {
+      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid message, can not parse requestId header.")) );
+    }
+
+    ProvideMessage pMessage;
+    pMessage.setCode ( static_cast<MessageCodes>(c) );
+    pMessage.setRequestId ( *maybeId );
+
+    return parseFields( std::move(pMessage), msg.headerList() );
+  }
+
   expected<zypp::PluginFrame> ProvideMessage::toStompMessage() const
   {
     zypp::PluginFrame f = rpc::prepareFrame<ProvideMessage>();
@@ -446,6 +490,110 @@ namespace zyppng {
     return ProvideMessage::create(msg);
   }
 
+  namespace {
+    // type tags of the values in the binary encoding
+    enum BinaryValueType : uint8_t {
+      BinString = 1,
+      BinInt32  = 2,
+      BinInt64  = 3,
+      BinBool   = 4
+    };
+  }
+
+  expected<zypp::PluginFrame> ProvideMessage::toBinaryMessage() const
+  {
+    try {
+      zypp::PluginFrame f = rpc::prepareFrame<ProvideMessage>();
+      f.addHeader( std::string(rpc::ContentTypeHeader), std::string(rpc::BinaryContentType) );
+
+      std::vector<std::pair<const std::string *, const FieldVal *>> values;
+      for ( auto i = _headers.beginList (); i != _headers.endList(); i++ ) {
+        for ( const auto &val : i->second ) {
+          if ( val.valid() )
+            values.push_back( std::make_pair( &i->first, &val ) );
+        }
+      }
+
+      zypp::ByteArray body;
+      rpc::BinaryWriter w( body );
+      w.writeInt<uint32_t>( static_cast<uint32_t>(_code) );
+      w.writeInt<uint32_t>( _reqId );
+      w.writeInt<uint32_t>( values.size() );
+      for ( const auto &[ name, val ] : values ) {
+        w.writeString<uint16_t>( *name );
+        std::visit([&]( const auto &v ){
+          using T = std::decay_t<decltype(v)>;
+          if constexpr ( std::is_same_v<T, std::string> ) {
+            w.writeInt<uint8_t>( BinString );
+            w.writeString<uint32_t>( v );
+          } else if constexpr ( std::is_same_v<T, int32_t> ) {
+            w.writeInt<uint8_t>( BinInt32 );
+            w.writeInt<int32_t>( v );
+          } else if constexpr ( std::is_same_v<T, int64_t> ) {
+            w.writeInt<uint8_t>( BinInt64 );
+            w.writeInt<int64_t>( v );
+          } else if constexpr ( std::is_same_v<T, bool> ) {
+            w.writeInt<uint8_t>( BinBool );
+            w.writeInt<uint8_t>( v ? 1 : 0 );
+          }
+        }, val->asVariant() );
+      }
+      f.setBody( std::move(body) );
+
+      return expected<zypp::PluginFrame>::success ( std::move(f) );
+
+    } catch ( const zypp::Exception &e ) {
+      ZYPP_CAUGHT (e);
+      return expected<zypp::PluginFrame>::error( ZYPP_EXCPT_PTR(e) );
+    }
+  }
+
+  expected<ProvideMessage> ProvideMessage::fromBinaryMessage( const zypp::PluginFrame &msg )
+  {
+    if ( msg.command() != ProvideMessage::typeName ) {
+      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR( InvalidMessageReceivedException("Message is not of type ProvideMessage") ) );
+    }
+
+    ProvideMessage pMessage;
+    std::vector<std::pair<std::string, HeaderValue>> values;
+    try {
+      rpc::BinaryReader r( msg.body() );
+      const auto c = r.readInt<uint32_t>();
+      if ( !isValidCode( c ) ) {
+        return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException("Invalid code in binary message")) );
+      }
+      pMessage.setCode ( static_cast<MessageCodes>(c) );
+      pMessage.setRequestId ( r.readInt<uint32_t>() );
+
+      const auto cnt = r.readInt<uint32_t>();
+      values.reserve( std::min<std::size_t>( cnt, r.remaining() ) );
+      for ( uint32_t i = 0; i < cnt; i++ ) {
+        auto name = r.readString<uint16_t>();
+        switch ( r.readInt<uint8_t>() ) {
+          case BinString:
+            values.emplace_back( std::move(name), r.readString<uint32_t>() );
+            break;
+          case BinInt32:
+            values.emplace_back( std::move(name), r.readInt<int32_t>() );
+            break;
+          case BinInt64:
+            values.emplace_back( std::move(name), r.readInt<int64_t>() );
+            break;
+          case BinBool:
+            values.emplace_back( std::move(name), r.readInt<uint8_t>() != 0 );
+            break;
+          default:
+            return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException( zypp::str::Str() << "Invalid type for field " << name << " in binary message" ) ) );
+        }
+      }
+    } catch ( const zypp::Exception &e ) {
+      ZYPP_CAUGHT (e);
+      return zyppng::expected<ProvideMessage>::error( ZYPP_EXCPT_PTR ( InvalidMessageReceivedException( zypp::str::Str() << "Malformed binary message: " << e.asUserString() ) ) );
+    }
+
+    return parseFields( std::move(pMessage), values );
+  }
+
   ProvideMessage ProvideMessage::createProvideStarted( const uint32_t reqId, const zypp::Url &url, const std::optional<std::string> &localFilename, const std::optional<std::string> &stagingFilename )
   {
     ProvideMessage msg;
@@ -564,6 +712,16 @@ namespace zyppng {
     return msg;
   }
 
+  ProvideMessage ProvideMessage::createUpdateProvide( const uint32_t reqId, int64_t maxDownloadSpeed )
+  {
+    ProvideMessage msg;
+    msg.setCode ( ProvideMessage::Code::UpdateProvide );
+    msg.setRequestId ( reqId );
+    msg.setValue ( ProvideMsgFields::MaxDownloadSpeed, maxDownloadSpeed );
+
+    return msg;
+  }
+
   ProvideMessage ProvideMessage::createAttach(const uint32_t reqId, const zypp::Url &url, const std::string attachId, const std::string &label, const std::optional<std::string> &verifyType, const std::optional<std::string> &verifyData, const std::optional<int32_t> &mediaNr )
   {
     ProvideMessage msg;
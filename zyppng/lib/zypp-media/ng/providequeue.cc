@@ -11,6 +11,8 @@
 #include "private/provideitem_p.h"
 #include "private/provide_p.h"
 #include "private/providedbg_p.h"
+#include "private/provideworkerpool_p.h"
+#include "private/providethreadworker_p.h"
 
 #include <zypp-core/fs/PathInfo.h>
 #include <zypp-core/ng/rpc/stompframestream.h>
@@ -18,6 +20,7 @@
 #include <zypp-media/ng/provide-configvars.h>
 #include <zypp-media/MediaException>
 #include <zypp-media/auth/CredentialManager>
+#include <zypp-media/MediaConfig>
 
 #include <zypp-core/Globals.h>
 #include <bitset>
@@ -45,7 +48,9 @@ namespace zyppng {
     return ( _request->code () == ProvideMessage::Code::Detach );
   }
 
-  ProvideQueue::ProvideQueue(ProvidePrivate &parent) : _parent(parent)
+  ProvideQueue::ProvideQueue(ProvidePrivate &parent)
+    : _parent(parent)
+    , _connLimit( constants::DEFAULT_ACTIVE_CONN_PER_HOST, constants::MIN_ACTIVE_CONN_PER_HOST, constants::MAX_ACTIVE_CONN_PER_HOST, constants::THROUGHPUT_WINDOW )
   { }
 
   ProvideQueue::~ProvideQueue()
@@ -60,13 +65,28 @@ namespace zyppng {
 
   bool ProvideQueue::startup(const std::string &workerScheme, const zypp::filesystem::Pathname &workDir, const std::string &hostname ) {
 
-    if ( _workerProc ) {
+    if ( _workerProc || _threadWorker ) {
       ERR << "Queue Worker was already initialized" << std::endl;
       return true;
     }
 
     _myHostname = hostname;
 
+    if ( _parent.useThreadWorker( workerScheme ) ) {
+      if ( zypp::filesystem::assert_dir( workDir ) != 0 ) {
+        ERR << "Failed to assert working directory '" << workDir << "' for worker " << workerScheme << std::endl;
+        return false;
+      }
+
+      MIL << "Trying to start in process worker for " << workerScheme << std::endl;
+      _workDir = workDir;
+      _threadWorker = std::make_unique<ProvideThreadWorker>( workerScheme );
+      if ( doStartup() )
+        return true;
+
+      MIL << "Falling back to the worker executable for " << workerScheme << std::endl;
+    }
+
     const auto &pN = _parent.workerPath() / ( "zypp-media-"+workerScheme ) ;
     MIL << "Trying to start " << pN << std::endl;
     const auto &pi = zypp::PathInfo( pN );
@@ -86,8 +106,14 @@ namespace zyppng {
     }
 
     _currentExe = pN;
-    _workerProc = Process::create();
-    _workerProc->setWorkingDirectory ( workDir );
+    _workDir = workDir;
+    _workerProc = ProvideWorkerPool::instance().take( pN );
+    if ( _workerProc ) {
+      MIL << "Using prestarted worker " << pN << " pid: " << _workerProc->pid() << std::endl;
+    } else {
+      _workerProc = Process::create();
+      _workerProc->setWorkingDirectory ( workDir );
+    }
     _messageStream = StompFrameStream::create( _workerProc );
     return doStartup();
   }
@@ -99,7 +125,12 @@ namespace zyppng {
     i._request   = request;
     i._request->provideMessage().setRequestId( nextRequestId() );
     request->setCurrentQueue( shared_this<ProvideQueue>() );
-    _waitQueue.push_back( std::move(i) );
+
+    // higher priorities go first, requests with the same priority keep their order
+    const auto pos = priorityInsertPos( _waitQueue.begin(), _waitQueue.end(), request->priority(), []( const Item &other ) {
+      return other._request ? other._request->priority() : ProvideFileSpec::High;
+    });
+    _waitQueue.insert( pos, std::move(i) );
     if ( _parent.isRunning() )
       scheduleNext();
   }
@@ -179,6 +210,10 @@ namespace zyppng {
       _workerProc->waitForExit();
       readAllStderr();
     }
+
+    if ( _threadWorker && _threadWorker->isRunning() ) {
+      _threadWorker->stop();
+    }
   }
 
   std::list< ProvideQueue::Item >::iterator ProvideQueue::cancelActiveItem( std::list< Item >::iterator i , const std::__exception_ptr::exception_ptr &error )
@@ -236,12 +271,14 @@ namespace zyppng {
       item._state = Item::Queued;
       _activeItems.push_back( std::move(item) );
       _idleSince.reset();
+      trackActivated();
     }
 
     if ( _waitQueue.empty() && _activeItems.empty() ) {
       _parent.schedule( ProvidePrivate::QueueIdle );
       if ( !_idleSince )
         _idleSince = std::chrono::steady_clock::now();
+      _connLimit.idle();
       _sigIdle.emit();
     }
   }
@@ -299,6 +336,104 @@ namespace zyppng {
     return dlSize;
   }
 
+  uint ProvideQueue::connectionLimit() const
+  {
+    return _connLimit.limit();
+  }
+
+  void ProvideQueue::setBandwidthShare( int64_t share )
+  {
+    const auto &update = [&]( Item &i, bool notifyWorker ) {
+      if ( !i._request || i._request->code() != ProvideMessage::Code::Prov )
+        return;
+      auto &msg = i._request->provideMessage();
+      if ( msg.value( ProvideMsgFields::MaxDownloadSpeed, int64_t(0) ).asInt64() == share )
+        return;
+      msg.setValue( ProvideMsgFields::MaxDownloadSpeed, share );
+      if ( notifyWorker && !_messageStream->sendMessage( ProvideMessage::createUpdateProvide( msg.requestId(), share ) ) )
+        ERR << "Failed to send update message to worker" << std::endl;
+    };
+
+    for ( auto &i : _waitQueue )
+      update( i, false );
+    for ( auto &i : _activeItems ) {
+      if ( i._state == Item::Queued || i._state == Item::Running )
+        update( i, true );
+    }
+  }
+
+  void ProvideQueue::trackActivated()
+  {
+    _connLimit.activated( _activeItems.size() );
+  }
+
+  void ProvideQueue::trackFinished( const zypp::ByteCount &bytes )
+  {
+    const auto oldLimit = _connLimit.limit();
+    const auto rate = _connLimit.finished( bytes, _activeItems.size() );
+    if ( rate && _connLimit.limit() != oldLimit ) {
+      MIL << "Throughput for " << _myHostname << " changed to " << zypp::ByteCount( zypp::ByteCount::SizeType(*rate) ) << "/s, "
+          << ( _connLimit.limit() > oldLimit ? "raising" : "lowering" ) << " connection limit to " << _connLimit.limit() << std::endl;
+    }
+  }
+
+  AdaptiveConnectionLimit::AdaptiveConnectionLimit( uint initial, uint min, uint max, std::chrono::steady_clock::duration window )
+    : _limit( initial )
+    , _min( min )
+    , _max( max )
+    , _window( window )
+  { }
+
+  uint AdaptiveConnectionLimit::limit() const
+  {
+    return _limit;
+  }
+
+  void AdaptiveConnectionLimit::activated( uint active, TimePoint now )
+  {
+    if ( !_windowStart ) {
+      _windowStart = now;
+      _windowBytes = 0;
+      _windowPeakActive = 0;
+    }
+    _windowPeakActive = std::max<uint>( _windowPeakActive, active );
+  }
+
+  std::optional<double> AdaptiveConnectionLimit::finished( const zypp::ByteCount &bytes, uint active, TimePoint now )
+  {
+    if ( !_windowStart )
+      return {};
+
+    _windowBytes += bytes;
+
+    const std::chrono::duration<double> elapsed = now - *_windowStart;
+    if ( elapsed < _window )
+      return {};
+
+    const double rate = double(_windowBytes) / elapsed.count();
+
+    // if the queue did not use all its slots the throughput tells us nothing about the limit
+    if ( _windowPeakActive >= _limit ) {
+      if ( _lastRate > 0 ) {
+        if ( rate > _lastRate * 1.1 && _limit < _max )
+          _limit++;
+        else if ( rate < _lastRate * 0.8 && _limit > _min )
+          _limit--;
+      }
+      _lastRate = rate;
+    }
+
+    _windowStart = now;
+    _windowBytes = 0;
+    _windowPeakActive = active;
+    return rate;
+  }
+
+  void AdaptiveConnectionLimit::idle()
+  {
+    _windowStart.reset();
+  }
+
   const std::string &ProvideQueue::hostname() const
   {
     return _myHostname;
@@ -316,36 +451,55 @@ namespace zyppng {
 
   bool ProvideQueue::doStartup()
   {
-    if ( _currentExe.empty() )
-      return false;
+    if ( _threadWorker ) {
+      if ( !_threadWorker->start() ) {
+        MIL << "Could not start in process worker" << std::endl;
+        _threadWorker.reset();
+        return false;
+      }
+      _messageStream = _threadWorker->messageStream();
 
-    //const char *argv[] = { "gdbserver", ":10000", _currentExe.c_str(), nullptr };
-    const char *argv[] = { _currentExe.c_str(), nullptr };
-    if ( !_workerProc->start( argv) ) {
-      ERR << "Failed to execute worker" << std::endl;
+    } else {
+      if ( _currentExe.empty() )
+        return false;
 
-      _messageStream.reset ();
-      _workerProc.reset ();
+      //const char *argv[] = { "gdbserver", ":10000", _currentExe.c_str(), nullptr };
+      const char *argv[] = { _currentExe.c_str(), nullptr };
+      // a worker taken from the ProvideWorkerPool is already running and waits for its config
+      if ( !_workerProc->isRunning() && !_workerProc->start( argv) ) {
+        ERR << "Failed to execute worker" << std::endl;
 
-      return false;
-    }
+        _messageStream.reset ();
+        _workerProc.reset ();
 
-    // make sure the default read channel is StdOut so RpcMessageStream gets all the rpc messages
-    _workerProc->setReadChannel ( Process::StdOut );
+        return false;
+      }
+
+      // make sure the default read channel is StdOut so RpcMessageStream gets all the rpc messages
+      _workerProc->setReadChannel ( Process::StdOut );
+    }
 
     // we are ready to send the data
 
     ProviderConfiguration conf;
     // @TODO actually write real config data :D
     conf.insert ( { AGENT_STRING_CONF.data (), "ZYpp " LIBZYPP_VERSION_STRING } );
-    conf.insert ( { ATTACH_POINT.data (), _workerProc->workingDirectory().asString() } );
+    conf.insert ( { ATTACH_POINT.data (), _workDir.asString() } );
     conf.insert ( { PROVIDER_ROOT.data (), _parent.z_func()->providerWorkdir().asString() } );
+    // frames to a in process worker are not encoded at all
+    if ( !_threadWorker && zypp::MediaConfig::instance().provide_binary_rpc() )
+      conf.insert ( { PROVIDER_BINARY_ENCODING.data (), "true" } );
+    if ( zypp::MediaConfig::instance().download_resume_partial() )
+      conf.insert ( { RESUME_PARTIAL.data (), "true" } );
 
     const auto &cleanupOnErr = [&](){
       readAllStderr();
       _messageStream.reset ();
-      _workerProc->close();
-      _workerProc.reset();
+      if ( _workerProc ) {
+        _workerProc->close();
+        _workerProc.reset();
+      }
+      _threadWorker.reset();
       return false;
     };
 
@@ -355,7 +509,8 @@ namespace zyppng {
     }
 
     // wait for the data to be written
-    _workerProc->flush ();
+    if ( _workerProc )
+      _workerProc->flush ();
 
     // wait until we receive a message
     const auto &caps = _messageStream->nextMessageWait();
@@ -372,12 +527,25 @@ namespace zyppng {
       _capabilities = std::move(*p);
     }
 
-    DBG << "Received config for worker: " << this->_currentExe.asString() << " Worker Type: " << this->_capabilities.worker_type() << " Flags: " << std::bitset<32>( _capabilities.cfg_flags() ).to_string() << std::endl;
+    // the worker sends binary frames right after its capabilities
+    if ( _capabilities.cfg_flags() & WorkerCaps::BinaryEncoding )
+      _messageStream->setEncoding( StompFrameStream::Binary );
+
+    DBG << "Received config for worker: " << ( _threadWorker ? _capabilities.worker_name() : this->_currentExe.asString() ) << " Worker Type: " << this->_capabilities.worker_type() << " Flags: " << std::bitset<32>( _capabilities.cfg_flags() ).to_string() << std::endl;
 
     // now we can set up signals and start processing messages
     connect( *_messageStream, &StompFrameStream::sigMessageReceived, *this, &ProvideQueue::processMessage );
-    connect( *_workerProc, &IODevice::sigChannelReadyRead, *this, &ProvideQueue::processReadyRead );
-    connect( *_workerProc, &Process::sigFinished, *this, &ProvideQueue::procFinished );
+    if ( _workerProc ) {
+      connect( *_workerProc, &IODevice::sigChannelReadyRead, *this, &ProvideQueue::processReadyRead );
+      connect( *_workerProc, &Process::sigFinished, *this, &ProvideQueue::procFinished );
+    } else {
+      // the in process worker closes its side of the connection when it exits,
+      // after we stopped it ourselves that is expected
+      connectFunc( *_messageStream, &StompFrameStream::sigClosed, [this](){
+        if ( _threadWorker && _threadWorker->isRunning() )
+          procFinished( 0 );
+      }, *this );
+    }
 
     // make sure we do not miss messages
     processMessage();
@@ -507,6 +675,8 @@ namespace zyppng {
                   dequeueActive( reqIter );
                   continue;
                 }
+
+                trackFinished( zypp::PathInfo( locFName ).size() );
               }
             }
           }
@@ -714,6 +884,10 @@ namespace zyppng {
    */
   void ProvideQueue::readAllStderr()
   {
+    // in process workers log directly
+    if ( !_workerProc )
+      return;
+
     // read all stderr data so we get the full logs
     auto ba = _workerProc->channelReadLine(Process::StdErr);
     while ( !ba.empty() ) {
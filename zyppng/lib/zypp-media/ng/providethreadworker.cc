@@ -0,0 +1,179 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+
+#include "private/providethreadworker_p.h"
+
+#include <zypp-core/base/Logger.h>
+#include <zypp-core/ng/thread/ThreadPool>
+#include <zypp-media/ng/worker/MountingWorker>
+#include <zypp-media/ng/worker/CopyProvider>
+#include <zypp-media/ng/worker/DirProvider>
+#include <zypp-media/ng/worker/DiskProvider>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace zyppng {
+
+  struct ProvideThreadWorker::JobState
+  {
+    std::mutex _lock;
+    std::condition_variable _cv;
+    bool _done = false;
+  };
+
+  namespace {
+
+    /// pool threads currently hosting a worker
+    std::atomic<unsigned> hostedWorkers = 0;
+
+    bool acquirePoolThread()
+    {
+      // always leave one thread for the short jobs the pool is meant for
+      const unsigned limit = ThreadPool::global().size() - 1;
+      unsigned cur = hostedWorkers.load();
+      do {
+        if ( cur >= limit )
+          return false;
+      } while ( !hostedWorkers.compare_exchange_weak( cur, cur + 1 ) );
+      return true;
+    }
+
+    void releasePoolThread()
+    {
+      hostedWorkers.fetch_sub( 1 );
+    }
+
+    template <typename Driver>
+    worker::ProvideWorkerRef makeMountingWorker( std::string_view workerName )
+    {
+      auto driver = std::make_shared<Driver>();
+      auto worker = std::make_shared<worker::MountingWorker>( workerName, driver );
+      driver->setProvider( worker );
+      return worker;
+    }
+
+    worker::ProvideWorkerRef makeWorker( const std::string &scheme )
+    {
+      if ( scheme == "dir" )
+        return makeMountingWorker<worker::DirProvider>( "zypp-media-dir" );
+      if ( scheme == "disk" )
+        return makeMountingWorker<worker::DiskProvider>( "zypp-media-disk" );
+      if ( scheme == "copy" )
+        return std::make_shared<worker::CopyProvider>( "zypp-media-copy" );
+      return nullptr;
+    }
+
+    void runWorker( const std::string &scheme, StompFrameStream::FrameQueue::Ptr recv, StompFrameStream::FrameQueue::Ptr send )
+    {
+      try {
+        // the worker needs to be created on this thread, it brings its own EventLoop
+        auto worker = makeWorker( scheme );
+        worker->setInProcess( true );
+
+        auto res = worker->run( recv, send );
+        worker->immediateShutdown();
+        if ( !res ) {
+          try {
+            std::rethrow_exception( res.error() );
+          } catch ( const zypp::Exception &e ) {
+            ERR << "In process worker for " << scheme << " failed with: " << e << std::endl;
+          } catch ( const std::exception &e ) {
+            ERR << "In process worker for " << scheme << " failed with: " << e.what() << std::endl;
+          } catch ( ... ) {
+            ERR << "In process worker for " << scheme << " failed with a unknown error" << std::endl;
+          }
+        }
+      } catch ( ... ) {
+        ERR << "Unexpected exception in the in process worker for " << scheme << std::endl;
+      }
+
+      // tells the controller that the worker is gone, even if the worker never got to open its stream
+      send->push( std::optional<zypp::PluginFrame>() );
+      MIL << "In process worker for " << scheme << " exited" << std::endl;
+    }
+  }
+
+  bool ProvideThreadWorker::supportsScheme( const std::string &scheme )
+  {
+    return ( scheme == "dir" || scheme == "disk" || scheme == "copy" );
+  }
+
+  ProvideThreadWorker::ProvideThreadWorker( std::string scheme )
+    : _scheme( std::move(scheme) )
+  { }
+
+  ProvideThreadWorker::~ProvideThreadWorker()
+  {
+    stop();
+  }
+
+  bool ProvideThreadWorker::start()
+  {
+    if ( _job )
+      return true;
+
+    if ( !supportsScheme( _scheme ) ) {
+      ERR << "No in process worker for scheme " << _scheme << std::endl;
+      return false;
+    }
+
+    if ( !acquirePoolThread() ) {
+      MIL << "No pool thread left to host a in process worker for " << _scheme << std::endl;
+      return false;
+    }
+
+    auto toWorker   = StompFrameStream::FrameQueue::create();
+    auto fromWorker = StompFrameStream::FrameQueue::create();
+    _stream = StompFrameStream::create( fromWorker, toWorker );
+    _job    = std::make_shared<JobState>();
+
+    ThreadPool::global().post( [ scheme = _scheme, job = _job, recv = std::move(toWorker), send = std::move(fromWorker) ]() {
+      runWorker( scheme, recv, send );
+      releasePoolThread();
+      {
+        std::lock_guard lk( job->_lock );
+        job->_done = true;
+      }
+      job->_cv.notify_all();
+    });
+
+    MIL << "Started in process worker for " << _scheme << std::endl;
+    return true;
+  }
+
+  bool ProvideThreadWorker::isRunning() const
+  {
+    return bool(_job);
+  }
+
+  void ProvideThreadWorker::stop()
+  {
+    if ( !_job )
+      return;
+
+    // the worker receives the end marker and shuts down, if it is waiting for a answer
+    // from us that wait fails
+    _stream->close();
+
+    std::unique_lock lk( _job->_lock );
+    _job->_cv.wait( lk, [this](){ return _job->_done; } );
+    lk.unlock();
+
+    _job.reset();
+    _stream.reset();
+  }
+
+  StompFrameStreamRef ProvideThreadWorker::messageStream() const
+  {
+    return _stream;
+  }
+
+}
@@ -0,0 +1,199 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+
+#include "private/provideworkerpool_p.h"
+
+#include <zypp-core/ng/base/EventDispatcher>
+#include <zypp-core/fs/PathInfo.h>
+#include <zypp-core/base/Logger.h>
+#include <zypp-media/MediaConfig>
+
+#include <csignal>
+
+namespace zyppng {
+
+  namespace {
+    /*!
+     * A prestarted worker is blocked reading its configuration, so there
+     * is nothing to flush and it can be terminated right away.
+     */
+    void stopWorker( Process &proc )
+    {
+      proc.closeWriteChannel();
+      proc.stop( SIGTERM );
+      proc.waitForExit();
+    }
+  }
+
+  ProvideWorkerPool::ProvideWorkerPool()
+    : _idleTimeout( std::chrono::seconds( zypp::MediaConfig::instance().provide_warm_worker_timeout() ) )
+  { }
+
+  ProvideWorkerPool::~ProvideWorkerPool()
+  {
+    clear();
+  }
+
+  ProvideWorkerPool &ProvideWorkerPool::instance()
+  {
+    // make sure the thread data outlive the pool, the workers need the dispatcher when stopped
+    auto ev = EventDispatcher::instance();
+    static thread_local ProvideWorkerPool pool;
+
+    if ( pool._ev.lock() != ev ) {
+      // workers of a previous dispatcher would not deliver any events anymore
+      pool.clear();
+      pool._ev = ev;
+      pool._refillPending = false;
+      pool._idleTimer.reset();
+      if ( ev ) {
+        pool._idleTimer = Timer::create();
+        pool._idleTimer->setSingleShot( true );
+        pool._idleTimer->sigExpired().connect( sigc::mem_fun( pool, &ProvideWorkerPool::onIdleTimeout ) );
+      }
+    }
+    return pool;
+  }
+
+  void ProvideWorkerPool::reserve( const zypp::Pathname &exe, uint count )
+  {
+    if ( !_idleTimer || exe.empty() )
+      return;
+
+    const zypp::PathInfo pi( exe );
+    if ( !pi.isFile() || !pi.userMayX() ) {
+      DBG << "Not prestarting " << exe << ", no executable worker" << std::endl;
+      return;
+    }
+
+    auto &entry = _entries[exe.asString()];
+    entry._wanted = count;
+    touch();
+    if ( entry._workers.size() < count )
+      scheduleRefill();
+  }
+
+  Process::Ptr ProvideWorkerPool::take( const zypp::Pathname &exe )
+  {
+    auto i = _entries.find( exe.asString() );
+    if ( i == _entries.end() )
+      return nullptr;
+
+    auto &workers = i->second._workers;
+    while ( workers.size() ) {
+      auto [ proc, conn ] = std::move( workers.front() );
+      workers.pop_front();
+      conn.disconnect();
+      if ( !proc->isRunning() )
+        continue;
+
+      touch();
+      scheduleRefill();
+      return proc;
+    }
+    return nullptr;
+  }
+
+  uint ProvideWorkerPool::available( const zypp::Pathname &exe ) const
+  {
+    auto i = _entries.find( exe.asString() );
+    return ( i == _entries.end() ? 0 : i->second._workers.size() );
+  }
+
+  std::chrono::milliseconds ProvideWorkerPool::idleTimeout() const
+  {
+    return _idleTimeout;
+  }
+
+  void ProvideWorkerPool::setIdleTimeout( std::chrono::milliseconds timeout )
+  {
+    _idleTimeout = timeout;
+    if ( _idleTimer && _idleTimer->isRunning() )
+      touch();
+  }
+
+  void ProvideWorkerPool::clear()
+  {
+    for ( auto &[ exe, entry ] : _entries ) {
+      if ( entry._workers.size() )
+        MIL << "Stopping " << entry._workers.size() << " prestarted workers of " << exe << std::endl;
+      for ( auto &[ proc, conn ] : entry._workers ) {
+        conn.disconnect();
+        stopWorker( *proc );
+      }
+    }
+    _entries.clear();
+    if ( _idleTimer )
+      _idleTimer->stop();
+  }
+
+  void ProvideWorkerPool::scheduleRefill()
+  {
+    if ( _refillPending )
+      return;
+
+    // starting processes takes a while, do not delay the request that triggered us
+    _refillPending = true;
+    EventDispatcher::invokeOnIdle( [this](){
+      _refillPending = false;
+      refill();
+      return false;
+    });
+  }
+
+  void ProvideWorkerPool::refill()
+  {
+    for ( auto &[ exe, entry ] : _entries ) {
+      while ( entry._workers.size() < entry._wanted ) {
+        auto proc = Process::create();
+        const char *argv[] = { exe.c_str(), nullptr };
+        if ( !proc->start( argv ) ) {
+          ERR << "Failed to prestart worker " << exe << ", giving up on it" << std::endl;
+          entry._wanted = 0;
+          break;
+        }
+        proc->setReadChannel( Process::StdOut );
+
+        auto conn = proc->sigFinished().connect( [ this, p = proc.get() ]( int ){ onWorkerFinished( p ); } );
+        DBG << "Prestarted worker " << exe << " pid: " << proc->pid() << std::endl;
+        entry._workers.push_back( std::make_pair( std::move(proc), std::move(conn) ) );
+      }
+    }
+  }
+
+  void ProvideWorkerPool::touch()
+  {
+    if ( _idleTimer )
+      _idleTimer->start( _idleTimeout.count() );
+  }
+
+  void ProvideWorkerPool::onIdleTimeout( Timer & )
+  {
+    MIL << "Prestarted workers were not used for " << _idleTimeout.count() << "ms, stopping them" << std::endl;
+    clear();
+  }
+
+  void ProvideWorkerPool::onWorkerFinished( Process *proc )
+  {
+    for ( auto &[ exe, entry ] : _entries ) {
+      auto i = std::find_if( entry._workers.begin(), entry._workers.end(), [proc]( const auto &w ) { return w.first.get() == proc; } );
+      if ( i == entry._workers.end() )
+        continue;
+
+      WAR << "Prestarted worker " << exe << " exited with code " << proc->exitStatus() << ", not prestarting it anymore" << std::endl;
+      // we are called from the process signal, release it when we are back in the event loop
+      i->second.disconnect();
+      EventDispatcher::unrefLater( std::move(i->first) );
+      entry._workers.erase( i );
+      entry._wanted = 0;
+      return;
+    }
+  }
+
+}
@@ -0,0 +1,36 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#ifndef ZYPP_MEDIA_NG_WORKER_COPYPROVIDER_H_INCLUDED
+#define ZYPP_MEDIA_NG_WORKER_COPYPROVIDER_H_INCLUDED
+
+#include <zypp-media/ng/worker/ProvideWorker>
+
+namespace zyppng::worker {
+
+  /*!
+   * The zypp-media-copy worker, it copies local files into the location
+   * given by the request's target filename hint.
+   */
+  class CopyProvider : public ProvideWorker
+  {
+    public:
+      CopyProvider( std::string_view workerName );
+
+      void immediateShutdown() override { }
+
+    protected:
+      // ProvideWorker interface
+      expected<WorkerCaps> initialize( const Configuration &conf ) override;
+      void provide() override;
+      void cancel( const std::deque<ProvideWorkerItemRef>::iterator &i ) override;
+  };
+
+}
+
+#endif
@@ -16,6 +16,8 @@
 #include <zypp-core/fs/TmpPath.h>
 #include <zypp-core/Date.h>
 
+#include <atomic>
+
 #undef ZYPP_BASE_LOGGER_LOGGROUP
 #define ZYPP_BASE_LOGGER_LOGGROUP "zyppng::worker::DeviceDriver"
 
@@ -223,10 +225,10 @@ namespace zyppng::worker
       return apoint;
     }
 
-    static bool cleanup_once( true );
-    if ( cleanup_once )
+    // workers for several schemes might run on threads of the same process
+    static std::atomic_bool cleanup_once( true );
+    if ( cleanup_once.exchange( false ) )
     {
-      cleanup_once = false;
       DBG << "Look for orphaned attach points in " << adir << std::endl;
       std::list<std::string> entries;
       zypp::filesystem::readdir( entries, attach_root, false );
@@ -6,20 +6,29 @@
 |                         /_____||_| |_| |_|                           |
 |                                                                      |
 \---------------------------------------------------------------------*/
-#ifndef ZYPP_NG_TOOLS_DISKPROVIDER_H_INCLUDED
-#define ZYPP_NG_TOOLS_DISKPROVIDER_H_INCLUDED
+#ifndef ZYPP_MEDIA_NG_WORKER_DIRPROVIDER_H_INCLUDED
+#define ZYPP_MEDIA_NG_WORKER_DIRPROVIDER_H_INCLUDED
 
 #include <zypp-media/ng/worker/DeviceDriver>
 
-class DiskProvider : public zyppng::worker::DeviceDriver
-{
-  public:
-    DiskProvider();
-    ~DiskProvider();
+namespace zyppng::worker {
 
-    // DeviceDriver interface
-    zyppng::worker::AttachResult mountDevice ( const uint32_t id, const zypp::Url &attachUrl, const std::string &attachId, const std::string &label, const zyppng::HeaderValueMap &extras ) override;
+  /*!
+   * The \ref DeviceDriver used by the zypp-media-dir worker
+   */
+  class DirProvider : public DeviceDriver
+  {
+    public:
+      DirProvider( );
+      ~DirProvider();
 
-};
+      AttachResult mountDevice ( const uint32_t id, const zypp::Url &attachUrl, const std::string &attachId, const std::string &label, const zyppng::HeaderValueMap &extras ) override;
+
+    protected:
+      void unmountDevice ( Device &dev ) override;
+
+  };
+
+}
 
 #endif
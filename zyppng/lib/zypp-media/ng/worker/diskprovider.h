@@ -6,22 +6,27 @@
 |                         /_____||_| |_| |_|                           |
 |                                                                      |
 \---------------------------------------------------------------------*/
-#ifndef ZYPP_NG_TOOLS_DIRPROVIDER_H_INCLUDED
-#define ZYPP_NG_TOOLS_DIRPROVIDER_H_INCLUDED
+#ifndef ZYPP_MEDIA_NG_WORKER_DISKPROVIDER_H_INCLUDED
+#define ZYPP_MEDIA_NG_WORKER_DISKPROVIDER_H_INCLUDED
 
 #include <zypp-media/ng/worker/DeviceDriver>
 
-class DirProvider : public zyppng::worker::DeviceDriver
-{
-  public:
-    DirProvider( );
-    ~DirProvider();
+namespace zyppng::worker {
 
-    zyppng::worker::AttachResult mountDevice ( const uint32_t id, const zypp::Url &attachUrl, const std::string &attachId, const std::string &label, const zyppng::HeaderValueMap &extras ) override;
+  /*!
+   * The \ref DeviceDriver used by the zypp-media-disk worker
+   */
+  class DiskProvider : public DeviceDriver
+  {
+    public:
+      DiskProvider();
+      ~DiskProvider();
 
-  protected:
-    void unmountDevice ( zyppng::worker::Device &dev ) override;
+      // DeviceDriver interface
+      AttachResult mountDevice ( const uint32_t id, const zypp::Url &attachUrl, const std::string &attachId, const std::string &label, const zyppng::HeaderValueMap &extras ) override;
 
-};
+  };
+
+}
 
 #endif
@@ -36,11 +36,6 @@ namespace zyppng::worker {
 
   ProvideWorker::ProvideWorker(std::string_view workerName) : _workerName(workerName)
   {
-    // do not change the order of these calls, otherwise showing the threadname does not work
-    // enableLogForwardingMode will initialize the log which would override the current thread name
-    zypp::base::LogControl::instance().enableLogForwardingMode( true );
-    ThreadData::current().setName( workerName );
-
     // we use a singleshot timer that triggers message handling
     connect( *_msgAvail, &Timer::sigExpired, *this, &ProvideWorker::messageLoop );
     _msgAvail->setSingleShot(true);
@@ -68,7 +63,13 @@ namespace zyppng::worker {
     zypp::DtorReset res( _isRunning );
     _isRunning = true;
 
-    initLog();
+    // do not change the order of these calls, otherwise showing the threadname does not work
+    // enableLogForwardingMode will initialize the log which would override the current thread name
+    if ( !_inProcess )
+      zypp::base::LogControl::instance().enableLogForwardingMode( true );
+    ThreadData::current().setName( _workerName );
+    if ( !_inProcess )
+      initLog();
 
     zypp::OnScopeExit cleanup([&](){
       _stream.reset();
@@ -85,7 +86,34 @@ namespace zyppng::worker {
     connect( *_controlIO, &AsyncDataSource::sigWriteFdClosed, *this, &ProvideWorker::writeFdClosed );
 
     _stream = StompFrameStream::create( _controlIO );
+    return runStream();
+  }
+
+  expected<void> ProvideWorker::run( StompFrameStream::FrameQueue::Ptr recv, StompFrameStream::FrameQueue::Ptr send )
+  {
+    // reentry not supported
+    assert ( !_isRunning );
+
+    zypp::DtorReset res( _isRunning );
+    _isRunning = true;
+
+    // we share the thread and the log with the controller, only the name is ours while we run
+    const std::string oldName = ThreadData::current().name();
+    ThreadData::current().setName( _workerName );
 
+    zypp::OnScopeExit cleanup([&](){
+      _stream.reset();
+      _loop.reset();
+      ThreadData::current().setName( oldName );
+    });
+
+    _stream = StompFrameStream::create( std::move(recv), std::move(send) );
+    connect( *_stream, &StompFrameStream::sigClosed, *this, &ProvideWorker::streamClosed );
+    return runStream();
+  }
+
+  expected<void> ProvideWorker::runStream()
+  {
     return executeHandshake () | and_then( [&]() {
       AutoDisconnect disC[] = {
         connect( *_stream, &StompFrameStream::sigMessageReceived, *this, &ProvideWorker::messageReceived ),
@@ -111,12 +139,25 @@ namespace zyppng::worker {
     _provNotificationMode = provNotificationMode;
   }
 
+  bool ProvideWorker::inProcess() const
+  {
+    return _inProcess;
+  }
+
+  void ProvideWorker::setInProcess( bool set )
+  {
+    _inProcess = set;
+  }
+
   void ProvideWorker::initLog()
   {
     // by default we log to strErr, if user code wants to change that it can overload this function
     zypp::base::LogControl::instance().logToStdErr();
   }
 
+  void ProvideWorker::update( const std::deque<ProvideWorkerItemRef>::iterator & )
+  { }
+
   ProvideWorkerItemRef ProvideWorker::makeItem( ProvideMessage &&spec )
   {
     return std::make_shared<ProvideWorkerItem>( std::move(spec) );
@@ -202,7 +243,8 @@ namespace zyppng::worker {
       return expected<ProvideMessage>::error( ZYPP_EXCPT_PTR(zypp::Exception("Failed to send message")) );
 
     // flush the io device, this will block until all bytes are written
-    _controlIO->flush();
+    if ( _controlIO )
+      _controlIO->flush();
 
     while ( !_fatalError ) {
 
@@ -304,11 +346,14 @@ namespace zyppng::worker {
 
       _workerConf = std::move(conf);
 
-      auto &mediaConf = zypp::MediaConfig::instance();
-      for( const auto &[key,value] : _workerConf ) {
-        zypp::Url keyUrl( key );
-        if ( keyUrl.getScheme() == "zconfig" && keyUrl.getAuthority() == "main" ) {
-          mediaConf.setConfigValue( keyUrl.getAuthority(), zypp::Pathname(keyUrl.getPathName()).basename(), value );
+      // a worker running in process shares the MediaConfig with the controller
+      if ( !_inProcess ) {
+        auto &mediaConf = zypp::MediaConfig::instance();
+        for( const auto &[key,value] : _workerConf ) {
+          zypp::Url keyUrl( key );
+          if ( keyUrl.getScheme() == "zconfig" && keyUrl.getAuthority() == "main" ) {
+            mediaConf.setConfigValue( keyUrl.getAuthority(), zypp::Pathname(keyUrl.getPathName()).basename(), value );
+          }
         }
       }
 
@@ -317,9 +362,19 @@ namespace zyppng::worker {
         caps.set_worker_name( _workerName.data() );
 
         caps.set_cfg_flags ( WorkerCaps::Flags(caps.cfg_flags() | WorkerCaps::ZyppLogFormat) );
+
+        // only switch to the binary encoding if the controller offered it, older controllers only speak STOMP
+        const auto binEnc = _workerConf.find( std::string(PROVIDER_BINARY_ENCODING) );
+        const bool useBinary = ( binEnc != _workerConf.end() && zypp::str::strToBool( binEnc->second, false ) );
+        if ( useBinary )
+          caps.set_cfg_flags ( WorkerCaps::Flags(caps.cfg_flags() | WorkerCaps::BinaryEncoding) );
+
         if ( !_stream->sendMessage ( caps ) ) {
           return expected<void>::error( ZYPP_EXCPT_PTR(zypp::Exception("Failed to send capabilities")) );
         }
+
+        if ( useBinary )
+          _stream->setEncoding( StompFrameStream::Binary );
         return expected<void>::success ();
       });
     };
@@ -370,6 +425,12 @@ namespace zyppng::worker {
     maybeDelayedShutdown();
   }
 
+  void ProvideWorker::streamClosed()
+  {
+    MIL << "Controller closed the connection, exiting." << std::endl;
+    maybeDelayedShutdown();
+  }
+
   void ProvideWorker::messageReceived()
   {
     while ( auto message = _stream->nextMessage() ) {
@@ -422,6 +483,19 @@ namespace zyppng::worker {
         return;
       }
 
+      if ( code == ProvideMessage::Code::UpdateProvide ) {
+        const auto &i = std::find_if( _pendingProvides.begin (), _pendingProvides.end(), [ id = provide.requestId() ]( const auto &it ){ return it->_spec.requestId() == id; } );
+        if ( i == _pendingProvides.end() || (*i)->_state == ProvideWorkerItem::Finished ) {
+          MIL << "Received Update for unknown request: " << provide.requestId() << ", ignoring!" << std::endl;
+          return;
+        }
+        const auto &maxSpeed = provide.value( ProvideMsgFields::MaxDownloadSpeed );
+        if ( maxSpeed.valid() )
+          (*i)->_spec.setValue( ProvideMsgFields::MaxDownloadSpeed, maxSpeed.asInt64() );
+        update(i);
+        return;
+      }
+
       _pendingProvides.push_back( makeItem (ProvideMessage(provide)) );
       return;
     }
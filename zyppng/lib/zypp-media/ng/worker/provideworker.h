@@ -78,6 +78,13 @@ namespace zyppng::worker {
 
     expected<void> run ( int recv = STDIN_FILENO, int send = STDOUT_FILENO );
 
+    /*!
+     * Runs the worker on a in process connection to the controller, used when the worker is
+     * hosted on a thread of the controller process. Messages are exchanged without encoding
+     * them, \ref controlIO is not available in this mode.
+     */
+    expected<void> run ( StompFrameStream::FrameQueue::Ptr recv, StompFrameStream::FrameQueue::Ptr send );
+
     std::deque<ProvideWorkerItemRef> &requestQueue();
     /*!
      * Called when the worker process exits
@@ -107,6 +114,14 @@ namespace zyppng::worker {
     ProvideNotificatioMode provNotificationMode() const;
     void setProvNotificationMode(const ProvideNotificatioMode &provNotificationMode);
 
+    /*!
+     * Set when the worker runs on a thread of the controller process instead of its own
+     * process. The process wide log setup is not touched in that case, the worker writes
+     * into the controller log directly. Needs to be set before calling \ref run.
+     */
+    bool inProcess() const;
+    void setInProcess( bool set );
+
   protected:
     virtual void initLog();
     virtual expected<WorkerCaps> initialize ( const Configuration &conf ) = 0;
@@ -117,6 +132,12 @@ namespace zyppng::worker {
     virtual void provide ( ) = 0;
     virtual void cancel  ( const std::deque<ProvideWorkerItemRef>::iterator &request ) = 0;
 
+    /*!
+     * Called when the controller changed parameters of a enqueued or running request via a UpdateProvide message,
+     * the new values are already merged into the items spec. The default implementation does nothing.
+     */
+    virtual void update  ( const std::deque<ProvideWorkerItemRef>::iterator &request );
+
     /*!
      * Always called to create new items for the request queue,
      * override this to populate the queue with instances of custom \ref ProvideItem subclasses.
@@ -173,17 +194,20 @@ namespace zyppng::worker {
     void redirect       ( const uint32_t id, const zypp::Url &url, const zypp::Pathname &newPath );
 
     /*!
-     * Returns the control IO datasource, only valid after \ref run was called
+     * Returns the control IO datasource, only valid after \ref run was called with
+     * file descriptors
      */
     AsyncDataSource &controlIO ();
 
 
   private:
+    expected<void> runStream ();
     expected<void> executeHandshake ();
     void maybeDelayedShutdown ();
     void messageLoop ( Timer & );
     void readFdClosed  ( uint, AsyncDataSource::ChannelCloseReason );
     void writeFdClosed ( AsyncDataSource::ChannelCloseReason );
+    void streamClosed ();
     void messageReceived ();
     void onInvalidMessageReceived ( );
     void invalidMessageReceived ( std::exception_ptr p );
@@ -196,6 +220,7 @@ namespace zyppng::worker {
     ProvideNotificatioMode _provNotificationMode = QUEUE_NOT_EMTPY;
     bool _inControllerRequest = false; //< Used to signalize that we are currently in a blocking controller callback
     bool _isRunning = false;
+    bool _inProcess = false;
     std::string_view _workerName;
     EventLoop::Ptr _loop = EventLoop::create();
     Timer::Ptr _msgAvail = Timer::create();
@@ -0,0 +1,170 @@
+#include <boost/test/unit_test.hpp>
+#include <zypp-core/ng/async/task.h>
+#include <zypp-core/ng/pipelines/operators.h>
+#include <zypp-core/ng/pipelines/Concurrent>
+#include <zypp-core/ng/pipelines/Expected>
+#include <zypp-core/ng/base/EventLoop>
+#include <zypp-core/ng/base/EventDispatcher>
+#include <zypp-core/base/UserRequestException>
+
+#include <algorithm>
+#include <vector>
+
+using namespace zyppng;
+using namespace zyppng::operators;
+
+namespace {
+
+  struct Sleep
+  {
+    Sleep( unsigned ms ) : _ms( ms ) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend( std::coroutine_handle<> cont ) {
+      EventDispatcher::instance()->invokeAfter( [ hdl = std::move(cont) ](){
+        hdl.resume();
+        return false;
+      }, _ms );
+    }
+
+    void await_resume() {}
+
+  private:
+    unsigned _ms;
+  };
+
+  /// tracks how many items are running at the same time
+  struct Activity {
+    unsigned active = 0;
+    unsigned maxActive = 0;
+    unsigned started = 0;
+
+    void enter() { ++started; maxActive = std::max( maxActive, ++active ); }
+    void leave() { --active; }
+  };
+
+  template <typename T>
+  T runLoop( EventLoopRef &l, Task<T> &task ) {
+    task.registerNotifyCallback( [&](){ l->quit(); } );
+    task.start();
+    if ( !task.isReady() )
+      l->run();
+    BOOST_REQUIRE( task.isReady() );
+    return std::move( task.get() );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( when_all_limited_keeps_order )
+{
+  EventLoopRef l = EventLoop::create();
+  Activity act;
+
+  // later items finish first
+  std::vector<int> in{ 1, 2, 3, 4, 5, 6, 7, 8 };
+  Task<std::vector<int>> task = std::move(in) | when_all_limited( 3, [&]( int i ) -> Task<int> {
+    act.enter();
+    co_await Sleep( 10 * ( 9 - i ) );
+    act.leave();
+    co_return i * 2;
+  });
+
+  std::vector<int> res = runLoop( l, task );
+  BOOST_REQUIRE_EQUAL( res.size(), 8 );
+  for ( int i = 0; i < 8; ++i )
+    BOOST_CHECK_EQUAL( res[i], (i + 1) * 2 );
+  BOOST_CHECK_EQUAL( act.maxActive, 3 );
+  BOOST_CHECK_EQUAL( act.active, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( when_all_limited_collects_errors )
+{
+  EventLoopRef l = EventLoop::create();
+
+  std::vector<int> in{ 1, 2, 3, 4 };
+  Task<std::vector<expected<int>>> task = std::move(in) | when_all_limited( 2, []( int i ) -> Task<expected<int>> {
+    co_await Sleep( 1 );
+    if ( i % 2 )
+      co_return expected<int>::error( ZYPP_EXCPT_PTR( zypp::Exception("odd") ) );
+    co_return expected<int>::success( i );
+  });
+
+  auto res = runLoop( l, task );
+  BOOST_REQUIRE_EQUAL( res.size(), 4 );
+  BOOST_CHECK( !res[0] );
+  BOOST_CHECK( res[1] && *res[1] == 2 );
+  BOOST_CHECK( !res[2] );
+  BOOST_CHECK( res[3] && *res[3] == 4 );
+}
+
+BOOST_AUTO_TEST_CASE( when_all_limited_cancel )
+{
+  EventLoopRef l = EventLoop::create();
+  CancellationToken token;
+  Activity act;
+
+  std::vector<int> in{ 1, 2, 3, 4, 5, 6 };
+  Task<std::vector<expected<int>>> task = std::move(in) | when_all_limited( 2, [&]( int i ) -> Task<expected<int>> {
+    act.enter();
+    co_await Sleep( 5 );
+    act.leave();
+    if ( i == 1 )
+      token.cancel();
+    co_return expected<int>::success( i );
+  }, token );
+
+  auto res = runLoop( l, task );
+  BOOST_REQUIRE_EQUAL( res.size(), 6 );
+  BOOST_CHECK_EQUAL( act.started, 2 );
+  BOOST_CHECK( res[0] && res[1] );
+  for ( int i = 2; i < 6; ++i ) {
+    BOOST_REQUIRE( !res[i] );
+    BOOST_CHECK_THROW( std::rethrow_exception( res[i].error() ), zypp::AbortRequestException );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( for_each_concurrent_stops_on_error )
+{
+  EventLoopRef l = EventLoop::create();
+  Activity act;
+
+  std::vector<int> in{ 1, 2, 3, 4, 5, 6, 7, 8 };
+  Task<expected<void>> task = std::move(in) | for_each_concurrent( 2, [&]( int i ) -> Task<expected<void>> {
+    act.enter();
+    co_await Sleep( 5 );
+    act.leave();
+    if ( i == 3 )
+      co_return expected<void>::error( ZYPP_EXCPT_PTR( zypp::Exception("three") ) );
+    co_return expected<void>::success();
+  });
+
+  auto res = runLoop( l, task );
+  BOOST_REQUIRE( !res );
+  BOOST_CHECK_THROW( std::rethrow_exception( res.error() ), zypp::Exception );
+  BOOST_CHECK_LT( act.started, 8 );
+  BOOST_CHECK_LE( act.maxActive, 2 );
+  BOOST_CHECK_EQUAL( act.active, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( for_each_concurrent_void )
+{
+  EventLoopRef l = EventLoop::create();
+  Activity act;
+
+  std::vector<int> in( 20, 1 );
+  Task<void> task = std::move(in) | for_each_concurrent( 5, [&]( int ) -> Task<void> {
+    act.enter();
+    co_await Sleep( 1 );
+    act.leave();
+  });
+
+  task.registerNotifyCallback( [&](){ l->quit(); } );
+  task.start();
+  if ( !task.isReady() )
+    l->run();
+
+  BOOST_REQUIRE( task.isReady() );
+  BOOST_CHECK_NO_THROW( task.get() );
+  BOOST_CHECK_EQUAL( act.started, 20 );
+  BOOST_CHECK_EQUAL( act.maxActive, 5 );
+}
@@ -0,0 +1,114 @@
+#include <boost/test/unit_test.hpp>
+
+#include <zypp-core/ng/async/task.h>
+#include <zypp-core/ng/async/offload.h>
+#include <zypp-core/ng/thread/threadpool.h>
+#include <zypp-core/ng/base/eventloop.h>
+#include <zypp-core/ng/base/timer.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+BOOST_AUTO_TEST_CASE( threadpool_runs_all_jobs )
+{
+  std::atomic<unsigned> done = 0;
+  {
+    zyppng::ThreadPool pool( 4 );
+    BOOST_REQUIRE_EQUAL( pool.size(), 4 );
+    for ( unsigned i = 0; i < 1000; ++i ) {
+      pool.post( [&](){
+        // jobs posted from a worker are queued locally and may be stolen
+        if ( done.fetch_add( 1 ) % 10 == 0 )
+          pool.post( [&](){ done.fetch_add( 1 ); } );
+      });
+    }
+  } // joins after all jobs ran
+  BOOST_REQUIRE_EQUAL( done.load(), 1100 );
+}
+
+BOOST_AUTO_TEST_CASE( offload_resumes_on_loop_thread )
+{
+  zyppng::EventLoopRef l = zyppng::EventLoop::create();
+  zyppng::ThreadPool pool( 2 );
+
+  const auto loopThread = std::this_thread::get_id();
+  std::thread::id jobThread;
+
+  auto task = [&]() -> zyppng::Task<int> {
+    int res = co_await zyppng::offload( [&](){
+      jobThread = std::this_thread::get_id();
+      return 42;
+    }, zyppng::CancellationToken(), pool );
+    BOOST_CHECK( std::this_thread::get_id() == loopThread );
+    co_return res;
+  }();
+
+  task.registerNotifyCallback( [&](){ l->quit(); } );
+  task.start();
+  if ( !task.isReady() )
+    l->run();
+
+  BOOST_REQUIRE( task.isReady() );
+  BOOST_REQUIRE_EQUAL( task.get(), 42 );
+  BOOST_CHECK( jobThread != loopThread );
+}
+
+BOOST_AUTO_TEST_CASE( offload_exception )
+{
+  zyppng::EventLoopRef l = zyppng::EventLoop::create();
+
+  auto task = []() -> zyppng::Task<void> {
+    co_await zyppng::offload( [](){ throw zypp::Exception("Test"); } );
+  }();
+
+  task.registerNotifyCallback( [&](){ l->quit(); } );
+  task.start();
+  if ( !task.isReady() )
+    l->run();
+
+  BOOST_REQUIRE( task.isReady() );
+  BOOST_REQUIRE_THROW( task.get(), zypp::Exception );
+}
+
+BOOST_AUTO_TEST_CASE( offload_cancel_on_destroy )
+{
+  zyppng::EventLoopRef l = zyppng::EventLoop::create();
+  zyppng::ThreadPool pool( 1 );
+
+  std::mutex m;
+  std::condition_variable cv;
+  bool started = false;
+  std::atomic<bool> sawCancel = false;
+
+  {
+    auto task = [&]() -> zyppng::Task<int> {
+      co_return co_await zyppng::offload( [&]( const zyppng::CancellationToken &token ){
+        {
+          std::lock_guard lk( m );
+          started = true;
+        }
+        cv.notify_all();
+        while ( !token.cancelled() )
+          std::this_thread::sleep_for( std::chrono::milliseconds(1) );
+        sawCancel = true;
+        return 1;
+      }, zyppng::CancellationToken(), pool );
+    }();
+    task.start();
+
+    std::unique_lock lk( m );
+    cv.wait( lk, [&](){ return started; } );
+  } // task destroyed while the job runs
+
+  // the completion must not resume the destroyed coroutine
+  auto timer = zyppng::Timer::create();
+  timer->setSingleShot( true );
+  timer->sigExpired().connect( [&]( auto & ){ l->quit(); } );
+  timer->start( 100 );
+  l->run();
+
+  BOOST_CHECK( sawCancel );
+}
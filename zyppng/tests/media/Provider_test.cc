@@ -1,11 +1,15 @@
 #include <zypp-media/ng/Provide>
 #include <zypp-media/ng/ProvideSpec>
 #include <zypp-media/ng/private/providemessage_p.h>
+#include <zypp-media/ng/private/provideworkerpool_p.h>
+#include <zypp-media/ng/private/providequeue_p.h>
 #include <zypp-media/MediaException>
+#include <zypp-media/MediaConfig>
 #include <zypp-media/auth/AuthData>
 #include <zypp-media/auth/CredentialManager>
 #include <zypp-core/OnMediaLocation>
 #include <zypp-core/ng/base/EventLoop>
+#include <zypp-core/ng/base/EventDispatcher>
 #include <zypp-core/Pathname.h>
 #include <zypp-core/Url.h>
 #include <zypp-core/base/UserRequestException>
@@ -53,6 +57,199 @@ BOOST_AUTO_TEST_CASE( http_prov_time_overflow )
   BOOST_REQUIRE_EQUAL( ts,msg.unwrap ().value ( zyppng::AuthInfoMsgFields::AuthTimestamp ).asInt64 () );
 }
 
+BOOST_AUTO_TEST_CASE( provide_message_binary )
+{
+  const int64_t size = int64_t(INT32_MAX) + 1;
+  auto prov = zyppng::ProvideMessage::createProvide( 42, zypp::Url("http://localhost/file"), std::string("file:with\nchars"), {}, size, true );
+  prov.setValue( std::string("extra"), std::string("value") );
+
+  auto bin = prov.toBinaryMessage ();
+  BOOST_REQUIRE( bin );
+  BOOST_REQUIRE( zyppng::rpc::isBinaryMessage( *bin ) );
+
+  // parseMessage picks the binary decoder by looking at the frame
+  auto msg = zyppng::StompFrameStream::parseMessage<zyppng::ProvideMessage>( *bin );
+  BOOST_REQUIRE( msg );
+  BOOST_REQUIRE_EQUAL( msg->code(), zyppng::ProvideMessage::Code::Prov );
+  BOOST_REQUIRE_EQUAL( msg->requestId(), 42u );
+  BOOST_REQUIRE_EQUAL( msg->value( zyppng::ProvideMsgFields::Url ).asString(), "http://localhost/file" );
+  BOOST_REQUIRE_EQUAL( msg->value( zyppng::ProvideMsgFields::Filename ).asString(), "file:with\nchars" );
+  BOOST_REQUIRE( msg->value( zyppng::ProvideMsgFields::ExpectedFilesize ).isInt64() );
+  BOOST_REQUIRE_EQUAL( msg->value( zyppng::ProvideMsgFields::ExpectedFilesize ).asInt64(), size );
+  BOOST_REQUIRE( msg->value( zyppng::ProvideMsgFields::CheckExistOnly ).isBool() );
+  BOOST_REQUIRE( msg->value( zyppng::ProvideMsgFields::CheckExistOnly ).asBool() );
+  BOOST_REQUIRE_EQUAL( msg->value( std::string("extra") ).asString(), "value" );
+
+  // typed fields are validated as well
+  auto fin = zyppng::ProvideMessage::createProvideFinished( 1, "/some/file", true );
+  fin.setValue( zyppng::ProvideFinishedMsgFields::CacheHit, std::string("true") );
+  BOOST_REQUIRE( !zyppng::ProvideMessage::fromBinaryMessage( fin.toBinaryMessage().unwrap() ) );
+
+  // truncated messages are rejected
+  auto broken = prov.toBinaryMessage().unwrap();
+  broken.bodyRef().resize( broken.body().size() - 3 );
+  BOOST_REQUIRE( !zyppng::ProvideMessage::fromBinaryMessage( broken ) );
+}
+
+BOOST_AUTO_TEST_CASE( provide_max_download_speed )
+{
+  BOOST_REQUIRE_EQUAL( zyppng::ProvideFileSpec().priority(), zyppng::ProvideFileSpec::Normal );
+  BOOST_REQUIRE_EQUAL( zyppng::ProvideFileSpec().setPriority( zyppng::ProvideFileSpec::High ).priority(), zyppng::ProvideFileSpec::High );
+
+  // the scheduler passes the bandwidth share as int64 field
+  auto prov = zyppng::ProvideMessage::createProvide( 1, zypp::Url("http://localhost/file") );
+  prov.setValue( zyppng::ProvideMsgFields::MaxDownloadSpeed, int64_t(1024) );
+  auto msg = zyppng::ProvideMessage::fromStompMessage( prov.toStompMessage().unwrap() );
+  BOOST_REQUIRE( msg );
+  BOOST_REQUIRE( msg->value( zyppng::ProvideMsgFields::MaxDownloadSpeed ).isInt64() );
+  BOOST_REQUIRE_EQUAL( msg->value( zyppng::ProvideMsgFields::MaxDownloadSpeed ).asInt64(), 1024 );
+
+  prov.setValue( zyppng::ProvideMsgFields::MaxDownloadSpeed, std::string("fast") );
+  BOOST_REQUIRE( !zyppng::ProvideMessage::fromStompMessage( prov.toStompMessage().unwrap() ) );
+}
+
+BOOST_AUTO_TEST_CASE( provide_inprocess_schemes )
+{
+  auto &cfg = zypp::MediaConfig::instance();
+  BOOST_REQUIRE( cfg.provide_inprocess_workers( "dir" ) );
+
+  cfg.setConfigValue( "main", "provide.inprocess_workers", "copy, disk" );
+  BOOST_REQUIRE( !cfg.provide_inprocess_workers( "dir" ) );
+  BOOST_REQUIRE( cfg.provide_inprocess_workers( "disk" ) );
+  BOOST_REQUIRE( cfg.provide_inprocess_workers( "copy" ) );
+
+  cfg.setConfigValue( "main", "provide.inprocess_workers", "false" );
+  BOOST_REQUIRE( !cfg.provide_inprocess_workers( "copy" ) );
+
+  cfg.setConfigValue( "main", "provide.inprocess_workers", "true" );
+  BOOST_REQUIRE( cfg.provide_inprocess_workers( "dir" ) );
+}
+
+BOOST_AUTO_TEST_CASE( provide_update_message )
+{
+  auto upd = zyppng::ProvideMessage::createUpdateProvide( 5, 2048 );
+  BOOST_REQUIRE_EQUAL( upd.code(), zyppng::ProvideMessage::Code::UpdateProvide );
+
+  auto msg = zyppng::ProvideMessage::fromStompMessage( upd.toStompMessage().unwrap() );
+  BOOST_REQUIRE( msg );
+  BOOST_REQUIRE_EQUAL( msg->requestId(), 5 );
+  BOOST_REQUIRE_EQUAL( msg->value( zyppng::ProvideMsgFields::MaxDownloadSpeed ).asInt64(), 2048 );
+
+  auto bin = zyppng::ProvideMessage::fromBinaryMessage( upd.toBinaryMessage().unwrap() );
+  BOOST_REQUIRE( bin );
+  BOOST_REQUIRE_EQUAL( bin->value( zyppng::ProvideMsgFields::MaxDownloadSpeed ).asInt64(), 2048 );
+}
+
+BOOST_AUTO_TEST_CASE( provide_priority_order )
+{
+  using Prio = zyppng::ProvideFileSpec::Priority;
+  std::deque<std::pair<Prio, int>> queue;
+  const auto &push = [&]( Prio prio, int id ) {
+    queue.insert( zyppng::priorityInsertPos( queue.begin(), queue.end(), prio, []( const auto &e ) { return e.first; } ), { prio, id } );
+  };
+
+  push( zyppng::ProvideFileSpec::Low,    1 );
+  push( zyppng::ProvideFileSpec::Normal, 2 );
+  push( zyppng::ProvideFileSpec::High,   3 );
+  push( zyppng::ProvideFileSpec::Normal, 4 );
+  push( zyppng::ProvideFileSpec::Low,    5 );
+  push( zyppng::ProvideFileSpec::High,   6 );
+
+  // higher priorities first, FIFO within the same priority
+  std::vector<int> order;
+  for ( const auto &e : queue )
+    order.push_back( e.second );
+  const std::vector<int> expected { 3, 6, 2, 4, 1, 5 };
+  BOOST_REQUIRE_EQUAL_COLLECTIONS( order.begin(), order.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( provide_adaptive_connection_limit )
+{
+  using namespace std::chrono_literals;
+  const auto t0 = std::chrono::steady_clock::now();
+  const auto mb = []( int n ) { return makeBytes( n * 1024LL * 1024LL ); };
+
+  zyppng::AdaptiveConnectionLimit limit( 2, 1, 3, 2s );
+  BOOST_REQUIRE_EQUAL( limit.limit(), 2 );
+
+  // nothing is measured before a request was activated
+  BOOST_REQUIRE( !limit.finished( mb(1), 0, t0 ) );
+
+  limit.activated( 1, t0 );
+  limit.activated( 2, t0 );
+  BOOST_REQUIRE( !limit.finished( mb(2), 2, t0 + 1s ) );  // window not closed yet
+
+  // first saturated window only sets the reference rate
+  auto rate = limit.finished( mb(2), 2, t0 + 2s );
+  BOOST_REQUIRE( rate );
+  BOOST_REQUIRE_CLOSE( *rate, 2.0 * 1024 * 1024, 0.1 );
+  BOOST_REQUIRE_EQUAL( limit.limit(), 2 );
+
+  // more than 10% better, raise
+  BOOST_REQUIRE( limit.finished( mb(6), 2, t0 + 4s ) );
+  BOOST_REQUIRE_EQUAL( limit.limit(), 3 );
+
+  // the queue did not use all 3 slots, a worse rate tells nothing
+  BOOST_REQUIRE( limit.finished( mb(1), 2, t0 + 6s ) );
+  BOOST_REQUIRE_EQUAL( limit.limit(), 3 );
+
+  // saturated and more than 20% worse, lower
+  limit.activated( 3, t0 + 6s );
+  BOOST_REQUIRE( limit.finished( mb(1), 3, t0 + 8s ) );
+  BOOST_REQUIRE_EQUAL( limit.limit(), 2 );
+
+  // idle time does not count
+  limit.idle();
+  BOOST_REQUIRE( !limit.finished( mb(100), 0, t0 + 20s ) );
+  BOOST_REQUIRE_EQUAL( limit.limit(), 2 );
+
+  // bounds are kept
+  zyppng::AdaptiveConnectionLimit fixed( 1, 1, 1, 1s );
+  fixed.activated( 1, t0 );
+  fixed.finished( mb(1), 1, t0 + 1s );
+  fixed.finished( mb(10), 1, t0 + 2s );
+  BOOST_REQUIRE_EQUAL( fixed.limit(), 1 );
+  fixed.finished( mb(0), 1, t0 + 3s );
+  BOOST_REQUIRE_EQUAL( fixed.limit(), 1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( worker_pool )
+{
+  auto ev = zyppng::EventLoop::create();
+  const auto &worker = zypp::Pathname ( ZYPPNG_WORKERS_DIR ) / "zypp-media-dir";
+
+  const auto &runFor = [&]( uint64_t ms ) {
+    zyppng::EventDispatcher::invokeAfter( [&](){ ev->quit(); return false; }, ms );
+    ev->run();
+  };
+
+  auto &pool = zyppng::ProvideWorkerPool::instance();
+  pool.setIdleTimeout( std::chrono::milliseconds(500) );
+
+  // non existing workers are ignored
+  pool.reserve( zypp::Pathname ( ZYPPNG_WORKERS_DIR ) / "zypp-media-doesnotexist", 2 );
+  pool.reserve( worker, 2 );
+  runFor( 100 );
+  BOOST_REQUIRE_EQUAL( pool.available( zypp::Pathname ( ZYPPNG_WORKERS_DIR ) / "zypp-media-doesnotexist" ), 0 );
+  BOOST_REQUIRE_EQUAL( pool.available( worker ), 2 );
+
+  // taken workers are running and replaced in the background
+  auto proc = pool.take( worker );
+  BOOST_REQUIRE( proc );
+  BOOST_REQUIRE( proc->isRunning() );
+  BOOST_REQUIRE_EQUAL( pool.available( worker ), 1 );
+  runFor( 100 );
+  BOOST_REQUIRE_EQUAL( pool.available( worker ), 2 );
+  proc->closeWriteChannel();
+  proc->waitForExit();
+
+  // unused workers are stopped after the idle timeout
+  runFor( 1000 );
+  BOOST_REQUIRE_EQUAL( pool.available( worker ), 0 );
+  BOOST_REQUIRE( !pool.take( worker ) );
+}
+
 
 ZYPP_CORO_TEST_CASE( http_prov )
 {
@@ -143,6 +340,49 @@ ZYPP_CORO_TEST_CASE( http_attach_prov )
   BOOST_REQUIRE_EQUAL( sum, std::string("7e562d52c100b68e9d6a561fa8519575") );
 }
 
+ZYPP_CORO_TEST_CASE( dir_attach_prov_inprocess )
+{
+  using namespace zyppng::operators;
+
+  const auto &workerPath = zypp::Pathname ( ZYPPNG_WORKERS_DIR );
+  const auto &dataRoot   = zypp::Pathname ( TESTS_SHARED_DIR ) / "data" / "http";
+
+  zypp::Url dirUrl( "dir:/" );
+  dirUrl.setPathName( dataRoot.asString() );
+
+  // the in process worker needs to behave exactly like the worker executable
+  for ( const bool inProcess : { true, false } ) {
+    zypp::MediaConfig::instance().setConfigValue( "main", "provide.inprocess_workers", inProcess ? "true" : "false" );
+
+    zypp::filesystem::TmpDir provideRoot;
+    auto prov = zyppng::Provide::create ( provideRoot );
+    prov->setWorkerPath ( workerPath );
+    prov->start();
+
+    zyppng::Provide::MediaHandle media;
+    auto res = co_await( prov->attachMedia( dirUrl, zyppng::ProvideMediaSpec( "OnlineMedia" )
+                                                 .setMediaFile( dataRoot / "media.1" / "media" )
+                                                 .setMedianr(1) )
+              | and_then ( [&]( zyppng::Provide::MediaHandle &&res ){
+                media = std::move(res);
+                return prov->provide( media, "/test.txt", zyppng::ProvideFileSpec() );
+              }));
+
+    BOOST_REQUIRE( res.is_valid() );
+    zypp::PathInfo pi ( res->file() );
+    BOOST_REQUIRE( pi.isExist() && pi.isFile() );
+
+    std::ifstream in( res->file().asString(), std::ios::binary );
+    auto sum = zypp::CheckSum::md5( in );
+    BOOST_REQUIRE_EQUAL( sum, std::string("7e562d52c100b68e9d6a561fa8519575") );
+
+    auto notFound = co_await prov->provide( media, "/doesnotexist.txt", zyppng::ProvideFileSpec() );
+    BOOST_REQUIRE( !notFound );
+    ZYPP_REQUIRE_THROW( std::rethrow_exception( notFound.error() ), zypp::media::MediaFileNotFoundException );
+  }
+  zypp::MediaConfig::instance().setConfigValue( "main", "provide.inprocess_workers", "true" );
+}
+
 ZYPP_CORO_TEST_CASE( http_attach_prov_404 )
 {
   using namespace zyppng::operators;
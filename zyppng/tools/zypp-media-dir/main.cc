@@ -1,7 +1,6 @@
-#include "dirprovider.h"
-
 #include <csignal>
 #include <zypp-media/ng/worker/MountingWorker>
+#include <zypp-media/ng/worker/DirProvider>
 #include <zypp-core/ng/base/private/linuxhelpers_p.h>
 
 
@@ -11,7 +10,7 @@ int main( int , char *[] )
   // to CTRL+C us
   zyppng::blockSignalsForCurrentThread( { SIGPIPE, SIGINT } );
 
-  auto driver   = std::make_shared<DirProvider>();
+  auto driver   = std::make_shared<zyppng::worker::DirProvider>();
   auto provider = std::make_shared<zyppng::worker::MountingWorker>( "zypp-media-dir", driver );
   driver->setProvider( provider );
 
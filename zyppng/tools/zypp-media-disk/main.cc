@@ -1,8 +1,7 @@
-#include "diskprovider.h"
-
 #include <csignal>
 #include <zypp-core/ng/base/private/linuxhelpers_p.h>
 #include <zypp-media/ng/worker/MountingWorker>
+#include <zypp-media/ng/worker/DiskProvider>
 
 int main( int , char *[] )
 {
@@ -10,7 +9,7 @@ int main( int , char *[] )
   // to CTRL+C us
   zyppng::blockSignalsForCurrentThread( { SIGPIPE, SIGINT } );
 
-  auto driver = std::make_shared<DiskProvider>();
+  auto driver = std::make_shared<zyppng::worker::DiskProvider>();
   auto worker = std::make_shared<zyppng::worker::MountingWorker>( "zypp-media-disk", driver );
   driver->setProvider( worker );
 
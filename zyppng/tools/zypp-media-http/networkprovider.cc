@@ -29,12 +29,15 @@ NetworkProvideItem::NetworkProvideItem(NetworkProvider &parent, zyppng::ProvideM
   const auto &headerSize      = _spec.value( zyppng::ProvideMsgFields::FileHeaderSize );
   const auto &checkExistsOnly = _spec.value( zyppng::ProvideMsgFields::CheckExistOnly );
   const auto &deltaFile       = _spec.value( zyppng::ProvideMsgFields::DeltaFile );
+  const auto &maxSpeed        = _spec.value( zyppng::ProvideMsgFields::MaxDownloadSpeed );
 
 
   _deltaFile   = deltaFile.isString()  ? zypp::Pathname(deltaFile.asString()) : std::optional<zypp::Pathname>();
   _expFilesize = expFilesize.isInt64() ? std::make_optional<zypp::ByteCount>( expFilesize.asInt64() ) : std::optional<zypp::ByteCount>();
   _headerSize  = headerSize.isInt64 () ? std::make_optional<zypp::ByteCount>( headerSize.asInt64() ) : std::optional<zypp::ByteCount>();
   _checkExistsOnly = ( checkExistsOnly.valid() && checkExistsOnly.isBool() && checkExistsOnly.asBool() );
+  if ( maxSpeed.isInt64() && maxSpeed.asInt64() > 0 )
+    _maxDownloadSpeed = maxSpeed.asInt64();
 }
 
 NetworkProvideItem::~NetworkProvideItem()
@@ -65,6 +68,9 @@ void NetworkProvideItem::startDownload( zypp::Url url )
     return;
   }
 
+  _urlMaxDownloadSpeed = settings.maxDownloadSpeed();
+  settings.setMaxDownloadSpeed( effectiveMaxDownloadSpeed() );
+
   _dl = std::make_shared<zyppng::NetworkRequest>( url, _stagingFileName, zyppng::NetworkRequest::WriteShared );
   _dl->transferSettings() = settings;
 
@@ -72,6 +78,7 @@ void NetworkProvideItem::startDownload( zypp::Url url )
     _dl->setExpectedFileSize( *_expFilesize );
 
   _connections.emplace_back( connect( *_dl, &zyppng::NetworkRequest::sigStarted, *this, &NetworkProvideItem::onStarted ) );
+  _connections.emplace_back( connect( *_dl, &zyppng::NetworkRequest::sigBytesDownloaded, *this, &NetworkProvideItem::onBytesDownloaded ) );
   _connections.emplace_back( connect( *_dl, &zyppng::NetworkRequest::sigFinished, *this, &NetworkProvideItem::onFinished ) );
 
 #ifdef ENABLE_ZCHUNK_COMPRESSION
@@ -105,6 +112,27 @@ void NetworkProvideItem::startDownload( zypp::Url url )
   normalDownload();
 }
 
+long NetworkProvideItem::effectiveMaxDownloadSpeed() const
+{
+  // the controller splits its bandwidth budget between all running requests, a lower limit set in the URL wins
+  if ( _maxDownloadSpeed && ( _urlMaxDownloadSpeed == 0 || _urlMaxDownloadSpeed > *_maxDownloadSpeed ) )
+    return *_maxDownloadSpeed;
+  return _urlMaxDownloadSpeed;
+}
+
+void NetworkProvideItem::updateMaxDownloadSpeed()
+{
+  const auto &maxSpeed = _spec.value( zyppng::ProvideMsgFields::MaxDownloadSpeed );
+  if ( maxSpeed.isInt64() && maxSpeed.asInt64() > 0 )
+    _maxDownloadSpeed = maxSpeed.asInt64();
+  else
+    _maxDownloadSpeed.reset();
+
+  // not yet started items pick up the new share in startDownload
+  if ( _dl )
+    _dl->setMaxDownloadSpeed( effectiveMaxDownloadSpeed() );
+}
+
 zyppng::NetworkRequestError NetworkProvideItem::safeFillSettingsFromURL( zypp::Url &url, zypp::media::TransferSettings &set)
 {
   auto buildExtraInfo = [this, &url](){
@@ -170,6 +198,16 @@ void NetworkProvideItem::onStarted( zyppng::NetworkRequest & )
   _parent.itemStarted( shared_this<NetworkProvideItem>() );
 }
 
+void NetworkProvideItem::onBytesDownloaded( zyppng::NetworkRequest &req, zypp::ByteCount )
+{
+  // the validators are stored as soon as we have the headers, so the data survives even if we are killed
+  if ( !_resumable || _partial.saved() )
+    return;
+
+  if ( _partial.save( req ) )
+    _stagingFile.resetDispose();
+}
+
 void NetworkProvideItem::onFinished( zyppng::NetworkRequest &result, const zyppng::NetworkRequestError & )
 {
   if ( result.hasError () ) {
@@ -177,6 +215,25 @@ void NetworkProvideItem::onFinished( zyppng::NetworkRequest &result, const zyppn
     const auto &err = result.error();
     _lastError = err;
 
+    // the server sent the full file or the data does not match, the partial data is useless
+    if ( _partial.resuming() ) {
+      switch ( err.type() ) {
+        case zyppng::NetworkRequestError::RangeFail:
+        case zyppng::NetworkRequestError::InvalidChecksum:
+        case zyppng::NetworkRequestError::ExceededMaxLen:
+        case zyppng::NetworkRequestError::MissingData: {
+          MIL << "Continuing the download of " << _dl->url() << " failed ( " << err.toString() << " ), starting over." << std::endl;
+          _partial.discard();
+          _stagingFile = zypp::ManagedFile( _stagingFileName, zypp::filesystem::unlink );
+          zypp::filesystem::assert_file( _stagingFileName );
+          normalDownload();
+          return;
+        }
+        default:
+          break;
+      }
+    }
+
     switch ( err.type () ) {
       case zyppng::NetworkRequestError::NoError:
         // err what
@@ -319,6 +376,9 @@ void NetworkProvideItem::normalDownload()
   // make sure no old ranges are lingering around
   _dl->resetRequestRanges();
 
+  // only ask for the missing data if we continue a interrupted download
+  _partial.setupRequest( *_dl );
+
   // ready, go
   _parent._dlManager->enqueue(_dl);
 }
@@ -399,6 +459,10 @@ zyppng::expected<zyppng::worker::WorkerCaps> NetworkProvider::initialize( const
     MIL << "Got anonymous ID setting from controller" << std::endl;
     _dlManager->setHostSpecificHeader("download.opensuse.org", "X-ZYpp-AnonymousId", val );
   }
+  if ( const auto &i = conf.find( std::string(zyppng::RESUME_PARTIAL) ); i != iEnd ) {
+    _resumePartial = zypp::str::strToBool( i->second, false );
+    MIL << "Keeping interrupted downloads: " << _resumePartial << std::endl;
+  }
   if ( const auto &i = conf.find( std::string(zyppng::ATTACH_POINT) ); i != iEnd ) {
     const auto &val = i->second;
     MIL << "Got attachpoint from controller: " << val << std::endl;
@@ -534,13 +598,20 @@ void NetworkProvider::provide()
         req->_scheduleAfter = now;
         continue;
       }
-
-      MIL<< "Removing broken staging file" << stagingPath << std::endl;
-
-      // here this is most likely a broken download
-      zypp::filesystem::unlink( stagingPath );
     }
 
+    /*
+     * A existing staging file is left by a interrupted download, if we know enough about it we
+     * continue where it stopped. Otherwise it is removed, a zchunk download builds the staging
+     * file from the delta file itself.
+     */
+    req->_resumable = ( _resumePartial && !req->_checkExistsOnly && !req->_deltaFile );
+    req->_partial   = zyppng::PartialDownload( stagingPath, req->_expFilesize.value_or( zypp::ByteCount() ) );
+    if ( req->_resumable )
+      req->_partial.prepare();
+    else
+      req->_partial.discard();
+
     auto errCode = zypp::filesystem::assert_dir( localPath.dirname() );
     if( errCode ) {
       std::string err = zypp::str::Str() << "assert_dir " << localPath.dirname() << " failed";
@@ -574,8 +645,10 @@ void NetworkProvider::provide()
     req->_targetFileName  = localPath;
     req->_stagingFileName = stagingPath;
 
-    // managed file to auto cleanup on errors
+    // managed file to auto cleanup on errors, unless the validators to continue it later were stored
     req->_stagingFile     =  zypp::ManagedFile( stagingPath, zypp::filesystem::unlink );
+    if ( req->_partial.saved() )
+      req->_stagingFile.resetDispose();
 
     req->startDownload( url );
   }
@@ -594,6 +667,11 @@ void NetworkProvider::cancel( const std::deque<zyppng::worker::ProvideWorkerItem
   queue.erase(i);
 }
 
+void NetworkProvider::update( const std::deque<zyppng::worker::ProvideWorkerItemRef>::iterator &i )
+{
+  std::static_pointer_cast<NetworkProvideItem>(*i)->updateMaxDownloadSpeed();
+}
+
 void NetworkProvider::immediateShutdown()
 {
   for ( const auto &pItem : requestQueue () ) {
@@ -634,7 +712,7 @@ void NetworkProvider::itemFinished( NetworkProvideItemRef item )
     const auto errCode = zypp::filesystem::rename( item->_stagingFileName, item->_targetFileName );
     if( errCode ) {
 
-      zypp::filesystem::unlink( item->_stagingFileName );
+      item->_partial.discard();
 
       std::string err = zypp::str::Str() << "Renaming " << item->_stagingFileName << " to " << item->_targetFileName << " failed!";
       DBG << err << std::endl;
@@ -647,6 +725,7 @@ void NetworkProvider::itemFinished( NetworkProvideItemRef item )
 
     } else {
       item->_stagingFile.resetDispose();
+      item->_partial.finish();
       provideSuccess( item->_spec.requestId(), false, item->_targetFileName );
     }
 
@@ -656,6 +735,23 @@ void NetworkProvider::itemFinished( NetworkProvideItemRef item )
     auto errCode = zyppng::ProvideMessage::Code::InternalError;
 
     const auto &error = maybeError.value();
+
+    // keep the data of a interrupted download only, everything else will not get better on the next attempt
+    switch( error.type() ) {
+      case zyppng::NetworkRequestError::Cancelled:
+      case zyppng::NetworkRequestError::ConnectionFailed:
+      case zyppng::NetworkRequestError::TemporaryProblem:
+      case zyppng::NetworkRequestError::Timeout:
+      case zyppng::NetworkRequestError::Http2Error:
+      case zyppng::NetworkRequestError::Http2StreamError:
+        if ( item->_partial.saved() )
+          MIL << "Keeping " << item->_stagingFileName << " to continue the download later" << std::endl;
+        break;
+      default:
+        item->_partial.discard();
+        break;
+    }
+
     switch( error.type() ) {
       case zyppng::NetworkRequestError::NoError: { throw std::runtime_error("DownloadError info broken"); break;}
       case zyppng::NetworkRequestError::InternalError: { errCode = zyppng::ProvideMessage::Code::InternalError; break;}
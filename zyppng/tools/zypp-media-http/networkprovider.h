@@ -14,6 +14,7 @@
 #include <zypp-core/ng/base/Signals>
 #include <zypp-curl/ng/network/AuthData>
 #include <zypp-curl/ng/network/zckhelper.h>
+#include <zypp-curl/ng/network/PartialDownload>
 #include <zypp-curl/transfersettings.h>
 #include <zypp-media/auth/CredentialManager>
 #include <zypp-media/ng/worker/ProvideWorker>
@@ -36,6 +37,7 @@ public:
 
   void startDownload( zypp::Url url );
   void cancelDownload ();
+  void updateMaxDownloadSpeed ();
 
   const std::optional<zyppng::NetworkRequestError> &error() const;
 
@@ -45,9 +47,13 @@ public:
   zypp::Pathname _targetFileName;
   zypp::Pathname _stagingFileName;
   zypp::ManagedFile _stagingFile;
+  zyppng::PartialDownload _partial; //< validators of the staging file, to continue a interrupted download
+  bool _resumable = false;          //< whether the staging file is kept if the download is interrupted
   bool _checkExistsOnly = false;
   std::optional<zypp::ByteCount> _expFilesize;
   std::optional<zypp::ByteCount> _headerSize;
+  std::optional<zypp::ByteCount> _maxDownloadSpeed; //< share of the controllers bandwidth budget
+  long _urlMaxDownloadSpeed = 0; //< limit requested in the URL or config, the share never raises it
   std::optional<zypp::Pathname> _deltaFile;
 
   std::chrono::steady_clock::time_point _scheduleAfter = std::chrono::steady_clock::time_point::min();
@@ -57,9 +63,11 @@ private:
   void clearConnections ();
   void setFinished ();
   void onStarted      ( zyppng::NetworkRequest & );
+  void onBytesDownloaded ( zyppng::NetworkRequest &req, zypp::ByteCount );
   void onFinished     (zyppng::NetworkRequest & result , const zyppng::NetworkRequestError &);
   void onAuthRequired ( zyppng::NetworkRequest &,  zyppng::NetworkAuthData &auth, const std::string &availAuth );
 
+  long effectiveMaxDownloadSpeed () const;
   zyppng::NetworkRequestError safeFillSettingsFromURL(zypp::Url &url, zypp::media::TransferSettings &set);
 
 #ifdef ENABLE_ZCHUNK_COMPRESSION
@@ -91,6 +99,7 @@ protected:
   zyppng::expected<zyppng::worker::WorkerCaps> initialize(const zyppng::worker::Configuration &conf) override;
   void provide() override;
   void cancel(const std::deque<zyppng::worker::ProvideWorkerItemRef>::iterator &i ) override;
+  void update(const std::deque<zyppng::worker::ProvideWorkerItemRef>::iterator &i ) override;
   zyppng::worker::ProvideWorkerItemRef makeItem(zyppng::ProvideMessage &&spec) override;
 
   friend struct NetworkProvideItem;
@@ -101,6 +110,7 @@ protected:
 private:
   zyppng::NetworkRequestDispatcherRef  _dlManager;
   zypp::Pathname _attachPoint;
+  bool _resumePartial = false; //< keep the data of interrupted downloads, see zyppng::RESUME_PARTIAL
   zypp::media::CredentialManager::CredentialSet _credCache; //< the credential cache for this download
 };
 